@@ -2,12 +2,14 @@ INCLUDEPATH += $$PWD
 
 HEADERS += \
     $$PWD/controltabs.h \
+    $$PWD/logmodel.h \
     $$PWD/logwidget.h \
     $$PWD/mainwindow.h \
     $$PWD/uiconstants.h
 
 SOURCES += \       
     $$PWD/controltabs.cpp \
+    $$PWD/logmodel.cpp \
     $$PWD/logwidget.cpp \
     $$PWD/mainwindow.cpp 
     
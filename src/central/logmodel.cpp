@@ -0,0 +1,205 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the LogModel class
+ */
+
+#include <QIcon>
+#include "logmodel.h"
+
+using namespace QRS::App;
+
+LogBuffer::LogBuffer(int capacity)
+    : mkCapacity(qMax(capacity, 1))
+{
+    mMessages.resize(mkCapacity);
+}
+
+//! Enqueue a message, returning false if the oldest one had to be overwritten
+bool LogBuffer::push(LogMessage const& message)
+{
+    bool isFull = mSize == mkCapacity;
+    if (isFull)
+        mFirst = (mFirst + 1) % mkCapacity;
+    else
+        ++mSize;
+    mMessages[(mFirst + mSize - 1) % mkCapacity] = message;
+    return !isFull;
+}
+
+//! Dequeue all the messages in the order they were pushed
+QList<LogMessage> LogBuffer::take()
+{
+    QList<LogMessage> result;
+    result.reserve(mSize);
+    for (int i = 0; i != mSize; ++i)
+        result.push_back(std::move(mMessages[(mFirst + i) % mkCapacity]));
+    mFirst = 0;
+    mSize = 0;
+    return result;
+}
+
+//! Dequeue the given number of the oldest messages
+void LogBuffer::discard(int numMessages)
+{
+    numMessages = qBound(0, numMessages, mSize);
+    for (int i = 0; i != numMessages; ++i)
+        mMessages[(mFirst + i) % mkCapacity] = LogMessage();
+    mFirst = (mFirst + numMessages) % mkCapacity;
+    mSize -= numMessages;
+}
+
+//! Dequeue all the messages
+void LogBuffer::clear()
+{
+    discard(mSize);
+    mFirst = 0;
+}
+
+//! Retrieve a message by its position counted from the oldest one
+LogMessage const& LogBuffer::at(int index) const
+{
+    return mMessages[(mFirst + index) % mkCapacity];
+}
+
+//! Retrieve the number of messages queued
+int LogBuffer::size() const
+{
+    return mSize;
+}
+
+//! Retrieve the maximum number of messages to be queued
+int LogBuffer::capacity() const
+{
+    return mkCapacity;
+}
+
+LogModel::LogModel(int capacity, QObject* parent)
+    : QAbstractTableModel(parent)
+    , mBuffer(capacity)
+{
+
+}
+
+//! Retrieve the number of messages stored
+int LogModel::rowCount(QModelIndex const& parent) const
+{
+    return parent.isValid() ? 0 : mBuffer.size();
+}
+
+//! Retrieve the number of columns: time, type and message
+int LogModel::columnCount(QModelIndex const& parent) const
+{
+    return parent.isValid() ? 0 : 3;
+}
+
+//! Retrieve a message by its row index
+LogMessage const& LogModel::message(int iRow) const
+{
+    return mBuffer.at(iRow);
+}
+
+//! Represent a message
+QVariant LogModel::data(QModelIndex const& index, int role) const
+{
+    if (!index.isValid() || index.row() >= mBuffer.size())
+        return QVariant();
+    LogMessage const& logMessage = message(index.row());
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        switch (index.column())
+        {
+        case ColumnType::kTime:
+            return logMessage.time.toString();
+        case ColumnType::kType:
+            return typeName(logMessage.type);
+        case ColumnType::kMessage:
+            return logMessage.text;
+        }
+        break;
+    case Qt::DecorationRole:
+        if (index.column() == ColumnType::kType)
+            return typeIcon(logMessage.type);
+        break;
+    case Qt::UserRole:
+        return (int)logMessage.type;
+    }
+    return QVariant();
+}
+
+//! Specify names of columns
+QVariant LogModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal)
+        return QAbstractTableModel::headerData(section, orientation, role);
+    switch (section)
+    {
+    case ColumnType::kTime:
+        return tr("Time");
+    case ColumnType::kType:
+        return tr("Type");
+    case ColumnType::kMessage:
+        return tr("Message");
+    }
+    return QVariant();
+}
+
+/*!
+ * \brief Append several messages at once
+ *
+ * When the capacity is exceeded, the oldest messages are discarded. Views are notified by one removal and one insertion.
+ */
+void LogModel::append(QList<LogMessage> const& messages)
+{
+    int numMessages = messages.size();
+    if (numMessages == 0)
+        return;
+    // Only the latest messages fit
+    int capacity = mBuffer.capacity();
+    int iStartMessage = qMax(numMessages - capacity, 0);
+    numMessages -= iStartMessage;
+    int numDiscard = qMax(mBuffer.size() + numMessages - capacity, 0);
+    if (numDiscard > 0)
+    {
+        beginRemoveRows(QModelIndex(), 0, numDiscard - 1);
+        mBuffer.discard(numDiscard);
+        endRemoveRows();
+    }
+    int size = mBuffer.size();
+    beginInsertRows(QModelIndex(), size, size + numMessages - 1);
+    for (int i = 0; i != numMessages; ++i)
+        mBuffer.push(messages[iStartMessage + i]);
+    endInsertRows();
+}
+
+//! Remove all the messages
+void LogModel::clear()
+{
+    beginResetModel();
+    mBuffer.clear();
+    endResetModel();
+}
+
+//! Retrieve a name of a message type
+QString const& LogModel::typeName(QtMsgType type)
+{
+    static QString const kNames[] = {"Debug", "Warning", "Critical", "Fatal", "Info", "Unknown"};
+    int iType = (int)type;
+    if (iType < 0 || iType > QtInfoMsg)
+        iType = QtInfoMsg + 1;
+    return kNames[iType];
+}
+
+//! Retrieve an icon of a message type which is created once for all the messages
+QIcon const& LogModel::typeIcon(QtMsgType type)
+{
+    static QIcon const kIcons[] = {QIcon(":/icons/dialog-debug.svg"), QIcon(":/icons/dialog-warning.svg"),
+                                   QIcon(":/icons/dialog-error.svg"), QIcon(":/icons/dialog-fatal.svg"),
+                                   QIcon(":/icons/dialog-info.svg"), QIcon(":/icons/dialog-question.svg")};
+    int iType = (int)type;
+    if (iType < 0 || iType > QtInfoMsg)
+        iType = QtInfoMsg + 1;
+    return kIcons[iType];
+}
@@ -0,0 +1,83 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the LogModel class
+ */
+
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractTableModel>
+#include <QTime>
+
+QT_BEGIN_NAMESPACE
+class QIcon;
+QT_END_NAMESPACE
+
+namespace QRS::App
+{
+
+//! Message to be logged
+struct LogMessage
+{
+    QTime time;
+    QtMsgType type;
+    QString text;
+};
+
+//! Fixed-capacity circular queue of messages which overwrites the oldest ones when full
+class LogBuffer
+{
+public:
+    explicit LogBuffer(int capacity);
+    ~LogBuffer() = default;
+    bool push(LogMessage const& message);
+    QList<LogMessage> take();
+    void discard(int numMessages);
+    void clear();
+    LogMessage const& at(int index) const;
+    int size() const;
+    int capacity() const;
+
+private:
+    //! Maximum number of messages to keep
+    int const mkCapacity;
+    //! Circular storage of messages
+    QList<LogMessage> mMessages;
+    //! Position of the oldest message
+    int mFirst = 0;
+    //! Number of messages stored
+    int mSize = 0;
+};
+
+//! Table model which keeps a bounded number of the latest messages
+class LogModel : public QAbstractTableModel
+{
+public:
+    enum ColumnType
+    {
+        kTime,
+        kType,
+        kMessage
+    };
+    explicit LogModel(int capacity, QObject* parent = nullptr);
+    ~LogModel() = default;
+    int rowCount(QModelIndex const& parent = QModelIndex()) const override;
+    int columnCount(QModelIndex const& parent = QModelIndex()) const override;
+    QVariant data(QModelIndex const& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    LogMessage const& message(int iRow) const;
+    void append(QList<LogMessage> const& messages);
+    void clear();
+    static QString const& typeName(QtMsgType type);
+    static QIcon const& typeIcon(QtMsgType type);
+
+private:
+    //! Messages in the order of rows
+    LogBuffer mBuffer;
+};
+
+}
+
+#endif // LOGMODEL_H
@@ -6,69 +6,225 @@
  */
 
 #include <QHeaderView>
-#include <QTime>
+#include <QScrollBar>
+#include <QSortFilterProxyModel>
+#include <QMutex>
 #include <QTimer>
+#include <QThread>
+#include <QFile>
+#include <QTextStream>
 #include "logwidget.h"
+#include "logmodel.h"
 
 using namespace QRS::App;
 
-enum ColumnType
+//! Maximum number of messages to represent
+static const int skMaxNumMessages = 10000;
+//! Interval between updates of the view in milliseconds
+static const int skFlushInterval = 50;
+
+//! Messages which have been sent, but not represented yet
+static LogBuffer sPendingMessages(skMaxNumMessages);
+static int sNumDiscardedMessages = 0;
+static QMutex sPendingMutex;
+
+namespace QRS::App
+{
+
+//! Filter to show messages of the selected types only
+class LogFilterModel : public QSortFilterProxyModel
+{
+public:
+    LogFilterModel(QObject* parent)
+        : QSortFilterProxyModel(parent)
+    {
+
+    }
+
+    //! Show or hide messages of the given type
+    void setTypeEnabled(QtMsgType type, bool isEnabled)
+    {
+        quint32 flag = 1u << (int)type;
+        quint32 enabledTypes = isEnabled ? mEnabledTypes | flag : mEnabledTypes & ~flag;
+        if (enabledTypes == mEnabledTypes)
+            return;
+        mEnabledTypes = enabledTypes;
+        invalidateRowsFilter();
+    }
+
+protected:
+    //! Check whether the type of a message is enabled
+    bool filterAcceptsRow(int iSourceRow, QModelIndex const& /*sourceParent*/) const override
+    {
+        LogMessage const& message = ((LogModel*)sourceModel())->message(iSourceRow);
+        return mEnabledTypes & (1u << (int)message.type);
+    }
+
+private:
+    quint32 mEnabledTypes = ~0u;
+};
+
+//! Worker which writes messages to a file in a separate thread
+class LogFileSink : public QObject
 {
-    kTime,
-    kType,
-    kMessage
+public:
+    LogFileSink(QString const& filePath)
+        : mFile(filePath)
+    {
+
+    }
+
+    //! Open the file to append messages
+    bool open()
+    {
+        if (!mFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+            return false;
+        mStream.setDevice(&mFile);
+        return true;
+    }
+
+    //! Write a bunch of messages
+    void write(QList<LogMessage> const& messages)
+    {
+        for (LogMessage const& message : messages)
+            mStream << message.time.toString() << '\t' << LogModel::typeName(message.type) << '\t' << message.text << '\n';
+        mStream.flush();
+    }
+
+private:
+    QFile mFile;
+    QTextStream mStream;
 };
 
+}
+
 LogWidget::LogWidget(QWidget* parent)
-    : QTableWidget(parent)
+    : QTableView(parent)
 {
-    setColumnCount(3);
+    mpModel = new LogModel(skMaxNumMessages, this);
+    mpFilterModel = new LogFilterModel(this);
+    mpFilterModel->setSourceModel(mpModel);
+    setModel(mpFilterModel);
     setSortingEnabled(false);
+    setWordWrap(false);
     setSizeAdjustPolicy(AdjustToContentsOnFirstShow);
+    setSelectionBehavior(QAbstractItemView::SelectRows);
     horizontalHeader()->setStretchLastSection(true);
-    setHorizontalHeaderLabels({tr("Time"), tr("Type"), tr("Message")});
+    verticalHeader()->setDefaultSectionSize(verticalHeader()->minimumSectionSize());
     setEditTriggers(QAbstractItemView::NoEditTriggers);
+    // Represent the messages sent at the fixed rate
+    mpFlushTimer = new QTimer(this);
+    mpFlushTimer->setInterval(skFlushInterval);
+    connect(mpFlushTimer, &QTimer::timeout, this, &LogWidget::flush);
+    mpFlushTimer->start();
+}
+
+LogWidget::~LogWidget()
+{
+    flush();
+    removeFileSink();
 }
 
-//! Represent a message sent
+/*!
+ * \brief Queue a message to be represented
+ *
+ * The function can be called from any thread, since the widget acquires the queued messages by timer.
+ * If the queue is full, the oldest messages are discarded.
+ */
 void LogWidget::log(QtMsgType messageType, const QString& message)
 {
-    static const int kWaitToScroll = 10;
-    int iRow = rowCount();
-    insertRow(iRow);
-    QString type = "Unknown";
-    QIcon icon = QIcon(":/icons/dialog-question.svg");
-    switch (messageType)
-    {
-    case QtDebugMsg:
-        type = "Debug";
-        icon = QIcon(":/icons/dialog-debug.svg");
-        break;
-    case QtInfoMsg:
-        type = "Info";
-        icon = QIcon(":/icons/dialog-info.svg");
-        break;
-    case QtWarningMsg:
-        type = "Warning";
-        icon = QIcon(":/icons/dialog-warning.svg");
-        break;
-    case QtCriticalMsg:
-        type = "Critical";
-        icon = QIcon(":/icons/dialog-error.svg");
-        break;
-    case QtFatalMsg:
-        type = "Fatal";
-        icon = QIcon(":/icons/dialog-fatal.svg");
-        break;
-    }
-    QString time = QTime::currentTime().toString();
     QString filterMessage = message;
     filterMessage.remove('\"');
-    setItem(iRow, ColumnType::kTime, new QTableWidgetItem(time));
-    setItem(iRow, ColumnType::kType, new QTableWidgetItem(icon, type));
-    setItem(iRow, ColumnType::kMessage, new QTableWidgetItem(filterMessage));
+    {
+        QMutexLocker locker(&sPendingMutex);
+        if (!sPendingMessages.push({QTime::currentTime(), messageType, filterMessage}))
+            ++sNumDiscardedMessages;
+    }
+    // The application is going to be aborted, so the message cannot be postponed
+    if (messageType == QtFatalMsg)
+        fprintf(stderr, "%s\n", qPrintable(filterMessage));
+}
+
+//! Represent all the queued messages
+void LogWidget::flush()
+{
+    QList<LogMessage> messages;
+    int numDiscardedMessages;
+    {
+        QMutexLocker locker(&sPendingMutex);
+        messages = sPendingMessages.take();
+        numDiscardedMessages = sNumDiscardedMessages;
+        sNumDiscardedMessages = 0;
+    }
+    if (messages.isEmpty())
+        return;
+    if (numDiscardedMessages > 0)
+    {
+        QString text = tr("%1 messages were discarded due to the overflow").arg(numDiscardedMessages);
+        messages.push_front({QTime::currentTime(), QtWarningMsg, text});
+    }
+    if (mpFileSink)
+    {
+        LogFileSink* pFileSink = mpFileSink;
+        QMetaObject::invokeMethod(pFileSink, [pFileSink, messages]() { pFileSink->write(messages); }, Qt::QueuedConnection);
+    }
+    // Follow the new messages only if the last one is shown
+    QScrollBar* pScrollBar = verticalScrollBar();
+    bool isScrollToBottom = pScrollBar->value() == pScrollBar->maximum();
+    mpModel->append(messages);
     // The last column is always maximized
-    resizeColumnToContents(0);
-    resizeColumnToContents(1);
-    QTimer::singleShot(kWaitToScroll, this, &QTableWidget::scrollToBottom);
+    if (!mIsColumnsResized)
+    {
+        resizeColumnToContents(LogModel::ColumnType::kTime);
+        resizeColumnToContents(LogModel::ColumnType::kType);
+        mIsColumnsResized = true;
+    }
+    if (isScrollToBottom)
+        scrollToBottom();
+}
+
+//! Show or hide messages of the given type
+void LogWidget::setTypeEnabled(QtMsgType messageType, bool isEnabled)
+{
+    mpFilterModel->setTypeEnabled(messageType, isEnabled);
+}
+
+//! Write all the following messages to a file asynchronously
+bool LogWidget::setFileSink(QString const& filePath)
+{
+    removeFileSink();
+    LogFileSink* pFileSink = new LogFileSink(filePath);
+    if (!pFileSink->open())
+    {
+        delete pFileSink;
+        qWarning() << tr("Log file %1 cannot be opened").arg(filePath);
+        return false;
+    }
+    mpFileThread = new QThread(this);
+    pFileSink->moveToThread(mpFileThread);
+    connect(mpFileThread, &QThread::finished, pFileSink, &QObject::deleteLater);
+    mpFileThread->start(QThread::LowPriority);
+    mpFileSink = pFileSink;
+    return true;
+}
+
+//! Stop writing messages to a file after all the queued ones are written
+void LogWidget::removeFileSink()
+{
+    if (!mpFileThread)
+        return;
+    flush();
+    // Writes are processed in the order they were posted, so the empty call returns once all of them are done
+    QMetaObject::invokeMethod(mpFileSink, []() {}, Qt::BlockingQueuedConnection);
+    mpFileThread->quit();
+    mpFileThread->wait();
+    delete mpFileThread;
+    mpFileThread = nullptr;
+    mpFileSink = nullptr;
+}
+
+//! Remove all the messages represented
+void LogWidget::clear()
+{
+    mpModel->clear();
 }
@@ -8,21 +8,45 @@
 #ifndef LOGWIDGET_H
 #define LOGWIDGET_H
 
-#include <QTableWidget>
+#include <QTableView>
+
+QT_BEGIN_NAMESPACE
+class QTimer;
+class QThread;
+QT_END_NAMESPACE
 
 namespace QRS::App
 {
 
+class LogModel;
+class LogFilterModel;
+class LogFileSink;
+
 //! Log all the messages sent
-class LogWidget : public QTableWidget
+class LogWidget : public QTableView
 {
 public:
     explicit LogWidget(QWidget* parent = nullptr);
-    ~LogWidget() = default;
-    void log(QtMsgType messageType, const QString& message);
+    ~LogWidget();
+    static void log(QtMsgType messageType, const QString& message);
+    void setTypeEnabled(QtMsgType messageType, bool isEnabled);
+    bool setFileSink(QString const& filePath);
+    void removeFileSink();
+    void clear();
+
+private:
+    void flush();
+
+private:
+    LogModel* mpModel;
+    LogFilterModel* mpFilterModel;
+    QTimer* mpFlushTimer;
+    // Writing messages to a file
+    LogFileSink* mpFileSink = nullptr;
+    QThread* mpFileThread = nullptr;
+    bool mIsColumnsResized = false;
 };
 
 }
 
-
 #endif // LOGWIDGET_H
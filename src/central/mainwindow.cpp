@@ -15,6 +15,7 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QLabel>
+#include <QLineEdit>
 #include "DockManager.h"
 #include "DockWidget.h"
 #include "DockAreaWidget.h"
@@ -26,6 +27,7 @@
 #include "logwidget.h"
 #include "uiconstants.h"
 #include "models/hierarchy/projecthierarchymodel.h"
+#include "models/hierarchy/hierarchyfiltermodel.h"
 #include "models/properties/dataobjectspropertiesmodel.h"
 #include "managers/managersfactory.h"
 #include "render/view3d.h"
@@ -149,7 +151,8 @@ CDockWidget* MainWindow::createProjectHierarchyWidget()
     // Set the hierarchy model
     mpProjectHierarchyModel = new ProjectHierarchyModel("central/projectHierarchy", pWidget);
     mpProjectHierarchyModel->setProject(mpProject);
-    pWidget->setModel(mpProjectHierarchyModel);
+    HierarchyFilterModel* pFilterModel = new HierarchyFilterModel(mpProjectHierarchyModel, pWidget);
+    pWidget->setModel(pFilterModel);
     connect(pWidget->selectionModel(), &QItemSelectionModel::selectionChanged,
             mpProjectHierarchyModel, &ProjectHierarchyModel::validateItemSelection);
     connect(mpProjectHierarchyModel, &ProjectHierarchyModel::selectionValidated,
@@ -158,6 +161,13 @@ CDockWidget* MainWindow::createProjectHierarchyWidget()
     CDockWidget* pDockWidget = new CDockWidget(tr("Project Hierarchy"));
     pDockWidget->setStyleSheet("background-color: white");
     pDockWidget->setWidget(pWidget);
+    // Search field
+    QLineEdit* pSearchEdit = new QLineEdit();
+    pSearchEdit->setPlaceholderText(tr("Search"));
+    pSearchEdit->setClearButtonEnabled(true);
+    connect(pSearchEdit, &QLineEdit::textChanged, pFilterModel, &HierarchyFilterModel::setPattern);
+    QToolBar* pToolBar = pDockWidget->createDefaultToolBar();
+    pToolBar->addWidget(pSearchEdit);
     mpUi->menuWindow->addAction(pDockWidget->toggleViewAction());
     return pDockWidget;
 }
@@ -195,6 +205,47 @@ CDockWidget* MainWindow::createLogWidget()
     pLogger = new LogWidget();
     CDockWidget* pDockWidget = new CDockWidget(tr("Logging"));
     pDockWidget->setWidget(pLogger);
+    // ToolBar
+    QToolBar* pToolBar = pDockWidget->createDefaultToolBar();
+    pToolBar->setToolButtonStyle(Qt::ToolButtonStyle::ToolButtonIconOnly);
+    pDockWidget->setToolBarIconSize(kToolBarIconSize, CDockWidget::StateDocked);
+    // Filters of message types
+    QList<QPair<QtMsgType, QAction*>> filterActions =
+    {
+        {QtDebugMsg, new QAction(QIcon(":/icons/dialog-debug.svg"), tr("Debug"), pToolBar)},
+        {QtInfoMsg, new QAction(QIcon(":/icons/dialog-info.svg"), tr("Info"), pToolBar)},
+        {QtWarningMsg, new QAction(QIcon(":/icons/dialog-warning.svg"), tr("Warning"), pToolBar)},
+        {QtCriticalMsg, new QAction(QIcon(":/icons/dialog-error.svg"), tr("Critical"), pToolBar)}
+    };
+    for (auto const& [type, pAction] : filterActions)
+    {
+        pAction->setCheckable(true);
+        pAction->setChecked(true);
+        QtMsgType messageType = type;
+        connect(pAction, &QAction::toggled, pLogger, [messageType](bool isChecked) { pLogger->setTypeEnabled(messageType, isChecked); });
+        pToolBar->addAction(pAction);
+    }
+    pToolBar->addSeparator();
+    // Clearing
+    QAction* pAction = pToolBar->addAction(QIcon(":/icons/delete.svg"), tr("Clear"));
+    connect(pAction, &QAction::triggered, pLogger, &LogWidget::clear);
+    // Writing to a file
+    pAction = pToolBar->addAction(QIcon(":/icons/document-save-as.svg"), tr("Write to File"));
+    pAction->setCheckable(true);
+    connect(pAction, &QAction::toggled, this, [this, pAction](bool isChecked)
+    {
+        if (!isChecked)
+        {
+            pLogger->removeFileSink();
+            return;
+        }
+        QString filePath = QFileDialog::getSaveFileName(this, tr("Write Log to File"), mLastPath, tr("Log files (*.log *.txt)"));
+        if (filePath.isEmpty() || !pLogger->setFileSink(filePath))
+        {
+            QSignalBlocker blocker(pAction);
+            pAction->setChecked(false);
+        }
+    });
     mpUi->menuWindow->addAction(pDockWidget->toggleViewAction());
     return pDockWidget;
 }
@@ -240,19 +291,14 @@ void MainWindow::specifyMenuConnections()
 void MainWindow::specifyProjectConnections()
 {
     // Update models
-    connect(mpProject, &Project::propertiesDataObjectsChanged, mpProjectHierarchyModel, &ProjectHierarchyModel::updateContent);
-    connect(mpProject, &Project::propertiesRodComponentsChanged, mpProjectHierarchyModel, &ProjectHierarchyModel::updateContent);
-    connect(mpProject, &Project::dataObjectsSubstituted, mpProjectHierarchyModel, &ProjectHierarchyModel::updateContent);
-    connect(mpProject, &Project::rodComponentsSubstituted, mpProjectHierarchyModel, &ProjectHierarchyModel::updateContent);
+    connect(mpProject, &Project::entitiesChanged, mpProjectHierarchyModel, &ProjectHierarchyModel::registerChanges);
+    connect(mpProject, &Project::changed, mpProjectHierarchyModel, &ProjectHierarchyModel::scheduleUpdate);
     // Update the project through models
     connect(mpProjectHierarchyModel, &ProjectHierarchyModel::hierarchyChanged, mpProject, &Project::projectHierarchyChanged);
     // Set the modified state when the project has been changed
     std::function<void()> funProjectChanged = [this]() { setModified(true); };
     connect(mpProject, &Project::projectHierarchyChanged, funProjectChanged);
-    connect(mpProject, &Project::propertiesDataObjectsChanged, funProjectChanged);
-    connect(mpProject, &Project::propertiesRodComponentsChanged, funProjectChanged);
-    connect(mpProject, &Project::dataObjectsSubstituted, funProjectChanged);
-    connect(mpProject, &Project::rodComponentsSubstituted, funProjectChanged);
+    connect(mpProject, &Project::changed, funProjectChanged);
 }
 
 //! Save the current window settings
@@ -308,11 +354,12 @@ void MainWindow::createProject()
 {
     if (!saveProjectChangesDialog())
         return;
+    // Managers refer to the project, so they are destroyed first
+    delete mpManagersFactory;
     delete mpProject;
     mpProject = new Project(skDefaultProjectName);
     specifyProjectConnections();
     setModified(false);
-    delete mpManagersFactory;
     mpManagersFactory = new ManagersFactory(*mpProject, mLastPath, *mpSettings, this);
 }
 
@@ -337,6 +384,9 @@ void MainWindow::openProject(QString const& filePath)
         return;
     QString path = info.path();
     QString baseName = info.baseName();
+    // Managers refer to the project, so they are destroyed first
+    delete mpManagersFactory;
+    mpManagersFactory = nullptr;
     delete mpProject;
     // Open a project and specify connections
     mpProject = new Project(path, baseName);
@@ -347,7 +397,6 @@ void MainWindow::openProject(QString const& filePath)
     setModified(false);
     addToRecentProjects();
     // Update managers
-    delete mpManagersFactory;
     mpManagersFactory = new ManagersFactory(*mpProject, mLastPath, *mpSettings, this);
 }
 
@@ -440,8 +489,8 @@ void MainWindow::representHierarchyProperties(QVector<AbstractHierarchyItem*> it
     {
     case AbstractHierarchyItem::ItemType::kDataObjects:
     {
-        DataObjectsPropertiesModel* pModel = new DataObjectsPropertiesModel(mpPropertiesWidget, items);
-        connect(pModel, &DataObjectsPropertiesModel::propertyChanged, mpProject, &Project::propertiesDataObjectsChanged);
+        DataObjectsPropertiesModel* pModel = new DataObjectsPropertiesModel(*mpProject, mpPropertiesWidget, items);
+        connect(pModel, &DataObjectsPropertiesModel::propertyChanged, mpProjectHierarchyModel, &ProjectHierarchyModel::updateNames);
         mpPropertiesWidget->setModel(pModel);
         break;
     }
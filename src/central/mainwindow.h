@@ -119,7 +119,7 @@ public:
 //! Log all the messages
 inline void throwMessage(QtMsgType type, const QMessageLogContext& /*context*/, const QString& message)
 {
-    MainWindow::pLogger->log(type, message);
+    LogWidget::log(type, message);
 }
 
 }
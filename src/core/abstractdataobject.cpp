@@ -9,19 +9,47 @@
 
 using namespace QRS::Core;
 
-DataIDType AbstractDataObject::smMaxObjectID = 0;
+std::atomic<DataIDType> AbstractDataObject::smMaxObjectID = 0;
+std::atomic<quint64> AbstractDataObject::smMaxVersion = 0;
 
 //! Base constructor
 AbstractDataObject::AbstractDataObject(ObjectType type, QString const& name)
-    : mkType(type)
-    , mName(name)
+    : mNameIndex(NamePool::instance().acquire(name))
+    , mkType(type)
 {
     mID = ++smMaxObjectID;
+    mVersion = ++smMaxVersion;
+    mHandle = DataHandleTable::instance().acquire(this);
 }
 
 AbstractDataObject::~AbstractDataObject()
 {
+    DataHandleTable::instance().release(mHandle);
+    NamePool::instance().release(mNameIndex);
+}
+
+//! Substitute the name of the object
+void AbstractDataObject::setName(QString const& name)
+{
+    if (name == this->name())
+        return;
+    NamePool& pool = NamePool::instance();
+    pool.release(mNameIndex);
+    mNameIndex = pool.acquire(name);
+}
 
+/*!
+ * \brief Copy a name and items of another data object of the same type
+ *
+ * Contrary to cloning, the identity of the object is preserved, so the pointers which refer to it remain valid
+ */
+void AbstractDataObject::assign(AbstractDataObject const& another)
+{
+    if (mkType != another.mkType)
+        return;
+    setName(another.name());
+    mItems = another.mItems;
+    markModified();
 }
 
 //! Modify a key existed
@@ -35,13 +63,16 @@ bool AbstractDataObject::changeItemKey(DataKeyType oldKey, DataKeyType newKey, D
     DataItemType obj = items->at(oldKey);
     items->erase(oldKey);
     items->emplace(newKey, std::move(obj));
+    if (items == &mItems)
+        markModified();
     return true;
 }
 
 //! Remove an entity with the specified key
 void AbstractDataObject::removeItem(DataKeyType key)
 {
-    mItems.erase(key);
+    if (mItems.erase(key))
+        markModified();
 }
 
 //! Set an array value with the specified indices
@@ -51,6 +82,7 @@ bool AbstractDataObject::setArrayValue(DataKeyType key, DataValueType newValue,
         return false;
     DataItemType& array = mItems.at(key);
     array[iRow][iColumn] = newValue;
+    markModified();
     return true;
 }
 
@@ -89,7 +121,7 @@ DataValueType AbstractDataObject::getAvailableItemKey(DataValueType key, DataHol
 void AbstractDataObject::serialize(QDataStream& stream) const
 {
     stream << (quint32)mkType;
-    stream << mName;
+    stream << name();
     stream << (DataIDType)mID;
     stream << (quint32)mItems.size();
     for (auto& item : mItems)
@@ -119,4 +151,5 @@ void AbstractDataObject::deserialize(QDataStream& stream)
         stream >> dataItem;
         mItems.emplace(key, dataItem);
     }
+    markModified();
 }
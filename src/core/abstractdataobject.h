@@ -8,12 +8,14 @@
 #ifndef ABSTRACTDATAOBJECT_H
 #define ABSTRACTDATAOBJECT_H
 
-#include <QObject>
 #include <QString>
 #include <QDataStream>
 #include <map>
+#include <atomic>
 #include "array.h"
 #include "aliasdata.h"
+#include "datahandletable.h"
+#include "namepool.h"
 
 namespace QRS::Core
 {
@@ -21,11 +23,22 @@ namespace QRS::Core
 using DataItemType = Array<DataValueType>;
 using DataHolder = std::map<DataKeyType, DataItemType>;
 
-//! Data object which is designied in the way to be represented in a table easily
-class AbstractDataObject : public QObject
+/*!
+ * \brief Data object which is designied in the way to be represented in a table easily
+ *
+ * Objects are kept compact: besides items, only an identifier, a handle, an index of an interned name,
+ * a version and a type tag are stored. Views access the name through name() and setName() as before.
+ * The version is drawn from a global counter every time items are modified, so that the objects which are computed
+ * from this one can detect whether their results are outdated. Clones keep the version, since their content is the same.
+ */
+class AbstractDataObject
 {
+    friend class DataObjectDelta;
+    friend class EditHistory;
+    friend class Expression;
+
 public:
-    enum ObjectType
+    enum ObjectType : quint8
     {
         kScalar,
         kVector,
@@ -33,19 +46,33 @@ public:
         kSurface
     };
     AbstractDataObject(ObjectType type, QString const& name);
+    AbstractDataObject(AbstractDataObject const&) = delete;
+    AbstractDataObject& operator=(AbstractDataObject const&) = delete;
     virtual ~AbstractDataObject() = 0;
     virtual AbstractDataObject* clone() const = 0;
+    virtual void assign(AbstractDataObject const& another);
     virtual DataItemType& addItem(DataKeyType key) = 0;
     void removeItem(DataValueType key);
     bool changeItemKey(DataKeyType oldKey, DataKeyType newKey, DataHolder* items = nullptr);
     DataValueType getAvailableItemKey(DataValueType key, DataHolder const* items = nullptr) const;
     bool setArrayValue(DataKeyType key, DataValueType newValue, IndexType iRow = 0, IndexType iColumn = 0);
     quint32 numberItems() const { return mItems.size(); }
-    DataHolder const& getItems() { return mItems; }
+    //! Retrieve items. Derived objects bring their cached results up to date first
+    DataHolder const& getItems() const
+    {
+        evaluate();
+        return mItems;
+    }
+    virtual bool isDerived() const { return false; }
+    virtual bool evaluate() const { return true; }
+    quint64 version() const { return mVersion; }
+    //! Register a modification of items which has been made through the references to them
+    void markModified() { mVersion = ++smMaxVersion; }
     DataIDType id() const { return mID; }
+    DataHandle handle() const { return mHandle; }
     ObjectType type() const { return mkType; }
-    QString const& name() const { return mName; }
-    void setName(QString const& name) { mName = name; }
+    QString const& name() const { return NamePool::instance().name(mNameIndex); }
+    void setName(QString const& name);
     static DataIDType maxObjectID() { return smMaxObjectID; }
     static void setMaxObjectID(DataIDType iMaxObjectID) { smMaxObjectID = iMaxObjectID; }
     virtual void serialize(QDataStream& stream) const;
@@ -54,13 +81,25 @@ public:
     virtual void import(QTextStream& stream) = 0;
 
 protected:
-    const ObjectType mkType;
-    QString mName;
+    //! Register items of a cache which has just been refreshed
+    void markEvaluated() const { mVersion = ++smMaxVersion; }
+
+protected:
+    //! Items and their version. Derived objects use them as a cache which is refreshed under their own lock
+    mutable DataHolder mItems;
     DataIDType mID;
-    DataHolder mItems;
+    mutable quint64 mVersion;
+
+private:
+    DataHandle mHandle;
+    quint32 mNameIndex;
+
+protected:
+    const ObjectType mkType;
 
 private:
-    static DataIDType smMaxObjectID;
+    static std::atomic<DataIDType> smMaxObjectID;
+    static std::atomic<quint64> smMaxVersion;
 };
 
 //! Print a data object to a stream
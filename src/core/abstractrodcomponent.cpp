@@ -7,10 +7,11 @@
 
 #include "abstractrodcomponent.h"
 #include "abstractdataobject.h"
+#include "dependencyindex.h"
 
 using namespace QRS::Core;
 
-DataIDType AbstractRodComponent::smMaxComponentID = 0;
+std::atomic<DataIDType> AbstractRodComponent::smMaxComponentID = 0;
 
 AbstractRodComponent::AbstractRodComponent(ComponentType componentType, QString const& name)
     : mkComponentType(componentType)
@@ -21,12 +22,53 @@ AbstractRodComponent::AbstractRodComponent(ComponentType componentType, QString
 
 AbstractRodComponent::~AbstractRodComponent()
 {
+    if (mpDependencyIndex)
+        mpDependencyIndex->remove(this);
+}
+
+//! Assign a data object to a field and register the reference, so that the reverse index stays consistent
+void AbstractRodComponent::setReference(int iField, DataHandle& field, AbstractDataObject const* pDataObject)
+{
+    field = pDataObject ? pDataObject->handle() : DataHandle();
+    auto iter = mReferences.find(iField);
+    if (iter != mReferences.end())
+    {
+        if (pDataObject && iter->second == pDataObject->id())
+            return;
+        if (mpDependencyIndex)
+            mpDependencyIndex->removeReference(iter->second, this, iField);
+        mReferences.erase(iter);
+    }
+    if (pDataObject)
+    {
+        mReferences.emplace(iField, pDataObject->id());
+        if (mpDependencyIndex)
+            mpDependencyIndex->addReference(pDataObject->id(), this, iField);
+    }
+}
 
+//! Attach the component to the reverse index of references
+void AbstractRodComponent::setDependencyIndex(DependencyIndex* pDependencyIndex)
+{
+    if (mpDependencyIndex == pDependencyIndex)
+        return;
+    if (mpDependencyIndex)
+    {
+        for (auto const& [iField, id] : mReferences)
+            mpDependencyIndex->removeReference(id, this, iField);
+    }
+    mpDependencyIndex = pDependencyIndex;
+    if (mpDependencyIndex)
+    {
+        for (auto const& [iField, id] : mReferences)
+            mpDependencyIndex->addReference(id, this, iField);
+    }
 }
 
 //! Helper function to write the identifier of a data object
-void AbstractRodComponent::writeDataObjectPointer(QDataStream& stream, AbstractDataObject const* pDataObject) const
+void AbstractRodComponent::writeDataObjectPointer(QDataStream& stream, DataHandle handle) const
 {
+    AbstractDataObject const* pDataObject = resolveDataObject(handle);
     qint64 id = -1;
     if (pDataObject)
         id = (qint64)pDataObject->id();
@@ -54,9 +96,9 @@ AbstractDataObject const* AbstractRodComponent::getDataObject(DataObjects const&
 }
 
 //! Substitute a data object with its updated version
-AbstractDataObject const* AbstractRodComponent::substituteDataObject(DataObjects const& dataObjects,
-                                                                     AbstractDataObject const* pDataObject) const
+AbstractDataObject const* AbstractRodComponent::substituteDataObject(DataObjects const& dataObjects, DataHandle handle) const
 {
+    AbstractDataObject const* pDataObject = resolveDataObject(handle);
     if (!pDataObject)
         return nullptr;
     DataIDType id = pDataObject->id();
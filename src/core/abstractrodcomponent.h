@@ -11,14 +11,24 @@
 #include <QObject>
 #include <QString>
 #include <QDataStream>
+#include <unordered_map>
+#include <atomic>
 #include "aliasdataset.h"
+#include "datahandletable.h"
 
 namespace QRS::Core
 {
 
+class DependencyIndex;
+
+//! Identifiers of data objects referred by fields of a component
+using DataReferences = std::unordered_map<int, DataIDType>;
+
 //! Component of the rod structure which characterizes one of its properties
 class AbstractRodComponent : public QObject
 {
+    friend class DependencyIndex;
+
 public:
     enum ComponentType
     {
@@ -43,20 +53,31 @@ public:
     virtual void deserialize(QDataStream& stream, DataObjects const& dataObjects) = 0;
     friend QDataStream& operator<<(QDataStream& stream, AbstractRodComponent const& component);
     virtual void resolveReferences(DataObjects const& dataObjects) = 0;
+    DataReferences const& references() const { return mReferences; }
+    DependencyIndex* dependencyIndex() const { return mpDependencyIndex; }
 
 protected:
-    void writeDataObjectPointer(QDataStream& stream, AbstractDataObject const* pDataObject) const;
+    void setReference(int iField, DataHandle& field, AbstractDataObject const* pDataObject);
+    //! Retrieve a data object referred by a field
+    static AbstractDataObject const* resolveDataObject(DataHandle handle) { return DataHandleTable::instance().resolve(handle); }
+    void writeDataObjectPointer(QDataStream& stream, DataHandle handle) const;
     AbstractDataObject const* readDataObjectPointer(QDataStream& stream, DataObjects const& dataObjects) const;
     AbstractDataObject const* getDataObject(DataObjects const& dataObjects, DataIDType id) const;
-    AbstractDataObject const* substituteDataObject(DataObjects const& dataObjects, AbstractDataObject const* pDataObject) const;
+    AbstractDataObject const* substituteDataObject(DataObjects const& dataObjects, DataHandle handle) const;
 
 protected:
     ComponentType const mkComponentType;
     QString mName;
     DataIDType mID;
+    //! References to data objects by fields
+    DataReferences mReferences;
+
+private:
+    void setDependencyIndex(DependencyIndex* pDependencyIndex);
 
 private:
-    static DataIDType smMaxComponentID;
+    static std::atomic<DataIDType> smMaxComponentID;
+    DependencyIndex* mpDependencyIndex = nullptr;
 };
 
 //! Print a rod component to a stream
@@ -10,7 +10,7 @@
 
 using namespace QRS::Core;
 
-quint32 AbstractSectionRodComponent::smNumInstances = 0;
+std::atomic<quint32> AbstractSectionRodComponent::smNumInstances = 0;
 
 AbstractSectionRodComponent::AbstractSectionRodComponent(SectionType sectionType, QString const& name)
     : AbstractRodComponent(kSection, name), mkSectionType(sectionType)
@@ -32,14 +32,14 @@ void AbstractSectionRodComponent::serialize(QDataStream& stream) const
     stream << (quint32)mkSectionType;
     stream << (DataIDType)mID;
     // Area
-    writeDataObjectPointer(stream, mpArea);
+    writeDataObjectPointer(stream, mArea);
     // Inertia moments
-    writeDataObjectPointer(stream, mpInertiaMomentTorsional);
-    writeDataObjectPointer(stream, mpInertiaMomentX);
-    writeDataObjectPointer(stream, mpInertiaMomentY);
+    writeDataObjectPointer(stream, mInertiaMomentTorsional);
+    writeDataObjectPointer(stream, mInertiaMomentX);
+    writeDataObjectPointer(stream, mInertiaMomentY);
     // Center coordinates
-    writeDataObjectPointer(stream, mpCenterCoordinateX);
-    writeDataObjectPointer(stream, mpCenterCoordinateY);
+    writeDataObjectPointer(stream, mCenterCoordinateX);
+    writeDataObjectPointer(stream, mCenterCoordinateY);
 }
 
 /*!
@@ -52,41 +52,41 @@ void AbstractSectionRodComponent::deserialize(QDataStream& stream, DataObjects c
 {
     stream >> mID;
     // Area
-    mpArea = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kArea, mArea, readDataObjectPointer(stream, dataObjects));
     // Inertia moments
-    mpInertiaMomentTorsional = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpInertiaMomentX = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpInertiaMomentY = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kInertiaMomentTorsional, mInertiaMomentTorsional, readDataObjectPointer(stream, dataObjects));
+    setReference(kInertiaMomentX, mInertiaMomentX, readDataObjectPointer(stream, dataObjects));
+    setReference(kInertiaMomentY, mInertiaMomentY, readDataObjectPointer(stream, dataObjects));
     // Center coordinates
-    mpCenterCoordinateX  = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpCenterCoordinateY   = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kCenterCoordinateX, mCenterCoordinateX, readDataObjectPointer(stream, dataObjects));
+    setReference(kCenterCoordinateY, mCenterCoordinateY, readDataObjectPointer(stream, dataObjects));
 }
 
 //! Resolve references of a cross-section
 void AbstractSectionRodComponent::resolveReferences(DataObjects const& dataObjects)
 {
     // Area
-    mpArea = (ScalarDataObject const*)substituteDataObject(dataObjects, mpArea);
+    setReference(kArea, mArea, substituteDataObject(dataObjects, mArea));
     // Inertia moments
-    mpInertiaMomentTorsional = (ScalarDataObject const*)substituteDataObject(dataObjects, mpInertiaMomentTorsional);
-    mpInertiaMomentX = (ScalarDataObject const*)substituteDataObject(dataObjects, mpInertiaMomentX);
-    mpInertiaMomentY = (ScalarDataObject const*)substituteDataObject(dataObjects, mpInertiaMomentY);
+    setReference(kInertiaMomentTorsional, mInertiaMomentTorsional, substituteDataObject(dataObjects, mInertiaMomentTorsional));
+    setReference(kInertiaMomentX, mInertiaMomentX, substituteDataObject(dataObjects, mInertiaMomentX));
+    setReference(kInertiaMomentY, mInertiaMomentY, substituteDataObject(dataObjects, mInertiaMomentY));
     // Center coordinates
-    mpCenterCoordinateX  = (ScalarDataObject const*)substituteDataObject(dataObjects, mpCenterCoordinateX);
-    mpCenterCoordinateY  = (ScalarDataObject const*)substituteDataObject(dataObjects, mpCenterCoordinateY);
+    setReference(kCenterCoordinateX, mCenterCoordinateX, substituteDataObject(dataObjects, mCenterCoordinateX));
+    setReference(kCenterCoordinateY, mCenterCoordinateY, substituteDataObject(dataObjects, mCenterCoordinateY));
 }
 
-//! Copy integrated properties of a cross section
+//! Copy integrated properties of a cross section, registering the references in the dependency index
 void AbstractSectionRodComponent::copyIntegratedProperties(AbstractSectionRodComponent const* pSection)
 {
     // Area
-    mpArea = pSection->mpArea;
+    setReference(kArea, mArea, resolveDataObject(pSection->mArea));
     // Inertia moments
-    mpInertiaMomentTorsional = pSection->mpInertiaMomentTorsional;
-    mpInertiaMomentX = pSection->mpInertiaMomentX;
-    mpInertiaMomentY = pSection->mpInertiaMomentY;
+    setReference(kInertiaMomentTorsional, mInertiaMomentTorsional, resolveDataObject(pSection->mInertiaMomentTorsional));
+    setReference(kInertiaMomentX, mInertiaMomentX, resolveDataObject(pSection->mInertiaMomentX));
+    setReference(kInertiaMomentY, mInertiaMomentY, resolveDataObject(pSection->mInertiaMomentY));
     // Center coordinates
-    mpCenterCoordinateX = pSection->mpCenterCoordinateX;
-    mpCenterCoordinateY = pSection->mpCenterCoordinateY;
+    setReference(kCenterCoordinateX, mCenterCoordinateX, resolveDataObject(pSection->mCenterCoordinateX));
+    setReference(kCenterCoordinateY, mCenterCoordinateY, resolveDataObject(pSection->mCenterCoordinateY));
 }
 
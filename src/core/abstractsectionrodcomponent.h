@@ -8,14 +8,12 @@
 #ifndef ABSTRACTSECTIONRODCOMPONENT_H
 #define ABSTRACTSECTIONRODCOMPONENT_H
 
-#include <QPointer>
 #include "abstractrodcomponent.h"
+#include "scalardataobject.h"
 
 namespace QRS::Core
 {
 
-class ScalarDataObject;
-
 //! General cross section of a rod
 class AbstractSectionRodComponent : public AbstractRodComponent
 {
@@ -36,18 +34,28 @@ protected:
     void copyIntegratedProperties(AbstractSectionRodComponent const* pSection);
 
 protected:
+    //! Fields which refer to data objects
+    enum ReferenceField
+    {
+        kArea,
+        kInertiaMomentTorsional,
+        kInertiaMomentX,
+        kInertiaMomentY,
+        kCenterCoordinateX,
+        kCenterCoordinateY
+    };
     // Info
     SectionType const mkSectionType;
-    static quint32 smNumInstances;
+    static std::atomic<quint32> smNumInstances;
     // Area
-    QPointer<ScalarDataObject const> mpArea;
+    DataHandle mArea;
     // Inertia moments
-    QPointer<ScalarDataObject const> mpInertiaMomentTorsional;
-    QPointer<ScalarDataObject const> mpInertiaMomentX;
-    QPointer<ScalarDataObject const> mpInertiaMomentY;
+    DataHandle mInertiaMomentTorsional;
+    DataHandle mInertiaMomentX;
+    DataHandle mInertiaMomentY;
     // Center coordinates
-    QPointer<ScalarDataObject const> mpCenterCoordinateX;
-    QPointer<ScalarDataObject const> mpCenterCoordinateY;
+    DataHandle mCenterCoordinateX;
+    DataHandle mCenterCoordinateY;
 };
 
 }
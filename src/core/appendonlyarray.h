@@ -0,0 +1,59 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the AppendOnlyArray class
+ */
+
+#ifndef APPENDONLYARRAY_H
+#define APPENDONLYARRAY_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Array which is appended under an external lock, whereas its elements are accessed without it
+ *
+ * Elements are stored in chunks which are never moved, and the table of chunks is allocated at once,
+ * so that accessing an element does not race with appending the others
+ */
+template<typename T, quint32 kChunkSize = 1024, quint32 kMaxChunks = 16384>
+class AppendOnlyArray
+{
+public:
+    AppendOnlyArray() = default;
+    AppendOnlyArray(AppendOnlyArray const&) = delete;
+    AppendOnlyArray& operator=(AppendOnlyArray const&) = delete;
+    ~AppendOnlyArray()
+    {
+        for (std::atomic<T*>& chunk : mChunks)
+            delete[] chunk.load(std::memory_order_relaxed);
+    }
+    quint32 size() const { return mSize.load(std::memory_order_acquire); }
+    T& operator[](quint32 index) { return mChunks[index / kChunkSize].load(std::memory_order_acquire)[index % kChunkSize]; }
+    T const& operator[](quint32 index) const { return mChunks[index / kChunkSize].load(std::memory_order_acquire)[index % kChunkSize]; }
+    //! Append a default constructed element. Only one thread can append at a time
+    T& emplaceBack()
+    {
+        quint32 index = mSize.load(std::memory_order_relaxed);
+        Q_ASSERT(index / kChunkSize < kMaxChunks);
+        std::atomic<T*>& chunk = mChunks[index / kChunkSize];
+        if (!chunk.load(std::memory_order_relaxed))
+            chunk.store(new T[kChunkSize], std::memory_order_release);
+        mSize.store(index + 1, std::memory_order_release);
+        return (*this)[index];
+    }
+
+private:
+    //! Pointers to chunks which are null until the chunks are needed
+    std::array<std::atomic<T*>, kMaxChunks> mChunks;
+    std::atomic<quint32> mSize = 0;
+};
+
+}
+
+#endif // APPENDONLYARRAY_H
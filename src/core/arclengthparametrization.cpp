@@ -0,0 +1,373 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the ArcLengthParametrization class
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "arclengthparametrization.h"
+
+using namespace QRS::Core;
+
+//! Nodes and weights of the five-point Gauss-Legendre quadrature over [-1, 1]
+double const skGaussNodes[] = {0.0, -0.5384693101056831, 0.5384693101056831, -0.9061798459386640, 0.9061798459386640};
+double const skGaussWeights[] = {0.5688888888888889, 0.4786286704993665, 0.4786286704993665, 0.2369268850561891, 0.2369268850561891};
+//! Relative accuracy of integrals and inverse mappings
+double const skTolerance = 1e-12;
+//! Maximum number of bisections of a segment while integrating
+int const skMaxDepth = 30;
+//! Maximum number of iterations to invert the arc length
+int const skMaxNumIterations = 100;
+//! Number of points which tangents are estimated by
+quint32 const skNumWindowKeys = 5;
+
+using Vector = std::array<double, 3>;
+
+//! Compute the cross product of two vectors
+static Vector cross(Vector const& first, Vector const& second)
+{
+    return {first[1] * second[2] - first[2] * second[1],
+            first[2] * second[0] - first[0] * second[2],
+            first[0] * second[1] - first[1] * second[0]};
+}
+
+//! Compute the dot product of two vectors
+static double dot(Vector const& first, Vector const& second)
+{
+    return first[0] * second[0] + first[1] * second[1] + first[2] * second[2];
+}
+
+/*!
+ * \brief Build the table for the given radius vector unless it has been built already
+ * \return Whether the radius vector contains points
+ */
+bool ArcLengthParametrization::update(VectorDataObject const* pRadiusVector)
+{
+    mIsCached = false;
+    if (!pRadiusVector || pRadiusVector->getItems().empty())
+    {
+        clear();
+        return false;
+    }
+    if (!mKeys.empty() && pRadiusVector->id() == mID && pRadiusVector->version() == mVersion)
+    {
+        mIsCached = true;
+        return true;
+    }
+    DataHolder const& items = pRadiusVector->getItems();
+    quint32 numKeys = items.size();
+    std::vector<Vector> points;
+    mKeys.clear();
+    points.reserve(numKeys);
+    mKeys.reserve(numKeys);
+    for (auto const& [key, array] : items)
+    {
+        mKeys.push_back(key);
+        points.push_back({array[0][0], array[0][1], array[0][2]});
+    }
+    mSegments.clear();
+    mArcLengths.assign(1, 0.0);
+    // A single point is represented by a segment of the zero speed
+    if (numKeys == 1)
+    {
+        mSegments.push_back({points[0], {}, {}, {}, mKeys[0], 1.0});
+    }
+    else
+    {
+        // Tangents are given by derivatives of the polynomials through the neighbouring points
+        std::vector<Vector> tangents(numKeys);
+        quint32 numWindowKeys = std::min(numKeys, skNumWindowKeys);
+        for (quint32 i = 0; i != numKeys; ++i)
+        {
+            quint32 iStart = std::clamp((int)i - (int)numWindowKeys / 2, 0, (int)(numKeys - numWindowKeys));
+            tangents[i] = {0.0, 0.0, 0.0};
+            for (quint32 j = iStart; j != iStart + numWindowKeys; ++j)
+            {
+                double weight = computeDerivativeWeight(iStart, numWindowKeys, i, j);
+                for (int k = 0; k != 3; ++k)
+                    tangents[i][k] += weight * points[j][k];
+            }
+        }
+        mSegments.resize(numKeys - 1);
+        mArcLengths.resize(numKeys);
+        for (quint32 i = 0; i + 1 != numKeys; ++i)
+        {
+            Segment& segment = mSegments[i];
+            double step = mKeys[i + 1] - mKeys[i];
+            segment.startKey = mKeys[i];
+            segment.step = step;
+            for (int k = 0; k != 3; ++k)
+            {
+                double difference = points[i + 1][k] - points[i][k];
+                double startTangent = step * tangents[i][k];
+                double endTangent = step * tangents[i + 1][k];
+                segment.a[k] = points[i][k];
+                segment.b[k] = startTangent;
+                segment.c[k] = 3.0 * difference - 2.0 * startTangent - endTangent;
+                segment.d[k] = -2.0 * difference + startTangent + endTangent;
+            }
+            mArcLengths[i + 1] = mArcLengths[i] + integrateSpeed(i, mKeys[i], mKeys[i + 1]);
+        }
+    }
+    mID = pRadiusVector->id();
+    mVersion = pRadiusVector->version();
+    return true;
+}
+
+//! Remove the table
+void ArcLengthParametrization::clear()
+{
+    mKeys.clear();
+    mArcLengths.clear();
+    mSegments.clear();
+    mID = 0;
+    mVersion = 0;
+    mIsCached = false;
+}
+
+//! Compute arc lengths measured from the first point of the curve
+void ArcLengthParametrization::computeArcLengths(std::vector<double> const& parameters, std::vector<double>& arcLengths) const
+{
+    quint32 numParameters = parameters.size();
+    arcLengths.resize(numParameters);
+    if (isEmpty())
+    {
+        std::fill(arcLengths.begin(), arcLengths.end(), 0.0);
+        return;
+    }
+    quint32 iPreviousSegment = mSegments.size();
+    double previousParameter = 0.0;
+    for (quint32 i = 0; i != numParameters; ++i)
+    {
+        double parameter = std::clamp(parameters[i], mKeys.front(), mKeys.back());
+        quint32 iSegment = findSegment(parameter);
+        // Increasing parameters are integrated from the previous one
+        if (iSegment == iPreviousSegment && parameter >= previousParameter)
+            arcLengths[i] = arcLengths[i - 1] + integrateSpeed(iSegment, previousParameter, parameter);
+        else
+            arcLengths[i] = mArcLengths[iSegment] + integrateSpeed(iSegment, mKeys[iSegment], parameter);
+        iPreviousSegment = iSegment;
+        previousParameter = parameter;
+    }
+}
+
+//! Compute parameters of the radius vector which correspond to the given arc lengths
+void ArcLengthParametrization::computeParameters(std::vector<double> const& arcLengths, std::vector<double>& parameters) const
+{
+    quint32 numArcLengths = arcLengths.size();
+    parameters.resize(numArcLengths);
+    if (isEmpty() || length() <= 0.0)
+    {
+        std::fill(parameters.begin(), parameters.end(), isEmpty() ? 0.0 : mKeys.front());
+        return;
+    }
+    quint32 numSegments = mSegments.size();
+    for (quint32 i = 0; i != numArcLengths; ++i)
+    {
+        double arcLength = std::clamp(arcLengths[i], 0.0, length());
+        quint32 iUpper = std::upper_bound(mArcLengths.begin(), mArcLengths.end(), arcLength) - mArcLengths.begin();
+        quint32 iSegment = std::min(iUpper == 0 ? 0 : iUpper - 1, numSegments - 1);
+        parameters[i] = findParameter(iSegment, arcLength);
+    }
+}
+
+//! Evaluate points of the curve
+void ArcLengthParametrization::computePositions(std::vector<double> const& parameters, std::array<std::vector<double>, 3>& positions) const
+{
+    quint32 numParameters = parameters.size();
+    for (auto& values : positions)
+        values.resize(numParameters);
+    if (isEmpty())
+    {
+        for (auto& values : positions)
+            std::fill(values.begin(), values.end(), 0.0);
+        return;
+    }
+    for (quint32 i = 0; i != numParameters; ++i)
+    {
+        double parameter = std::clamp(parameters[i], mKeys.front(), mKeys.back());
+        Segment const& segment = mSegments[findSegment(parameter)];
+        double u = (parameter - segment.startKey) / segment.step;
+        for (int k = 0; k != 3; ++k)
+            positions[k][i] = segment.a[k] + u * (segment.b[k] + u * (segment.c[k] + u * segment.d[k]));
+    }
+}
+
+//! Evaluate the first and second derivatives of the curve with respect to the parameter
+void ArcLengthParametrization::computeDerivatives(std::vector<double> const& parameters,
+                                                  std::array<std::vector<double>, 3>& firstDerivatives,
+                                                  std::array<std::vector<double>, 3>& secondDerivatives) const
+{
+    quint32 numParameters = parameters.size();
+    for (int k = 0; k != 3; ++k)
+    {
+        firstDerivatives[k].assign(numParameters, 0.0);
+        secondDerivatives[k].assign(numParameters, 0.0);
+    }
+    if (isEmpty())
+        return;
+    for (quint32 i = 0; i != numParameters; ++i)
+    {
+        double parameter = std::clamp(parameters[i], mKeys.front(), mKeys.back());
+        Segment const& segment = mSegments[findSegment(parameter)];
+        double h = segment.step;
+        double u = (parameter - segment.startKey) / h;
+        for (int k = 0; k != 3; ++k)
+        {
+            firstDerivatives[k][i] = (segment.b[k] + u * (2.0 * segment.c[k] + 3.0 * u * segment.d[k])) / h;
+            secondDerivatives[k][i] = (2.0 * segment.c[k] + 6.0 * u * segment.d[k]) / (h * h);
+        }
+    }
+}
+
+/*!
+ * \brief Evaluate curvature and torsion of the curve
+ *
+ * Both are set to zero where the curve is straight, since the binormal vector is undefined there.
+ */
+void ArcLengthParametrization::computeCurvatures(std::vector<double> const& parameters, std::vector<double>& curvatures,
+                                                 std::vector<double>& torsions) const
+{
+    quint32 numParameters = parameters.size();
+    curvatures.assign(numParameters, 0.0);
+    torsions.assign(numParameters, 0.0);
+    if (isEmpty())
+        return;
+    for (quint32 i = 0; i != numParameters; ++i)
+    {
+        double parameter = std::clamp(parameters[i], mKeys.front(), mKeys.back());
+        Segment const& segment = mSegments[findSegment(parameter)];
+        double h = segment.step;
+        double u = (parameter - segment.startKey) / h;
+        Vector first, second, third;
+        for (int k = 0; k != 3; ++k)
+        {
+            first[k] = (segment.b[k] + u * (2.0 * segment.c[k] + 3.0 * u * segment.d[k])) / h;
+            second[k] = (2.0 * segment.c[k] + 6.0 * u * segment.d[k]) / (h * h);
+            third[k] = 6.0 * segment.d[k] / (h * h * h);
+        }
+        double speed = std::sqrt(dot(first, first));
+        Vector binormal = cross(first, second);
+        double binormalNorm = std::sqrt(dot(binormal, binormal));
+        if (binormalNorm <= skTolerance * speed * speed)
+            continue;
+        curvatures[i] = binormalNorm / (speed * speed * speed);
+        torsions[i] = dot(binormal, third) / (binormalNorm * binormalNorm);
+    }
+}
+
+//! Find the segment which contains the parameter
+quint32 ArcLengthParametrization::findSegment(double parameter) const
+{
+    quint32 iUpper = std::upper_bound(mKeys.begin(), mKeys.end(), parameter) - mKeys.begin();
+    return std::min(iUpper == 0 ? 0 : iUpper - 1, (quint32)mSegments.size() - 1);
+}
+
+/*!
+ * \brief Compute the weight of a point in the derivative of the Lagrange polynomial
+ * \param iStart Index of the first key which the polynomial passes through
+ * \param numWindowKeys Number of keys which the polynomial passes through
+ * \param iKey Index of the key which the derivative is evaluated at
+ * \param iPoint Index of the point whose weight is computed
+ */
+double ArcLengthParametrization::computeDerivativeWeight(quint32 iStart, quint32 numWindowKeys, quint32 iKey, quint32 iPoint) const
+{
+    quint32 iEnd = iStart + numWindowKeys;
+    double result = 0.0;
+    if (iPoint == iKey)
+    {
+        for (quint32 m = iStart; m != iEnd; ++m)
+        {
+            if (m != iKey)
+                result += 1.0 / (mKeys[iKey] - mKeys[m]);
+        }
+        return result;
+    }
+    result = 1.0;
+    for (quint32 m = iStart; m != iEnd; ++m)
+    {
+        if (m != iPoint)
+            result /= mKeys[iPoint] - mKeys[m];
+        if (m != iPoint && m != iKey)
+            result *= mKeys[iKey] - mKeys[m];
+    }
+    return result;
+}
+
+//! Compute the norm of the derivative of the radius vector with respect to the parameter
+double ArcLengthParametrization::computeSpeed(quint32 iSegment, double parameter) const
+{
+    Segment const& segment = mSegments[iSegment];
+    double u = (parameter - segment.startKey) / segment.step;
+    Vector derivative;
+    for (int k = 0; k != 3; ++k)
+        derivative[k] = (segment.b[k] + u * (2.0 * segment.c[k] + 3.0 * u * segment.d[k])) / segment.step;
+    return std::sqrt(dot(derivative, derivative));
+}
+
+//! Integrate the speed over a part of a segment
+double ArcLengthParametrization::integrateSpeed(quint32 iSegment, double startParameter, double endParameter) const
+{
+    if (startParameter == endParameter)
+        return 0.0;
+    double estimate = estimateSpeedIntegral(iSegment, startParameter, endParameter);
+    return integrateSpeed(iSegment, startParameter, endParameter, estimate, 0);
+}
+
+//! Bisect the interval until the estimates of the halves are consistent with the estimate of the whole
+double ArcLengthParametrization::integrateSpeed(quint32 iSegment, double startParameter, double endParameter,
+                                                double estimate, int depth) const
+{
+    double middleParameter = 0.5 * (startParameter + endParameter);
+    double leftEstimate = estimateSpeedIntegral(iSegment, startParameter, middleParameter);
+    double rightEstimate = estimateSpeedIntegral(iSegment, middleParameter, endParameter);
+    double refinedEstimate = leftEstimate + rightEstimate;
+    if (depth == skMaxDepth || std::abs(refinedEstimate - estimate) <= skTolerance * std::abs(refinedEstimate))
+        return refinedEstimate;
+    return integrateSpeed(iSegment, startParameter, middleParameter, leftEstimate, depth + 1)
+           + integrateSpeed(iSegment, middleParameter, endParameter, rightEstimate, depth + 1);
+}
+
+//! Apply the Gauss-Legendre quadrature to the speed over the interval
+double ArcLengthParametrization::estimateSpeedIntegral(quint32 iSegment, double startParameter, double endParameter) const
+{
+    double halfLength = 0.5 * (endParameter - startParameter);
+    double middleParameter = 0.5 * (startParameter + endParameter);
+    double result = 0.0;
+    for (int i = 0; i != 5; ++i)
+        result += skGaussWeights[i] * computeSpeed(iSegment, middleParameter + halfLength * skGaussNodes[i]);
+    return result * halfLength;
+}
+
+//! Solve for the parameter of the given arc length by Newton's method safeguarded by bisection
+double ArcLengthParametrization::findParameter(quint32 iSegment, double arcLength) const
+{
+    double startKey = mKeys[iSegment];
+    double endKey = mKeys[iSegment + 1];
+    double startArcLength = mArcLengths[iSegment];
+    double endArcLength = mArcLengths[iSegment + 1];
+    if (endArcLength <= startArcLength)
+        return startKey;
+    double lower = startKey;
+    double upper = endKey;
+    double parameter = startKey + (arcLength - startArcLength) / (endArcLength - startArcLength) * (endKey - startKey);
+    double tolerance = skTolerance * std::max(1.0, length());
+    for (int i = 0; i != skMaxNumIterations; ++i)
+    {
+        double residual = startArcLength + integrateSpeed(iSegment, startKey, parameter) - arcLength;
+        if (std::abs(residual) <= tolerance)
+            break;
+        if (residual > 0.0)
+            upper = parameter;
+        else
+            lower = parameter;
+        double speed = computeSpeed(iSegment, parameter);
+        double nextParameter = speed > 0.0 ? parameter - residual / speed : lower;
+        if (nextParameter <= lower || nextParameter >= upper)
+            nextParameter = 0.5 * (lower + upper);
+        parameter = nextParameter;
+    }
+    return parameter;
+}
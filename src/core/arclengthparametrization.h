@@ -0,0 +1,74 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the ArcLengthParametrization class
+ */
+
+#ifndef ARCLENGTHPARAMETRIZATION_H
+#define ARCLENGTHPARAMETRIZATION_H
+
+#include <array>
+#include <vector>
+#include "vectordataobject.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Table which relates parameters of a radius vector with the arc length of the curve
+ *
+ * Points of the radius vector are joined by a cubic Hermite spline. Its tangents are the derivatives of the polynomials
+ * which pass through five neighbouring points, so that the third derivative and, hence, the torsion are accurate.
+ * The arc length of each segment is integrated by the adaptive Gauss-Legendre quadrature. Curvature and torsion are
+ * evaluated analytically. The table is rebuilt only when the identifier or version of the radius vector changes,
+ * so that stations can be placed again and again at no cost. All the batched mappings expect increasing arguments
+ * for the best performance, but accept any order. Arguments outside of the curve are clamped.
+ */
+class ArcLengthParametrization
+{
+public:
+    bool update(VectorDataObject const* pRadiusVector);
+    void clear();
+    bool isEmpty() const { return mKeys.empty(); }
+    //! Check whether the last update reused the table built before
+    bool isCached() const { return mIsCached; }
+    double length() const { return mArcLengths.empty() ? 0.0 : mArcLengths.back(); }
+    std::vector<double> const& keys() const { return mKeys; }
+    std::vector<double> const& arcLengths() const { return mArcLengths; }
+    void computeArcLengths(std::vector<double> const& parameters, std::vector<double>& arcLengths) const;
+    void computeParameters(std::vector<double> const& arcLengths, std::vector<double>& parameters) const;
+    void computePositions(std::vector<double> const& parameters, std::array<std::vector<double>, 3>& positions) const;
+    void computeDerivatives(std::vector<double> const& parameters, std::array<std::vector<double>, 3>& firstDerivatives,
+                            std::array<std::vector<double>, 3>& secondDerivatives) const;
+    void computeCurvatures(std::vector<double> const& parameters, std::vector<double>& curvatures,
+                           std::vector<double>& torsions) const;
+
+private:
+    using Vector = std::array<double, 3>;
+    //! Polynomial a + b u + c u^2 + d u^3 of the local coordinate u which spans [0, 1] over a segment
+    struct Segment
+    {
+        Vector a, b, c, d;
+        double startKey, step;
+    };
+    double computeDerivativeWeight(quint32 iStart, quint32 numWindowKeys, quint32 iKey, quint32 iPoint) const;
+    quint32 findSegment(double parameter) const;
+    double computeSpeed(quint32 iSegment, double parameter) const;
+    double integrateSpeed(quint32 iSegment, double startParameter, double endParameter) const;
+    double integrateSpeed(quint32 iSegment, double startParameter, double endParameter, double estimate, int depth) const;
+    double estimateSpeedIntegral(quint32 iSegment, double startParameter, double endParameter) const;
+    double findParameter(quint32 iSegment, double arcLength) const;
+
+private:
+    std::vector<double> mKeys;
+    std::vector<double> mArcLengths;
+    std::vector<Segment> mSegments;
+    DataIDType mID = 0;
+    quint64 mVersion = 0;
+    bool mIsCached = false;
+};
+
+}
+
+#endif // ARCLENGTHPARAMETRIZATION_H
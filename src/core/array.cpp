@@ -5,6 +5,7 @@
  * \brief Implementation of the Array class
  */
 
+#include <algorithm>
 #include "array.h"
 
 template class QRS::Core::Array<double>;
@@ -138,5 +139,21 @@ void Array<T>::swapColumns(IndexType iFirstColumn, IndexType iSecondColumn)
     if (iFirstColumn >= mNumCols || iSecondColumn >= mNumCols)
         return;
     for (IndexType iRow = 0; iRow != mNumRows; ++iRow)
-        std::swap(mpData[iRow + iFirstColumn], mpData[iRow + iSecondColumn]);
+        std::swap(mpData[iRow * mNumCols + iFirstColumn], mpData[iRow * mNumCols + iSecondColumn]);
+}
+
+//! Move a column to a new position shifting the ones in between
+template<typename T>
+void Array<T>::moveColumn(IndexType iFromColumn, IndexType iToColumn)
+{
+    if (iFromColumn >= mNumCols || iToColumn >= mNumCols || iFromColumn == iToColumn)
+        return;
+    for (IndexType iRow = 0; iRow != mNumRows; ++iRow)
+    {
+        T* pRow = &mpData[iRow * mNumCols];
+        if (iFromColumn < iToColumn)
+            std::rotate(pRow + iFromColumn, pRow + iFromColumn + 1, pRow + iToColumn + 1);
+        else
+            std::rotate(pRow + iToColumn, pRow + iFromColumn, pRow + iFromColumn + 1);
+    }
 }
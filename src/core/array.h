@@ -28,9 +28,11 @@ public:
     Array(Array<T>&& another);
     ~Array();
     T* data() { return mpData; }
+    T const* data() const { return mpData; }
     void resize(IndexType numRows, IndexType numCols);
     void removeColumn(IndexType iRemoveColumn);
     void swapColumns(IndexType iFirstColumn, IndexType iSecondColumn);
+    void moveColumn(IndexType iFromColumn, IndexType iToColumn);
     IndexType rows() const { return mNumRows; };
     IndexType cols() const { return mNumCols; };
     IndexType size() const { return mNumRows * mNumCols; }
@@ -0,0 +1,137 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the BlockTridiagonalMatrix class
+ */
+
+#include "blocktridiagonalmatrix.h"
+
+using namespace QRS::Core;
+
+//! Set the number of blocks along the diagonal
+void BlockTridiagonalMatrix::resize(quint32 numBlocks)
+{
+    mDiagonal.resize(numBlocks);
+    mUpper.resize(numBlocks > 0 ? numBlocks - 1 : 0);
+    mLower.resize(mUpper.size());
+    mPivots.resize(numBlocks);
+    mIsFactorized = false;
+}
+
+//! Zero all the blocks
+void BlockTridiagonalMatrix::setZero()
+{
+    std::fill(mDiagonal.begin(), mDiagonal.end(), Matrix66::zeros());
+    std::fill(mUpper.begin(), mUpper.end(), Matrix66::zeros());
+    std::fill(mLower.begin(), mLower.end(), Matrix66::zeros());
+    mIsFactorized = false;
+}
+
+//! Multiply the matrix by a vector. The matrix must not be factorized
+void BlockTridiagonalMatrix::multiply(std::vector<Vector6> const& values, std::vector<Vector6>& result) const
+{
+    quint32 numBlocks = mDiagonal.size();
+    result.resize(numBlocks);
+    for (quint32 i = 0; i != numBlocks; ++i)
+    {
+        result[i] = mDiagonal[i] * values[i];
+        if (i + 1 < numBlocks)
+            result[i] += mUpper[i] * values[i + 1];
+        if (i > 0)
+            result[i] += mLower[i - 1] * values[i - 1];
+    }
+}
+
+/*!
+ * \brief Fix a degree of freedom of a station
+ *
+ * The row and column of the degree of freedom are zeroed except for the unit diagonal element, so that the solution
+ * is zero there provided that the right-hand side is zero as well.
+ */
+void BlockTridiagonalMatrix::constrain(quint32 iBlock, int iDof)
+{
+    quint32 numBlocks = mDiagonal.size();
+    Matrix66& diagonal = mDiagonal[iBlock];
+    for (int k = 0; k != 6; ++k)
+    {
+        diagonal(iDof, k) = 0.0;
+        diagonal(k, iDof) = 0.0;
+        if (iBlock + 1 < numBlocks)
+        {
+            mUpper[iBlock](iDof, k) = 0.0;
+            mLower[iBlock](k, iDof) = 0.0;
+        }
+        if (iBlock > 0)
+        {
+            mLower[iBlock - 1](iDof, k) = 0.0;
+            mUpper[iBlock - 1](k, iDof) = 0.0;
+        }
+    }
+    diagonal(iDof, iDof) = 1.0;
+}
+
+/*!
+ * \brief Express the degrees of freedom of a station in another basis
+ *
+ * The original unknowns are the product of the transformation by the new ones. The rows of the station are
+ * multiplied by the transposed transformation, so that the right-hand side of the station should be transformed
+ * in the same way.
+ */
+void BlockTridiagonalMatrix::transform(quint32 iBlock, Matrix66 const& transformation)
+{
+    quint32 numBlocks = mDiagonal.size();
+    Matrix66& diagonal = mDiagonal[iBlock];
+    diagonal = transposeProduct(transformation, diagonal * transformation);
+    if (iBlock + 1 < numBlocks)
+    {
+        mUpper[iBlock] = transposeProduct(transformation, mUpper[iBlock]);
+        mLower[iBlock] = mLower[iBlock] * transformation;
+    }
+    if (iBlock > 0)
+    {
+        mLower[iBlock - 1] = transposeProduct(transformation, mLower[iBlock - 1]);
+        mUpper[iBlock - 1] = mUpper[iBlock - 1] * transformation;
+    }
+}
+
+/*!
+ * \brief Factorize the matrix in place by the block Thomas algorithm
+ *
+ * Each diagonal block is substituted by the LU factors of its Schur complement, and each upper block is substituted
+ * by the product of the inverse complement and the block.
+ * \return Whether all the complements are nonsingular
+ */
+bool BlockTridiagonalMatrix::factorize()
+{
+    quint32 numBlocks = mDiagonal.size();
+    for (quint32 i = 0; i != numBlocks; ++i)
+    {
+        if (i > 0)
+            mDiagonal[i] -= mLower[i - 1] * mUpper[i - 1];
+        if (!factorizeLU(mDiagonal[i], mPivots[i]))
+            return false;
+        if (i + 1 < numBlocks)
+            solveLU(mDiagonal[i], mPivots[i], mUpper[i]);
+    }
+    mIsFactorized = true;
+    return true;
+}
+
+//! Solve the system by the factorized matrix in place
+void BlockTridiagonalMatrix::solve(std::vector<Vector6>& values) const
+{
+    quint32 numBlocks = mDiagonal.size();
+    if (numBlocks == 0)
+        return;
+    // Forward substitution
+    for (quint32 i = 0; i != numBlocks; ++i)
+    {
+        if (i > 0)
+            values[i] -= mLower[i - 1] * values[i - 1];
+        solveLU(mDiagonal[i], mPivots[i], values[i]);
+    }
+    // Backward substitution
+    for (quint32 i = numBlocks - 1; i-- > 0;)
+        values[i] -= mUpper[i] * values[i + 1];
+}
@@ -0,0 +1,56 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the BlockTridiagonalMatrix class
+ */
+
+#ifndef BLOCKTRIDIAGONALMATRIX_H
+#define BLOCKTRIDIAGONALMATRIX_H
+
+#include "smallmatrix.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Matrix which consists of 6x6 blocks on the main diagonal and next to it
+ *
+ * This is the structure of the tangent matrices of rods, where each block relates the degrees of freedom of two
+ * stations connected by an element. The matrix is factorized in place by the block Thomas algorithm, that is, the LU
+ * decomposition by blocks without fill-in, so both the factorization and solution take linear time and memory.
+ * Diagonal blocks are pivoted internally.
+ */
+class BlockTridiagonalMatrix
+{
+public:
+    void resize(quint32 numBlocks);
+    void setZero();
+    quint32 numBlocks() const { return mDiagonal.size(); }
+    //! Block which relates the station with itself
+    Matrix66& diagonal(quint32 iBlock) { return mDiagonal[iBlock]; }
+    Matrix66 const& diagonal(quint32 iBlock) const { return mDiagonal[iBlock]; }
+    //! Block of the row of the given station and the column of the next one
+    Matrix66& upper(quint32 iBlock) { return mUpper[iBlock]; }
+    Matrix66 const& upper(quint32 iBlock) const { return mUpper[iBlock]; }
+    //! Block of the row of the next station and the column of the given one
+    Matrix66& lower(quint32 iBlock) { return mLower[iBlock]; }
+    Matrix66 const& lower(quint32 iBlock) const { return mLower[iBlock]; }
+    void multiply(std::vector<Vector6> const& values, std::vector<Vector6>& result) const;
+    void constrain(quint32 iBlock, int iDof);
+    void transform(quint32 iBlock, Matrix66 const& transformation);
+    bool factorize();
+    bool isFactorized() const { return mIsFactorized; }
+    void solve(std::vector<Vector6>& values) const;
+
+private:
+    std::vector<Matrix66> mDiagonal;
+    std::vector<Matrix66> mUpper;
+    std::vector<Matrix66> mLower;
+    std::vector<std::array<int, 6>> mPivots;
+    bool mIsFactorized = false;
+};
+
+}
+
+#endif // BLOCKTRIDIAGONALMATRIX_H
@@ -9,7 +9,7 @@
 
 using namespace QRS::Core;
 
-quint32 ConstraintRodComponent::smNumInstances = 0;
+std::atomic<quint32> ConstraintRodComponent::smNumInstances = 0;
 
 ConstraintRodComponent::ConstraintRodComponent(QString const& name)
     : AbstractRodComponent(kConstraint, name)
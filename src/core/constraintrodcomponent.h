@@ -42,7 +42,7 @@ public:
     Constraints const& constraints() const { return mConstraints; }
 
 private:
-    static quint32 smNumInstances;
+    static std::atomic<quint32> smNumInstances;
     Constraints mConstraints;
 };
 
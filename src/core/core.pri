@@ -3,21 +3,46 @@ INCLUDEPATH += $$PWD
 HEADERS += \
     $$PWD/abstractrodcomponent.h \
     $$PWD/abstractsectionrodcomponent.h \
+    $$PWD/arclengthparametrization.h \
     $$PWD/aliasdata.h \
     $$PWD/aliasdataset.h \
+    $$PWD/appendonlyarray.h \
     $$PWD/array.h \
+    $$PWD/blocktridiagonalmatrix.h \
     $$PWD/constraintrodcomponent.h \
+    $$PWD/datachangeset.h \
+    $$PWD/datahandletable.h \
+    $$PWD/dataobjectdelta.h \
+    $$PWD/dependencyindex.h \
+    $$PWD/deriveddataobject.h \
+    $$PWD/edithistory.h \
+    $$PWD/expression.h \
     $$PWD/geometryrodcomponent.h \
     $$PWD/loadrodcomponent.h \
     $$PWD/materialrodcomponent.h \
+    $$PWD/nameindex.h \
+    $$PWD/namepool.h \
     $$PWD/mechanicalrodcomponent.h \
+    $$PWD/movingframes.h \
     $$PWD/project.h \
+    $$PWD/rodassembly.h \
+    $$PWD/rodcontinuationsolver.h \
+    $$PWD/roddynamicsolver.h \
+    $$PWD/rodexplicitsolver.h \
+    $$PWD/rodmodalsolver.h \
+    $$PWD/rodmodel.h \
+    $$PWD/rodsampler.h \
+    $$PWD/rodstaticsolver.h \
+    $$PWD/rotations.h \
     $$PWD/abstractdataobject.h \
     $$PWD/scalardataobject.h \
+    $$PWD/smallmatrix.h \
+    $$PWD/tasks.h \
     $$PWD/usersectionrodcomponent.h \
     $$PWD/vectordataobject.h \
     $$PWD/matrixdataobject.h \
     $$PWD/surfacedataobject.h \
+    $$PWD/hierarchydelta.h \
     $$PWD/hierarchynode.h \
     $$PWD/hierarchytree.h \
     $$PWD/utilities.h
@@ -25,20 +50,40 @@ HEADERS += \
 SOURCES += \
     $$PWD/abstractrodcomponent.cpp \
     $$PWD/abstractsectionrodcomponent.cpp \
+    $$PWD/arclengthparametrization.cpp \
     $$PWD/array.cpp \
+    $$PWD/blocktridiagonalmatrix.cpp \
     $$PWD/constraintrodcomponent.cpp \
+    $$PWD/datahandletable.cpp \
+    $$PWD/dataobjectdelta.cpp \
+    $$PWD/dependencyindex.cpp \
+    $$PWD/deriveddataobject.cpp \
+    $$PWD/edithistory.cpp \
+    $$PWD/expression.cpp \
     $$PWD/geometryrodcomponent.cpp \
     $$PWD/loadrodcomponent.cpp \
     $$PWD/materialrodcomponent.cpp \
     $$PWD/mechanicalrodcomponent.cpp \
+    $$PWD/movingframes.cpp \
+    $$PWD/nameindex.cpp \
+    $$PWD/namepool.cpp \
     $$PWD/project-base.cpp \
     $$PWD/project-io.cpp \
+    $$PWD/rodassembly.cpp \
+    $$PWD/rodcontinuationsolver.cpp \
+    $$PWD/roddynamicsolver.cpp \
+    $$PWD/rodexplicitsolver.cpp \
+    $$PWD/rodmodalsolver.cpp \
+    $$PWD/rodmodel.cpp \
+    $$PWD/rodsampler.cpp \
+    $$PWD/rodstaticsolver.cpp \
     $$PWD/abstractdataobject.cpp \
     $$PWD/scalardataobject.cpp \
     $$PWD/usersectionrodcomponent.cpp \
     $$PWD/vectordataobject.cpp \
     $$PWD/matrixdataobject.cpp \
     $$PWD/surfacedataobject.cpp \
+    $$PWD/hierarchydelta.cpp \
     $$PWD/hierarchynode.cpp \
     $$PWD/hierarchytree.cpp \
     $$PWD/utilities.cpp
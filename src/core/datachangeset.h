@@ -0,0 +1,121 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the DataChangeSet class
+ */
+
+#ifndef DATACHANGESET_H
+#define DATACHANGESET_H
+
+#include <unordered_set>
+#include "aliasdata.h"
+
+namespace QRS::Core
+{
+
+using DataIDSet = std::unordered_set<DataIDType>;
+
+//! Identifiers of entities which were created, modified, renamed or removed since the last synchronization
+class DataChangeSet
+{
+public:
+    //! Register an entity which did not exist before
+    void setCreated(DataIDType id)
+    {
+        mCreatedIDs.insert(id);
+    }
+
+    //! Register an entity whose content has been changed
+    void setModified(DataIDType id)
+    {
+        if (!mCreatedIDs.contains(id))
+            mModifiedIDs.insert(id);
+    }
+
+    //! Register an entity whose name has been changed. The ones created after the last synchronization are just created
+    void setRenamed(DataIDType id)
+    {
+        if (mCreatedIDs.contains(id))
+            return;
+        mModifiedIDs.insert(id);
+        mRenamedIDs.insert(id);
+    }
+
+    //! Register an entity which has been deleted. The ones created after the last synchronization are just forgotten
+    void setRemoved(DataIDType id)
+    {
+        if (mCreatedIDs.erase(id))
+            return;
+        mModifiedIDs.erase(id);
+        mRenamedIDs.erase(id);
+        mRemovedIDs.insert(id);
+    }
+
+    /*!
+     * \brief Register an entity which has been brought back
+     *
+     * If it was removed after the last synchronization, it is just modified. Its name could differ from the one
+     * it had before the removal, so it is considered to be renamed as well
+     */
+    void setRestored(DataIDType id)
+    {
+        if (mRemovedIDs.erase(id))
+        {
+            mModifiedIDs.insert(id);
+            mRenamedIDs.insert(id);
+        }
+        else
+        {
+            mCreatedIDs.insert(id);
+        }
+    }
+
+    //! Register a modification of a hierarchy
+    void setHierarchyChanged() { mIsHierarchyChanged = true; }
+
+    DataIDSet const& createdIDs() const { return mCreatedIDs; }
+    DataIDSet const& modifiedIDs() const { return mModifiedIDs; }
+    DataIDSet const& removedIDs() const { return mRemovedIDs; }
+    //! Modified entities whose names have been changed
+    DataIDSet const& renamedIDs() const { return mRenamedIDs; }
+    bool isHierarchyChanged() const { return mIsHierarchyChanged; }
+    //! Check if there are changes which alter the set of entities or their hierarchy
+    bool isStructureChanged() const { return mIsHierarchyChanged || !mCreatedIDs.empty() || !mRemovedIDs.empty(); }
+    bool isEmpty() const { return !isStructureChanged() && mModifiedIDs.empty(); }
+
+    //! Register the changes which followed the current ones
+    void append(DataChangeSet const& next)
+    {
+        for (DataIDType id : next.mRemovedIDs)
+            setRemoved(id);
+        for (DataIDType id : next.mCreatedIDs)
+            setRestored(id);
+        for (DataIDType id : next.mModifiedIDs)
+            setModified(id);
+        for (DataIDType id : next.mRenamedIDs)
+            setRenamed(id);
+        mIsHierarchyChanged = mIsHierarchyChanged || next.mIsHierarchyChanged;
+    }
+
+    //! Forget all the changes after synchronization
+    void clear()
+    {
+        mCreatedIDs.clear();
+        mModifiedIDs.clear();
+        mRemovedIDs.clear();
+        mRenamedIDs.clear();
+        mIsHierarchyChanged = false;
+    }
+
+private:
+    DataIDSet mCreatedIDs;
+    DataIDSet mModifiedIDs;
+    DataIDSet mRemovedIDs;
+    DataIDSet mRenamedIDs;
+    bool mIsHierarchyChanged = false;
+};
+
+}
+
+#endif // DATACHANGESET_H
@@ -0,0 +1,53 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the DataHandleTable class
+ */
+
+#include "datahandletable.h"
+
+using namespace QRS::Core;
+
+//! Retrieve the table which all the data objects are registered in
+DataHandleTable& DataHandleTable::instance()
+{
+    static DataHandleTable table;
+    return table;
+}
+
+//! Register a data object and issue a handle for it
+DataHandle DataHandleTable::acquire(AbstractDataObject* pDataObject)
+{
+    QMutexLocker locker(&mMutex);
+    quint32 index;
+    if (mFreeIndices.empty())
+    {
+        index = mSlots.size();
+        mSlots.emplaceBack();
+    }
+    else
+    {
+        index = mFreeIndices.back();
+        mFreeIndices.pop_back();
+    }
+    Slot& slot = mSlots[index];
+    slot.pDataObject.store(pDataObject, std::memory_order_release);
+    return {index, slot.generation.load(std::memory_order_relaxed)};
+}
+
+//! Unregister a data object, so that all its handles become null
+void DataHandleTable::release(DataHandle handle)
+{
+    QMutexLocker locker(&mMutex);
+    if (handle.index >= mSlots.size())
+        return;
+    Slot& slot = mSlots[handle.index];
+    if (slot.generation.load(std::memory_order_relaxed) != handle.generation)
+        return;
+    slot.pDataObject.store(nullptr, std::memory_order_release);
+    // Zero generation is skipped after overflow, since it marks null handles
+    quint32 generation = handle.generation + 1;
+    slot.generation.store(generation == 0 ? 1 : generation, std::memory_order_release);
+    mFreeIndices.push_back(handle.index);
+}
@@ -0,0 +1,75 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the DataHandleTable class
+ */
+
+#ifndef DATAHANDLETABLE_H
+#define DATAHANDLETABLE_H
+
+#include <vector>
+#include <QMutex>
+#include "aliasdata.h"
+#include "appendonlyarray.h"
+
+namespace QRS::Core
+{
+
+class AbstractDataObject;
+
+//! Weak reference to a data object which becomes null as soon as the object is destroyed
+struct DataHandle
+{
+    quint32 index = 0;
+    //! Generation of a slot which the handle was issued for. Zero is reserved for null handles
+    quint32 generation = 0;
+    bool isNull() const { return generation == 0; }
+    bool operator==(DataHandle const& another) const = default;
+};
+
+/*!
+ * \brief Table of slots to resolve handles of data objects
+ *
+ * A slot is reused after the object it refers to is destroyed, but its generation is increased,
+ * so that all the handles issued before are rejected. Data objects acquire their slots while being constructed,
+ * that is why the table is shared by all the data objects as well as their identifiers.
+ * Objects can be copied in a background thread, so acquiring and releasing slots is guarded by a mutex.
+ * Handles are resolved without locking, since slots are never moved and their fields are atomic.
+ */
+class DataHandleTable
+{
+public:
+    static DataHandleTable& instance();
+    DataHandle acquire(AbstractDataObject* pDataObject);
+    void release(DataHandle handle);
+    //! Retrieve a data object by its handle or nullptr if it has been destroyed
+    AbstractDataObject* resolve(DataHandle handle) const
+    {
+        if (handle.index >= mSlots.size())
+            return nullptr;
+        Slot const& slot = mSlots[handle.index];
+        AbstractDataObject* pDataObject = slot.pDataObject.load(std::memory_order_acquire);
+        // The generation is checked after the pointer is read, so that a pointer stored by reusing the slot is rejected
+        return slot.generation.load(std::memory_order_acquire) == handle.generation ? pDataObject : nullptr;
+    }
+
+private:
+    DataHandleTable() = default;
+    DataHandleTable(DataHandleTable const&) = delete;
+    DataHandleTable& operator=(DataHandleTable const&) = delete;
+
+private:
+    struct Slot
+    {
+        std::atomic<AbstractDataObject*> pDataObject = nullptr;
+        std::atomic<quint32> generation = 1;
+    };
+    AppendOnlyArray<Slot> mSlots;
+    std::vector<quint32> mFreeIndices;
+    mutable QMutex mMutex;
+};
+
+}
+
+#endif // DATAHANDLETABLE_H
@@ -0,0 +1,363 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the DataObjectDelta class
+ */
+
+#include <map>
+#include <tuple>
+#include "dataobjectdelta.h"
+#include "surfacedataobject.h"
+
+using namespace QRS::Core;
+
+bool isItemsEqual(DataItemType const& first, DataItemType const& second);
+size_t itemMemorySize(DataItemType const& item);
+
+DataObjectDelta::DataObjectDelta(DataIDType id)
+    : mID(id)
+{
+
+}
+
+/*!
+ * \brief Compute a difference between two states of items of the same data object
+ *
+ * It is used when an object is transformed as a whole. Items which are presented only in one of the states
+ * are either removed or inserted. If their number is the same and their values coincide, they are stored as key changes instead.
+ * Leading items of surfaces are supposed to be the same in both of the states.
+ */
+DataObjectDelta::DataObjectDelta(AbstractDataObject const& before, AbstractDataObject const& after)
+    : mID(after.id())
+{
+    using Items = std::vector<std::pair<DataKeyType, DataItemType const*>>;
+    Items removedItems;
+    Items insertedItems;
+    std::vector<Change> valueChanges;
+    auto iterBefore = before.mItems.begin();
+    auto iterAfter = after.mItems.begin();
+    while (iterBefore != before.mItems.end() || iterAfter != after.mItems.end())
+    {
+        if (iterAfter == after.mItems.end() || (iterBefore != before.mItems.end() && iterBefore->first < iterAfter->first))
+        {
+            removedItems.push_back({iterBefore->first, &iterBefore->second});
+            ++iterBefore;
+            continue;
+        }
+        if (iterBefore == before.mItems.end() || iterAfter->first < iterBefore->first)
+        {
+            insertedItems.push_back({iterAfter->first, &iterAfter->second});
+            ++iterAfter;
+            continue;
+        }
+        // Items which have been resized are substituted as a whole
+        DataKeyType key = iterBefore->first;
+        DataItemType const& itemBefore = iterBefore->second;
+        DataItemType const& itemAfter = iterAfter->second;
+        IndexType numRows = itemBefore.rows();
+        IndexType numCols = itemBefore.cols();
+        if (numRows != itemAfter.rows() || numCols != itemAfter.cols())
+        {
+            removedItems.push_back({key, &itemBefore});
+            insertedItems.push_back({key, &itemAfter});
+        }
+        else
+        {
+            for (IndexType i = 0; i != numRows; ++i)
+            {
+                for (IndexType j = 0; j != numCols; ++j)
+                {
+                    if (itemBefore[i][j] != itemAfter[i][j])
+                        valueChanges.push_back({kValue, key, key, i, j, itemBefore[i][j], itemAfter[i][j], 0});
+                }
+            }
+        }
+        ++iterBefore;
+        ++iterAfter;
+    }
+    // Items are matched in the order of their keys, since changing a key preserves it mostly
+    size_t numItems = removedItems.size();
+    bool isMatched = numItems > 0 && numItems == insertedItems.size();
+    std::vector<bool> matches(numItems, false);
+    if (isMatched)
+    {
+        for (size_t i = 0; i != numItems; ++i)
+            matches[i] = isItemsEqual(*removedItems[i].second, *insertedItems[i].second);
+    }
+    for (size_t i = 0; i != numItems; ++i)
+    {
+        if (!matches[i])
+            pushItem(kRemoveItem, removedItems[i].first, *removedItems[i].second);
+    }
+    for (size_t i = 0; i != numItems; ++i)
+    {
+        if (matches[i])
+            mChanges.push_back({kKey, removedItems[i].first, insertedItems[i].first, 0, 0, 0.0, 0.0, 0});
+    }
+    size_t numInsertedItems = insertedItems.size();
+    for (size_t i = 0; i != numInsertedItems; ++i)
+    {
+        if (!isMatched || !matches[i])
+            pushItem(kInsertItem, insertedItems[i].first, *insertedItems[i].second);
+    }
+    mChanges.insert(mChanges.end(), valueChanges.begin(), valueChanges.end());
+}
+
+//! Set an array value of an item and register the change
+bool DataObjectDelta::setArrayValue(AbstractDataObject& dataObject, DataKeyType key, DataValueType newValue,
+                                    IndexType iRow, IndexType iColumn)
+{
+    auto iter = dataObject.mItems.find(key);
+    if (iter == dataObject.mItems.end() || iRow >= iter->second.rows() || iColumn >= iter->second.cols())
+        return false;
+    DataValueType oldValue = iter->second[iRow][iColumn];
+    dataObject.setArrayValue(key, newValue, iRow, iColumn);
+    if (oldValue != newValue)
+        mChanges.push_back({kValue, key, key, iRow, iColumn, oldValue, newValue, 0});
+    return true;
+}
+
+//! Modify a key of an item and register the change
+bool DataObjectDelta::changeItemKey(AbstractDataObject& dataObject, DataKeyType oldKey, DataKeyType newKey)
+{
+    if (!dataObject.changeItemKey(oldKey, newKey))
+        return false;
+    mChanges.push_back({kKey, oldKey, newKey, 0, 0, 0.0, 0.0, 0});
+    return true;
+}
+
+//! Insert an item with the first available key and register it
+DataItemType const& DataObjectDelta::addItem(AbstractDataObject& dataObject, DataKeyType key)
+{
+    key = dataObject.getAvailableItemKey(key);
+    DataItemType const& item = dataObject.addItem(key);
+    pushItem(kInsertItem, key, item);
+    return item;
+}
+
+//! Remove an item and keep it to be restored
+void DataObjectDelta::removeItem(AbstractDataObject& dataObject, DataKeyType key)
+{
+    auto iter = dataObject.mItems.find(key);
+    if (iter == dataObject.mItems.end())
+        return;
+    pushItem(kRemoveItem, key, iter->second);
+    dataObject.removeItem(key);
+}
+
+//! Insert a leading item of a surface and register it
+DataKeyType DataObjectDelta::addLeadingItem(SurfaceDataObject& surface, DataKeyType key)
+{
+    key = surface.addLeadingItem(key);
+    mChanges.push_back({kInsertLeadingItem, key, key, 0, 0, 0.0, 0.0, 0});
+    return key;
+}
+
+//! Remove a leading item of a surface together with the values of its column and keep them to be restored
+void DataObjectDelta::removeLeadingItem(SurfaceDataObject& surface, DataKeyType key)
+{
+    DataHolder const& leadingItems = surface.mLeadingItems;
+    auto iterLeading = leadingItems.find(key);
+    if (leadingItems.size() == 1 || iterLeading == leadingItems.end())
+        return;
+    IndexType iColumn = std::distance(leadingItems.begin(), iterLeading);
+    DataItemType column(1, surface.mItems.size());
+    IndexType iItem = 0;
+    for (auto const& item : surface.mItems)
+        column[0][iItem++] = item.second[0][iColumn];
+    Change change = {kRemoveLeadingItem, key, key, 0, iColumn, 0.0, 0.0, mItems.size()};
+    mItems.push_back(iterLeading->second);
+    mItems.push_back(std::move(column));
+    mChanges.push_back(change);
+    surface.removeLeadingItem(key);
+}
+
+//! Modify a key of a leading item of a surface and register the change
+bool DataObjectDelta::changeLeadingItemKey(SurfaceDataObject& surface, DataKeyType oldKey, DataKeyType newKey)
+{
+    if (!surface.changeLeadingItemKey(oldKey, newKey))
+        return false;
+    mChanges.push_back({kLeadingKey, oldKey, newKey, 0, 0, 0.0, 0.0, 0});
+    return true;
+}
+
+//! Revert a data object to the state before the edits
+void DataObjectDelta::undo(AbstractDataObject& dataObject) const
+{
+    for (auto iter = mChanges.rbegin(); iter != mChanges.rend(); ++iter)
+        apply(dataObject, *iter, false);
+    dataObject.markModified();
+}
+
+//! Bring a data object to the state after the edits
+void DataObjectDelta::redo(AbstractDataObject& dataObject) const
+{
+    for (Change const& change : mChanges)
+        apply(dataObject, change, true);
+    dataObject.markModified();
+}
+
+/*!
+ * \brief Combine with the following change of values of the same data object
+ *
+ * Both of the deltas are supposed to contain values only. For each cell, the oldest value and the newest one are kept.
+ */
+bool DataObjectDelta::merge(DataObjectDelta const& next)
+{
+    if (mID != next.mID || !isValuesOnly() || !next.isValuesOnly())
+        return false;
+    std::map<std::tuple<DataKeyType, IndexType, IndexType>, size_t> indices;
+    size_t numChanges = mChanges.size();
+    for (size_t i = 0; i != numChanges; ++i)
+    {
+        Change const& change = mChanges[i];
+        indices.emplace(std::make_tuple(change.key, change.iRow, change.iColumn), i);
+    }
+    for (Change const& change : next.mChanges)
+    {
+        auto iter = indices.find(std::make_tuple(change.key, change.iRow, change.iColumn));
+        if (iter != indices.end())
+            mChanges[iter->second].newValue = change.newValue;
+        else
+            mChanges.push_back(change);
+    }
+    return true;
+}
+
+//! Check if only values of existing items were changed
+bool DataObjectDelta::isValuesOnly() const
+{
+    for (Change const& change : mChanges)
+    {
+        if (change.type != kValue)
+            return false;
+    }
+    return true;
+}
+
+//! Estimate the number of bytes occupied by the delta
+size_t DataObjectDelta::memorySize() const
+{
+    size_t size = sizeof(DataObjectDelta) + mChanges.capacity() * sizeof(Change) + mItems.capacity() * sizeof(DataItemType);
+    for (DataItemType const& item : mItems)
+        size += itemMemorySize(item) - sizeof(DataItemType);
+    return size;
+}
+
+//! Register an item which is inserted or removed
+void DataObjectDelta::pushItem(ChangeType type, DataKeyType key, DataItemType const& item)
+{
+    mChanges.push_back({type, key, key, 0, 0, 0.0, 0.0, mItems.size()});
+    mItems.push_back(item);
+}
+
+//! Apply either the direct or the inverse change to a data object
+void DataObjectDelta::apply(AbstractDataObject& dataObject, Change const& change, bool isRedo) const
+{
+    DataHolder& items = dataObject.mItems;
+    bool isSurface = dataObject.type() == AbstractDataObject::ObjectType::kSurface;
+    switch (change.type)
+    {
+    case kValue:
+    {
+        auto iter = items.find(change.key);
+        if (iter != items.end() && change.iRow < iter->second.rows() && change.iColumn < iter->second.cols())
+            iter->second[change.iRow][change.iColumn] = isRedo ? change.newValue : change.oldValue;
+        break;
+    }
+    case kKey:
+        if (isRedo)
+            moveItem(items, change.key, change.newKey);
+        else
+            moveItem(items, change.newKey, change.key);
+        break;
+    case kInsertItem:
+        if (isRedo)
+            items.insert_or_assign(change.key, mItems[change.iItem]);
+        else
+            items.erase(change.key);
+        break;
+    case kRemoveItem:
+        if (isRedo)
+            items.erase(change.key);
+        else
+            items.insert_or_assign(change.key, mItems[change.iItem]);
+        break;
+    case kInsertLeadingItem:
+        if (!isSurface)
+            break;
+        if (isRedo)
+            ((SurfaceDataObject&)dataObject).addLeadingItem(change.key);
+        else
+            ((SurfaceDataObject&)dataObject).removeLeadingItem(change.key);
+        break;
+    case kRemoveLeadingItem:
+        if (!isSurface)
+            break;
+        if (isRedo)
+            ((SurfaceDataObject&)dataObject).removeLeadingItem(change.key);
+        else
+            insertColumn((SurfaceDataObject&)dataObject, change);
+        break;
+    case kLeadingKey:
+        if (!isSurface)
+            break;
+        if (isRedo)
+            ((SurfaceDataObject&)dataObject).changeLeadingItemKey(change.key, change.newKey);
+        else
+            ((SurfaceDataObject&)dataObject).changeLeadingItemKey(change.newKey, change.key);
+        break;
+    }
+}
+
+//! Restore a leading item of a surface together with the values of its column
+void DataObjectDelta::insertColumn(SurfaceDataObject& surface, Change const& change) const
+{
+    surface.mLeadingItems.insert_or_assign(change.key, mItems[change.iItem]);
+    DataItemType const& column = mItems[change.iItem + 1];
+    IndexType numLeadingItems = surface.mLeadingItems.size();
+    IndexType iItem = 0;
+    for (auto& item : surface.mItems)
+    {
+        item.second.resize(1, numLeadingItems);
+        item.second.moveColumn(numLeadingItems - 1, change.iColumn);
+        if (iItem < column.cols())
+            item.second[0][change.iColumn] = column[0][iItem];
+        ++iItem;
+    }
+}
+
+//! Move an item to another key without copying its values
+void DataObjectDelta::moveItem(DataHolder& items, DataKeyType oldKey, DataKeyType newKey)
+{
+    auto node = items.extract(oldKey);
+    if (node.empty())
+        return;
+    node.key() = newKey;
+    items.insert(std::move(node));
+}
+
+//! Helper function to compare items by values
+bool isItemsEqual(DataItemType const& first, DataItemType const& second)
+{
+    IndexType numRows = first.rows();
+    IndexType numCols = first.cols();
+    if (numRows != second.rows() || numCols != second.cols())
+        return false;
+    for (IndexType i = 0; i != numRows; ++i)
+    {
+        for (IndexType j = 0; j != numCols; ++j)
+        {
+            if (first[i][j] != second[i][j])
+                return false;
+        }
+    }
+    return true;
+}
+
+//! Helper function to estimate the number of bytes occupied by an item
+size_t itemMemorySize(DataItemType const& item)
+{
+    return sizeof(DataItemType) + item.size() * sizeof(DataValueType);
+}
@@ -0,0 +1,86 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the DataObjectDelta class
+ */
+
+#ifndef DATAOBJECTDELTA_H
+#define DATAOBJECTDELTA_H
+
+#include <vector>
+#include "abstractdataobject.h"
+
+namespace QRS::Core
+{
+
+class SurfaceDataObject;
+
+/*!
+ * \brief Edits of a data object
+ *
+ * Each edit is applied to an object and registered at once, so that the size of a delta
+ * is proportional to the size of an edit rather than to the size of the object.
+ * The edits are undone in the reverse order and redone in the direct one.
+ */
+class DataObjectDelta
+{
+public:
+    explicit DataObjectDelta(DataIDType id = 0);
+    DataObjectDelta(AbstractDataObject const& before, AbstractDataObject const& after);
+    DataIDType id() const { return mID; }
+    // Edits
+    bool setArrayValue(AbstractDataObject& dataObject, DataKeyType key, DataValueType newValue, IndexType iRow = 0,
+                       IndexType iColumn = 0);
+    bool changeItemKey(AbstractDataObject& dataObject, DataKeyType oldKey, DataKeyType newKey);
+    DataItemType const& addItem(AbstractDataObject& dataObject, DataKeyType key);
+    void removeItem(AbstractDataObject& dataObject, DataKeyType key);
+    DataKeyType addLeadingItem(SurfaceDataObject& surface, DataKeyType key);
+    void removeLeadingItem(SurfaceDataObject& surface, DataKeyType key);
+    bool changeLeadingItemKey(SurfaceDataObject& surface, DataKeyType oldKey, DataKeyType newKey);
+    // History
+    void undo(AbstractDataObject& dataObject) const;
+    void redo(AbstractDataObject& dataObject) const;
+    bool merge(DataObjectDelta const& next);
+    bool isEmpty() const { return mChanges.empty(); }
+    bool isValuesOnly() const;
+    size_t memorySize() const;
+
+private:
+    enum ChangeType : quint8
+    {
+        kValue,
+        kKey,
+        kInsertItem,
+        kRemoveItem,
+        kInsertLeadingItem,
+        kRemoveLeadingItem,
+        kLeadingKey
+    };
+    struct Change
+    {
+        ChangeType type;
+        DataKeyType key;
+        DataKeyType newKey;
+        IndexType iRow;
+        IndexType iColumn;
+        DataValueType oldValue;
+        DataValueType newValue;
+        //! Index of the stored item which is inserted or removed
+        size_t iItem;
+    };
+    void pushItem(ChangeType type, DataKeyType key, DataItemType const& item);
+    void apply(AbstractDataObject& dataObject, Change const& change, bool isRedo) const;
+    void insertColumn(SurfaceDataObject& surface, Change const& change) const;
+    static void moveItem(DataHolder& items, DataKeyType oldKey, DataKeyType newKey);
+
+private:
+    DataIDType mID;
+    std::vector<Change> mChanges;
+    //! Items inserted or removed, as well as values of columns of surfaces removed
+    std::vector<DataItemType> mItems;
+};
+
+}
+
+#endif // DATAOBJECTDELTA_H
@@ -0,0 +1,115 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the DependencyIndex class
+ */
+
+#include "dependencyindex.h"
+#include "abstractrodcomponent.h"
+#include "deriveddataobject.h"
+
+using namespace QRS::Core;
+
+//! Detach all the indexed components, so that they do not refer to the destroyed index
+DependencyIndex::~DependencyIndex()
+{
+    clear();
+}
+
+//! Register a reference of a component field to a data object
+void DependencyIndex::addReference(DataIDType dataObjectID, AbstractRodComponent* pRodComponent, int iField)
+{
+    mDependents[dataObjectID][pRodComponent] |= 1u << iField;
+}
+
+//! Unregister a reference of a component field to a data object
+void DependencyIndex::removeReference(DataIDType dataObjectID, AbstractRodComponent* pRodComponent, int iField)
+{
+    auto iterDependents = mDependents.find(dataObjectID);
+    if (iterDependents == mDependents.end())
+        return;
+    DataDependents& dependents = iterDependents->second;
+    auto iterComponent = dependents.find(pRodComponent);
+    if (iterComponent == dependents.end())
+        return;
+    iterComponent->second &= ~(1u << iField);
+    if (iterComponent->second == 0)
+        dependents.erase(iterComponent);
+    if (dependents.empty())
+        mDependents.erase(iterDependents);
+}
+
+//! Register all the references of a component and make it report the following changes
+void DependencyIndex::insert(AbstractRodComponent* pRodComponent)
+{
+    if (mRodComponents.insert(pRodComponent).second)
+        pRodComponent->setDependencyIndex(this);
+}
+
+//! Unregister all the references of a component
+void DependencyIndex::remove(AbstractRodComponent* pRodComponent)
+{
+    if (mRodComponents.erase(pRodComponent))
+        pRodComponent->setDependencyIndex(nullptr);
+}
+
+//! Retrieve components which refer to a data object
+DataDependents const& DependencyIndex::dependents(DataIDType dataObjectID) const
+{
+    static DataDependents const kEmptyDependents;
+    auto iter = mDependents.find(dataObjectID);
+    if (iter == mDependents.end())
+        return kEmptyDependents;
+    return iter->second;
+}
+
+//! Register the names which a derived object refers to. The names registered previously are forgotten
+void DependencyIndex::insertDerived(DerivedDataObject const* pDataObject)
+{
+    DataIDType id = pDataObject->id();
+    removeDerived(id);
+    QStringList const& references = pDataObject->references();
+    for (QString const& name : references)
+        mDerivedDependents[name].insert(id);
+    mDerivedReferences.emplace(id, references);
+}
+
+//! Unregister the names which a derived object refers to
+void DependencyIndex::removeDerived(DataIDType id)
+{
+    auto iter = mDerivedReferences.find(id);
+    if (iter == mDerivedReferences.end())
+        return;
+    for (QString const& name : iter->second)
+    {
+        auto iterDependents = mDerivedDependents.find(name);
+        if (iterDependents == mDerivedDependents.end())
+            continue;
+        iterDependents->erase(id);
+        if (iterDependents->empty())
+            mDerivedDependents.erase(iterDependents);
+    }
+    mDerivedReferences.erase(iter);
+}
+
+//! Retrieve derived objects which refer to a name
+DataIDSet const& DependencyIndex::derivedDependents(QString const& name) const
+{
+    static DataIDSet const kEmptyDependents;
+    auto iter = mDerivedDependents.constFind(name);
+    if (iter == mDerivedDependents.constEnd())
+        return kEmptyDependents;
+    return iter.value();
+}
+
+//! Unregister all the components and derived objects
+void DependencyIndex::clear()
+{
+    for (AbstractRodComponent* pRodComponent : mRodComponents)
+        pRodComponent->setDependencyIndex(nullptr);
+    mRodComponents.clear();
+    mDependents.clear();
+    mDerivedDependents.clear();
+    mDerivedReferences.clear();
+}
@@ -0,0 +1,60 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the DependencyIndex class
+ */
+
+#ifndef DEPENDENCYINDEX_H
+#define DEPENDENCYINDEX_H
+
+#include <QHash>
+#include <QStringList>
+#include <unordered_map>
+#include <unordered_set>
+#include "datachangeset.h"
+
+namespace QRS::Core
+{
+
+class AbstractRodComponent;
+class DerivedDataObject;
+
+//! Rod components which refer to a data object together with masks of their referencing fields
+using DataDependents = std::unordered_map<AbstractRodComponent*, quint32>;
+
+/*!
+ * \brief Reverse index to look up entities which refer to data objects
+ *
+ * Rod components refer to data objects by identifiers, whereas derived data objects refer to them by names
+ */
+class DependencyIndex
+{
+public:
+    DependencyIndex() = default;
+    ~DependencyIndex();
+    DependencyIndex(DependencyIndex const&) = delete;
+    DependencyIndex& operator=(DependencyIndex const&) = delete;
+    void addReference(DataIDType dataObjectID, AbstractRodComponent* pRodComponent, int iField);
+    void removeReference(DataIDType dataObjectID, AbstractRodComponent* pRodComponent, int iField);
+    void insert(AbstractRodComponent* pRodComponent);
+    void remove(AbstractRodComponent* pRodComponent);
+    DataDependents const& dependents(DataIDType dataObjectID) const;
+    bool hasDependents(DataIDType dataObjectID) const { return mDependents.contains(dataObjectID); }
+    void insertDerived(DerivedDataObject const* pDataObject);
+    void removeDerived(DataIDType id);
+    DataIDSet const& derivedDependents(QString const& name) const;
+    void clear();
+
+private:
+    std::unordered_map<DataIDType, DataDependents> mDependents;
+    std::unordered_set<AbstractRodComponent*> mRodComponents;
+    //! Derived data objects which refer to each name
+    QHash<QString, DataIDSet> mDerivedDependents;
+    //! Names which each derived data object refers to
+    std::unordered_map<DataIDType, QStringList> mDerivedReferences;
+};
+
+}
+
+#endif // DEPENDENCYINDEX_H
@@ -0,0 +1,269 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the DerivedDataObject class
+ */
+
+#include <QTextStream>
+#include <algorithm>
+#include "deriveddataobject.h"
+
+using namespace QRS::Core;
+
+std::atomic<quint32> DerivedDataObject::smNumInstances = 0;
+//! Number of elements along each dimension of vectors and matrices
+const IndexType skNumElements = 3;
+
+//! Construct a data object computed by a formula
+DerivedDataObject::DerivedDataObject(ObjectType type, QString const& name, QString const& formula)
+    : AbstractDataObject(type, name)
+    , mFormula(formula)
+    , mExpression(formula)
+{
+    ++smNumInstances;
+}
+
+//! Decrease a number of instances while being destroyed
+DerivedDataObject::~DerivedDataObject()
+{
+    --smNumInstances;
+}
+
+//! Clone a derived data object together with its memoized items
+AbstractDataObject* DerivedDataObject::clone() const
+{
+    QMutexLocker locker(&mMutex);
+    DerivedDataObject* obj = new DerivedDataObject(mkType, name(), mFormula);
+    obj->mItems = mItems;
+    obj->mID = mID;
+    obj->mVersion = mVersion;
+    obj->mInputs = mInputs;
+    obj->mIsEvaluated = mIsEvaluated;
+    obj->mErrorMessage = mErrorMessage;
+    --smNumInstances;
+    return obj;
+}
+
+//! Copy a formula of another derived object. Its inputs need to be resolved afterwards
+void DerivedDataObject::assign(AbstractDataObject const& another)
+{
+    if (mkType != another.type() || !another.isDerived())
+        return;
+    DerivedDataObject const& derived = (DerivedDataObject const&)another;
+    QMutexLocker locker(&derived.mMutex);
+    AbstractDataObject::assign(another);
+    mFormula = derived.mFormula;
+    mExpression = derived.mExpression;
+    mInputs = derived.mInputs;
+    mIsEvaluated = derived.mIsEvaluated;
+    mErrorMessage = derived.mErrorMessage;
+    // The items are the same, so the objects which depend on this one remain valid
+    mVersion = derived.mVersion;
+}
+
+//! Insert an item of the size corresponding to the type
+DataItemType& DerivedDataObject::addItem(DataKeyType key)
+{
+    DataValueType rightKey = getAvailableItemKey(key);
+    mItems.emplace(rightKey, makeItem());
+    markModified();
+    return mItems.at(rightKey);
+}
+
+//! Create an item of the size corresponding to the type
+DataItemType DerivedDataObject::makeItem() const
+{
+    IndexType numRows = 1;
+    IndexType numColumns = 1;
+    if (mkType == kVector)
+    {
+        numColumns = skNumElements;
+    }
+    else if (mkType == kMatrix)
+    {
+        numRows = skNumElements;
+        numColumns = skNumElements;
+    }
+    return DataItemType(numRows, numColumns);
+}
+
+//! Substitute the formula. Its inputs need to be resolved afterwards
+void DerivedDataObject::setFormula(QString const& formula)
+{
+    QMutexLocker locker(&mMutex);
+    mFormula = formula;
+    mExpression = Expression(formula);
+    mInputs.clear();
+    invalidate();
+}
+
+/*!
+ * \brief Compute items unless they are up to date
+ *
+ * Inputs are evaluated first, so that chains of derived objects are updated at once. The items are recomputed
+ * only if the version of one of the inputs differs from the one recorded during the previous evaluation.
+ * \return Whether the items are valid. Otherwise, the reason is given by errorMessage()
+ */
+bool DerivedDataObject::evaluate() const
+{
+    QMutexLocker locker(&mMutex);
+    if (mIsEvaluating)
+    {
+        mErrorMessage = QString("Formula of the data object \"%1\" refers to itself").arg(name());
+        return false;
+    }
+    if (!mExpression.isValid())
+    {
+        mErrorMessage = mExpression.errorMessage();
+        return false;
+    }
+    int numInputs = mInputs.size();
+    if (numInputs != (int)mExpression.references().size())
+    {
+        mErrorMessage = QString("Data objects which the formula of \"%1\" refers to are not resolved").arg(name());
+        return false;
+    }
+    if (mkType == kSurface)
+    {
+        mErrorMessage = QString("Surface \"%1\" cannot be derived from other data objects").arg(name());
+        return false;
+    }
+    // Bring the inputs up to date and check whether they have been changed since the last evaluation
+    std::vector<AbstractDataObject const*> references(numInputs);
+    bool isOutdated = !mIsEvaluated;
+    bool isInputsValid = true;
+    mIsEvaluating = true;
+    for (int i = 0; i != numInputs && isInputsValid; ++i)
+    {
+        AbstractDataObject* pInput = DataHandleTable::instance().resolve(mInputs[i].handle);
+        QString const& inputName = mExpression.references()[i];
+        if (!pInput)
+        {
+            mErrorMessage = QString("Data object \"%1\" is not found").arg(inputName);
+            isInputsValid = false;
+        }
+        else if (!pInput->evaluate())
+        {
+            mErrorMessage = QString("Data object \"%1\" cannot be evaluated").arg(inputName);
+            isInputsValid = false;
+        }
+        else
+        {
+            references[i] = pInput;
+            isOutdated = isOutdated || pInput->version() != mInputs[i].version;
+        }
+    }
+    mIsEvaluating = false;
+    if (!isInputsValid)
+    {
+        invalidate();
+        return false;
+    }
+    if (!isOutdated)
+        return true;
+    // Merge the grids of keys of all the inputs
+    std::vector<DataKeyType> keys;
+    for (AbstractDataObject const* pInput : references)
+    {
+        for (auto const& item : pInput->getItems())
+            keys.push_back(item.first);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    mItems.clear();
+    for (DataKeyType key : keys)
+        mItems.emplace(key, makeItem());
+    // Evaluate the formula over zeros, so that the current value is not involved
+    if (!mExpression.apply(mItems, name(), references, mErrorMessage))
+    {
+        invalidate();
+        return false;
+    }
+    markEvaluated();
+    for (int i = 0; i != numInputs; ++i)
+        mInputs[i].version = references[i]->version();
+    mIsEvaluated = true;
+    mErrorMessage.clear();
+    return true;
+}
+
+//! Bind the names which the formula refers to with the data objects from the given set
+bool DerivedDataObject::resolveReferences(DataObjects const& dataObjects)
+{
+    QMutexLocker locker(&mMutex);
+    std::vector<AbstractDataObject*> references;
+    if (!mExpression.resolveReferences(dataObjects, references, mErrorMessage))
+    {
+        mInputs.clear();
+        invalidate();
+        return false;
+    }
+    // Versions are kept, since the copies of the inputs share them with the originals
+    int numInputs = references.size();
+    mInputs.resize(numInputs);
+    for (int i = 0; i != numInputs; ++i)
+        mInputs[i].handle = references[i]->handle();
+    return true;
+}
+
+//! Bind all the derived objects from the set with the objects they refer to
+void DerivedDataObject::resolveAllReferences(DataObjects const& dataObjects)
+{
+    for (auto const& item : dataObjects)
+    {
+        if (item.second->isDerived())
+            ((DerivedDataObject*)item.second)->resolveReferences(dataObjects);
+    }
+}
+
+//! Bind the derived objects from the set which refer to any of the given names
+void DerivedDataObject::resolveReferencesTo(DataObjects const& dataObjects, QSet<QString> const& names)
+{
+    if (names.isEmpty())
+        return;
+    for (auto const& item : dataObjects)
+    {
+        if (!item.second->isDerived())
+            continue;
+        DerivedDataObject* pDerivedDataObject = (DerivedDataObject*)item.second;
+        QStringList const& references = pDerivedDataObject->references();
+        if (std::any_of(references.begin(), references.end(), [&names](QString const& name) { return names.contains(name); }))
+            pDerivedDataObject->resolveReferences(dataObjects);
+    }
+}
+
+//! Drop the memoized items, so that they are recomputed on the next request
+void DerivedDataObject::invalidate() const
+{
+    mIsEvaluated = false;
+    if (!mItems.empty())
+    {
+        mItems.clear();
+        markEvaluated();
+    }
+}
+
+//! Serialize a formula instead of items
+void DerivedDataObject::serialize(QDataStream& stream) const
+{
+    stream << ((quint32)mkType | kSerializationFlag);
+    stream << name();
+    stream << (DataIDType)mID;
+    stream << mFormula;
+}
+
+//! Read an identifier and formula. The object needs to be resolved as soon as all the objects are read
+void DerivedDataObject::deserialize(QDataStream& stream)
+{
+    QString formula;
+    stream >> mID;
+    stream >> formula;
+    setFormula(formula);
+}
+
+//! Import a formula written in a single line
+void DerivedDataObject::import(QTextStream& stream)
+{
+    setFormula(stream.readLine().trimmed());
+}
@@ -0,0 +1,81 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the DerivedDataObject class
+ */
+
+#ifndef DERIVEDDATAOBJECT_H
+#define DERIVEDDATAOBJECT_H
+
+#include <vector>
+#include <QRecursiveMutex>
+#include <QSet>
+#include "abstractdataobject.h"
+#include "aliasdataset.h"
+#include "expression.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Data object which is computed by a formula over other data objects
+ *
+ * Items are evaluated on demand on the merged grid of keys of all the inputs, which are interpolated linearly.
+ * The result is memoized until the version of one of the inputs changes. Evaluation does not alter the logical state,
+ * so it is available through const accessors. The memoized state is guarded by a mutex, since objects can be read
+ * from several threads. Inputs are referred by names in the formula and bound to handles by resolveReferences(),
+ * so the objects must be resolved every time they are copied to another set. Only the formula is serialized.
+ */
+class DerivedDataObject : public AbstractDataObject
+{
+public:
+    //! Flag which is combined with the type of an object while being serialized
+    static quint32 const kSerializationFlag = 1u << 8;
+    DerivedDataObject(ObjectType type, QString const& name, QString const& formula = QString());
+    ~DerivedDataObject();
+    AbstractDataObject* clone() const override;
+    void assign(AbstractDataObject const& another) override;
+    DataItemType& addItem(DataKeyType key) override;
+    bool isDerived() const override { return true; }
+    bool evaluate() const override;
+    QString const& formula() const { return mFormula; }
+    void setFormula(QString const& formula);
+    //! Names of the objects which the formula refers to
+    QStringList const& references() const { return mExpression.references(); }
+    QString const& errorMessage() const { return mErrorMessage; }
+    bool resolveReferences(DataObjects const& dataObjects);
+    static void resolveAllReferences(DataObjects const& dataObjects);
+    static void resolveReferencesTo(DataObjects const& dataObjects, QSet<QString> const& names);
+    static quint32 numberInstances() { return smNumInstances; }
+    void serialize(QDataStream& stream) const override;
+    void deserialize(QDataStream& stream) override;
+    void import(QTextStream& stream) override;
+
+private:
+    //! Object which the formula refers to and its version the items were evaluated for
+    struct Input
+    {
+        DataHandle handle;
+        quint64 version = 0;
+    };
+    DataItemType makeItem() const;
+    void invalidate() const;
+
+private:
+    static std::atomic<quint32> smNumInstances;
+    QString mFormula;
+    Expression mExpression;
+    // Memoized state
+    mutable std::vector<Input> mInputs;
+    mutable bool mIsEvaluated = false;
+    //! Guard against formulas which refer to themselves through other objects
+    mutable bool mIsEvaluating = false;
+    mutable QString mErrorMessage;
+    //! Recursive, since a formula which refers to itself reaches the object again while it is being evaluated
+    mutable QRecursiveMutex mMutex;
+};
+
+}
+
+#endif // DERIVEDDATAOBJECT_H
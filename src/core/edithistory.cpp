@@ -0,0 +1,347 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the EditHistory class
+ */
+
+#include "edithistory.h"
+#include "abstractdataobject.h"
+#include "abstractrodcomponent.h"
+
+using namespace QRS::Core;
+
+//! Edit which can be undone and redone
+struct EditHistory::Edit
+{
+    virtual ~Edit() = default;
+    virtual void undo(DataChangeSet& changeSet) = 0;
+    virtual void redo(DataChangeSet& changeSet) = 0;
+    virtual size_t memorySize() const = 0;
+    bool isMergeable = false;
+};
+
+//! Modification of items of a data object
+struct EditHistory::DataObjectEdit : public EditHistory::Edit
+{
+    DataObjectEdit(DataObjects& dataObjects, DataObjectDelta&& dataObjectDelta)
+        : entities(dataObjects)
+        , delta(std::move(dataObjectDelta))
+    {
+
+    }
+
+    void undo(DataChangeSet& changeSet) override
+    {
+        auto iter = entities.find(delta.id());
+        if (iter == entities.end())
+            return;
+        delta.undo(*iter->second);
+        changeSet.setModified(delta.id());
+    }
+
+    void redo(DataChangeSet& changeSet) override
+    {
+        auto iter = entities.find(delta.id());
+        if (iter == entities.end())
+            return;
+        delta.redo(*iter->second);
+        changeSet.setModified(delta.id());
+    }
+
+    size_t memorySize() const override
+    {
+        return sizeof(DataObjectEdit) - sizeof(DataObjectDelta) + delta.memorySize();
+    }
+
+    DataObjects& entities;
+    DataObjectDelta delta;
+};
+
+//! Modification of properties of a rod component. The component is small, so its other state is stored as a whole
+struct EditHistory::RodComponentEdit : public EditHistory::Edit
+{
+    RodComponentEdit(RodComponents& rodComponents, AbstractRodComponent* pState)
+        : entities(rodComponents)
+        , pOtherState(pState)
+    {
+
+    }
+
+    ~RodComponentEdit()
+    {
+        delete pOtherState;
+    }
+
+    void undo(DataChangeSet& changeSet) override
+    {
+        swap(changeSet);
+    }
+
+    void redo(DataChangeSet& changeSet) override
+    {
+        swap(changeSet);
+    }
+
+    //! Substitute the state of the component in the set with the stored one
+    void swap(DataChangeSet& changeSet)
+    {
+        DataIDType id = pOtherState->id();
+        auto iter = entities.find(id);
+        if (iter == entities.end())
+            return;
+        // Renaming is not registered as an edit, so the current name is kept
+        pOtherState->setName(iter->second->name());
+        std::swap(iter->second, pOtherState);
+        changeSet.setModified(id);
+    }
+
+    size_t memorySize() const override
+    {
+        return sizeof(RodComponentEdit) + entityMemorySize(pOtherState);
+    }
+
+    RodComponents& entities;
+    //! State of the component which is not presented in the set
+    AbstractRodComponent* pOtherState;
+};
+
+/*!
+ * \brief Creation, removal and reorganization of entities
+ *
+ * Entities are looked up by their identifiers, since they can be substituted by clones after the edit.
+ * The ones which are out of the set in the current state of the edit are owned by it.
+ * An entity substituted by another one with the same identifier is both removed and created.
+ */
+template <typename Entity>
+struct EditHistory::StructureEdit : public EditHistory::Edit
+{
+    using Entities = std::unordered_map<DataIDType, Entity*>;
+    //! Entity which is owned by the edit while it is out of the set
+    struct Slot
+    {
+        DataIDType id;
+        Entity* pEntity;
+    };
+
+    StructureEdit(Entities& entitiesSet, HierarchyDelta&& hierarchyDelta, std::vector<Entity*> const& createdEntities,
+                  std::vector<Entity*> const& removedEntities)
+        : entities(entitiesSet)
+        , hierarchy(std::move(hierarchyDelta))
+    {
+        // The created entities can be modified later, so the size is estimated once
+        size = sizeof(StructureEdit) - sizeof(HierarchyDelta) + hierarchy.memorySize()
+               + (createdEntities.size() + removedEntities.size()) * sizeof(Slot);
+        for (Entity* pEntity : createdEntities)
+        {
+            created.push_back({pEntity->id(), nullptr});
+            size += entityMemorySize(pEntity);
+        }
+        for (Entity* pEntity : removedEntities)
+        {
+            removed.push_back({pEntity->id(), pEntity});
+            size += entityMemorySize(pEntity);
+        }
+    }
+
+    ~StructureEdit()
+    {
+        for (std::vector<Slot>* pSlots : {&created, &removed})
+        {
+            for (Slot& slot : *pSlots)
+                delete slot.pEntity;
+        }
+    }
+
+    void undo(DataChangeSet& changeSet) override
+    {
+        exchange(created, removed, changeSet);
+        hierarchy.undo();
+        changeSet.setHierarchyChanged();
+    }
+
+    void redo(DataChangeSet& changeSet) override
+    {
+        exchange(removed, created, changeSet);
+        hierarchy.redo();
+        changeSet.setHierarchyChanged();
+    }
+
+    //! Take some entities out of the set and bring the others back
+    void exchange(std::vector<Slot>& outSlots, std::vector<Slot>& inSlots, DataChangeSet& changeSet)
+    {
+        for (Slot& slot : outSlots)
+        {
+            auto iter = entities.find(slot.id);
+            if (iter == entities.end())
+                continue;
+            slot.pEntity = iter->second;
+            entities.erase(iter);
+            changeSet.setRemoved(slot.id);
+        }
+        for (Slot& slot : inSlots)
+        {
+            if (!slot.pEntity)
+                continue;
+            entities.insert_or_assign(slot.id, slot.pEntity);
+            slot.pEntity = nullptr;
+            changeSet.setRestored(slot.id);
+        }
+    }
+
+    size_t memorySize() const override
+    {
+        return size;
+    }
+
+    Entities& entities;
+    HierarchyDelta hierarchy;
+    std::vector<Slot> created;
+    std::vector<Slot> removed;
+    size_t size;
+};
+
+EditHistory::EditHistory(size_t maxMemorySize)
+    : mkMaxMemorySize(maxMemorySize)
+{
+
+}
+
+EditHistory::~EditHistory()
+{
+    clear();
+}
+
+/*!
+ * \brief Register a modification of a data object
+ *
+ * If both this edit and the previous one are mergeable, and they change values of the same object, they are combined
+ */
+void EditHistory::pushDataObject(DataObjects& dataObjects, DataObjectDelta&& delta, bool isMergeable)
+{
+    if (delta.isEmpty())
+        return;
+    removeUndone();
+    // Only edits of data objects can be mergeable
+    if (isMergeable && mNumDone > 0 && mEdits.back()->isMergeable)
+    {
+        DataObjectEdit* pLastEdit = (DataObjectEdit*)mEdits.back();
+        size_t lastSize = pLastEdit->memorySize();
+        if (pLastEdit->delta.merge(delta))
+        {
+            mMemorySize = mMemorySize - lastSize + pLastEdit->memorySize();
+            return;
+        }
+    }
+    DataObjectEdit* pEdit = new DataObjectEdit(dataObjects, std::move(delta));
+    pEdit->isMergeable = isMergeable;
+    push(pEdit);
+}
+
+//! Register a modification of a rod component given its state before the modification. The state is owned by the history
+void EditHistory::pushRodComponent(RodComponents& rodComponents, AbstractRodComponent* pPreviousState)
+{
+    if (!pPreviousState)
+        return;
+    removeUndone();
+    push(new RodComponentEdit(rodComponents, pPreviousState));
+}
+
+/*!
+ * \brief Register creation, removal or reorganization of entities
+ *
+ * The created entities are supposed to be in the set already, whereas the removed ones have been taken out of it.
+ * The removed entities are owned by the history.
+ */
+template <typename Entity>
+void EditHistory::pushStructure(std::unordered_map<DataIDType, Entity*>& entities, HierarchyDelta&& hierarchy,
+                                std::vector<Entity*> const& createdEntities, std::vector<Entity*> const& removedEntities)
+{
+    if (hierarchy.isEmpty() && createdEntities.empty() && removedEntities.empty())
+        return;
+    removeUndone();
+    push(new StructureEdit<Entity>(entities, std::move(hierarchy), createdEntities, removedEntities));
+}
+
+template void EditHistory::pushStructure(DataObjects&, HierarchyDelta&&, std::vector<AbstractDataObject*> const&,
+                                         std::vector<AbstractDataObject*> const&);
+template void EditHistory::pushStructure(RodComponents&, HierarchyDelta&&, std::vector<AbstractRodComponent*> const&,
+                                         std::vector<AbstractRodComponent*> const&);
+
+//! Revert the last edit done and register the entities affected
+bool EditHistory::undo(DataChangeSet& changeSet)
+{
+    if (!canUndo())
+        return false;
+    --mNumDone;
+    mEdits[mNumDone]->undo(changeSet);
+    return true;
+}
+
+//! Repeat the last edit undone and register the entities affected
+bool EditHistory::redo(DataChangeSet& changeSet)
+{
+    if (!canRedo())
+        return false;
+    mEdits[mNumDone]->redo(changeSet);
+    ++mNumDone;
+    return true;
+}
+
+//! Forget all the edits
+void EditHistory::clear()
+{
+    for (Edit* pEdit : mEdits)
+        delete pEdit;
+    mEdits.clear();
+    mNumDone = 0;
+    mMemorySize = 0;
+}
+
+//! Append an edit and forget the oldest ones which do not fit into the memory limit
+void EditHistory::push(Edit* pEdit)
+{
+    mEdits.push_back(pEdit);
+    mMemorySize += pEdit->memorySize();
+    ++mNumDone;
+    while (mMemorySize > mkMaxMemorySize && mEdits.size() > 1)
+    {
+        Edit* pFirstEdit = mEdits.front();
+        mMemorySize -= pFirstEdit->memorySize();
+        delete pFirstEdit;
+        mEdits.pop_front();
+        --mNumDone;
+    }
+}
+
+//! Forget the edits which have been undone, since they cannot be redone after a new edit
+void EditHistory::removeUndone()
+{
+    if (mEdits.size() == mNumDone)
+        return;
+    while (mEdits.size() > mNumDone)
+    {
+        Edit* pEdit = mEdits.back();
+        mMemorySize -= pEdit->memorySize();
+        delete pEdit;
+        mEdits.pop_back();
+    }
+    // The edit preceding the undone ones must not absorb new ones
+    if (mNumDone > 0)
+        mEdits.back()->isMergeable = false;
+}
+
+//! Estimate the number of bytes occupied by a data object
+size_t EditHistory::entityMemorySize(AbstractDataObject const* pDataObject)
+{
+    size_t size = sizeof(AbstractDataObject);
+    for (auto const& [key, item] : pDataObject->mItems)
+        size += sizeof(key) + sizeof(item) + item.size() * sizeof(DataValueType);
+    return size;
+}
+
+//! Estimate the number of bytes occupied by a rod component
+size_t EditHistory::entityMemorySize(AbstractRodComponent const* /*pRodComponent*/)
+{
+    return sizeof(AbstractRodComponent);
+}
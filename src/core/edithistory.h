@@ -0,0 +1,70 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the EditHistory class
+ */
+
+#ifndef EDITHISTORY_H
+#define EDITHISTORY_H
+
+#include <deque>
+#include <vector>
+#include "aliasdataset.h"
+#include "datachangeset.h"
+#include "dataobjectdelta.h"
+#include "hierarchydelta.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Bounded history of edits of entities and their hierarchy
+ *
+ * Edits are stored as deltas. When the memory they occupy exceeds the limit, the oldest edits are forgotten.
+ * Consecutive mergeable edits of values of the same object are combined to be undone at once.
+ * Entities which are created or removed by an edit are owned by the history while they are out of their set.
+ */
+class EditHistory
+{
+public:
+    explicit EditHistory(size_t maxMemorySize = skDefaultMaxMemorySize);
+    EditHistory(EditHistory const&) = delete;
+    EditHistory& operator=(EditHistory const&) = delete;
+    ~EditHistory();
+    void pushDataObject(DataObjects& dataObjects, DataObjectDelta&& delta, bool isMergeable = false);
+    void pushRodComponent(RodComponents& rodComponents, AbstractRodComponent* pPreviousState);
+    template <typename Entity>
+    void pushStructure(std::unordered_map<DataIDType, Entity*>& entities, HierarchyDelta&& hierarchy,
+                       std::vector<Entity*> const& createdEntities = {}, std::vector<Entity*> const& removedEntities = {});
+    bool undo(DataChangeSet& changeSet);
+    bool redo(DataChangeSet& changeSet);
+    bool canUndo() const { return mNumDone > 0; }
+    bool canRedo() const { return mNumDone < mEdits.size(); }
+    quint32 numberEdits() const { return mEdits.size(); }
+    size_t memorySize() const { return mMemorySize; }
+    void clear();
+
+private:
+    struct Edit;
+    struct DataObjectEdit;
+    struct RodComponentEdit;
+    template <typename Entity>
+    struct StructureEdit;
+    void push(Edit* pEdit);
+    void removeUndone();
+    static size_t entityMemorySize(AbstractDataObject const* pDataObject);
+    static size_t entityMemorySize(AbstractRodComponent const* pRodComponent);
+
+private:
+    static const size_t skDefaultMaxMemorySize = 64 * 1024 * 1024;
+    size_t const mkMaxMemorySize;
+    std::deque<Edit*> mEdits;
+    //! Number of edits which can be undone
+    size_t mNumDone = 0;
+    size_t mMemorySize = 0;
+};
+
+}
+
+#endif // EDITHISTORY_H
@@ -0,0 +1,752 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the Expression class
+ */
+
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <algorithm>
+#include "expression.h"
+#include "abstractdataobject.h"
+
+using namespace QRS::Core;
+
+//! Maximum number of constants, variables or functions which an instruction can refer to
+static int const skMaxOperand = std::numeric_limits<quint16>::max();
+
+//! Function of one argument which can be called from an expression
+struct UnaryFunction
+{
+    char const* name;
+    double (*function)(double);
+};
+
+static UnaryFunction const skUnaryFunctions[] =
+{
+    {"sin", [](double value) { return std::sin(value); }},
+    {"cos", [](double value) { return std::cos(value); }},
+    {"tan", [](double value) { return std::tan(value); }},
+    {"asin", [](double value) { return std::asin(value); }},
+    {"acos", [](double value) { return std::acos(value); }},
+    {"atan", [](double value) { return std::atan(value); }},
+    {"sinh", [](double value) { return std::sinh(value); }},
+    {"cosh", [](double value) { return std::cosh(value); }},
+    {"tanh", [](double value) { return std::tanh(value); }},
+    {"exp", [](double value) { return std::exp(value); }},
+    {"log", [](double value) { return std::log(value); }},
+    {"log10", [](double value) { return std::log10(value); }},
+    {"sqrt", [](double value) { return std::sqrt(value); }},
+    {"abs", [](double value) { return std::abs(value); }},
+    {"floor", [](double value) { return std::floor(value); }},
+    {"ceil", [](double value) { return std::ceil(value); }},
+    {"round", [](double value) { return std::round(value); }},
+    {"rad", [](double value) { return value * std::numbers::pi / 180.0; }},
+    {"deg", [](double value) { return value * 180.0 / std::numbers::pi; }}
+};
+static int const skNumUnaryFunctions = sizeof(skUnaryFunctions) / sizeof(UnaryFunction);
+
+namespace QRS::Core
+{
+
+//! Recursive descent parser which builds a tree of operations, folds its constant branches and emits the bytecode
+class Expression::Compiler
+{
+public:
+    Compiler(Expression& expression, QString const& text)
+        : mExpression(expression)
+        , mText(text)
+    {
+
+    }
+
+    //! Translate the text into the bytecode of the expression
+    void compile()
+    {
+        int iRoot = parseSum();
+        skipSpaces();
+        if (iRoot >= 0 && mPosition != mText.size())
+            fail(QString("Unexpected symbol \"%1\"").arg(mText[mPosition]));
+        if (!isFailed())
+            generate(iRoot, 0);
+        if (isFailed())
+        {
+            mExpression.mInstructions.clear();
+            mExpression.mConstants.clear();
+        }
+    }
+
+private:
+    //! Operation of the tree. Leaves are constants and variables
+    struct Node
+    {
+        OpCode code;
+        quint16 operand = 0;
+        double value = 0.0;
+        int iFirst = -1;
+        int iSecond = -1;
+    };
+
+    // Grammar: sum := product {(+|-) product}, product := unary {(*|/) unary}, unary := {+|-} power,
+    // power := primary [^ unary], primary := number | name | name(sum[, sum]) | [reference] | (sum)
+    int parseSum()
+    {
+        int iNode = parseProduct();
+        while (iNode >= 0)
+        {
+            if (accept('+'))
+                iNode = makeBinary(kAdd, iNode, parseProduct());
+            else if (accept('-'))
+                iNode = makeBinary(kSubtract, iNode, parseProduct());
+            else
+                break;
+        }
+        return iNode;
+    }
+
+    int parseProduct()
+    {
+        int iNode = parseUnary();
+        while (iNode >= 0)
+        {
+            if (accept('*'))
+                iNode = makeBinary(kMultiply, iNode, parseUnary());
+            else if (accept('/'))
+                iNode = makeBinary(kDivide, iNode, parseUnary());
+            else
+                break;
+        }
+        return iNode;
+    }
+
+    int parseUnary()
+    {
+        if (accept('-'))
+            return makeUnary(kNegate, 0, parseUnary());
+        if (accept('+'))
+            return parseUnary();
+        return parsePower();
+    }
+
+    int parsePower()
+    {
+        int iNode = parsePrimary();
+        if (iNode >= 0 && accept('^'))
+            iNode = makeBinary(kPower, iNode, parseUnary());
+        return iNode;
+    }
+
+    int parsePrimary()
+    {
+        skipSpaces();
+        if (mPosition == mText.size())
+        {
+            fail("Unexpected end of the expression");
+            return -1;
+        }
+        QChar symbol = mText[mPosition];
+        if (symbol.isDigit() || symbol == '.')
+            return parseNumber();
+        if (symbol.isLetter() || symbol == '_')
+            return parseName();
+        if (accept('['))
+            return parseReference();
+        if (accept('('))
+        {
+            int iNode = parseSum();
+            if (iNode >= 0 && !accept(')'))
+                return fail("Closing parenthesis is missing");
+            return iNode;
+        }
+        return fail(QString("Unexpected symbol \"%1\"").arg(symbol));
+    }
+
+    int parseNumber()
+    {
+        int iStart = mPosition;
+        int length = mText.size();
+        while (mPosition < length && (mText[mPosition].isDigit() || mText[mPosition] == '.'))
+            ++mPosition;
+        // Exponent is read only if it is followed by digits, so that names are not consumed
+        if (mPosition < length && (mText[mPosition] == 'e' || mText[mPosition] == 'E'))
+        {
+            int iExponent = mPosition + 1;
+            if (iExponent < length && (mText[iExponent] == '+' || mText[iExponent] == '-'))
+                ++iExponent;
+            if (iExponent < length && mText[iExponent].isDigit())
+            {
+                mPosition = iExponent;
+                while (mPosition < length && mText[mPosition].isDigit())
+                    ++mPosition;
+            }
+        }
+        bool isOkay = false;
+        double value = mText.mid(iStart, mPosition - iStart).toDouble(&isOkay);
+        if (!isOkay)
+            return fail(QString("Number \"%1\" is not valid").arg(mText.mid(iStart, mPosition - iStart)));
+        return makeConstant(value);
+    }
+
+    int parseName()
+    {
+        int iStart = mPosition;
+        while (mPosition < mText.size() && (mText[mPosition].isLetterOrNumber() || mText[mPosition] == '_'))
+            ++mPosition;
+        QString name = mText.mid(iStart, mPosition - iStart);
+        if (accept('('))
+            return parseCall(name);
+        if (name == "x")
+            return makeVariable(kValue);
+        if (name == "key")
+            return makeVariable(kKey);
+        if (name == "pi")
+            return makeConstant(std::numbers::pi);
+        if (name == "e")
+            return makeConstant(std::numbers::e);
+        return fail(QString("Unknown name \"%1\"").arg(name));
+    }
+
+    int parseCall(QString const& name)
+    {
+        QList<int> arguments;
+        if (!accept(')'))
+        {
+            do
+            {
+                int iArgument = parseSum();
+                if (iArgument < 0)
+                    return -1;
+                arguments.push_back(iArgument);
+            } while (accept(','));
+            if (!accept(')'))
+                return fail(QString("Closing parenthesis of the function \"%1\" is missing").arg(name));
+        }
+        int numArguments = arguments.size();
+        for (int i = 0; i != skNumUnaryFunctions; ++i)
+        {
+            if (name != skUnaryFunctions[i].name)
+                continue;
+            if (numArguments != 1)
+                return fail(QString("Function \"%1\" takes one argument").arg(name));
+            return makeUnary(kFunction, i, arguments[0]);
+        }
+        OpCode code;
+        if (name == "min")
+            code = kMinimum;
+        else if (name == "max")
+            code = kMaximum;
+        else if (name == "pow")
+            code = kPower;
+        else if (name == "atan2")
+            code = kArcTangent2;
+        else
+            return fail(QString("Unknown function \"%1\"").arg(name));
+        if (numArguments != 2)
+            return fail(QString("Function \"%1\" takes two arguments").arg(name));
+        return makeBinary(code, arguments[0], arguments[1]);
+    }
+
+    int parseReference()
+    {
+        int iEnd = mText.indexOf(']', mPosition);
+        if (iEnd < 0)
+            return fail("Closing bracket of the reference is missing");
+        QString name = mText.mid(mPosition, iEnd - mPosition).trimmed();
+        mPosition = iEnd + 1;
+        if (name.isEmpty())
+            return fail("Name of the referenced data object is empty");
+        QStringList& references = mExpression.mReferences;
+        int iReference = references.indexOf(name);
+        if (iReference < 0)
+        {
+            iReference = references.size();
+            references.push_back(name);
+        }
+        return makeVariable(kNumBaseVariables + iReference);
+    }
+
+    int makeConstant(double value)
+    {
+        mNodes.push_back({kPushConstant, 0, value});
+        return mNodes.size() - 1;
+    }
+
+    int makeVariable(int iVariable)
+    {
+        if (iVariable > skMaxOperand)
+            return fail("Too many data objects are referenced");
+        mNodes.push_back({kPushVariable, (quint16)iVariable});
+        return mNodes.size() - 1;
+    }
+
+    //! Create an operation of one argument. Constant arguments are computed at once
+    int makeUnary(OpCode code, quint16 operand, int iArgument)
+    {
+        if (iArgument < 0)
+            return -1;
+        if (mNodes[iArgument].code == kPushConstant)
+        {
+            mNodes[iArgument].value = compute(code, operand, mNodes[iArgument].value, 0.0);
+            return iArgument;
+        }
+        mNodes.push_back({code, operand, 0.0, iArgument});
+        return mNodes.size() - 1;
+    }
+
+    //! Create an operation of two arguments. Constant arguments are computed at once
+    int makeBinary(OpCode code, int iFirst, int iSecond)
+    {
+        if (iFirst < 0 || iSecond < 0)
+            return -1;
+        if (mNodes[iFirst].code == kPushConstant && mNodes[iSecond].code == kPushConstant)
+        {
+            mNodes[iFirst].value = compute(code, 0, mNodes[iFirst].value, mNodes[iSecond].value);
+            return iFirst;
+        }
+        mNodes.push_back({code, 0, 0.0, iFirst, iSecond});
+        return mNodes.size() - 1;
+    }
+
+    /*!
+     * \brief Write the instructions of a node after the ones of its arguments
+     *
+     * Arithmetic operations with constant second arguments are replaced by the instructions which take the constant
+     * as an operand, so that the constant is not spread over a batch
+     */
+    void generate(int iNode, int depth)
+    {
+        Node const& node = mNodes[iNode];
+        std::vector<Instruction>& instructions = mExpression.mInstructions;
+        mExpression.mStackDepth = std::max(mExpression.mStackDepth, depth + 1);
+        switch (node.code)
+        {
+        case kPushConstant:
+            instructions.push_back({kPushConstant, pushConstant(node.value)});
+            return;
+        case kPushVariable:
+            instructions.push_back(Instruction{kPushVariable, node.operand});
+            return;
+        case kNegate:
+        case kFunction:
+            generate(node.iFirst, depth);
+            instructions.push_back({node.code, node.operand});
+            return;
+        default:
+            break;
+        }
+        generate(node.iFirst, depth);
+        Node const& secondNode = mNodes[node.iSecond];
+        if (secondNode.code == kPushConstant)
+        {
+            OpCode code = node.code;
+            switch (node.code)
+            {
+            case kAdd:
+                code = kAddConstant;
+                break;
+            case kSubtract:
+                code = kSubtractConstant;
+                break;
+            case kMultiply:
+                code = kMultiplyConstant;
+                break;
+            case kDivide:
+                code = kDivideConstant;
+                break;
+            default:
+                break;
+            }
+            if (code != node.code)
+            {
+                instructions.push_back({code, pushConstant(secondNode.value)});
+                return;
+            }
+        }
+        generate(node.iSecond, depth + 1);
+        instructions.push_back({node.code, 0});
+    }
+
+    quint16 pushConstant(double value)
+    {
+        std::vector<double>& constants = mExpression.mConstants;
+        if ((int)constants.size() > skMaxOperand)
+        {
+            fail("The expression is too complex");
+            return 0;
+        }
+        constants.push_back(value);
+        return constants.size() - 1;
+    }
+
+    void skipSpaces()
+    {
+        while (mPosition < mText.size() && mText[mPosition].isSpace())
+            ++mPosition;
+    }
+
+    //! Skip a symbol if it is the next one
+    bool accept(char symbol)
+    {
+        skipSpaces();
+        if (mPosition < mText.size() && mText[mPosition] == symbol)
+        {
+            ++mPosition;
+            return true;
+        }
+        return false;
+    }
+
+    //! Remember the first error only, since the following ones are caused by it
+    int fail(QString const& message)
+    {
+        if (!isFailed())
+            mExpression.mErrorMessage = message;
+        return -1;
+    }
+
+    bool isFailed() const { return !mExpression.mErrorMessage.isEmpty(); }
+
+private:
+    Expression& mExpression;
+    QString const& mText;
+    int mPosition = 0;
+    std::vector<Node> mNodes;
+};
+
+}
+
+//! Apply a function to each value of a batch
+template<typename Function>
+inline void transformBatch(double const* pFirst, double* pResult, int numValues, Function function)
+{
+    for (int i = 0; i != numValues; ++i)
+        pResult[i] = function(pFirst[i]);
+}
+
+//! Apply a function to each pair of values of two batches
+template<typename Function>
+inline void transformBatch(double const* pFirst, double const* pSecond, double* pResult, int numValues, Function function)
+{
+    for (int i = 0; i != numValues; ++i)
+        pResult[i] = function(pFirst[i], pSecond[i]);
+}
+
+//! Compile an expression. The error message is set, if the text cannot be compiled
+Expression::Expression(QString const& text)
+{
+    mBody = text;
+    // The target is separated from the expression, since the language has no comparison operators
+    int iAssignment = -1;
+    bool isReference = false;
+    for (int i = 0; i != text.size() && iAssignment < 0; ++i)
+    {
+        if (text[i] == '[' || text[i] == ']')
+            isReference = text[i] == '[';
+        else if (text[i] == '=' && !isReference)
+            iAssignment = i;
+    }
+    if (iAssignment >= 0)
+    {
+        mTarget = text.left(iAssignment).trimmed();
+        if (mTarget.startsWith('[') && mTarget.endsWith(']'))
+            mTarget = mTarget.mid(1, mTarget.size() - 2).trimmed();
+        if (mTarget.isEmpty())
+        {
+            mErrorMessage = "Name of the resulting data object is empty";
+            return;
+        }
+        mBody = text.mid(iAssignment + 1).trimmed();
+    }
+    Compiler(*this, mBody).compile();
+}
+
+/*!
+ * \brief Evaluate the expression for several sets of variables
+ *
+ * Each variable is given by an array of values: the current values, keys and then the referenced objects
+ * in the order of references(). The result can be written over one of the variables.
+ */
+void Expression::evaluate(double const* const* variables, double* result, quint64 numValues) const
+{
+    if (!isValid() || mInstructions.empty())
+        return;
+    // Every level of the stack owns a batch to write results to, but it can also point to the values of a variable
+    std::vector<double> batches(mStackDepth * kBatchSize);
+    std::vector<double const*> stack(mStackDepth);
+    for (quint64 iStart = 0; iStart < numValues; iStart += kBatchSize)
+    {
+        int numBatchValues = (int)std::min<quint64>(kBatchSize, numValues - iStart);
+        int iTop = -1;
+        for (Instruction const& instruction : mInstructions)
+        {
+            double const* pFirst = iTop >= 0 ? stack[iTop] : nullptr;
+            double* pTop = iTop >= 0 ? &batches[iTop * kBatchSize] : nullptr;
+            double constant = 0.0;
+            switch (instruction.code)
+            {
+            case kPushConstant:
+                ++iTop;
+                pTop = &batches[iTop * kBatchSize];
+                std::fill_n(pTop, numBatchValues, mConstants[instruction.operand]);
+                stack[iTop] = pTop;
+                continue;
+            case kPushVariable:
+                ++iTop;
+                stack[iTop] = variables[instruction.operand] + iStart;
+                continue;
+            case kAddConstant:
+                constant = mConstants[instruction.operand];
+                transformBatch(pFirst, pTop, numBatchValues, [constant](double value) { return value + constant; });
+                break;
+            case kSubtractConstant:
+                constant = mConstants[instruction.operand];
+                transformBatch(pFirst, pTop, numBatchValues, [constant](double value) { return value - constant; });
+                break;
+            case kMultiplyConstant:
+                constant = mConstants[instruction.operand];
+                transformBatch(pFirst, pTop, numBatchValues, [constant](double value) { return value * constant; });
+                break;
+            case kDivideConstant:
+                constant = mConstants[instruction.operand];
+                transformBatch(pFirst, pTop, numBatchValues, [constant](double value) { return value / constant; });
+                break;
+            case kNegate:
+                transformBatch(pFirst, pTop, numBatchValues, [](double value) { return -value; });
+                break;
+            case kFunction:
+                transformBatch(pFirst, pTop, numBatchValues, skUnaryFunctions[instruction.operand].function);
+                break;
+            default:
+            {
+                // Operations of two arguments write to the batch of the first one
+                double const* pSecond = pFirst;
+                --iTop;
+                pFirst = stack[iTop];
+                pTop = &batches[iTop * kBatchSize];
+                switch (instruction.code)
+                {
+                case kAdd:
+                    transformBatch(pFirst, pSecond, pTop, numBatchValues, [](double a, double b) { return a + b; });
+                    break;
+                case kSubtract:
+                    transformBatch(pFirst, pSecond, pTop, numBatchValues, [](double a, double b) { return a - b; });
+                    break;
+                case kMultiply:
+                    transformBatch(pFirst, pSecond, pTop, numBatchValues, [](double a, double b) { return a * b; });
+                    break;
+                case kDivide:
+                    transformBatch(pFirst, pSecond, pTop, numBatchValues, [](double a, double b) { return a / b; });
+                    break;
+                default:
+                {
+                    quint8 code = instruction.code;
+                    transformBatch(pFirst, pSecond, pTop, numBatchValues,
+                                   [code](double a, double b) { return compute(code, 0, a, b); });
+                    break;
+                }
+                }
+                break;
+            }
+            }
+            stack[iTop] = pTop;
+        }
+        std::copy_n(stack[0], numBatchValues, result + iStart);
+    }
+}
+
+//! Interpolate items linearly at a key. Arrays of one value are spread over all the values of the target arrays
+static bool sampleItems(DataHolder const& items, DataKeyType key, quint32 size, double* pValues)
+{
+    if (items.empty())
+        return false;
+    auto iter = items.lower_bound(key);
+    DataItemType const* pFirstItem;
+    DataItemType const* pSecondItem = nullptr;
+    double weight = 0.0;
+    // Values are kept constant outside the range of keys
+    if (iter == items.end())
+    {
+        pFirstItem = &std::prev(iter)->second;
+    }
+    else if (iter->first == key || iter == items.begin())
+    {
+        pFirstItem = &iter->second;
+    }
+    else
+    {
+        auto iterPrevious = std::prev(iter);
+        pFirstItem = &iterPrevious->second;
+        pSecondItem = &iter->second;
+        weight = (key - iterPrevious->first) / (iter->first - iterPrevious->first);
+    }
+    quint32 itemSize = pFirstItem->size();
+    if ((itemSize != size && itemSize != 1) || (pSecondItem && pSecondItem->size() != itemSize))
+        return false;
+    double const* pFirst = pFirstItem->data();
+    if (!pSecondItem)
+    {
+        if (itemSize == 1)
+            std::fill_n(pValues, size, pFirst[0]);
+        else
+            std::copy_n(pFirst, size, pValues);
+        return true;
+    }
+    double const* pSecond = pSecondItem->data();
+    if (itemSize == 1)
+        std::fill_n(pValues, size, (1.0 - weight) * pFirst[0] + weight * pSecond[0]);
+    else
+        for (quint32 i = 0; i != size; ++i)
+            pValues[i] = (1.0 - weight) * pFirst[i] + weight * pSecond[i];
+    return true;
+}
+
+//! Substitute all the values of a data object, looking up the referenced objects by names among the given ones
+bool Expression::apply(AbstractDataObject& dataObject, DataObjects const& dataObjects, QString& errorMessage) const
+{
+    std::vector<AbstractDataObject*> foundReferences;
+    if (!resolveReferences(dataObjects, foundReferences, errorMessage))
+        return false;
+    // Derived objects are brought up to date before being sampled
+    for (AbstractDataObject* pReference : foundReferences)
+    {
+        if (!pReference->evaluate())
+        {
+            errorMessage = QString("Data object \"%1\" cannot be evaluated").arg(pReference->name());
+            return false;
+        }
+    }
+    std::vector<AbstractDataObject const*> references(foundReferences.begin(), foundReferences.end());
+    return apply(dataObject, references, errorMessage);
+}
+
+//! Find the data objects which the expression refers to in the order of references()
+bool Expression::resolveReferences(DataObjects const& dataObjects, std::vector<AbstractDataObject*>& references,
+                                   QString& errorMessage) const
+{
+    int numReferences = mReferences.size();
+    references.assign(numReferences, nullptr);
+    for (auto const& [id, pDataObject] : dataObjects)
+    {
+        int iReference = mReferences.indexOf(pDataObject->name());
+        if (iReference < 0)
+            continue;
+        if (references[iReference])
+        {
+            errorMessage = QString("Several data objects are named \"%1\"").arg(mReferences[iReference]);
+            return false;
+        }
+        references[iReference] = pDataObject;
+    }
+    for (int i = 0; i != numReferences; ++i)
+    {
+        if (!references[i])
+        {
+            errorMessage = QString("Data object \"%1\" is not found").arg(mReferences[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Substitute all the values of a data object with the results of the expression
+ *
+ * Referenced objects are given in the order of references(). Their arrays should have the same size as the ones
+ * of the transformed object or consist of a single value.
+ */
+bool Expression::apply(AbstractDataObject& dataObject, std::vector<AbstractDataObject const*> const& references,
+                       QString& errorMessage) const
+{
+    if (!apply(dataObject.mItems, dataObject.name(), references, errorMessage))
+        return false;
+    dataObject.markModified();
+    return true;
+}
+
+//! Substitute the values of items with the results of the expression. The name is used to report errors
+bool Expression::apply(DataHolder& items, QString const& name, std::vector<AbstractDataObject const*> const& references,
+                       QString& errorMessage) const
+{
+    if (!isValid())
+    {
+        errorMessage = mErrorMessage;
+        return false;
+    }
+    int numReferences = mReferences.size();
+    if ((int)references.size() != numReferences)
+    {
+        errorMessage = QString("Expression refers to %1 data objects, but %2 are given").arg(numReferences).arg(references.size());
+        return false;
+    }
+    // Gather the values of all the items
+    quint64 numValues = 0;
+    for (auto const& [key, item] : items)
+        numValues += item.size();
+    if (numValues == 0)
+        return true;
+    int numVariables = kNumBaseVariables + numReferences;
+    std::vector<std::vector<double>> values(numVariables, std::vector<double>(numValues));
+    quint64 iStart = 0;
+    for (auto& [key, item] : items)
+    {
+        quint32 size = item.size();
+        std::copy_n(item.data(), size, values[kValue].data() + iStart);
+        std::fill_n(values[kKey].data() + iStart, size, key);
+        for (int i = 0; i != numReferences; ++i)
+        {
+            if (!sampleItems(references[i]->mItems, key, size, values[kNumBaseVariables + i].data() + iStart))
+            {
+                errorMessage = QString("Sizes of the data objects \"%1\" and \"%2\" do not match")
+                                   .arg(name, mReferences[i]);
+                return false;
+            }
+        }
+        iStart += size;
+    }
+    // Evaluate over the current values and write them back
+    std::vector<double const*> variables(numVariables);
+    for (int i = 0; i != numVariables; ++i)
+        variables[i] = values[i].data();
+    double* pResult = values[kValue].data();
+    evaluate(variables.data(), pResult, numValues);
+    iStart = 0;
+    for (auto& [key, item] : items)
+    {
+        quint32 size = item.size();
+        std::copy_n(pResult + iStart, size, item.data());
+        iStart += size;
+    }
+    return true;
+}
+
+//! Compute the result of an instruction for a single set of arguments
+double Expression::compute(quint8 code, quint16 operand, double first, double second)
+{
+    switch (code)
+    {
+    case kAdd:
+        return first + second;
+    case kSubtract:
+        return first - second;
+    case kMultiply:
+        return first * second;
+    case kDivide:
+        return first / second;
+    case kPower:
+        return std::pow(first, second);
+    case kNegate:
+        return -first;
+    case kMinimum:
+        return std::min(first, second);
+    case kMaximum:
+        return std::max(first, second);
+    case kArcTangent2:
+        return std::atan2(first, second);
+    case kFunction:
+        return skUnaryFunctions[operand].function(first);
+    default:
+        return first;
+    }
+}
@@ -0,0 +1,101 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the Expression class
+ */
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <QString>
+#include <QStringList>
+#include <vector>
+#include "aliasdataset.h"
+#include "abstractdataobject.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Arithmetic expression which is evaluated over all the values of a data object at once
+ *
+ * The text is compiled into a compact stack bytecode. Values are processed in batches, so that every instruction
+ * is dispatched once per batch and its loop is vectorized by the compiler. Expressions can refer to the current value
+ * (x), the key of an item (key), other data objects by names in square brackets ([Young Modulus]),
+ * the constants pi and e, and the functions listed in the implementation file. Referenced objects are interpolated
+ * linearly at the keys of the transformed object. The text can start with an assignment ("EA = [E] * [A]"),
+ * which specifies the name of the resulting object.
+ */
+class Expression
+{
+public:
+    //! Number of values which every instruction processes at once
+    static int const kBatchSize = 256;
+    enum Variable
+    {
+        kValue,
+        kKey,
+        kNumBaseVariables
+    };
+    explicit Expression(QString const& text);
+    ~Expression() = default;
+    bool isValid() const { return mErrorMessage.isEmpty(); }
+    QString const& errorMessage() const { return mErrorMessage; }
+    QString const& target() const { return mTarget; }
+    //! Text of the expression without the assignment
+    QString const& body() const { return mBody; }
+    QStringList const& references() const { return mReferences; }
+    quint32 numberInstructions() const { return mInstructions.size(); }
+    void evaluate(double const* const* variables, double* result, quint64 numValues) const;
+    bool apply(AbstractDataObject& dataObject, DataObjects const& dataObjects, QString& errorMessage) const;
+    bool apply(AbstractDataObject& dataObject, std::vector<AbstractDataObject const*> const& references,
+               QString& errorMessage) const;
+    bool apply(DataHolder& items, QString const& name, std::vector<AbstractDataObject const*> const& references,
+               QString& errorMessage) const;
+    bool resolveReferences(DataObjects const& dataObjects, std::vector<AbstractDataObject*>& references,
+                           QString& errorMessage) const;
+
+private:
+    enum OpCode : quint8
+    {
+        kPushConstant,
+        kPushVariable,
+        kAdd,
+        kSubtract,
+        kMultiply,
+        kDivide,
+        kPower,
+        kAddConstant,
+        kSubtractConstant,
+        kMultiplyConstant,
+        kDivideConstant,
+        kNegate,
+        kMinimum,
+        kMaximum,
+        kArcTangent2,
+        kFunction
+    };
+    //! Instruction of the bytecode. The operand is an index of a constant, variable or function
+    struct Instruction
+    {
+        OpCode code;
+        quint16 operand;
+    };
+    class Compiler;
+    static double compute(quint8 code, quint16 operand, double first, double second);
+
+private:
+    QString mTarget;
+    QString mBody;
+    QStringList mReferences;
+    std::vector<Instruction> mInstructions;
+    std::vector<double> mConstants;
+    //! Maximum number of batches on the stack
+    int mStackDepth = 0;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // EXPRESSION_H
@@ -11,7 +11,7 @@
 
 using namespace QRS::Core;
 
-quint32 GeometryRodComponent::smNumInstances = 0;
+std::atomic<quint32> GeometryRodComponent::smNumInstances = 0;
 
 GeometryRodComponent::GeometryRodComponent(QString const& name)
     : AbstractRodComponent(kGeometry, name)
@@ -30,8 +30,9 @@ AbstractRodComponent* GeometryRodComponent::clone() const
 {
     GeometryRodComponent* pGeometry = new GeometryRodComponent(mName);
     pGeometry->mID = mID;
-    pGeometry->mpRadiusVector = mpRadiusVector;
-    pGeometry->mpRotationMatrix = mpRotationMatrix;
+    pGeometry->mReferences = mReferences;
+    pGeometry->mRadiusVector = mRadiusVector;
+    pGeometry->mRotationMatrix = mRotationMatrix;
     --smNumInstances;
     return pGeometry;
 }
@@ -42,27 +43,27 @@ void GeometryRodComponent::serialize(QDataStream& stream) const
     stream << (quint32)mkComponentType;
     stream << mName;
     stream << (DataIDType)mID;
-    writeDataObjectPointer(stream, mpRadiusVector);
-    writeDataObjectPointer(stream, mpRotationMatrix);
+    writeDataObjectPointer(stream, mRadiusVector);
+    writeDataObjectPointer(stream, mRotationMatrix);
 }
 
 //! Deserialize a geometrical component
 void GeometryRodComponent::deserialize(QDataStream& stream, DataObjects const& dataObjects)
 {
     stream >> mID;
-    mpRadiusVector = (VectorDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpRotationMatrix = (MatrixDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kRadiusVector, mRadiusVector, readDataObjectPointer(stream, dataObjects));
+    setReference(kRotationMatrix, mRotationMatrix, readDataObjectPointer(stream, dataObjects));
 }
 
 //! Resolve references of a geometrical rod component
 void GeometryRodComponent::resolveReferences(DataObjects const& dataObjects)
 {
-    mpRadiusVector = (VectorDataObject const*)substituteDataObject(dataObjects, mpRadiusVector);
-    mpRotationMatrix = (MatrixDataObject const*)substituteDataObject(dataObjects, mpRotationMatrix);
+    setReference(kRadiusVector, mRadiusVector, substituteDataObject(dataObjects, mRadiusVector));
+    setReference(kRotationMatrix, mRotationMatrix, substituteDataObject(dataObjects, mRotationMatrix));
 }
 
-//! Check whether the component data is complete
+//! Check whether the component data is complete. The rotation matrix is optional, since frames can be generated
 bool GeometryRodComponent::isDataComplete() const
 {
-    return mpRadiusVector && mpRotationMatrix;
+    return radiusVector();
 };
@@ -8,15 +8,13 @@
 #ifndef GEOMETRYRODCOMPONENT_H
 #define GEOMETRYRODCOMPONENT_H
 
-#include <QPointer>
 #include "abstractrodcomponent.h"
+#include "vectordataobject.h"
+#include "matrixdataobject.h"
 
 namespace QRS::Core
 {
 
-class VectorDataObject;
-class MatrixDataObject;
-
 //! Geometrical configuration of a rod
 class GeometryRodComponent : public AbstractRodComponent
 {
@@ -30,16 +28,22 @@ public:
     void deserialize(QDataStream& stream, DataObjects const& dataObjects) override;
     void resolveReferences(DataObjects const& dataObjects) override;
     // Getters
-    VectorDataObject const* radiusVector() const { return mpRadiusVector; }
-    MatrixDataObject const* rotationMatrix() const { return mpRotationMatrix; }
+    VectorDataObject const* radiusVector() const { return (VectorDataObject const*)resolveDataObject(mRadiusVector); }
+    MatrixDataObject const* rotationMatrix() const { return (MatrixDataObject const*)resolveDataObject(mRotationMatrix); }
     // Setters
-    void setRadiusVector(VectorDataObject const* pRadiusVector) { mpRadiusVector = pRadiusVector; }
-    void setRotationMatrix(MatrixDataObject const* pRotationMatrix) { mpRotationMatrix = pRotationMatrix; }
+    void setRadiusVector(VectorDataObject const* pRadiusVector) { setReference(kRadiusVector, mRadiusVector, pRadiusVector); }
+    void setRotationMatrix(MatrixDataObject const* pRotationMatrix) { setReference(kRotationMatrix, mRotationMatrix, pRotationMatrix); }
 
 private:
-    static quint32 smNumInstances;
-    QPointer<VectorDataObject const> mpRadiusVector;
-    QPointer<MatrixDataObject const> mpRotationMatrix;
+    //! Fields which refer to data objects
+    enum ReferenceField
+    {
+        kRadiusVector,
+        kRotationMatrix
+    };
+    static std::atomic<quint32> smNumInstances;
+    DataHandle mRadiusVector;
+    DataHandle mRotationMatrix;
 };
 
 }
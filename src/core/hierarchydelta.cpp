@@ -0,0 +1,168 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the HierarchyDelta class
+ */
+
+#include <unordered_set>
+#include "hierarchydelta.h"
+#include "hierarchytree.h"
+
+using namespace QRS::Core;
+
+HierarchyDelta::HierarchyDelta(HierarchyDelta&& another)
+    : mMoves(std::move(another.mMoves))
+    , mIndices(std::move(another.mIndices))
+    , mIsRecorded(another.mIsRecorded)
+    , mIsDone(another.mIsDone)
+{
+    another.mMoves.clear();
+    another.mIndices.clear();
+    another.mIsRecorded = false;
+    another.mIsDone = true;
+}
+
+HierarchyDelta& HierarchyDelta::operator=(HierarchyDelta&& another)
+{
+    if (this != &another)
+    {
+        release();
+        mMoves = std::move(another.mMoves);
+        mIndices = std::move(another.mIndices);
+        mIsRecorded = another.mIsRecorded;
+        mIsDone = another.mIsDone;
+        another.mMoves.clear();
+        another.mIndices.clear();
+        another.mIsRecorded = false;
+        another.mIsDone = true;
+    }
+    return *this;
+}
+
+HierarchyDelta::~HierarchyDelta()
+{
+    release();
+}
+
+//! Register the position of a node which is about to be moved. Only the first position of each node is kept
+void HierarchyDelta::recordBefore(HierarchyNode* pNode)
+{
+    if (!pNode || mIndices.contains(pNode))
+        return;
+    mIndices.emplace(pNode, mMoves.size());
+    Position current = position(pNode);
+    mMoves.push_back({pNode, current, current});
+}
+
+//! Register a node which has just been created, so that it is detached while the edit is undone
+void HierarchyDelta::recordCreated(HierarchyNode* pNode)
+{
+    if (!pNode || mIndices.contains(pNode))
+        return;
+    mIndices.emplace(pNode, mMoves.size());
+    mMoves.push_back({pNode, {nullptr, nullptr, QVariant()}, position(pNode)});
+}
+
+//! Register the current positions of all the nodes recorded. The nodes which have not been moved are forgotten
+void HierarchyDelta::recordAfter()
+{
+    std::vector<Move> moves;
+    moves.reserve(mMoves.size());
+    mIndices.clear();
+    for (Move& move : mMoves)
+    {
+        move.after = position(move.pNode);
+        if (move.after == move.before)
+            continue;
+        mIndices.emplace(move.pNode, moves.size());
+        moves.push_back(std::move(move));
+    }
+    mMoves.swap(moves);
+    mIsRecorded = true;
+    mIsDone = true;
+}
+
+//! Return the nodes to their positions before the edit
+void HierarchyDelta::undo()
+{
+    place(false);
+    mIsDone = false;
+}
+
+//! Return the nodes to their positions after the edit
+void HierarchyDelta::redo()
+{
+    place(true);
+    mIsDone = true;
+}
+
+//! Estimate the number of bytes occupied by the delta
+size_t HierarchyDelta::memorySize() const
+{
+    return sizeof(HierarchyDelta) + mMoves.capacity() * sizeof(Move)
+           + mIndices.size() * (sizeof(HierarchyNode*) + sizeof(size_t) + 2 * sizeof(void*));
+}
+
+//! Retrieve the current position of a node
+HierarchyDelta::Position HierarchyDelta::position(HierarchyNode* pNode)
+{
+    return {pNode->parent(), pNode->previousSibling(), pNode->value()};
+}
+
+/*!
+ * \brief Move all the recorded nodes to their positions either before or after the edit
+ *
+ * The nodes are detached first. Then a node is inserted as soon as its previous sibling is in place,
+ * so the order of siblings is restored regardless of the order in which the nodes were recorded.
+ */
+void HierarchyDelta::place(bool isAfter)
+{
+    for (Move& move : mMoves)
+        move.pNode->place(nullptr, nullptr);
+    std::unordered_set<HierarchyNode*> pendingNodes;
+    for (Move& move : mMoves)
+        pendingNodes.insert(move.pNode);
+    while (!pendingNodes.empty())
+    {
+        size_t numPendingNodes = pendingNodes.size();
+        for (Move& move : mMoves)
+        {
+            Position const& target = isAfter ? move.after : move.before;
+            if (!pendingNodes.contains(move.pNode) || pendingNodes.contains(target.pPrevious))
+                continue;
+            move.pNode->place(target.pParent, target.pPrevious);
+            move.pNode->value() = target.value;
+            pendingNodes.erase(move.pNode);
+        }
+        // Positions which refer to each other cannot be restored
+        if (pendingNodes.size() == numPendingNodes)
+            break;
+    }
+}
+
+//! Delete the nodes which are detached in the current state, since nobody else refers to them
+void HierarchyDelta::release()
+{
+    if (mIsRecorded)
+    {
+        std::unordered_set<HierarchyNode*> detachedNodes;
+        for (Move& move : mMoves)
+        {
+            Position const& current = mIsDone ? move.after : move.before;
+            if (!current.pParent)
+                detachedNodes.insert(move.pNode);
+        }
+        // The nodes are deleted along with their children, so the ones inside the others are skipped
+        for (HierarchyNode* pNode : detachedNodes)
+        {
+            HierarchyNode* pParent = pNode->parent();
+            while (pParent && !detachedNodes.contains(pParent))
+                pParent = pParent->parent();
+            if (!pParent)
+                HierarchyTree::removeNode(pNode);
+        }
+    }
+    mMoves.clear();
+    mIndices.clear();
+}
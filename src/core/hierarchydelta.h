@@ -0,0 +1,72 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the HierarchyDelta class
+ */
+
+#ifndef HIERARCHYDELTA_H
+#define HIERARCHYDELTA_H
+
+#include <vector>
+#include <unordered_map>
+#include "hierarchynode.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Moves of nodes of a hierarchy
+ *
+ * Positions of the nodes affected by an edit are recorded before and after it, so that the size of a delta
+ * is proportional to the number of nodes moved rather than to the size of the tree.
+ * Removed nodes are detached from the tree instead of being deleted. A delta owns the nodes which are detached
+ * in its current state and deletes them once it is destroyed.
+ */
+class HierarchyDelta
+{
+public:
+    HierarchyDelta() = default;
+    HierarchyDelta(HierarchyDelta const&) = delete;
+    HierarchyDelta(HierarchyDelta&& another);
+    HierarchyDelta& operator=(HierarchyDelta const&) = delete;
+    HierarchyDelta& operator=(HierarchyDelta&& another);
+    ~HierarchyDelta();
+    void recordBefore(HierarchyNode* pNode);
+    void recordCreated(HierarchyNode* pNode);
+    void recordAfter();
+    void undo();
+    void redo();
+    bool isEmpty() const { return mMoves.empty(); }
+    size_t memorySize() const;
+
+private:
+    //! Position of a node: a detached node has no parent
+    struct Position
+    {
+        HierarchyNode* pParent;
+        HierarchyNode* pPrevious;
+        QVariant value;
+        bool operator==(Position const& another) const = default;
+    };
+    struct Move
+    {
+        HierarchyNode* pNode;
+        Position before;
+        Position after;
+    };
+    static Position position(HierarchyNode* pNode);
+    void place(bool isAfter);
+    void release();
+
+private:
+    std::vector<Move> mMoves;
+    //! Indices of the moves by nodes
+    std::unordered_map<HierarchyNode*, size_t> mIndices;
+    bool mIsRecorded = false;
+    bool mIsDone = true;
+};
+
+}
+
+#endif // HIERARCHYDELTA_H
@@ -117,6 +117,33 @@ bool HierarchyNode::setAfter(HierarchyNode* pSetNode)
     return true;
 }
 
+/*!
+ * \brief Move the node to the specified position
+ *
+ * The node is inserted after the previous sibling if it is given, otherwise it becomes the first child of the parent.
+ * If the parent is not specified, the node is just excluded from the hierarchy.
+ */
+void HierarchyNode::place(HierarchyNode* pParent, HierarchyNode* pPrevious)
+{
+    excludeNodeFromHierarchy();
+    if (!pParent)
+        return;
+    mpParent = pParent;
+    if (pPrevious)
+    {
+        mpPreviousSibling = pPrevious;
+        mpNextSibling = pPrevious->mpNextSibling;
+        pPrevious->mpNextSibling = this;
+    }
+    else
+    {
+        mpNextSibling = pParent->mpFirstChild;
+        pParent->mpFirstChild = this;
+    }
+    if (mpNextSibling)
+        mpNextSibling->mpPreviousSibling = this;
+}
+
 //! Retrieve a number of children of the current node
 quint32 HierarchyNode::numberChildren() const
 {
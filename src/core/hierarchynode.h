@@ -34,11 +34,13 @@ public:
     HierarchyNode* parent() { return mpParent; }
     HierarchyNode* firstChild() { return mpFirstChild; }
     HierarchyNode* nextSibling() { return mpNextSibling; }
+    HierarchyNode* previousSibling() { return mpPreviousSibling; }
     NodeType type() const { return mType; }
     QVariant& value() { return mValue; }
     HierarchyNode* groupNodes(HierarchyNode* pChildNode);
     bool setBefore(HierarchyNode* pSetNode);
     bool setAfter(HierarchyNode* pSetNode);
+    void place(HierarchyNode* pParent, HierarchyNode* pPrevious);
     quint32 numberChildren() const;
 
 private:
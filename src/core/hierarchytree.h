@@ -29,7 +29,7 @@ public:
     void clear();
     void appendNode(HierarchyNode* pNode);
     bool removeNode(HierarchyNode::NodeType type, QVariant const& value);
-    void removeNode(HierarchyNode* pNode);
+    static void removeNode(HierarchyNode* pNode);
     void changeNodeValue(HierarchyNode::NodeType type, QVariant const& oldValue, QVariant const& newValue);
     HierarchyNode* root() { return mpRootNode; }
     HierarchyTree clone() const;
@@ -40,7 +40,7 @@ public:
 
 private:
     HierarchyNode* copyNode(HierarchyNode* pBaseNode, quint32 relativeLevel) const;
-    void removeNodeSiblings(HierarchyNode* pNode);
+    static void removeNodeSiblings(HierarchyNode* pNode);
     void printNode(quint32 level, HierarchyNode* pNode, QDebug stream) const;
     void writeNode(HierarchyNode* pNode, QDataStream& stream) const;
 
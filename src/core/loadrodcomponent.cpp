@@ -11,7 +11,7 @@
 
 using namespace QRS::Core;
 
-quint32 LoadRodComponent::smNumInstances = 0;
+std::atomic<quint32> LoadRodComponent::smNumInstances = 0;
 
 LoadRodComponent::LoadRodComponent(QString const& name)
     : AbstractRodComponent(kLoad, name)
@@ -30,11 +30,12 @@ AbstractRodComponent* LoadRodComponent::clone() const
 {
     LoadRodComponent* pLoad = new LoadRodComponent(mName);
     pLoad->mID = mID;
+    pLoad->mReferences = mReferences;
     pLoad->mLoadType = mLoadType;
-    pLoad->mpDirectionVector = mpDirectionVector;
-    pLoad->mpLongitudinalFunction = mpLongitudinalFunction;
-    pLoad->mpTimeCoefficient = mpTimeCoefficient;
-    pLoad->mpTimeRotationVector = mpTimeRotationVector;
+    pLoad->mDirectionVector = mDirectionVector;
+    pLoad->mLongitudinalFunction = mLongitudinalFunction;
+    pLoad->mTimeCoefficient = mTimeCoefficient;
+    pLoad->mTimeRotationVector = mTimeRotationVector;
     pLoad->mMultiplier = mMultiplier;
     pLoad->mIsFollowing = mIsFollowing;
     --smNumInstances;
@@ -48,10 +49,10 @@ void LoadRodComponent::serialize(QDataStream& stream) const
     stream << mName;
     stream << (DataIDType)mID;
     stream << mLoadType;
-    writeDataObjectPointer(stream, mpDirectionVector);
-    writeDataObjectPointer(stream, mpLongitudinalFunction);
-    writeDataObjectPointer(stream, mpTimeCoefficient);
-    writeDataObjectPointer(stream, mpTimeRotationVector);
+    writeDataObjectPointer(stream, mDirectionVector);
+    writeDataObjectPointer(stream, mLongitudinalFunction);
+    writeDataObjectPointer(stream, mTimeCoefficient);
+    writeDataObjectPointer(stream, mTimeRotationVector);
     stream << mMultiplier;
     stream << mIsFollowing;
 }
@@ -61,10 +62,10 @@ void LoadRodComponent::deserialize(QDataStream& stream, DataObjects const& dataO
 {
     stream >> mID;
     stream >> mLoadType;
-    mpDirectionVector = (VectorDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpLongitudinalFunction = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpTimeCoefficient = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpTimeRotationVector = (VectorDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kDirectionVector, mDirectionVector, readDataObjectPointer(stream, dataObjects));
+    setReference(kLongitudinalFunction, mLongitudinalFunction, readDataObjectPointer(stream, dataObjects));
+    setReference(kTimeCoefficient, mTimeCoefficient, readDataObjectPointer(stream, dataObjects));
+    setReference(kTimeRotationVector, mTimeRotationVector, readDataObjectPointer(stream, dataObjects));
     stream >> mMultiplier;
     stream >> mIsFollowing;
 }
@@ -72,14 +73,14 @@ void LoadRodComponent::deserialize(QDataStream& stream, DataObjects const& dataO
 //! Resolve references of a rod load
 void LoadRodComponent::resolveReferences(DataObjects const& dataObjects)
 {
-    mpDirectionVector = (VectorDataObject const*)substituteDataObject(dataObjects, mpDirectionVector);
-    mpLongitudinalFunction = (ScalarDataObject const*)substituteDataObject(dataObjects, mpLongitudinalFunction);
-    mpTimeCoefficient = (ScalarDataObject const*)substituteDataObject(dataObjects, mpTimeCoefficient);
-    mpTimeRotationVector = (VectorDataObject const*)substituteDataObject(dataObjects, mpTimeRotationVector);
+    setReference(kDirectionVector, mDirectionVector, substituteDataObject(dataObjects, mDirectionVector));
+    setReference(kLongitudinalFunction, mLongitudinalFunction, substituteDataObject(dataObjects, mLongitudinalFunction));
+    setReference(kTimeCoefficient, mTimeCoefficient, substituteDataObject(dataObjects, mTimeCoefficient));
+    setReference(kTimeRotationVector, mTimeRotationVector, substituteDataObject(dataObjects, mTimeRotationVector));
 }
 
 //! Check whether the component data is complete
 bool LoadRodComponent::isDataComplete() const
 {
-    return mLoadType != kNone && mpDirectionVector;
+    return mLoadType != kNone && directionVector();
 }
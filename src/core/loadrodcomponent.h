@@ -8,15 +8,13 @@
 #ifndef LOADRODCOMPONENT_H
 #define LOADRODCOMPONENT_H
 
-#include <QPointer>
 #include "abstractrodcomponent.h"
+#include "scalardataobject.h"
+#include "vectordataobject.h"
 
 namespace QRS::Core
 {
 
-class ScalarDataObject;
-class VectorDataObject;
-
 //! Load applied to a rod
 class LoadRodComponent : public AbstractRodComponent
 {
@@ -44,28 +42,36 @@ public:
     void resolveReferences(DataObjects const& dataObjects) override;
     // Getters
     LoadType loadType() const { return mLoadType; }
-    VectorDataObject const* directionVector() const { return mpDirectionVector; }
-    ScalarDataObject const* longitudinalFunction() const { return mpLongitudinalFunction; }
-    ScalarDataObject const* timeCoefficient() const { return mpTimeCoefficient; }
-    VectorDataObject const* timeRotationVector() const { return mpTimeRotationVector; }
+    VectorDataObject const* directionVector() const { return (VectorDataObject const*)resolveDataObject(mDirectionVector); }
+    ScalarDataObject const* longitudinalFunction() const { return (ScalarDataObject const*)resolveDataObject(mLongitudinalFunction); }
+    ScalarDataObject const* timeCoefficient() const { return (ScalarDataObject const*)resolveDataObject(mTimeCoefficient); }
+    VectorDataObject const* timeRotationVector() const { return (VectorDataObject const*)resolveDataObject(mTimeRotationVector); }
     DataValueType multiplier() const { return mMultiplier; }
     bool isFollowing() const { return mIsFollowing; }
     // Setters
     void setType(LoadType type) { mLoadType = type; }
-    void setDirectionVector(VectorDataObject const* pDirectionVector) { mpDirectionVector = pDirectionVector; }
-    void setLongitudinalFunction(ScalarDataObject const* pLongitudinalFunction) { mpLongitudinalFunction = pLongitudinalFunction; }
-    void setTimeCoefficient(ScalarDataObject const* pTimeCoefficient) { mpTimeCoefficient = pTimeCoefficient; }
-    void setTimeRotationVector(VectorDataObject const* pTimeRotationVector) { mpTimeRotationVector = pTimeRotationVector; }
+    void setDirectionVector(VectorDataObject const* pDirectionVector) { setReference(kDirectionVector, mDirectionVector, pDirectionVector); }
+    void setLongitudinalFunction(ScalarDataObject const* pLongitudinalFunction) { setReference(kLongitudinalFunction, mLongitudinalFunction, pLongitudinalFunction); }
+    void setTimeCoefficient(ScalarDataObject const* pTimeCoefficient) { setReference(kTimeCoefficient, mTimeCoefficient, pTimeCoefficient); }
+    void setTimeRotationVector(VectorDataObject const* pTimeRotationVector) { setReference(kTimeRotationVector, mTimeRotationVector, pTimeRotationVector); }
     void setMultiplier(DataValueType value) { mMultiplier = value; }
     void setFollowingState(bool isFollowing) { mIsFollowing = isFollowing; }
 
 private:
-    static quint32 smNumInstances;
+    //! Fields which refer to data objects
+    enum ReferenceField
+    {
+        kDirectionVector,
+        kLongitudinalFunction,
+        kTimeCoefficient,
+        kTimeRotationVector
+    };
+    static std::atomic<quint32> smNumInstances;
     LoadType mLoadType = kNone;
-    QPointer<VectorDataObject const> mpDirectionVector;
-    QPointer<ScalarDataObject const> mpLongitudinalFunction;
-    QPointer<ScalarDataObject const> mpTimeCoefficient;
-    QPointer<VectorDataObject const> mpTimeRotationVector;
+    DataHandle mDirectionVector;
+    DataHandle mLongitudinalFunction;
+    DataHandle mTimeCoefficient;
+    DataHandle mTimeRotationVector;
     DataValueType mMultiplier = 1.0;
     bool mIsFollowing = false;
 };
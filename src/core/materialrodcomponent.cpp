@@ -10,7 +10,7 @@
 
 using namespace QRS::Core;
 
-quint32 MaterialRodComponent::smNumInstances = 0;
+std::atomic<quint32> MaterialRodComponent::smNumInstances = 0;
 
 MaterialRodComponent::MaterialRodComponent(QString const& name)
     : AbstractRodComponent(kMaterial, name)
@@ -29,10 +29,11 @@ AbstractRodComponent* MaterialRodComponent::clone() const
 {
     MaterialRodComponent* pMaterial = new MaterialRodComponent(mName);
     pMaterial->mID = mID;
-    pMaterial->mpElasticModulus = mpElasticModulus;
-    pMaterial->mpShearModulus = mpShearModulus;
-    pMaterial->mpPoissonsRatio = mpPoissonsRatio;
-    pMaterial->mpDensity = mpDensity;
+    pMaterial->mReferences = mReferences;
+    pMaterial->mElasticModulus = mElasticModulus;
+    pMaterial->mShearModulus = mShearModulus;
+    pMaterial->mPoissonsRatio = mPoissonsRatio;
+    pMaterial->mDensity = mDensity;
     --smNumInstances;
     return pMaterial;
 }
@@ -43,33 +44,33 @@ void MaterialRodComponent::serialize(QDataStream& stream) const
     stream << (quint32)mkComponentType;
     stream << mName;
     stream << (DataIDType)mID;
-    writeDataObjectPointer(stream, mpElasticModulus);
-    writeDataObjectPointer(stream, mpShearModulus);
-    writeDataObjectPointer(stream, mpPoissonsRatio);
-    writeDataObjectPointer(stream, mpDensity);
+    writeDataObjectPointer(stream, mElasticModulus);
+    writeDataObjectPointer(stream, mShearModulus);
+    writeDataObjectPointer(stream, mPoissonsRatio);
+    writeDataObjectPointer(stream, mDensity);
 }
 
 //! Deserialize a material component
 void MaterialRodComponent::deserialize(QDataStream& stream, DataObjects const& dataObjects)
 {
     stream >> mID;
-    mpElasticModulus = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpShearModulus = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpPoissonsRatio = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpDensity = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kElasticModulus, mElasticModulus, readDataObjectPointer(stream, dataObjects));
+    setReference(kShearModulus, mShearModulus, readDataObjectPointer(stream, dataObjects));
+    setReference(kPoissonsRatio, mPoissonsRatio, readDataObjectPointer(stream, dataObjects));
+    setReference(kDensity, mDensity, readDataObjectPointer(stream, dataObjects));
 }
 
 //! Resolve references of a material rod component
 void MaterialRodComponent::resolveReferences(DataObjects const& dataObjects)
 {
-    mpElasticModulus = (ScalarDataObject const*)substituteDataObject(dataObjects, mpElasticModulus);
-    mpShearModulus = (ScalarDataObject const*)substituteDataObject(dataObjects, mpShearModulus);
-    mpPoissonsRatio = (ScalarDataObject const*)substituteDataObject(dataObjects, mpPoissonsRatio);
-    mpDensity = (ScalarDataObject const*)substituteDataObject(dataObjects, mpDensity);
+    setReference(kElasticModulus, mElasticModulus, substituteDataObject(dataObjects, mElasticModulus));
+    setReference(kShearModulus, mShearModulus, substituteDataObject(dataObjects, mShearModulus));
+    setReference(kPoissonsRatio, mPoissonsRatio, substituteDataObject(dataObjects, mPoissonsRatio));
+    setReference(kDensity, mDensity, substituteDataObject(dataObjects, mDensity));
 }
 
 //! Check whether the component data is complete
 bool MaterialRodComponent::isDataComplete() const
 {
-    return mpElasticModulus && mpPoissonsRatio;
+    return elasticModulus() && poissonsRatio();
 }
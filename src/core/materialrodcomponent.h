@@ -8,14 +8,12 @@
 #ifndef MATERIALRODCOMPONENT_H
 #define MATERIALRODCOMPONENT_H
 
-#include <QPointer>
 #include "abstractrodcomponent.h"
+#include "scalardataobject.h"
 
 namespace QRS::Core
 {
 
-class ScalarDataObject;
-
 //! Material properties of a rod
 class MaterialRodComponent : public AbstractRodComponent
 {
@@ -29,22 +27,30 @@ public:
     void deserialize(QDataStream& stream, DataObjects const& dataObjects) override;
     void resolveReferences(DataObjects const& dataObjects) override;
     // Getters
-    ScalarDataObject const* elasticModulus() const { return mpElasticModulus; }
-    ScalarDataObject const* shearModulus() const { return mpShearModulus; }
-    ScalarDataObject const* poissonsRatio() const { return mpPoissonsRatio; }
-    ScalarDataObject const* density() const { return mpDensity; }
+    ScalarDataObject const* elasticModulus() const { return (ScalarDataObject const*)resolveDataObject(mElasticModulus); }
+    ScalarDataObject const* shearModulus() const { return (ScalarDataObject const*)resolveDataObject(mShearModulus); }
+    ScalarDataObject const* poissonsRatio() const { return (ScalarDataObject const*)resolveDataObject(mPoissonsRatio); }
+    ScalarDataObject const* density() const { return (ScalarDataObject const*)resolveDataObject(mDensity); }
     // Setters
-    void setElasticModulus(ScalarDataObject const* pElasticModulus) { mpElasticModulus = pElasticModulus; }
-    void setShearModulus(ScalarDataObject const* pShearModulus) { mpShearModulus = pShearModulus; }
-    void setPoissonsRatio(ScalarDataObject const* pPoissonsRatio) { mpPoissonsRatio = pPoissonsRatio; }
-    void setDensity(ScalarDataObject const* pDensity) { mpDensity = pDensity; }
+    void setElasticModulus(ScalarDataObject const* pElasticModulus) { setReference(kElasticModulus, mElasticModulus, pElasticModulus); }
+    void setShearModulus(ScalarDataObject const* pShearModulus) { setReference(kShearModulus, mShearModulus, pShearModulus); }
+    void setPoissonsRatio(ScalarDataObject const* pPoissonsRatio) { setReference(kPoissonsRatio, mPoissonsRatio, pPoissonsRatio); }
+    void setDensity(ScalarDataObject const* pDensity) { setReference(kDensity, mDensity, pDensity); }
 
 private:
-    static quint32 smNumInstances;
-    QPointer<ScalarDataObject const> mpElasticModulus;
-    QPointer<ScalarDataObject const> mpShearModulus;
-    QPointer<ScalarDataObject const> mpPoissonsRatio;
-    QPointer<ScalarDataObject const> mpDensity;
+    //! Fields which refer to data objects
+    enum ReferenceField
+    {
+        kElasticModulus,
+        kShearModulus,
+        kPoissonsRatio,
+        kDensity
+    };
+    static std::atomic<quint32> smNumInstances;
+    DataHandle mElasticModulus;
+    DataHandle mShearModulus;
+    DataHandle mPoissonsRatio;
+    DataHandle mDensity;
 };
 
 }
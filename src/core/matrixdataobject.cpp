@@ -9,7 +9,7 @@
 
 using namespace QRS::Core;
 
-quint32 MatrixDataObject::smNumInstances = 0;
+std::atomic<quint32> MatrixDataObject::smNumInstances = 0;
 const IndexType skNumElements = 3;
 
 //! Construct a matrix data object
@@ -30,15 +30,17 @@ DataItemType& MatrixDataObject::addItem(DataValueType key)
 {
     DataValueType rightKey = getAvailableItemKey(key);
     mItems.emplace(rightKey, DataItemType(skNumElements, skNumElements));
+    markModified();
     return mItems.at(rightKey);
 }
 
 //! Clone a matrix data object
 AbstractDataObject* MatrixDataObject::clone() const
 {
-    MatrixDataObject* obj = new MatrixDataObject(mName);
+    MatrixDataObject* obj = new MatrixDataObject(name());
     obj->mItems = mItems;
     obj->mID = mID;
+    obj->mVersion = mVersion;
     --smNumInstances;
     return obj;
 }
@@ -10,7 +10,7 @@
 
 using namespace QRS::Core;
 
-quint32 MechanicalRodComponent::smNumInstances = 0;
+std::atomic<quint32> MechanicalRodComponent::smNumInstances = 0;
 
 MechanicalRodComponent::MechanicalRodComponent(QString const& name)
     : AbstractRodComponent(kMechanical, name)
@@ -29,21 +29,22 @@ AbstractRodComponent* MechanicalRodComponent::clone() const
 {
     MechanicalRodComponent* pMechanical = new MechanicalRodComponent(mName);
     pMechanical->mID = mID;
+    pMechanical->mReferences = mReferences;
     // Stiffness distribution
-    pMechanical->mpTensionStiffness   = mpTensionStiffness;
-    pMechanical->mpTorsionalStiffness = mpTorsionalStiffness;
-    pMechanical->mpBendingStiffnessX  = mpBendingStiffnessX;
-    pMechanical->mpBendingStiffnessY  = mpBendingStiffnessY;
+    pMechanical->mTensionStiffness   = mTensionStiffness;
+    pMechanical->mTorsionalStiffness = mTorsionalStiffness;
+    pMechanical->mBendingStiffnessX  = mBendingStiffnessX;
+    pMechanical->mBendingStiffnessY  = mBendingStiffnessY;
     // Mass distribution
-    pMechanical->mpLinearMassDensity  = mpLinearMassDensity;
-    pMechanical->mpInertiaMassMomentX = mpInertiaMassMomentX;
-    pMechanical->mpInertiaMassMomentY = mpInertiaMassMomentY;
-    pMechanical->mpInertiaMassMomentZ = mpInertiaMassMomentZ;
+    pMechanical->mLinearMassDensity  = mLinearMassDensity;
+    pMechanical->mInertiaMassMomentX = mInertiaMassMomentX;
+    pMechanical->mInertiaMassMomentY = mInertiaMassMomentY;
+    pMechanical->mInertiaMassMomentZ = mInertiaMassMomentZ;
     // Eccentricity
-    pMechanical->mpEccentricityX = mpEccentricityX;
-    pMechanical->mpEccentricityY = mpEccentricityY;
+    pMechanical->mEccentricityX = mEccentricityX;
+    pMechanical->mEccentricityY = mEccentricityY;
     // Contact diameter
-    pMechanical->mpContactDiameter = mpContactDiameter;
+    pMechanical->mContactDiameter = mContactDiameter;
     --smNumInstances;
     return pMechanical;
 }
@@ -55,20 +56,20 @@ void MechanicalRodComponent::serialize(QDataStream& stream) const
     stream << mName;
     stream << (DataIDType)mID;
     // Stiffness distribution
-    writeDataObjectPointer(stream, mpTensionStiffness);
-    writeDataObjectPointer(stream, mpTorsionalStiffness);
-    writeDataObjectPointer(stream, mpBendingStiffnessX);
-    writeDataObjectPointer(stream, mpBendingStiffnessY);
+    writeDataObjectPointer(stream, mTensionStiffness);
+    writeDataObjectPointer(stream, mTorsionalStiffness);
+    writeDataObjectPointer(stream, mBendingStiffnessX);
+    writeDataObjectPointer(stream, mBendingStiffnessY);
     // Mass distribution
-    writeDataObjectPointer(stream, mpLinearMassDensity);
-    writeDataObjectPointer(stream, mpInertiaMassMomentX);
-    writeDataObjectPointer(stream, mpInertiaMassMomentY);
-    writeDataObjectPointer(stream, mpInertiaMassMomentZ);
+    writeDataObjectPointer(stream, mLinearMassDensity);
+    writeDataObjectPointer(stream, mInertiaMassMomentX);
+    writeDataObjectPointer(stream, mInertiaMassMomentY);
+    writeDataObjectPointer(stream, mInertiaMassMomentZ);
     // Eccentricity
-    writeDataObjectPointer(stream, mpEccentricityX);
-    writeDataObjectPointer(stream, mpEccentricityY);
+    writeDataObjectPointer(stream, mEccentricityX);
+    writeDataObjectPointer(stream, mEccentricityY);
     // Contact diameter
-    writeDataObjectPointer(stream, mpContactDiameter);
+    writeDataObjectPointer(stream, mContactDiameter);
 }
 
 //! Deserialize a geometrical component
@@ -76,38 +77,38 @@ void MechanicalRodComponent::deserialize(QDataStream& stream, DataObjects const&
 {
     stream >> mID;
     // Stiffness distribution
-    mpTensionStiffness   = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpTorsionalStiffness = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpBendingStiffnessX  = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpBendingStiffnessY  = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kTensionStiffness, mTensionStiffness, readDataObjectPointer(stream, dataObjects));
+    setReference(kTorsionalStiffness, mTorsionalStiffness, readDataObjectPointer(stream, dataObjects));
+    setReference(kBendingStiffnessX, mBendingStiffnessX, readDataObjectPointer(stream, dataObjects));
+    setReference(kBendingStiffnessY, mBendingStiffnessY, readDataObjectPointer(stream, dataObjects));
     // Mass distribution
-    mpLinearMassDensity  = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpInertiaMassMomentX = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpInertiaMassMomentY = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpInertiaMassMomentZ = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kLinearMassDensity, mLinearMassDensity, readDataObjectPointer(stream, dataObjects));
+    setReference(kInertiaMassMomentX, mInertiaMassMomentX, readDataObjectPointer(stream, dataObjects));
+    setReference(kInertiaMassMomentY, mInertiaMassMomentY, readDataObjectPointer(stream, dataObjects));
+    setReference(kInertiaMassMomentZ, mInertiaMassMomentZ, readDataObjectPointer(stream, dataObjects));
     // Eccentricity
-    mpEccentricityX = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
-    mpEccentricityY = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kEccentricityX, mEccentricityX, readDataObjectPointer(stream, dataObjects));
+    setReference(kEccentricityY, mEccentricityY, readDataObjectPointer(stream, dataObjects));
     // Contact diameter
-    mpContactDiameter = (ScalarDataObject const*)readDataObjectPointer(stream, dataObjects);
+    setReference(kContactDiameter, mContactDiameter, readDataObjectPointer(stream, dataObjects));
 }
 
 //! Resolve references of a geometrical rod component
 void MechanicalRodComponent::resolveReferences(DataObjects const& dataObjects)
 {
     // Stiffness distribution
-    mpTensionStiffness = (ScalarDataObject const*)substituteDataObject(dataObjects, mpTensionStiffness);
-    mpTorsionalStiffness = (ScalarDataObject const*)substituteDataObject(dataObjects, mpTorsionalStiffness);
-    mpBendingStiffnessX = (ScalarDataObject const*)substituteDataObject(dataObjects, mpBendingStiffnessX);
-    mpBendingStiffnessY = (ScalarDataObject const*)substituteDataObject(dataObjects, mpBendingStiffnessY);
+    setReference(kTensionStiffness, mTensionStiffness, substituteDataObject(dataObjects, mTensionStiffness));
+    setReference(kTorsionalStiffness, mTorsionalStiffness, substituteDataObject(dataObjects, mTorsionalStiffness));
+    setReference(kBendingStiffnessX, mBendingStiffnessX, substituteDataObject(dataObjects, mBendingStiffnessX));
+    setReference(kBendingStiffnessY, mBendingStiffnessY, substituteDataObject(dataObjects, mBendingStiffnessY));
     // Mass distribution
-    mpLinearMassDensity = (ScalarDataObject const*)substituteDataObject(dataObjects, mpLinearMassDensity);
-    mpInertiaMassMomentX = (ScalarDataObject const*)substituteDataObject(dataObjects, mpInertiaMassMomentX);
-    mpInertiaMassMomentY = (ScalarDataObject const*)substituteDataObject(dataObjects, mpInertiaMassMomentY);
-    mpInertiaMassMomentZ = (ScalarDataObject const*)substituteDataObject(dataObjects, mpInertiaMassMomentZ);
+    setReference(kLinearMassDensity, mLinearMassDensity, substituteDataObject(dataObjects, mLinearMassDensity));
+    setReference(kInertiaMassMomentX, mInertiaMassMomentX, substituteDataObject(dataObjects, mInertiaMassMomentX));
+    setReference(kInertiaMassMomentY, mInertiaMassMomentY, substituteDataObject(dataObjects, mInertiaMassMomentY));
+    setReference(kInertiaMassMomentZ, mInertiaMassMomentZ, substituteDataObject(dataObjects, mInertiaMassMomentZ));
     // Eccentricity
-    mpEccentricityX = (ScalarDataObject const*)substituteDataObject(dataObjects, mpEccentricityX);
-    mpEccentricityY = (ScalarDataObject const*)substituteDataObject(dataObjects, mpEccentricityY);
+    setReference(kEccentricityX, mEccentricityX, substituteDataObject(dataObjects, mEccentricityX));
+    setReference(kEccentricityY, mEccentricityY, substituteDataObject(dataObjects, mEccentricityY));
     // Contact diameter
-    mpContactDiameter = (ScalarDataObject const*)substituteDataObject(dataObjects, mpContactDiameter);
+    setReference(kContactDiameter, mContactDiameter, substituteDataObject(dataObjects, mContactDiameter));
 }
@@ -8,14 +8,12 @@
 #ifndef MECHANICALRODCOMPONENT_H
 #define MECHANICALRODCOMPONENT_H
 
-#include <QPointer>
 #include "abstractrodcomponent.h"
+#include "scalardataobject.h"
 
 namespace QRS::Core
 {
 
-class ScalarDataObject;
-
 //! Stiffness and mass distributions of a rod
 class MechanicalRodComponent : public AbstractRodComponent
 {
@@ -30,54 +28,69 @@ public:
     void resolveReferences(DataObjects const& dataObjects) override;
     // Getters
     // Stiffness distribution
-    ScalarDataObject const* tensionStiffness() const { return mpTensionStiffness; }
-    ScalarDataObject const* torsionalStiffness() const { return mpTorsionalStiffness; }
-    ScalarDataObject const* bendingStiffnessX() const { return mpBendingStiffnessX; }
-    ScalarDataObject const* bendingStiffnessY() const { return mpBendingStiffnessY; }
+    ScalarDataObject const* tensionStiffness() const { return (ScalarDataObject const*)resolveDataObject(mTensionStiffness); }
+    ScalarDataObject const* torsionalStiffness() const { return (ScalarDataObject const*)resolveDataObject(mTorsionalStiffness); }
+    ScalarDataObject const* bendingStiffnessX() const { return (ScalarDataObject const*)resolveDataObject(mBendingStiffnessX); }
+    ScalarDataObject const* bendingStiffnessY() const { return (ScalarDataObject const*)resolveDataObject(mBendingStiffnessY); }
     // Mass distribution
-    ScalarDataObject const* linearMassDensity() const { return mpLinearMassDensity; }
-    ScalarDataObject const* inertiaMassMomentX() const { return mpInertiaMassMomentX; }
-    ScalarDataObject const* inertiaMassMomentY() const { return mpInertiaMassMomentY; }
-    ScalarDataObject const* inertiaMassMomentZ() const { return mpInertiaMassMomentZ; }
+    ScalarDataObject const* linearMassDensity() const { return (ScalarDataObject const*)resolveDataObject(mLinearMassDensity); }
+    ScalarDataObject const* inertiaMassMomentX() const { return (ScalarDataObject const*)resolveDataObject(mInertiaMassMomentX); }
+    ScalarDataObject const* inertiaMassMomentY() const { return (ScalarDataObject const*)resolveDataObject(mInertiaMassMomentY); }
+    ScalarDataObject const* inertiaMassMomentZ() const { return (ScalarDataObject const*)resolveDataObject(mInertiaMassMomentZ); }
     // Eccentricity
-    ScalarDataObject const* eccentricityX() const { return mpEccentricityX; }
-    ScalarDataObject const* eccentricityY() const { return mpEccentricityY; }
+    ScalarDataObject const* eccentricityX() const { return (ScalarDataObject const*)resolveDataObject(mEccentricityX); }
+    ScalarDataObject const* eccentricityY() const { return (ScalarDataObject const*)resolveDataObject(mEccentricityY); }
     // Contact diameter
-    ScalarDataObject const* contactDiameter() const { return mpContactDiameter; }
+    ScalarDataObject const* contactDiameter() const { return (ScalarDataObject const*)resolveDataObject(mContactDiameter); }
     // Setters
     // Stiffness distribution
-    void setTensionStiffness(ScalarDataObject const* pTensionStiffness) { mpTensionStiffness = pTensionStiffness; }
-    void setTorsionalStiffness(ScalarDataObject const* pTorsionalStiffness) { mpTorsionalStiffness = pTorsionalStiffness; }
-    void setBendingStiffnessX(ScalarDataObject const* pBendingStiffnessX) { mpBendingStiffnessX = pBendingStiffnessX; }
-    void setBendingStiffnessY(ScalarDataObject const* pBendingStiffnessY) { mpBendingStiffnessY = pBendingStiffnessY; }
+    void setTensionStiffness(ScalarDataObject const* pTensionStiffness) { setReference(kTensionStiffness, mTensionStiffness, pTensionStiffness); }
+    void setTorsionalStiffness(ScalarDataObject const* pTorsionalStiffness) { setReference(kTorsionalStiffness, mTorsionalStiffness, pTorsionalStiffness); }
+    void setBendingStiffnessX(ScalarDataObject const* pBendingStiffnessX) { setReference(kBendingStiffnessX, mBendingStiffnessX, pBendingStiffnessX); }
+    void setBendingStiffnessY(ScalarDataObject const* pBendingStiffnessY) { setReference(kBendingStiffnessY, mBendingStiffnessY, pBendingStiffnessY); }
     // Mass distribution
-    void setLinearMassDensity(ScalarDataObject const* pLinearMassDensity) { mpLinearMassDensity = pLinearMassDensity; }
-    void setInertiaMassMomentX(ScalarDataObject const* pInertiaMassMomentX) { mpInertiaMassMomentX = pInertiaMassMomentX; }
-    void setInertiaMassMomentY(ScalarDataObject const* pInertiaMassMomentY) { mpInertiaMassMomentY = pInertiaMassMomentY; }
-    void setInertiaMassMomentZ(ScalarDataObject const* pInertiaMassMomentZ) { mpInertiaMassMomentZ = pInertiaMassMomentZ; }
+    void setLinearMassDensity(ScalarDataObject const* pLinearMassDensity) { setReference(kLinearMassDensity, mLinearMassDensity, pLinearMassDensity); }
+    void setInertiaMassMomentX(ScalarDataObject const* pInertiaMassMomentX) { setReference(kInertiaMassMomentX, mInertiaMassMomentX, pInertiaMassMomentX); }
+    void setInertiaMassMomentY(ScalarDataObject const* pInertiaMassMomentY) { setReference(kInertiaMassMomentY, mInertiaMassMomentY, pInertiaMassMomentY); }
+    void setInertiaMassMomentZ(ScalarDataObject const* pInertiaMassMomentZ) { setReference(kInertiaMassMomentZ, mInertiaMassMomentZ, pInertiaMassMomentZ); }
     // Eccentricity
-    void setEccentricityX(ScalarDataObject const* pEccentricityX) { mpEccentricityX = pEccentricityX; }
-    void setEccentricityY(ScalarDataObject const* pEccentricityY) { mpEccentricityY = pEccentricityY; }
+    void setEccentricityX(ScalarDataObject const* pEccentricityX) { setReference(kEccentricityX, mEccentricityX, pEccentricityX); }
+    void setEccentricityY(ScalarDataObject const* pEccentricityY) { setReference(kEccentricityY, mEccentricityY, pEccentricityY); }
     // Contact diameter
-    void setContactDiameter(ScalarDataObject const* pContactDiameter) { mpContactDiameter = pContactDiameter; }
+    void setContactDiameter(ScalarDataObject const* pContactDiameter) { setReference(kContactDiameter, mContactDiameter, pContactDiameter); }
 
 private:
-    static quint32 smNumInstances;
+    //! Fields which refer to data objects
+    enum ReferenceField
+    {
+        kTensionStiffness,
+        kTorsionalStiffness,
+        kBendingStiffnessX,
+        kBendingStiffnessY,
+        kLinearMassDensity,
+        kInertiaMassMomentX,
+        kInertiaMassMomentY,
+        kInertiaMassMomentZ,
+        kEccentricityX,
+        kEccentricityY,
+        kContactDiameter
+    };
+    static std::atomic<quint32> smNumInstances;
     // Stiffness distribution
-    QPointer<ScalarDataObject const> mpTensionStiffness;
-    QPointer<ScalarDataObject const> mpTorsionalStiffness;
-    QPointer<ScalarDataObject const> mpBendingStiffnessX;
-    QPointer<ScalarDataObject const> mpBendingStiffnessY;
+    DataHandle mTensionStiffness;
+    DataHandle mTorsionalStiffness;
+    DataHandle mBendingStiffnessX;
+    DataHandle mBendingStiffnessY;
     // Mass distribution
-    QPointer<ScalarDataObject const> mpLinearMassDensity;
-    QPointer<ScalarDataObject const> mpInertiaMassMomentX;
-    QPointer<ScalarDataObject const> mpInertiaMassMomentY;
-    QPointer<ScalarDataObject const> mpInertiaMassMomentZ;
+    DataHandle mLinearMassDensity;
+    DataHandle mInertiaMassMomentX;
+    DataHandle mInertiaMassMomentY;
+    DataHandle mInertiaMassMomentZ;
     // Eccentricity
-    QPointer<ScalarDataObject const> mpEccentricityX;
-    QPointer<ScalarDataObject const> mpEccentricityY;
+    DataHandle mEccentricityX;
+    DataHandle mEccentricityY;
     // Contact diameter
-    QPointer<ScalarDataObject const> mpContactDiameter;
+    DataHandle mContactDiameter;
 };
 
 }
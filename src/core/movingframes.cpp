@@ -0,0 +1,298 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the MovingFrames class
+ */
+
+#include <QThreadPool>
+#include <algorithm>
+#include <cmath>
+#include "movingframes.h"
+#include "tasks.h"
+#include "matrixdataobject.h"
+
+using namespace QRS::Core;
+
+//! Minimal number of stations which is worth distributing between threads
+quint32 const skMinParallelStations = 1u << 12;
+//! Number of chunks of stations per thread to balance the work
+int const skNumChunksPerThread = 2;
+//! Sine of the angle between the derivatives of the curve below which it is considered straight
+double const skStraightTolerance = 1e-8;
+
+using Vector = std::array<double, 3>;
+
+//! Compute the cross product of two vectors
+static Vector cross(Vector const& first, Vector const& second)
+{
+    return {first[1] * second[2] - first[2] * second[1],
+            first[2] * second[0] - first[0] * second[2],
+            first[0] * second[1] - first[1] * second[0]};
+}
+
+//! Compute the dot product of two vectors
+static double dot(Vector const& first, Vector const& second)
+{
+    return first[0] * second[0] + first[1] * second[1] + first[2] * second[2];
+}
+
+//! Remove the component of a vector along the unit tangent and return the norm of the rest
+static double orthogonalize(Vector& vector, Vector const& tangent)
+{
+    double projection = dot(vector, tangent);
+    for (int k = 0; k != 3; ++k)
+        vector[k] -= projection * tangent[k];
+    return std::sqrt(dot(vector, vector));
+}
+
+//! Retrieve the direction perpendicular to the unit tangent which is the closest to the axis least aligned with it
+static Vector perpendicularAxis(Vector const& tangent)
+{
+    int iAxis = 0;
+    for (int k = 1; k != 3; ++k)
+    {
+        if (std::abs(tangent[k]) < std::abs(tangent[iAxis]))
+            iAxis = k;
+    }
+    Vector result = {0.0, 0.0, 0.0};
+    result[iAxis] = 1.0;
+    for (int k = 0; k != 3; ++k)
+        result[k] -= tangent[iAxis] * tangent[k];
+    return result;
+}
+
+/*!
+ * \brief Compute frames of the curve at the given parameters
+ * \param frames Buffers of the elements of the rotation matrices stored in the row-major order
+ */
+void MovingFrames::compute(ArcLengthParametrization const& parametrization, std::vector<double> const& parameters,
+                           FrameType type, std::array<std::vector<double>, 9>& frames)
+{
+    evaluateCurve(parametrization, parameters);
+    if (type == kFrenet)
+        computeFrenet();
+    else
+        computeRotationMinimizing();
+    writeFrames(frames);
+}
+
+//! Create a matrix data object which consists of the frames at the given parameters
+MatrixDataObject* MovingFrames::createDataObject(QString const& name, std::vector<double> const& parameters,
+                                                 std::array<std::vector<double>, 9> const& frames)
+{
+    MatrixDataObject* pDataObject = new MatrixDataObject(name);
+    quint32 numParameters = parameters.size();
+    for (quint32 i = 0; i != numParameters; ++i)
+    {
+        DataItemType& item = pDataObject->addItem(parameters[i]);
+        for (IndexType j = 0; j != 3; ++j)
+        {
+            for (IndexType k = 0; k != 3; ++k)
+                item[j][k] = frames[3 * j + k][i];
+        }
+    }
+    return pDataObject;
+}
+
+//! Evaluate points, unit tangents and binormal directions of the curve
+void MovingFrames::evaluateCurve(ArcLengthParametrization const& parametrization, std::vector<double> const& parameters)
+{
+    std::array<std::vector<double>, 3> positions, firstDerivatives, secondDerivatives;
+    parametrization.computePositions(parameters, positions);
+    parametrization.computeDerivatives(parameters, firstDerivatives, secondDerivatives);
+    quint32 numStations = parameters.size();
+    mPositions.resize(numStations);
+    mTangents.resize(numStations);
+    mBinormals.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector first, second;
+        for (int k = 0; k != 3; ++k)
+        {
+            mPositions[i][k] = positions[k][i];
+            first[k] = firstDerivatives[k][i];
+            second[k] = secondDerivatives[k][i];
+        }
+        // The tangent of the previous station is kept where the curve stops
+        double speed = std::sqrt(dot(first, first));
+        if (speed > 0.0)
+            mTangents[i] = {first[0] / speed, first[1] / speed, first[2] / speed};
+        else
+            mTangents[i] = i == 0 ? Vector{0.0, 0.0, 1.0} : mTangents[i - 1];
+        Vector binormal = cross(first, second);
+        double binormalNorm = std::sqrt(dot(binormal, binormal));
+        if (binormalNorm > skStraightTolerance * speed * std::sqrt(dot(second, second)))
+            mBinormals[i] = {binormal[0] / binormalNorm, binormal[1] / binormalNorm, binormal[2] / binormalNorm};
+        else
+            mBinormals[i] = {0.0, 0.0, 0.0};
+    }
+}
+
+/*!
+ * \brief Transport normals along the curve by the double reflection method
+ *
+ * The composed maps of the chunks are stored by columns, that is, images of the basis vectors.
+ */
+void MovingFrames::computeRotationMinimizing()
+{
+    quint32 numStations = mTangents.size();
+    mNormals.resize(numStations);
+    if (numStations == 0)
+        return;
+    mNormals[0] = computeInitialNormal();
+    // Split the stations into chunks
+    quint32 numChunks = 1;
+    if (mIsParallel && numStations >= skMinParallelStations)
+        numChunks = std::max(1, QThreadPool::globalInstance()->maxThreadCount() * skNumChunksPerThread);
+    quint32 chunkSize = (numStations + numChunks - 1) / numChunks;
+    numChunks = (numStations + chunkSize - 1) / chunkSize;
+    auto chunkStart = [chunkSize, numStations](quint32 iChunk) { return std::min(iChunk * chunkSize, numStations); };
+    // Compose the maps from the start of each chunk to the start of the next one
+    std::vector<Matrix> maps(numChunks);
+    runTasks(numChunks - 1, [&](int iChunk)
+    {
+        Matrix& columns = maps[iChunk];
+        columns = {Vector{1.0, 0.0, 0.0}, Vector{0.0, 1.0, 0.0}, Vector{0.0, 0.0, 1.0}};
+        quint32 iEnd = chunkStart(iChunk + 1);
+        for (quint32 i = chunkStart(iChunk); i != iEnd; ++i)
+        {
+            for (Vector& column : columns)
+                column = transport(i, i + 1, column);
+        }
+    }, mIsParallel);
+    // Propagate the initial normal through the starts of the chunks
+    for (quint32 iChunk = 1; iChunk < numChunks; ++iChunk)
+    {
+        Matrix const& columns = maps[iChunk - 1];
+        Vector const& normal = mNormals[chunkStart(iChunk - 1)];
+        Vector& startNormal = mNormals[chunkStart(iChunk)];
+        for (int k = 0; k != 3; ++k)
+            startNormal[k] = columns[0][k] * normal[0] + columns[1][k] * normal[1] + columns[2][k] * normal[2];
+    }
+    // Fill the chunks
+    runTasks(numChunks, [&](int iChunk)
+    {
+        quint32 iEnd = chunkStart(iChunk + 1);
+        for (quint32 i = chunkStart(iChunk) + 1; i < iEnd; ++i)
+            mNormals[i] = transport(i - 1, i, mNormals[i - 1]);
+    }, mIsParallel);
+}
+
+/*!
+ * \brief Compute principal normals of the curve
+ *
+ * Normals at straight parts are transported from the closest curved station. If the curve is straight as a whole,
+ * the frames are rotation-minimizing.
+ */
+void MovingFrames::computeFrenet()
+{
+    quint32 numStations = mTangents.size();
+    auto isStraight = [this](quint32 i) { return mBinormals[i] == Vector{0.0, 0.0, 0.0}; };
+    quint32 iFirstCurved = 0;
+    while (iFirstCurved != numStations && isStraight(iFirstCurved))
+        ++iFirstCurved;
+    if (iFirstCurved == numStations)
+    {
+        computeRotationMinimizing();
+        return;
+    }
+    mNormals.resize(numStations);
+    quint32 numTasks = mIsParallel && numStations >= skMinParallelStations ? QThreadPool::globalInstance()->maxThreadCount() : 1;
+    quint32 chunkSize = (numStations + numTasks - 1) / numTasks;
+    runTasks(numTasks, [&](int iTask)
+    {
+        quint32 iEnd = std::min((iTask + 1) * chunkSize, numStations);
+        for (quint32 i = iTask * chunkSize; i < iEnd; ++i)
+            mNormals[i] = cross(mBinormals[i], mTangents[i]);
+    }, mIsParallel);
+    for (quint32 i = iFirstCurved; i-- != 0;)
+        mNormals[i] = transport(i + 1, i, mNormals[i + 1]);
+    for (quint32 i = iFirstCurved + 1; i < numStations; ++i)
+    {
+        if (isStraight(i))
+            mNormals[i] = transport(i - 1, i, mNormals[i - 1]);
+    }
+}
+
+/*!
+ * \brief Transport a normal vector between neighbouring stations by the double reflection
+ *
+ * The first reflection maps the start point onto the end one, the second one aligns the reflected tangent with the end
+ * tangent. Both reflections are skipped if they are degenerate.
+ */
+MovingFrames::Vector MovingFrames::transport(quint32 iStart, quint32 iEnd, Vector const& normal) const
+{
+    Vector result = normal;
+    Vector tangent = mTangents[iStart];
+    Vector chord;
+    for (int k = 0; k != 3; ++k)
+        chord[k] = mPositions[iEnd][k] - mPositions[iStart][k];
+    double chordSquared = dot(chord, chord);
+    if (chordSquared > 0.0)
+    {
+        double normalFactor = 2.0 * dot(chord, result) / chordSquared;
+        double tangentFactor = 2.0 * dot(chord, tangent) / chordSquared;
+        for (int k = 0; k != 3; ++k)
+        {
+            result[k] -= normalFactor * chord[k];
+            tangent[k] -= tangentFactor * chord[k];
+        }
+    }
+    Vector difference;
+    for (int k = 0; k != 3; ++k)
+        difference[k] = mTangents[iEnd][k] - tangent[k];
+    double differenceSquared = dot(difference, difference);
+    if (differenceSquared > 0.0)
+    {
+        double factor = 2.0 * dot(difference, result) / differenceSquared;
+        for (int k = 0; k != 3; ++k)
+            result[k] -= factor * difference[k];
+    }
+    return result;
+}
+
+//! Choose the normal at the first station which is the closest to the axis least aligned with the tangent
+MovingFrames::Vector MovingFrames::computeInitialNormal() const
+{
+    return perpendicularAxis(mTangents[0]);
+}
+
+//! Orthonormalize the normals against the tangents and store the frames by elements
+void MovingFrames::writeFrames(std::array<std::vector<double>, 9>& frames) const
+{
+    quint32 numStations = mTangents.size();
+    for (auto& values : frames)
+        values.resize(numStations);
+    if (numStations == 0)
+        return;
+    Vector previousNormal = computeInitialNormal();
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector const& tangent = mTangents[i];
+        Vector normal = mNormals[i];
+        double norm = orthogonalize(normal, tangent);
+        // A normal which is (nearly) parallel to the tangent carries no direction, so the previous frame is kept
+        if (norm <= skStraightTolerance)
+        {
+            normal = previousNormal;
+            norm = orthogonalize(normal, tangent);
+        }
+        // The previous normal is parallel to the tangent as well, if the curve turns sharply
+        if (norm <= skStraightTolerance)
+        {
+            normal = perpendicularAxis(tangent);
+            norm = std::sqrt(dot(normal, normal));
+        }
+        for (int k = 0; k != 3; ++k)
+            normal[k] /= norm;
+        previousNormal = normal;
+        Vector binormal = cross(tangent, normal);
+        for (int k = 0; k != 3; ++k)
+        {
+            frames[3 * k][i] = normal[k];
+            frames[3 * k + 1][i] = binormal[k];
+            frames[3 * k + 2][i] = tangent[k];
+        }
+    }
+}
@@ -0,0 +1,67 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the MovingFrames class
+ */
+
+#ifndef MOVINGFRAMES_H
+#define MOVINGFRAMES_H
+
+#include <QString>
+#include <array>
+#include <vector>
+#include "arclengthparametrization.h"
+
+namespace QRS::Core
+{
+
+class MatrixDataObject;
+
+/*!
+ * \brief Generator of orthonormal frames along a curve given by a radius vector
+ *
+ * Each frame is a rotation matrix whose columns are the normal, binormal and tangent vectors, so that the frame of
+ * a straight curve along the Z axis is the identity. Rotation-minimizing frames are computed by the double reflection
+ * method. The transport from a station to the next one is a linear map of the normal vector, so the stations are split
+ * into chunks whose composed maps are computed in parallel. Then, the normals at the starts of the chunks are found
+ * sequentially, and the frames of the chunks are filled in parallel. Frenet frames are evaluated at each station
+ * independently. Where the curve is straight and the principal normal is undefined, the neighbouring frames are
+ * transported instead.
+ */
+class MovingFrames
+{
+public:
+    enum FrameType
+    {
+        kRotationMinimizing,
+        kFrenet
+    };
+    void compute(ArcLengthParametrization const& parametrization, std::vector<double> const& parameters, FrameType type,
+                 std::array<std::vector<double>, 9>& frames);
+    void setParallel(bool isParallel) { mIsParallel = isParallel; }
+    static MatrixDataObject* createDataObject(QString const& name, std::vector<double> const& parameters,
+                                              std::array<std::vector<double>, 9> const& frames);
+
+private:
+    using Vector = std::array<double, 3>;
+    using Matrix = std::array<Vector, 3>;
+    void evaluateCurve(ArcLengthParametrization const& parametrization, std::vector<double> const& parameters);
+    void computeRotationMinimizing();
+    void computeFrenet();
+    Vector transport(quint32 iStart, quint32 iEnd, Vector const& normal) const;
+    Vector computeInitialNormal() const;
+    void writeFrames(std::array<std::vector<double>, 9>& frames) const;
+
+private:
+    std::vector<Vector> mPositions;
+    std::vector<Vector> mTangents;
+    std::vector<Vector> mNormals;
+    //! Binormal directions of the curve which are zero where it is straight
+    std::vector<Vector> mBinormals;
+    bool mIsParallel = true;
+};
+
+}
+
+#endif // MOVINGFRAMES_H
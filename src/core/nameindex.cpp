@@ -0,0 +1,140 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the NameIndex class
+ */
+
+#include <algorithm>
+#include "nameindex.h"
+
+using namespace QRS::Core;
+
+//! Maximum length of n-grams
+static int const skMaxGramLength = 3;
+
+//! Index the name of an entity. The previous name of the entity is forgotten
+void NameIndex::insert(DataIDType id, QString const& name)
+{
+    QString foldedName = name.toLower();
+    auto iter = mNames.find(id);
+    if (iter != mNames.end())
+    {
+        replace(iter, std::move(foldedName));
+        return;
+    }
+    for (QString const& gram : grams(foldedName))
+        mGrams[gram].insert(id);
+    mNames.emplace(id, std::move(foldedName));
+}
+
+//! Exclude an entity from the index
+void NameIndex::remove(DataIDType id)
+{
+    auto iter = mNames.find(id);
+    if (iter == mNames.end())
+        return;
+    for (QString const& gram : grams(iter->second))
+        excludeGram(gram, id);
+    mNames.erase(iter);
+}
+
+//! Change the name of an entity. If the entity is not indexed with the old name, the new one is indexed from scratch
+void NameIndex::rename(DataIDType id, QString const& oldName, QString const& newName)
+{
+    auto iter = mNames.find(id);
+    if (iter == mNames.end() || iter->second != oldName.toLower())
+    {
+        insert(id, newName);
+        return;
+    }
+    replace(iter, newName.toLower());
+}
+
+//! Reindex an entity by its new name, so that only the n-grams which differ between the names are processed
+void NameIndex::replace(std::unordered_map<DataIDType, QString>::iterator iter, QString&& foldedName)
+{
+    if (iter->second == foldedName)
+        return;
+    DataIDType id = iter->first;
+    QSet<QString> oldGrams = grams(iter->second);
+    QSet<QString> newGrams = grams(foldedName);
+    for (QString const& gram : oldGrams)
+    {
+        if (!newGrams.contains(gram))
+            excludeGram(gram, id);
+    }
+    for (QString const& gram : newGrams)
+    {
+        if (!oldGrams.contains(gram))
+            mGrams[gram].insert(id);
+    }
+    iter->second = std::move(foldedName);
+}
+
+//! Exclude an entity from the ones which contain an n-gram. The n-grams contained by no entities are forgotten
+void NameIndex::excludeGram(QString const& gram, DataIDType id)
+{
+    auto iterGram = mGrams.find(gram);
+    if (iterGram == mGrams.end())
+        return;
+    iterGram->erase(id);
+    if (iterGram->empty())
+        mGrams.erase(iterGram);
+}
+
+//! Forget all the entities
+void NameIndex::clear()
+{
+    mNames.clear();
+    mGrams.clear();
+}
+
+//! Retrieve the entities whose names contain a pattern
+DataIDSet NameIndex::find(QString const& pattern) const
+{
+    QString foldedPattern = pattern.toLower();
+    int length = foldedPattern.size();
+    if (length == 0)
+        return DataIDSet();
+    // Short patterns are stored as they are
+    if (length <= skMaxGramLength)
+        return mGrams.value(foldedPattern);
+    // Start from the rarest trigram to check as few candidates as possible
+    QList<DataIDSet const*> gramEntities;
+    for (int i = 0; i <= length - skMaxGramLength; ++i)
+    {
+        auto iterGram = mGrams.constFind(foldedPattern.mid(i, skMaxGramLength));
+        if (iterGram == mGrams.constEnd())
+            return DataIDSet();
+        gramEntities.push_back(&iterGram.value());
+    }
+    std::sort(gramEntities.begin(), gramEntities.end(),
+              [](DataIDSet const* pFirst, DataIDSet const* pSecond) { return pFirst->size() < pSecond->size(); });
+    DataIDSet result;
+    int numGrams = gramEntities.size();
+    for (DataIDType id : *gramEntities[0])
+    {
+        bool isCandidate = true;
+        for (int i = 1; i != numGrams && isCandidate; ++i)
+            isCandidate = gramEntities[i]->contains(id);
+        // Trigrams can be found in a name in a different order
+        if (isCandidate && mNames.at(id).contains(foldedPattern))
+            result.insert(id);
+    }
+    return result;
+}
+
+//! Retrieve all the distinct n-grams of a name
+QSet<QString> NameIndex::grams(QString const& name)
+{
+    QSet<QString> result;
+    int length = name.size();
+    for (int i = 0; i != length; ++i)
+    {
+        int maxLength = qMin(skMaxGramLength, length - i);
+        for (int j = 1; j <= maxLength; ++j)
+            result.insert(name.mid(i, j));
+    }
+    return result;
+}
@@ -0,0 +1,73 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the NameIndex class
+ */
+
+#ifndef NAMEINDEX_H
+#define NAMEINDEX_H
+
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <unordered_map>
+#include "datachangeset.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Index to search entities by a part of their names
+ *
+ * Every name is split into all its substrings which are not longer than three characters (n-grams).
+ * Patterns of up to three characters are resolved by a single lookup. Longer patterns are resolved by intersecting
+ * the entities of their trigrams and checking the names of the remaining candidates. Search is case insensitive.
+ */
+class NameIndex
+{
+public:
+    NameIndex() = default;
+    ~NameIndex() = default;
+    void insert(DataIDType id, QString const& name);
+    void remove(DataIDType id);
+    void rename(DataIDType id, QString const& oldName, QString const& newName);
+    template<typename Entities>
+    void update(DataChangeSet const& changeSet, Entities const& entities);
+    void clear();
+    DataIDSet find(QString const& pattern) const;
+    bool contains(DataIDType id) const { return mNames.contains(id); }
+    quint32 size() const { return mNames.size(); }
+
+private:
+    void replace(std::unordered_map<DataIDType, QString>::iterator iter, QString&& foldedName);
+    void excludeGram(QString const& gram, DataIDType id);
+    static QSet<QString> grams(QString const& name);
+
+private:
+    //! Names of entities converted to lower case
+    std::unordered_map<DataIDType, QString> mNames;
+    //! Entities which contain each n-gram
+    QHash<QString, DataIDSet> mGrams;
+};
+
+//! Follow the changes of entities: the removed ones are excluded, the created and renamed ones are indexed
+template<typename Entities>
+void NameIndex::update(DataChangeSet const& changeSet, Entities const& entities)
+{
+    for (DataIDType id : changeSet.removedIDs())
+        remove(id);
+    for (DataIDSet const* pIDs : {&changeSet.createdIDs(), &changeSet.renamedIDs()})
+    {
+        for (DataIDType id : *pIDs)
+        {
+            auto iter = entities.find(id);
+            if (iter != entities.end())
+                insert(id, iter->second->name());
+        }
+    }
+}
+
+}
+
+#endif // NAMEINDEX_H
@@ -0,0 +1,60 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the NamePool class
+ */
+
+#include "namepool.h"
+
+using namespace QRS::Core;
+
+//! Retrieve the pool which all the data objects share
+NamePool& NamePool::instance()
+{
+    static NamePool pool;
+    return pool;
+}
+
+//! Intern a name and retrieve its index
+quint32 NamePool::acquire(QString const& name)
+{
+    QMutexLocker locker(&mMutex);
+    auto iter = mIndices.constFind(QStringView(name));
+    if (iter != mIndices.constEnd())
+    {
+        ++mEntries[iter.value()].numReferences;
+        return iter.value();
+    }
+    quint32 index;
+    if (mFreeIndices.empty())
+    {
+        index = mEntries.size();
+        mEntries.emplaceBack();
+    }
+    else
+    {
+        index = mFreeIndices.back();
+        mFreeIndices.pop_back();
+    }
+    Entry& entry = mEntries[index];
+    entry.name = name;
+    entry.numReferences = 1;
+    // The key views the string owned by the entry, so that the name is not stored twice
+    mIndices.insert(QStringView(entry.name), index);
+    return index;
+}
+
+//! Stop referring to a name. The entry is freed when the last reference is released
+void NamePool::release(quint32 index)
+{
+    QMutexLocker locker(&mMutex);
+    if (index >= mEntries.size())
+        return;
+    Entry& entry = mEntries[index];
+    if (entry.numReferences == 0 || --entry.numReferences > 0)
+        return;
+    mIndices.remove(QStringView(entry.name));
+    entry.name = QString();
+    mFreeIndices.push_back(index);
+}
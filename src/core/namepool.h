@@ -0,0 +1,67 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the NamePool class
+ */
+
+#ifndef NAMEPOOL_H
+#define NAMEPOOL_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <vector>
+#include "appendonlyarray.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Pool of names shared by data objects
+ *
+ * Objects refer to their names by indices, so that equal names are stored only once.
+ * Entries are counted and reused as soon as nobody refers to them. Acquiring and releasing names is guarded by a mutex,
+ * since objects can be copied in a background thread. Names are retrieved without locking: entries are never moved,
+ * and the name of an entry is not changed while somebody refers to it.
+ */
+class NamePool
+{
+public:
+    static NamePool& instance();
+    quint32 acquire(QString const& name);
+    void release(quint32 index);
+    //! Retrieve a name by its index. The reference is valid while the name is acquired
+    QString const& name(quint32 index) const
+    {
+        return mEntries[index].name;
+    }
+    //! Number of distinct names acquired
+    quint32 size() const
+    {
+        QMutexLocker locker(&mMutex);
+        return mIndices.size();
+    }
+
+private:
+    NamePool() = default;
+    NamePool(NamePool const&) = delete;
+    NamePool& operator=(NamePool const&) = delete;
+
+private:
+    struct Entry
+    {
+        QString name;
+        quint32 numReferences = 0;
+    };
+    //! Entries are never moved, so that references to names remain valid
+    AppendOnlyArray<Entry> mEntries;
+    std::vector<quint32> mFreeIndices;
+    //! Lookup of entries by views of the names they store
+    QHash<QStringView, quint32> mIndices;
+    mutable QMutex mMutex;
+};
+
+}
+
+#endif // NAMEPOOL_H
@@ -8,12 +8,15 @@
  */
 
 #include <QRandomGenerator>
+#include <QSet>
+#include <vector>
 
 #include "project.h"
 #include "scalardataobject.h"
 #include "vectordataobject.h"
 #include "matrixdataobject.h"
 #include "surfacedataobject.h"
+#include "deriveddataobject.h"
 #include "geometryrodcomponent.h"
 #include "usersectionrodcomponent.h"
 #include "materialrodcomponent.h"
@@ -23,6 +26,9 @@
 
 using namespace QRS::Core;
 
+//! Number of attempts to copy entities under short locks before they are copied under a single one
+static int const skMaxNumSnapshotAttempts = 3;
+
 template<typename T>
 void clearDataMap(std::unordered_map<DataIDType, T*>& dataMap);
 AbstractDataObject* createDataObject(AbstractDataObject::ObjectType type);
@@ -39,6 +45,133 @@ Project::~Project()
 {
     clearDataMap(mDataObjects);
     clearDataMap(mRodComponents);
+    clearDataMap(mPendingRemovedDataObjects);
+}
+
+/*!
+ * \brief Start a group of changes which are reported at once
+ *
+ * Transactions can be nested. References to removed data objects are resolved and all the signals are emitted
+ * only when the outermost transaction is committed.
+ */
+void Project::beginTransaction()
+{
+    ++mTransactionDepth;
+}
+
+//! Finish a group of changes and report them if the transaction is the outermost one
+void Project::commitTransaction()
+{
+    if (mTransactionDepth == 0)
+        return;
+    --mTransactionDepth;
+    notifyChanges(kNoChanges);
+}
+
+/*!
+ * \brief Register changes and report them unless a transaction is active
+ *
+ * Each signal is emitted once at most. Substitution of entities implies that their names could be changed as well.
+ * The entities affected are reported before the kinds of changes, so that views could follow them incrementally
+ */
+void Project::notifyChanges(Changes changes)
+{
+    mPendingChanges |= changes;
+    if (mTransactionDepth > 0)
+        return;
+    resolvePendingReferences();
+    changes = mPendingChanges;
+    mPendingChanges = kNoChanges;
+    if (changes == kNoChanges)
+        return;
+    if (!mPendingDataObjectChanges.isEmpty() || !mPendingRodComponentChanges.isEmpty())
+    {
+        DataChangeSet dataObjectChanges = std::move(mPendingDataObjectChanges);
+        DataChangeSet rodComponentChanges = std::move(mPendingRodComponentChanges);
+        mPendingDataObjectChanges.clear();
+        mPendingRodComponentChanges.clear();
+        emit entitiesChanged(dataObjectChanges, rodComponentChanges);
+    }
+    if (changes & kDataObjectsSubstituted)
+        emit dataObjectsSubstituted();
+    else if (changes & kDataObjectNamesChanged)
+        emit propertiesDataObjectsChanged();
+    else if (changes & kDataObjectsModified)
+        emit dataObjectsModified();
+    if (changes & kRodComponentsSubstituted)
+        emit rodComponentsSubstituted();
+    else if (changes & kRodComponentNamesChanged)
+        emit propertiesRodComponentsChanged();
+    emit changed(changes);
+}
+
+/*!
+ * \brief Rename data objects, e.g. through the properties
+ *
+ * The names are changed under the lock, so that the objects are not renamed while being copied in a background thread
+ */
+void Project::renameDataObjects(std::vector<DataIDType> const& ids, QString const& name)
+{
+    {
+        QWriteLocker locker(&mLock);
+        ++mRevision;
+        QSet<QString> names = {name};
+        for (DataIDType id : ids)
+        {
+            auto iter = mDataObjects.find(id);
+            if (iter == mDataObjects.end())
+                continue;
+            names.insert(iter->second->name());
+            iter->second->setName(name);
+            mPendingDataObjectChanges.setRenamed(id);
+        }
+        DataIDSet derivedIDs;
+        resolveDerivedReferences(names, derivedIDs);
+    }
+    notifyChanges(kDataObjectNamesChanged);
+}
+
+//! Rename directories of the hierarchy of data objects under the lock
+void Project::renameDataObjectDirectories(std::vector<HierarchyNode*> const& nodes, QString const& name)
+{
+    {
+        QWriteLocker locker(&mLock);
+        ++mRevision;
+        for (HierarchyNode* pNode : nodes)
+            pNode->value() = name;
+        mPendingDataObjectChanges.setHierarchyChanged();
+    }
+    notifyChanges(kDataObjectNamesChanged);
+}
+
+//! Report names of rod components which have been changed in place
+void Project::notifyRodComponentNamesChanged(std::vector<DataIDType> const& ids)
+{
+    {
+        QWriteLocker locker(&mLock);
+        ++mRevision;
+    }
+    for (DataIDType id : ids)
+        mPendingRodComponentChanges.setRenamed(id);
+    notifyChanges(kRodComponentNamesChanged);
+}
+
+//! Resolve references of rod components to the removed data objects and destroy the latter
+void Project::resolvePendingReferences()
+{
+    if (mPendingRemovedDataObjects.empty())
+        return;
+    QWriteLocker locker(&mLock);
+    ++mRevision;
+    std::vector<AbstractRodComponent*> dependents;
+    for (auto& item : mPendingRemovedDataObjects)
+    {
+        for (auto& dependent : mDependencyIndex.dependents(item.first))
+            dependents.push_back(dependent.first);
+    }
+    for (AbstractRodComponent* pRodComponent : dependents)
+        pRodComponent->resolveReferences(mDataObjects);
+    clearDataMap(mPendingRemovedDataObjects);
 }
 
 //! Create a data object with the specified type
@@ -47,37 +180,122 @@ AbstractDataObject* Project::addDataObject(AbstractDataObject::ObjectType type)
     AbstractDataObject* pObject = createDataObject(type);
     if (pObject)
     {
+        QWriteLocker locker(&mLock);
+        ++mRevision;
         DataIDType id = pObject->id();
         mDataObjects.emplace(id, pObject);
         mHierarchyDataObjects.appendNode(new HierarchyNode(HierarchyNode::NodeType::kObject, id));
+        mPendingDataObjectChanges.setCreated(id);
+        mPendingDataObjectChanges.setHierarchyChanged();
     }
     return pObject;
 }
 
-//! Substitute current data objects with new ones
-void Project::setDataObjects(DataObjects const& dataObjects, HierarchyTree const& hierarchyDataObjects)
+/*!
+ * \brief Apply the changes of data objects made outside of the project
+ *
+ * Only the objects listed in the change set are processed. Modified objects are assigned in place,
+ * so that rod components which refer to them stay valid. Only the components which referred to removed objects are resolved,
+ * which is postponed until the current transaction is committed. Derived objects are resolved only if they are copied or
+ * refer to names of created, renamed or removed objects.
+ */
+void Project::applyDataObjects(DataObjects const& dataObjects, HierarchyTree const& hierarchyDataObjects,
+                               DataChangeSet const& changeSet)
 {
-    // Copying references to data objects
-    DataObjects copyDataObjects = mDataObjects;
-    // Substituting data objects
-    mDataObjects.clear();
-    AbstractDataObject* pDataObject;
-    for (auto& item : dataObjects)
+    if (changeSet.isEmpty())
+        return;
+    QWriteLocker locker(&mLock);
+    ++mRevision;
+    DataIDSet derivedIDs;
+    QSet<QString> names;
+    // Creating new data objects
+    for (DataIDType id : changeSet.createdIDs())
     {
-        pDataObject = item.second;
-        mDataObjects.emplace(pDataObject->id(), pDataObject->clone());
+        auto iter = dataObjects.find(id);
+        if (iter == dataObjects.end())
+            continue;
+        AbstractDataObject* pDataObject = iter->second->clone();
+        mDataObjects.emplace(id, pDataObject);
+        mPendingDataObjectChanges.setCreated(id);
+        names.insert(pDataObject->name());
+        if (pDataObject->isDerived())
+            derivedIDs.insert(id);
     }
-    mHierarchyDataObjects = hierarchyDataObjects;
-    // Resolving references of rod components
-    AbstractRodComponent* pRodComponent;
-    for (auto& item : mRodComponents)
+    // Modifying existing data objects
+    bool isNamesChanged = false;
+    for (DataIDType id : changeSet.modifiedIDs())
     {
-        pRodComponent = item.second;
-        pRodComponent->resolveReferences(mDataObjects);
+        auto iterSource = dataObjects.find(id);
+        auto iterTarget = mDataObjects.find(id);
+        if (iterSource == dataObjects.end() || iterTarget == mDataObjects.end())
+            continue;
+        AbstractDataObject const* pSourceDataObject = iterSource->second;
+        AbstractDataObject* pTargetDataObject = iterTarget->second;
+        // Values are assigned in place, so the objects referring to the modified one are affected only by its name
+        if (pSourceDataObject->name() != pTargetDataObject->name())
+        {
+            isNamesChanged = true;
+            names.insert(pTargetDataObject->name());
+            names.insert(pSourceDataObject->name());
+            mPendingDataObjectChanges.setRenamed(id);
+        }
+        else
+        {
+            mPendingDataObjectChanges.setModified(id);
+        }
+        pTargetDataObject->assign(*pSourceDataObject);
+        if (pTargetDataObject->isDerived())
+            derivedIDs.insert(id);
+    }
+    // Excluding removed data objects which are destroyed after resolving references to them
+    for (DataIDType id : changeSet.removedIDs())
+    {
+        auto iter = mDataObjects.find(id);
+        if (iter == mDataObjects.end())
+            continue;
+        names.insert(iter->second->name());
+        mPendingDataObjectChanges.setRemoved(id);
+        mDependencyIndex.removeDerived(id);
+        mPendingRemovedDataObjects.emplace(id, iter->second);
+        mDataObjects.erase(iter);
+    }
+    if (changeSet.isHierarchyChanged())
+    {
+        mHierarchyDataObjects = hierarchyDataObjects;
+        mPendingDataObjectChanges.setHierarchyChanged();
+    }
+    // Derived copies still refer to the objects they were evaluated with
+    resolveDerivedReferences(names, derivedIDs);
+    locker.unlock();
+    if (changeSet.isStructureChanged())
+        notifyChanges(kDataObjectsSubstituted);
+    else if (isNamesChanged)
+        notifyChanges(kDataObjectNamesChanged);
+    else
+        notifyChanges(kDataObjectsModified);
+}
+
+/*!
+ * \brief Bind derived objects with the objects they refer to
+ *
+ * The given derived objects are registered in the dependency index again, since their formulas could be changed.
+ * The lock must be taken for writing
+ */
+void Project::resolveDerivedReferences(QSet<QString> const& names, DataIDSet& derivedIDs)
+{
+    for (DataIDType id : derivedIDs)
+        mDependencyIndex.insertDerived((DerivedDataObject const*)mDataObjects.at(id));
+    for (QString const& name : names)
+    {
+        DataIDSet const& dependents = mDependencyIndex.derivedDependents(name);
+        derivedIDs.insert(dependents.begin(), dependents.end());
+    }
+    for (DataIDType id : derivedIDs)
+    {
+        auto iter = mDataObjects.find(id);
+        if (iter != mDataObjects.end())
+            ((DerivedDataObject*)iter->second)->resolveReferences(mDataObjects);
     }
-    emit dataObjectsSubstituted();
-    // Removing old data objects
-    clearDataMap(copyDataObjects);
 }
 
 //! Clone data objects
@@ -89,9 +307,17 @@ DataObjects Project::cloneDataObjects() const
         AbstractDataObject* pObject = pItem.second->clone();
         result.emplace(pObject->id(), pObject);
     }
+    DerivedDataObject::resolveAllReferences(result);
     return result;
 }
 
+//! Clone data objects and their hierarchy in a background thread, while the project can still be modified
+void Project::snapshotDataObjects(DataObjects& dataObjects, HierarchyTree& hierarchyDataObjects) const
+{
+    snapshot(mDataObjects, mHierarchyDataObjects, dataObjects, hierarchyDataObjects);
+    DerivedDataObject::resolveAllReferences(dataObjects);
+}
+
 //! Create a geometrical rod component
 AbstractRodComponent* Project::addGeometry()
 {
@@ -152,18 +378,61 @@ AbstractRodComponent* Project::addMechanical()
     return pRodComponent;
 }
 
-//! Substitute current rod components with new ones
-void Project::setRodComponents(RodComponents const& rodComponents, HierarchyTree const& hierarchyRodComponents)
+/*!
+ * \brief Apply the changes of rod components made outside of the project
+ *
+ * Only the components listed in the change set are cloned or deleted
+ */
+void Project::applyRodComponents(RodComponents const& rodComponents, HierarchyTree const& hierarchyRodComponents,
+                                 DataChangeSet const& changeSet)
 {
-    clearDataMap(mRodComponents);
-    AbstractRodComponent* pRodComponent;
-    for (auto& item : rodComponents)
+    if (changeSet.isEmpty())
+        return;
+    QWriteLocker locker(&mLock);
+    ++mRevision;
+    for (DataIDType id : changeSet.removedIDs())
+    {
+        auto iter = mRodComponents.find(id);
+        if (iter == mRodComponents.end())
+            continue;
+        delete iter->second;
+        mRodComponents.erase(iter);
+        mPendingRodComponentChanges.setRemoved(id);
+    }
+    // Created and modified components are substituted by their copies
+    for (DataIDSet const* pIDs : {&changeSet.createdIDs(), &changeSet.modifiedIDs()})
+    {
+        for (DataIDType id : *pIDs)
+        {
+            auto iterSource = rodComponents.find(id);
+            if (iterSource == rodComponents.end())
+                continue;
+            auto iterTarget = mRodComponents.find(id);
+            AbstractRodComponent* pRodComponent = iterSource->second->clone();
+            mDependencyIndex.insert(pRodComponent);
+            if (iterTarget != mRodComponents.end())
+            {
+                if (iterTarget->second->name() != pRodComponent->name())
+                    mPendingRodComponentChanges.setRenamed(id);
+                else
+                    mPendingRodComponentChanges.setModified(id);
+                delete iterTarget->second;
+                iterTarget->second = pRodComponent;
+            }
+            else
+            {
+                mRodComponents.emplace(id, pRodComponent);
+                mPendingRodComponentChanges.setCreated(id);
+            }
+        }
+    }
+    if (changeSet.isHierarchyChanged())
     {
-        pRodComponent = item.second;
-        mRodComponents.emplace(pRodComponent->id(), pRodComponent->clone());
+        mHierarchyRodComponents = hierarchyRodComponents;
+        mPendingRodComponentChanges.setHierarchyChanged();
     }
-    mHierarchyRodComponents = hierarchyRodComponents;
-    emit rodComponentsSubstituted();
+    locker.unlock();
+    notifyChanges(kRodComponentsSubstituted);
 }
 
 //! Clone rod components
@@ -178,14 +447,77 @@ RodComponents Project::cloneRodComponents() const
     return result;
 }
 
+/*!
+ * \brief Clone rod components and their hierarchy in a background thread, while the project can still be modified
+ *
+ * The copies are passed to the thread of the project, since they are utilized by widgets
+ */
+void Project::snapshotRodComponents(RodComponents& rodComponents, HierarchyTree& hierarchyRodComponents) const
+{
+    snapshot(mRodComponents, mHierarchyRodComponents, rodComponents, hierarchyRodComponents);
+    for (auto& item : rodComponents)
+        item.second->moveToThread(thread());
+}
+
+/*!
+ * \brief Clone entities taking the lock for each of them, so that the main thread is not blocked for the whole copying
+ *
+ * The identifiers and the hierarchy are retrieved at once. If the project is modified before all the entities are cloned,
+ * the copies are discarded and the cloning is repeated. If the project keeps changing, the entities are cloned under
+ * a single lock, so that the copying is not starved by edits
+ */
+template<typename T>
+void Project::snapshot(std::unordered_map<DataIDType, T*> const& entities, HierarchyTree const& hierarchyEntities,
+                       std::unordered_map<DataIDType, T*>& resultEntities, HierarchyTree& resultHierarchy) const
+{
+    std::vector<DataIDType> ids;
+    for (int iAttempt = 0; iAttempt != skMaxNumSnapshotAttempts; ++iAttempt)
+    {
+        clearDataMap(resultEntities);
+        quint64 revision;
+        {
+            QReadLocker locker(&mLock);
+            revision = mRevision;
+            resultHierarchy = hierarchyEntities.clone();
+            ids.clear();
+            ids.reserve(entities.size());
+            for (auto const& item : entities)
+                ids.push_back(item.first);
+        }
+        bool isConsistent = true;
+        for (DataIDType id : ids)
+        {
+            QReadLocker locker(&mLock);
+            if (mRevision != revision)
+            {
+                isConsistent = false;
+                break;
+            }
+            resultEntities.emplace(id, entities.at(id)->clone());
+        }
+        if (isConsistent)
+            return;
+    }
+    clearDataMap(resultEntities);
+    QReadLocker locker(&mLock);
+    resultHierarchy = hierarchyEntities.clone();
+    for (auto const& item : entities)
+        resultEntities.emplace(item.first, item.second->clone());
+}
+
 //! Emplace a rod component into a project
 void Project::emplaceRodComponent(AbstractRodComponent* pRodComponent)
 {
     if (pRodComponent)
     {
+        QWriteLocker locker(&mLock);
+        ++mRevision;
         DataIDType id = pRodComponent->id();
         mRodComponents.emplace(id, pRodComponent);
+        mDependencyIndex.insert(pRodComponent);
         mHierarchyRodComponents.appendNode(new HierarchyNode(HierarchyNode::NodeType::kObject, id));
+        mPendingRodComponentChanges.setCreated(id);
+        mPendingRodComponentChanges.setHierarchyChanged();
     }
 }
 
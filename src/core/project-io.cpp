@@ -17,6 +17,7 @@
 #include "vectordataobject.h"
 #include "matrixdataobject.h"
 #include "surfacedataobject.h"
+#include "deriveddataobject.h"
 #include "geometryrodcomponent.h"
 #include "usersectionrodcomponent.h"
 #include "materialrodcomponent.h"
@@ -36,8 +37,10 @@ void readHierarchyTree(QDataStream& inputStream, HierarchyTree& hierarchy);
 //! Save a project to a file
 bool Project::save(QString const& path, QString const& fileName)
 {
+    // References to the removed objects must not be written even within a transaction
+    resolvePendingReferences();
     // Formats
-    const quint32 kFileVersion = 1;
+    const quint32 kFileVersion = 2;
     const QString kDateFormat = "dd.MM.yyyy - hh:mm:ss";
     // Retrieving the full path
     QString baseFileName = QFileInfo(fileName).baseName();
@@ -105,10 +108,17 @@ Project::Project(QString const& path, QString const& fileName)
     in >> mID;
     // 3. Data objects
     readDataObjects(in, mDataObjects);
+    for (auto& item : mDataObjects)
+    {
+        if (item.second->isDerived())
+            mDependencyIndex.insertDerived((DerivedDataObject const*)item.second);
+    }
     // 4. Hierarchy of data objects
     readHierarchyTree(in, mHierarchyDataObjects);
     // 5. Rod components
     readRodComponents(in, mDataObjects, mRodComponents);
+    for (auto& item : mRodComponents)
+        mDependencyIndex.insert(item.second);
     // 6. Hierarchy of rod components
     readHierarchyTree(in, mHierarchyRodComponents);
     // Closing the file
@@ -130,12 +140,21 @@ void Project::importDataObjects(QString const& path, QString const& fileName)
     stream.readLine();
     stream >> numDataObjects;
     stream.readLine();
+    QSet<QString> names;
     for (quint32 iDataObject = 0; iDataObject != numDataObjects; ++iDataObject)
     {
         AbstractDataObject* pDataObject = addDataObject(type);
         pDataObject->import(stream);
+        names.insert(pDataObject->name());
     }
     pFile->close();
+    {
+        QWriteLocker locker(&mLock);
+        ++mRevision;
+        DataIDSet derivedIDs;
+        resolveDerivedReferences(names, derivedIDs);
+    }
+    notifyChanges(kDataObjectsSubstituted);
 }
 
 //! Helper function to read a set of data objects from a stream
@@ -146,7 +165,7 @@ void readDataObjects(QDataStream& inputStream, DataObjects& dataObjects)
     inputStream >> maxID;
     AbstractDataObject::setMaxObjectID(maxID);
     // Data objects
-    AbstractDataObject::ObjectType type;
+    quint32 type;
     QString name;
     quint32 numObjects;
     inputStream >> numObjects;
@@ -155,24 +174,35 @@ void readDataObjects(QDataStream& inputStream, DataObjects& dataObjects)
         inputStream >> type;
         inputStream >> name;
         AbstractDataObject* pObject = nullptr;
-        switch (type)
+        // Derived objects are written as formulas
+        bool isDerived = type & DerivedDataObject::kSerializationFlag;
+        type &= ~DerivedDataObject::kSerializationFlag;
+        if (isDerived)
         {
-        case (AbstractDataObject::ObjectType::kScalar):
-            pObject = new ScalarDataObject(name);
-            break;
-        case (AbstractDataObject::ObjectType::kVector):
-            pObject = new VectorDataObject(name);
-            break;
-        case (AbstractDataObject::ObjectType::kMatrix):
-            pObject = new MatrixDataObject(name);
-            break;
-        case (AbstractDataObject::ObjectType::kSurface):
-            pObject = new SurfaceDataObject(name);
-            break;
+            pObject = new DerivedDataObject((AbstractDataObject::ObjectType)type, name);
+        }
+        else
+        {
+            switch (type)
+            {
+            case (AbstractDataObject::ObjectType::kScalar):
+                pObject = new ScalarDataObject(name);
+                break;
+            case (AbstractDataObject::ObjectType::kVector):
+                pObject = new VectorDataObject(name);
+                break;
+            case (AbstractDataObject::ObjectType::kMatrix):
+                pObject = new MatrixDataObject(name);
+                break;
+            case (AbstractDataObject::ObjectType::kSurface):
+                pObject = new SurfaceDataObject(name);
+                break;
+            }
         }
         pObject->deserialize(inputStream);
         dataObjects.emplace(pObject->id(), pObject);
     }
+    DerivedDataObject::resolveAllReferences(dataObjects);
 }
 
 //! Helper function to read rod components from a stream
@@ -9,9 +9,14 @@
 #define PROJECT_H
 
 #include <QObject>
+#include <QReadWriteLock>
+#include <QSet>
+#include <vector>
 #include "aliasdataset.h"
 #include "array.h"
 #include "hierarchytree.h"
+#include "datachangeset.h"
+#include "dependencyindex.h"
 #include "abstractdataobject.h"
 #include "abstractrodcomponent.h"
 #include "abstractsectionrodcomponent.h"
@@ -42,6 +47,17 @@ class Project : public QObject
     friend class QRS::Managers::ManagersFactory;
 
 public:
+    //! Kinds of changes which are reported to views
+    enum ChangeType
+    {
+        kNoChanges = 0,
+        kDataObjectsSubstituted = 1 << 0,
+        kDataObjectsModified = 1 << 1,
+        kDataObjectNamesChanged = 1 << 2,
+        kRodComponentsSubstituted = 1 << 3,
+        kRodComponentNamesChanged = 1 << 4
+    };
+    Q_DECLARE_FLAGS(Changes, ChangeType)
     Project(QString const& name);
     Project(QString const& path, QString const& fileName);
     virtual ~Project();
@@ -50,6 +66,9 @@ public:
     AbstractDataObject* addDataObject(AbstractDataObject::ObjectType type);
     DataObjects cloneDataObjects() const;
     HierarchyTree cloneHierarchyDataObjects() const { return mHierarchyDataObjects.clone(); }
+    void snapshotDataObjects(DataObjects& dataObjects, HierarchyTree& hierarchyDataObjects) const;
+    void renameDataObjects(std::vector<DataIDType> const& ids, QString const& name);
+    void renameDataObjectDirectories(std::vector<HierarchyNode*> const& nodes, QString const& name);
     // Rod components
     DataIDType numberRodComponents() const { return mRodComponents.size(); }
     AbstractRodComponent* addGeometry();
@@ -60,15 +79,26 @@ public:
     AbstractRodComponent* addMechanical();
     RodComponents cloneRodComponents() const;
     HierarchyTree cloneHierarchyRodComponents() const { return mHierarchyRodComponents.clone(); }
+    void snapshotRodComponents(RodComponents& rodComponents, HierarchyTree& hierarchyRodComponents) const;
+    DataDependents const& dependentRodComponents(DataIDType dataObjectID) const { return mDependencyIndex.dependents(dataObjectID); }
     // Getters and setters
     QString const& name() const { return mName; }
     QString const& filePath() const { return mFilePath; }
     static QString const& getFileExtension() { return skProjectExtension; }
     void importDataObjects(QString const& path, QString const& fileName);
+    // Transactions
+    void beginTransaction();
+    void commitTransaction();
+    bool isTransactionActive() const { return mTransactionDepth > 0; }
 
 signals:
+    //! Changes made since the last notification or through the whole transaction
+    void changed(QRS::Core::Project::Changes changes);
+    //! Entities affected by the changes which are reported next
+    void entitiesChanged(QRS::Core::DataChangeSet const& dataObjectChanges, QRS::Core::DataChangeSet const& rodComponentChanges);
     // Data objects
     void dataObjectsSubstituted();
+    void dataObjectsModified();
     void propertiesDataObjectsChanged();
     // Rod components
     void rodComponentsSubstituted();
@@ -78,11 +108,20 @@ signals:
 
 public slots:
     bool save(QString const& dir, QString const& fileName);
-    void setDataObjects(QRS::Core::DataObjects const& dataObjects, QRS::Core::HierarchyTree const& hierarchyDataObjects);
-    void setRodComponents(QRS::Core::RodComponents const& rodComponents, QRS::Core::HierarchyTree const& hierarchyRodComponents);
+    void applyDataObjects(QRS::Core::DataObjects const& dataObjects, QRS::Core::HierarchyTree const& hierarchyDataObjects,
+                          QRS::Core::DataChangeSet const& changeSet);
+    void applyRodComponents(QRS::Core::RodComponents const& rodComponents, QRS::Core::HierarchyTree const& hierarchyRodComponents,
+                            QRS::Core::DataChangeSet const& changeSet);
+    void notifyRodComponentNamesChanged(std::vector<QRS::Core::DataIDType> const& ids);
 
 private:
     void emplaceRodComponent(AbstractRodComponent* pRodComponent);
+    void notifyChanges(Changes changes);
+    void resolvePendingReferences();
+    void resolveDerivedReferences(QSet<QString> const& names, DataIDSet& derivedIDs);
+    template<typename T>
+    void snapshot(std::unordered_map<DataIDType, T*> const& entities, HierarchyTree const& hierarchyEntities,
+                  std::unordered_map<DataIDType, T*>& resultEntities, HierarchyTree& resultHierarchy) const;
 
 private:
     //! Unique project identifier
@@ -99,10 +138,48 @@ private:
     RodComponents mRodComponents;
     //! Hierarchy of rod components
     HierarchyTree mHierarchyRodComponents;
+    //! Rod components and derived data objects which refer to each data object
+    DependencyIndex mDependencyIndex;
+    //! Number of nested transactions
+    quint32 mTransactionDepth = 0;
+    //! Changes to be reported when the outermost transaction is committed
+    Changes mPendingChanges;
+    //! Data objects affected by the changes to be reported
+    DataChangeSet mPendingDataObjectChanges;
+    //! Rod components affected by the changes to be reported
+    DataChangeSet mPendingRodComponentChanges;
+    //! Removed data objects which are destroyed after resolving references to them
+    DataObjects mPendingRemovedDataObjects;
+    //! Guard of entities which are modified in the main thread while being copied in a background one
+    mutable QReadWriteLock mLock;
+    //! Number of modifications made under the lock to detect the ones which interleave with copying
+    quint64 mRevision = 0;
     //! File extensionn
     static const QString skProjectExtension;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Project::Changes)
+
+//! Transaction which is committed when the guard goes out of scope
+class ProjectTransaction
+{
+public:
+    explicit ProjectTransaction(Project& project)
+        : mProject(project)
+    {
+        mProject.beginTransaction();
+    }
+    ~ProjectTransaction()
+    {
+        mProject.commitTransaction();
+    }
+    ProjectTransaction(ProjectTransaction const&) = delete;
+    ProjectTransaction& operator=(ProjectTransaction const&) = delete;
+
+private:
+    Project& mProject;
+};
+
 }
 
 #endif // PROJECT_H
@@ -0,0 +1,507 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodAssembly class
+ */
+
+#include <bit>
+#include <cmath>
+#include <numbers>
+#include "rodassembly.h"
+#include "rodsampler.h"
+#include "geometryrodcomponent.h"
+#include "usersectionrodcomponent.h"
+#include "materialrodcomponent.h"
+#include "mechanicalrodcomponent.h"
+#include "constraintrodcomponent.h"
+
+using namespace QRS::Core;
+
+double const skDefaultPoissonsRatio = 0.3;
+
+//! Retrieve a component of the given type by its identifier
+template<typename T>
+T const* findComponent(RodComponents const& rodComponents, DataIDType id, AbstractRodComponent::ComponentType type)
+{
+    auto iter = rodComponents.find(id);
+    if (iter == rodComponents.end() || iter->second->componentType() != type)
+        return nullptr;
+    return static_cast<T const*>(iter->second);
+}
+
+//! Retrieve a cross section by its identifier, provided that it is specified by the user
+UserSectionRodComponent const* findUserSection(RodComponents const& rodComponents, DataIDType id)
+{
+    auto pSection = findComponent<AbstractSectionRodComponent>(rodComponents, id, AbstractRodComponent::ComponentType::kSection);
+    if (!pSection || pSection->sectionType() != AbstractSectionRodComponent::kUserDefined)
+        return nullptr;
+    return static_cast<UserSectionRodComponent const*>(pSection);
+}
+
+//! Add an identifier and version of a data object to the fingerprint
+void appendDataObject(std::vector<quint64>& fingerprint, AbstractDataObject const* pDataObject)
+{
+    if (!pDataObject)
+    {
+        fingerprint.push_back(0);
+        fingerprint.push_back(0);
+        return;
+    }
+    // Derived objects are brought up to date, so that their versions are actual
+    pDataObject->getItems();
+    fingerprint.push_back(pDataObject->id());
+    fingerprint.push_back(pDataObject->version());
+}
+
+//! Remove all the sampled values
+void RodBuffers::clear()
+{
+    parameters.clear();
+    arcLengths.clear();
+    for (auto& values : positions)
+        values.clear();
+    for (auto& values : frames)
+        values.clear();
+    curvatures.clear();
+    torsions.clear();
+    tensionStiffness.clear();
+    shearStiffness.clear();
+    torsionalStiffness.clear();
+    bendingStiffnessX.clear();
+    bendingStiffnessY.clear();
+    linearMassDensity.clear();
+    inertiaMassMomentX.clear();
+    inertiaMassMomentY.clear();
+    inertiaMassMomentZ.clear();
+    eccentricityX.clear();
+    eccentricityY.clear();
+    contactDiameter.clear();
+    loads.clear();
+    constraintMasks.clear();
+    localConstraintMasks.clear();
+}
+
+/*!
+ * \brief Sample the components of a rod at uniformly distributed stations
+ *
+ * The stations are placed uniformly along the curve given by the radius vector. If the section and material are given,
+ * the stiffness and mass distributions are computed from them. Each distribution which is set in the mechanical
+ * component substitutes the computed one.
+ * \return Whether the rod has been assembled. Otherwise, the reason is given by errorMessage()
+ */
+bool RodAssembly::assemble(RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    std::vector<quint64> fingerprint;
+    mIsCached = false;
+    if (!computeFingerprint(definition, rodComponents, fingerprint))
+    {
+        clear();
+        return false;
+    }
+    if (mIsValid && fingerprint == mFingerprint)
+    {
+        mIsCached = true;
+        return true;
+    }
+    mBuffers.clear();
+    placeStations(definition, rodComponents);
+    RodSampler geometrySampler;
+    addGeometryFields(geometrySampler, definition, rodComponents);
+    geometrySampler.sample(mBuffers.parameters);
+    // Request the rest of distributions at once, so that they are sampled in a single pass
+    RodSampler sampler;
+    addPropertyFields(sampler, definition, rodComponents);
+    addLoadFields(sampler, definition, rodComponents);
+    sampler.sample(mBuffers.arcLengths);
+    computeProperties(definition, rodComponents);
+    scaleLoads(definition, rodComponents);
+    setConstraints(definition, rodComponents);
+    mFingerprint = std::move(fingerprint);
+    mIsValid = true;
+    mErrorMessage.clear();
+    return true;
+}
+
+//! Forget the assembled rod
+void RodAssembly::clear()
+{
+    mBuffers.clear();
+    mFingerprint.clear();
+    mIsValid = false;
+    mIsCached = false;
+}
+
+/*!
+ * \brief Interpolate an element of arrays of a data object linearly at increasing parameters
+ *
+ * Values are clamped at the ends. Arrays which consist of a single value are broadcasted to all the elements.
+ * Since the parameters are sorted, the items are traversed only once.
+ */
+void RodAssembly::sampleElement(AbstractDataObject const* pDataObject, IndexType iElement, std::vector<double> const& parameters,
+                                std::vector<double>& values, double defaultValue)
+{
+    quint32 numParameters = parameters.size();
+    values.resize(numParameters);
+    if (!pDataObject || pDataObject->getItems().empty())
+    {
+        std::fill(values.begin(), values.end(), defaultValue);
+        return;
+    }
+    DataHolder const& items = pDataObject->getItems();
+    auto element = [iElement](DataItemType const& item)
+    {
+        return item.size() > iElement ? item.data()[iElement] : item.data()[0];
+    };
+    auto iterPrevious = items.begin();
+    auto iterNext = items.begin();
+    for (quint32 i = 0; i != numParameters; ++i)
+    {
+        double parameter = parameters[i];
+        while (iterNext != items.end() && iterNext->first < parameter)
+        {
+            iterPrevious = iterNext;
+            ++iterNext;
+        }
+        if (iterNext == items.end())
+        {
+            values[i] = element(iterPrevious->second);
+        }
+        else if (iterNext == iterPrevious || iterNext->first == parameter)
+        {
+            values[i] = element(iterNext->second);
+        }
+        else
+        {
+            double ratio = (parameter - iterPrevious->first) / (iterNext->first - iterPrevious->first);
+            double previousValue = element(iterPrevious->second);
+            values[i] = previousValue + ratio * (element(iterNext->second) - previousValue);
+        }
+    }
+}
+
+//! Check the components and gather everything which the result depends on
+bool RodAssembly::computeFingerprint(RodDefinition const& definition, RodComponents const& rodComponents,
+                                     std::vector<quint64>& fingerprint)
+{
+    using Type = AbstractRodComponent::ComponentType;
+    if (definition.numStations < 2)
+    {
+        mErrorMessage = QString("Rod should consist of two stations at least");
+        return false;
+    }
+    auto pGeometry = findComponent<GeometryRodComponent>(rodComponents, definition.geometryID, Type::kGeometry);
+    if (!pGeometry || !pGeometry->radiusVector() || pGeometry->radiusVector()->getItems().empty())
+    {
+        mErrorMessage = QString("Geometry of the rod is not specified");
+        return false;
+    }
+    auto pSection = findUserSection(rodComponents, definition.sectionID);
+    auto pMaterial = findComponent<MaterialRodComponent>(rodComponents, definition.materialID, Type::kMaterial);
+    auto pMechanical = findComponent<MechanicalRodComponent>(rodComponents, definition.mechanicalID, Type::kMechanical);
+    if (!pMechanical && (!pSection || !pSection->isDataComplete() || !pMaterial || !pMaterial->isDataComplete()))
+    {
+        mErrorMessage = QString("Either a complete section and material or mechanical properties should be specified");
+        return false;
+    }
+    fingerprint.push_back(definition.numStations);
+    // Geometry
+    fingerprint.push_back(definition.geometryID);
+    appendDataObject(fingerprint, pGeometry->radiusVector());
+    appendDataObject(fingerprint, pGeometry->rotationMatrix());
+    fingerprint.push_back(definition.frameType);
+    // Section
+    fingerprint.push_back(pSection ? definition.sectionID : 0);
+    if (pSection)
+    {
+        appendDataObject(fingerprint, pSection->area());
+        appendDataObject(fingerprint, pSection->inertiaMomentTorsional());
+        appendDataObject(fingerprint, pSection->inertiaMomentX());
+        appendDataObject(fingerprint, pSection->inertiaMomentY());
+        appendDataObject(fingerprint, pSection->centerCoordinateX());
+        appendDataObject(fingerprint, pSection->centerCoordinateY());
+    }
+    // Material
+    fingerprint.push_back(pMaterial ? definition.materialID : 0);
+    if (pMaterial)
+    {
+        appendDataObject(fingerprint, pMaterial->elasticModulus());
+        appendDataObject(fingerprint, pMaterial->shearModulus());
+        appendDataObject(fingerprint, pMaterial->poissonsRatio());
+        appendDataObject(fingerprint, pMaterial->density());
+    }
+    // Mechanical properties
+    fingerprint.push_back(pMechanical ? definition.mechanicalID : 0);
+    if (pMechanical)
+    {
+        appendDataObject(fingerprint, pMechanical->tensionStiffness());
+        appendDataObject(fingerprint, pMechanical->torsionalStiffness());
+        appendDataObject(fingerprint, pMechanical->bendingStiffnessX());
+        appendDataObject(fingerprint, pMechanical->bendingStiffnessY());
+        appendDataObject(fingerprint, pMechanical->linearMassDensity());
+        appendDataObject(fingerprint, pMechanical->inertiaMassMomentX());
+        appendDataObject(fingerprint, pMechanical->inertiaMassMomentY());
+        appendDataObject(fingerprint, pMechanical->inertiaMassMomentZ());
+        appendDataObject(fingerprint, pMechanical->eccentricityX());
+        appendDataObject(fingerprint, pMechanical->eccentricityY());
+        appendDataObject(fingerprint, pMechanical->contactDiameter());
+    }
+    // Loads
+    for (DataIDType id : definition.loadIDs)
+    {
+        auto pLoad = findComponent<LoadRodComponent>(rodComponents, id, Type::kLoad);
+        if (!pLoad || !pLoad->isDataComplete())
+            continue;
+        fingerprint.push_back(id);
+        fingerprint.push_back(pLoad->loadType());
+        fingerprint.push_back(pLoad->isFollowing());
+        fingerprint.push_back(std::bit_cast<quint64>(pLoad->multiplier()));
+        appendDataObject(fingerprint, pLoad->directionVector());
+        appendDataObject(fingerprint, pLoad->longitudinalFunction());
+        appendDataObject(fingerprint, pLoad->timeCoefficient());
+    }
+    // Constraints
+    for (DataIDType id : {definition.startConstraintID, definition.endConstraintID})
+    {
+        auto pConstraint = findComponent<ConstraintRodComponent>(rodComponents, id, Type::kConstraint);
+        fingerprint.push_back(pConstraint ? id : 0);
+        if (!pConstraint)
+            continue;
+        for (auto const& [type, coordinateSystem] : pConstraint->constraints())
+            fingerprint.push_back(((quint64)type << 1) | (quint64)coordinateSystem);
+    }
+    return true;
+}
+
+//! Distribute stations uniformly along the arc length of the geometry and evaluate the curve at them
+void RodAssembly::placeStations(RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    auto pGeometry = findComponent<GeometryRodComponent>(rodComponents, definition.geometryID,
+                                                         AbstractRodComponent::ComponentType::kGeometry);
+    mParametrization.update(pGeometry->radiusVector());
+    quint32 numStations = definition.numStations;
+    double length = mParametrization.length();
+    std::vector<double>& arcLengths = mBuffers.arcLengths;
+    arcLengths.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+        arcLengths[i] = length * i / (numStations - 1);
+    mParametrization.computeParameters(arcLengths, mBuffers.parameters);
+    mParametrization.computePositions(mBuffers.parameters, mBuffers.positions);
+    mParametrization.computeCurvatures(mBuffers.parameters, mBuffers.curvatures, mBuffers.torsions);
+}
+
+//! Request frames at the stations or generate them from the radius vector if the rotation matrix is not given
+void RodAssembly::addGeometryFields(RodSampler& sampler, RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    auto pGeometry = findComponent<GeometryRodComponent>(rodComponents, definition.geometryID,
+                                                         AbstractRodComponent::ComponentType::kGeometry);
+    MatrixDataObject const* pRotationMatrix = pGeometry->rotationMatrix();
+    if (!pRotationMatrix || pRotationMatrix->getItems().empty())
+    {
+        mMovingFrames.compute(mParametrization, mBuffers.parameters, definition.frameType, mBuffers.frames);
+        return;
+    }
+    for (IndexType i = 0; i != 9; ++i)
+        sampler.addField(pRotationMatrix, i, allocate(mBuffers.frames[i]));
+}
+
+//! Request distributions of the section, material and mechanical properties
+void RodAssembly::addPropertyFields(RodSampler& sampler, RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    using Type = AbstractRodComponent::ComponentType;
+    using M = MechanicalRodComponent;
+    auto pSection = findUserSection(rodComponents, definition.sectionID);
+    auto pMaterial = findComponent<MaterialRodComponent>(rodComponents, definition.materialID, Type::kMaterial);
+    auto pMechanical = findComponent<MechanicalRodComponent>(rodComponents, definition.mechanicalID, Type::kMechanical);
+    auto given = [pMechanical](ScalarDataObject const* (M::*getter)() const) -> ScalarDataObject const*
+    {
+        return pMechanical ? (pMechanical->*getter)() : nullptr;
+    };
+    // Properties of the section and material are zero if they are not given
+    bool isComputed = pSection && pMaterial;
+    auto addComputedField = [&](ScalarDataObject const* pDataObject, std::vector<double>& values)
+    {
+        sampler.addField(isComputed ? pDataObject : nullptr, 0, allocate(values));
+    };
+    addComputedField(pSection ? pSection->area() : nullptr, mDistributions.area);
+    addComputedField(pSection ? pSection->inertiaMomentTorsional() : nullptr, mDistributions.inertiaMomentTorsional);
+    addComputedField(pSection ? pSection->inertiaMomentX() : nullptr, mDistributions.inertiaMomentX);
+    addComputedField(pSection ? pSection->inertiaMomentY() : nullptr, mDistributions.inertiaMomentY);
+    addComputedField(pMaterial ? pMaterial->elasticModulus() : nullptr, mDistributions.elasticModulus);
+    addComputedField(pMaterial ? pMaterial->shearModulus() : nullptr, mDistributions.shearModulus);
+    addComputedField(pMaterial ? pMaterial->poissonsRatio() : nullptr, mDistributions.poissonsRatio);
+    addComputedField(pMaterial ? pMaterial->density() : nullptr, mDistributions.density);
+    // Eccentricities are taken from the mechanical component if they are given there
+    if (given(&M::eccentricityX))
+        sampler.addField(given(&M::eccentricityX), 0, allocate(mBuffers.eccentricityX));
+    else
+        addComputedField(pSection ? pSection->centerCoordinateX() : nullptr, mBuffers.eccentricityX);
+    if (given(&M::eccentricityY))
+        sampler.addField(given(&M::eccentricityY), 0, allocate(mBuffers.eccentricityY));
+    else
+        addComputedField(pSection ? pSection->centerCoordinateY() : nullptr, mBuffers.eccentricityY);
+    // Other distributions which are given explicitly are sampled directly into the buffers
+    auto addMechanicalField = [&](ScalarDataObject const* (M::*getter)() const, std::vector<double>& values)
+    {
+        double* pValues = allocate(values);
+        if (given(getter))
+            sampler.addField(given(getter), 0, pValues);
+    };
+    addMechanicalField(&M::tensionStiffness, mBuffers.tensionStiffness);
+    allocate(mBuffers.shearStiffness);
+    addMechanicalField(&M::torsionalStiffness, mBuffers.torsionalStiffness);
+    addMechanicalField(&M::bendingStiffnessX, mBuffers.bendingStiffnessX);
+    addMechanicalField(&M::bendingStiffnessY, mBuffers.bendingStiffnessY);
+    addMechanicalField(&M::linearMassDensity, mBuffers.linearMassDensity);
+    addMechanicalField(&M::inertiaMassMomentX, mBuffers.inertiaMassMomentX);
+    addMechanicalField(&M::inertiaMassMomentY, mBuffers.inertiaMassMomentY);
+    addMechanicalField(&M::inertiaMassMomentZ, mBuffers.inertiaMassMomentZ);
+    addMechanicalField(&M::contactDiameter, mBuffers.contactDiameter);
+}
+
+//! Request direction vectors and longitudinal functions of the loads
+void RodAssembly::addLoadFields(RodSampler& sampler, RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    std::vector<LoadRodComponent const*> loads;
+    for (DataIDType id : definition.loadIDs)
+    {
+        auto pLoad = findComponent<LoadRodComponent>(rodComponents, id, AbstractRodComponent::ComponentType::kLoad);
+        if (pLoad && pLoad->isDataComplete())
+            loads.push_back(pLoad);
+    }
+    quint32 numLoads = loads.size();
+    mBuffers.loads.resize(numLoads);
+    mDistributions.loadFactors.resize(numLoads);
+    for (quint32 i = 0; i != numLoads; ++i)
+    {
+        LoadRodComponent const* pLoad = loads[i];
+        RodLoadBuffer& load = mBuffers.loads[i];
+        load.type = pLoad->loadType();
+        load.isFollowing = pLoad->isFollowing();
+        sampler.addField(pLoad->longitudinalFunction(), 0, allocate(mDistributions.loadFactors[i]), 1.0);
+        for (IndexType j = 0; j != 3; ++j)
+            sampler.addField(pLoad->directionVector(), j, allocate(load.values[j]));
+        ScalarDataObject const* pTimeCoefficient = pLoad->timeCoefficient();
+        if (pTimeCoefficient)
+        {
+            for (auto const& [key, item] : pTimeCoefficient->getItems())
+            {
+                load.timeKeys.push_back(key);
+                load.timeValues.push_back(item.data()[0]);
+            }
+        }
+    }
+}
+
+//! Compute stiffness, mass and contact diameter unless they are given explicitly
+void RodAssembly::computeProperties(RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    using Type = AbstractRodComponent::ComponentType;
+    auto pSection = findUserSection(rodComponents, definition.sectionID);
+    auto pMaterial = findComponent<MaterialRodComponent>(rodComponents, definition.materialID, Type::kMaterial);
+    auto pMechanical = findComponent<MechanicalRodComponent>(rodComponents, definition.mechanicalID, Type::kMechanical);
+    quint32 numStations = mBuffers.numStations();
+    Distributions& d = mDistributions;
+    if (pSection && pMaterial)
+    {
+        for (quint32 i = 0; i != numStations; ++i)
+        {
+            // The polar moment of inertia is used unless the torsional one is given
+            if (!pSection->inertiaMomentTorsional())
+                d.inertiaMomentTorsional[i] = d.inertiaMomentX[i] + d.inertiaMomentY[i];
+            if (!pMaterial->shearModulus())
+                d.shearModulus[i] = d.elasticModulus[i] / (2.0 * (1.0 + d.poissonsRatio[i]));
+        }
+    }
+    auto compute = [numStations](ScalarDataObject const* pGiven, std::vector<double>& values, auto const& function)
+    {
+        if (pGiven)
+            return;
+        for (quint32 i = 0; i != numStations; ++i)
+            values[i] = function(i);
+    };
+    using M = MechanicalRodComponent;
+    auto given = [pMechanical](ScalarDataObject const* (M::*getter)() const) -> ScalarDataObject const*
+    {
+        return pMechanical ? (pMechanical->*getter)() : nullptr;
+    };
+    compute(given(&M::tensionStiffness), mBuffers.tensionStiffness,
+            [&d](quint32 i) { return d.elasticModulus[i] * d.area[i]; });
+    // The shear stiffness cannot be set explicitly, so it is estimated from the tension one for an isotropic material
+    // unless the section and material are given
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        double shearStiffness = d.shearModulus[i] * d.area[i];
+        if (shearStiffness <= 0.0)
+            shearStiffness = mBuffers.tensionStiffness[i] / (2.0 * (1.0 + skDefaultPoissonsRatio));
+        mBuffers.shearStiffness[i] = shearStiffness;
+    }
+    compute(given(&M::torsionalStiffness), mBuffers.torsionalStiffness,
+            [&d](quint32 i) { return d.shearModulus[i] * d.inertiaMomentTorsional[i]; });
+    compute(given(&M::bendingStiffnessX), mBuffers.bendingStiffnessX,
+            [&d](quint32 i) { return d.elasticModulus[i] * d.inertiaMomentX[i]; });
+    compute(given(&M::bendingStiffnessY), mBuffers.bendingStiffnessY,
+            [&d](quint32 i) { return d.elasticModulus[i] * d.inertiaMomentY[i]; });
+    compute(given(&M::linearMassDensity), mBuffers.linearMassDensity,
+            [&d](quint32 i) { return d.density[i] * d.area[i]; });
+    compute(given(&M::inertiaMassMomentX), mBuffers.inertiaMassMomentX,
+            [&d](quint32 i) { return d.density[i] * d.inertiaMomentX[i]; });
+    compute(given(&M::inertiaMassMomentY), mBuffers.inertiaMassMomentY,
+            [&d](quint32 i) { return d.density[i] * d.inertiaMomentY[i]; });
+    compute(given(&M::inertiaMassMomentZ), mBuffers.inertiaMassMomentZ,
+            [&d](quint32 i) { return d.density[i] * (d.inertiaMomentX[i] + d.inertiaMomentY[i]); });
+    // Diameter of the circle of the same area
+    compute(given(&M::contactDiameter), mBuffers.contactDiameter,
+            [&d](quint32 i) { return 2.0 * std::sqrt(d.area[i] / std::numbers::pi); });
+}
+
+//! Scale direction vectors of the loads by their longitudinal functions and multipliers
+void RodAssembly::scaleLoads(RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    quint32 numStations = mBuffers.numStations();
+    quint32 iLoad = 0;
+    for (DataIDType id : definition.loadIDs)
+    {
+        auto pLoad = findComponent<LoadRodComponent>(rodComponents, id, AbstractRodComponent::ComponentType::kLoad);
+        if (!pLoad || !pLoad->isDataComplete())
+            continue;
+        std::vector<double> const& factors = mDistributions.loadFactors[iLoad];
+        for (auto& values : mBuffers.loads[iLoad].values)
+        {
+            for (quint32 i = 0; i != numStations; ++i)
+                values[i] *= factors[i] * pLoad->multiplier();
+        }
+        ++iLoad;
+    }
+}
+
+//! Size a buffer by the number of stations and return a pointer to write values into
+double* RodAssembly::allocate(std::vector<double>& values)
+{
+    values.resize(mBuffers.numStations());
+    return values.data();
+}
+
+//! Set masks of the degrees of freedom which are constrained at the ends
+void RodAssembly::setConstraints(RodDefinition const& definition, RodComponents const& rodComponents)
+{
+    quint32 numStations = mBuffers.numStations();
+    mBuffers.constraintMasks.assign(numStations, 0);
+    mBuffers.localConstraintMasks.assign(numStations, 0);
+    std::array<DataIDType, 2> const ids = {definition.startConstraintID, definition.endConstraintID};
+    std::array<quint32, 2> const stations = {0, numStations - 1};
+    for (int i = 0; i != 2; ++i)
+    {
+        auto pConstraint = findComponent<ConstraintRodComponent>(rodComponents, ids[i],
+                                                                 AbstractRodComponent::ComponentType::kConstraint);
+        if (!pConstraint)
+            continue;
+        for (auto const& [type, coordinateSystem] : pConstraint->constraints())
+        {
+            quint8 bit = 1u << type;
+            mBuffers.constraintMasks[stations[i]] |= bit;
+            if (coordinateSystem == ConstraintRodComponent::kLocal)
+                mBuffers.localConstraintMasks[stations[i]] |= bit;
+        }
+    }
+}
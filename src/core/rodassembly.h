@@ -0,0 +1,158 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodAssembly class
+ */
+
+#ifndef RODASSEMBLY_H
+#define RODASSEMBLY_H
+
+#include <QString>
+#include <array>
+#include <vector>
+#include "aliasdataset.h"
+#include "arclengthparametrization.h"
+#include "movingframes.h"
+#include "loadrodcomponent.h"
+
+namespace QRS::Core
+{
+
+class RodSampler;
+
+//! Rod components which a rod is assembled from
+struct RodDefinition
+{
+    DataIDType geometryID = 0;
+    DataIDType sectionID = 0;
+    DataIDType materialID = 0;
+    //! Optional component whose distributions substitute the ones computed by the section and material
+    DataIDType mechanicalID = 0;
+    std::vector<DataIDType> loadIDs;
+    //! Constraints applied at the first and last stations
+    DataIDType startConstraintID = 0;
+    DataIDType endConstraintID = 0;
+    quint32 numStations = 101;
+    //! Frames which are generated if the geometry has no rotation matrix
+    MovingFrames::FrameType frameType = MovingFrames::kRotationMinimizing;
+};
+
+//! Load tabulated at stations of a rod
+struct RodLoadBuffer
+{
+    LoadRodComponent::LoadType type;
+    bool isFollowing;
+    //! Direction vector scaled by the longitudinal function and multiplier
+    std::array<std::vector<double>, 3> values;
+    //! Time coefficient given by keys and values
+    std::vector<double> timeKeys;
+    std::vector<double> timeValues;
+};
+
+/*!
+ * \brief Properties of a rod sampled at stations
+ *
+ * Each property is stored contiguously over all the stations, so that solvers and renderers can stream through them.
+ * Vectors and matrices are split into separate buffers by elements, matrices are stored in the row-major order.
+ */
+struct RodBuffers
+{
+    quint32 numStations() const { return parameters.size(); }
+    void clear();
+    //! Keys of the geometry which the stations are placed at
+    std::vector<double> parameters;
+    //! Distances from the first station along the rod which the other distributions are given along
+    std::vector<double> arcLengths;
+    // Geometry
+    std::array<std::vector<double>, 3> positions;
+    std::array<std::vector<double>, 9> frames;
+    std::vector<double> curvatures;
+    std::vector<double> torsions;
+    // Stiffness
+    std::vector<double> tensionStiffness;
+    std::vector<double> shearStiffness;
+    std::vector<double> torsionalStiffness;
+    std::vector<double> bendingStiffnessX;
+    std::vector<double> bendingStiffnessY;
+    // Mass
+    std::vector<double> linearMassDensity;
+    std::vector<double> inertiaMassMomentX;
+    std::vector<double> inertiaMassMomentY;
+    std::vector<double> inertiaMassMomentZ;
+    // Eccentricity
+    std::vector<double> eccentricityX;
+    std::vector<double> eccentricityY;
+    // Contact diameter
+    std::vector<double> contactDiameter;
+    // Loads
+    std::vector<RodLoadBuffer> loads;
+    //! Bits of the constrained degrees of freedom ordered as ConstraintRodComponent::ConstraintType
+    std::vector<quint8> constraintMasks;
+    //! Bits of the constraints which are specified in the local coordinate system
+    std::vector<quint8> localConstraintMasks;
+};
+
+/*!
+ * \brief Engine which compiles rod components into flat buffers
+ *
+ * The result is cached together with the fingerprint of all the inputs: identifiers of the components, their settings
+ * as well as identifiers and versions of the data objects they refer to. So, the rod is sampled again only if one
+ * of the inputs has been changed since the previous assembly. Stations are distributed uniformly along the arc length
+ * by means of the parametrization of the geometry, which is kept while the radius vector is the same. The rotation
+ * matrix is sampled along the parameter of the geometry, and the rest of distributions are sampled along the arc length.
+ * If the rotation matrix is not given, the frames are generated from the radius vector.
+ */
+class RodAssembly
+{
+public:
+    bool assemble(RodDefinition const& definition, RodComponents const& rodComponents);
+    RodBuffers const& buffers() const { return mBuffers; }
+    ArcLengthParametrization const& parametrization() const { return mParametrization; }
+    bool isValid() const { return mIsValid; }
+    //! Check whether the last assembly reused the buffers computed before
+    bool isCached() const { return mIsCached; }
+    QString const& errorMessage() const { return mErrorMessage; }
+    void clear();
+    static void sampleElement(AbstractDataObject const* pDataObject, IndexType iElement, std::vector<double> const& parameters,
+                              std::vector<double>& values, double defaultValue = 0.0);
+
+private:
+    bool computeFingerprint(RodDefinition const& definition, RodComponents const& rodComponents,
+                            std::vector<quint64>& fingerprint);
+    void placeStations(RodDefinition const& definition, RodComponents const& rodComponents);
+    void addGeometryFields(RodSampler& sampler, RodDefinition const& definition, RodComponents const& rodComponents);
+    void addPropertyFields(RodSampler& sampler, RodDefinition const& definition, RodComponents const& rodComponents);
+    void addLoadFields(RodSampler& sampler, RodDefinition const& definition, RodComponents const& rodComponents);
+    void computeProperties(RodDefinition const& definition, RodComponents const& rodComponents);
+    void scaleLoads(RodDefinition const& definition, RodComponents const& rodComponents);
+    void setConstraints(RodDefinition const& definition, RodComponents const& rodComponents);
+    double* allocate(std::vector<double>& values);
+
+private:
+    //! Intermediate distributions which the buffers are computed from
+    struct Distributions
+    {
+        std::vector<double> area;
+        std::vector<double> inertiaMomentTorsional;
+        std::vector<double> inertiaMomentX;
+        std::vector<double> inertiaMomentY;
+        std::vector<double> elasticModulus;
+        std::vector<double> shearModulus;
+        std::vector<double> poissonsRatio;
+        std::vector<double> density;
+        std::vector<std::vector<double>> loadFactors;
+    };
+    RodBuffers mBuffers;
+    Distributions mDistributions;
+    ArcLengthParametrization mParametrization;
+    MovingFrames mMovingFrames;
+    std::vector<quint64> mFingerprint;
+    bool mIsValid = false;
+    bool mIsCached = false;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // RODASSEMBLY_H
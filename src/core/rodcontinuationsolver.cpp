@@ -0,0 +1,185 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodContinuationSolver class
+ */
+
+#include "rodcontinuationsolver.h"
+
+using namespace QRS::Core;
+
+//! Maximum number of times the arc length is halved when the iterations of a step diverge
+int const skMaxNumCutbacks = 10;
+//! Ratio of the maximum arc length to the initial one
+double const skMaxArcLengthGrowth = 16.0;
+//! Ratio of consecutive residuals above which the tangent matrix is assembled and factorized anew
+double const skMaxContractionRatio = 0.25;
+
+/*!
+ * \brief Trace the equilibrium path of the rod from the reference configuration
+ *
+ * The path stops when the absolute value of the load factor exceeds the maximum one, when the maximum number of steps
+ * is done, or when the writer asks to stop. If the iterations do not converge at a step, it is restarted from the
+ * previous equilibrium with half the arc length.
+ * \param writer Function which is called with each converged state
+ * \return Whether the path has been traced without failures. Otherwise, the reason is given by errorMessage()
+ */
+bool RodContinuationSolver::solve(RodBuffers const& buffers, RodContinuationOptions const& options,
+                                  RodStateWriterFun const& writer)
+{
+    mLoadFactor = 0.0;
+    mLoadStep = 0.0;
+    mNumSteps = 0;
+    mNumIterations = 0;
+    mNumFactorizations = 0;
+    mResidualNorm = 0.0;
+    mErrorMessage.clear();
+    mPredictor.clear();
+    mPredictorLoadStep = 0.0;
+    mTangent.resize(0);
+    if (!mModel.initialize(buffers, options.time))
+    {
+        mErrorMessage = mModel.errorMessage();
+        return false;
+    }
+    mModel.exportState(mState);
+    // The initial arc length corresponds to the given increment of the load factor along the tangent of the path
+    if (!factorizeTangent(0.0))
+        return false;
+    computeLoadIncrements();
+    mArcLength = std::abs(options.initialLoadStep) * std::sqrt(computeDotProduct(mLoadIncrements, mLoadIncrements) + 1.0);
+    double maxArcLength = skMaxArcLengthGrowth * mArcLength;
+    double minArcLength = mArcLength / (1u << skMaxNumCutbacks);
+    while (mNumSteps != options.maxNumSteps && std::abs(mLoadFactor) < options.maxLoadFactor)
+    {
+        mDisplacements = mModel.displacements();
+        mRotations = mModel.rotations();
+        if (!solveStep(options))
+        {
+            mModel.setConfiguration(mDisplacements, mRotations);
+            mTangent.resize(0);
+            mArcLength *= 0.5;
+            if (mArcLength < minArcLength)
+                return false;
+            continue;
+        }
+        mLoadFactor += mLoadStep;
+        ++mNumSteps;
+        mModel.exportState(mState);
+        if (writer && !writer(mLoadFactor, mState))
+            break;
+        // Steps which converge fast are lengthened, and slow ones are shortened
+        double ratio = std::sqrt((double)options.desiredNumIterations / std::max(mNumStepIterations, 1u));
+        mArcLength = std::clamp(ratio * mArcLength, minArcLength, std::min(2.0 * mArcLength, maxArcLength));
+    }
+    mErrorMessage.clear();
+    return true;
+}
+
+//! Assemble and factorize the tangent matrix at the current configuration
+bool RodContinuationSolver::factorizeTangent(double loadFactor)
+{
+    mResidualNorm = mModel.computeTangent(loadFactor, mTangent, mResidual);
+    ++mNumFactorizations;
+    if (!mTangent.factorize())
+    {
+        mErrorMessage = QString("Tangent matrix of the rod is singular");
+        return false;
+    }
+    return true;
+}
+
+//! Solve the tangent system for the current loads
+void RodContinuationSolver::computeLoadIncrements()
+{
+    mModel.computeLoads(mLoads);
+    mLoadIncrements = mLoads;
+    mTangent.solve(mLoadIncrements);
+    mModel.expand(mLoadIncrements);
+}
+
+/*!
+ * \brief Find the next point of the path at the current arc length
+ *
+ * The predictor follows the tangent of the path in the direction of the previous predictor. The corrections are
+ * orthogonal to the predictor, so that the load factor is one more unknown.
+ */
+bool RodContinuationSolver::solveStep(RodContinuationOptions const& options)
+{
+    quint32 numStations = mModel.numStations();
+    mNumStepIterations = 0;
+    if (!mTangent.isFactorized() && !factorizeTangent(mLoadFactor))
+        return false;
+    computeLoadIncrements();
+    // Predictor
+    double loadStep = mArcLength / std::sqrt(computeDotProduct(mLoadIncrements, mLoadIncrements) + 1.0);
+    if (computeDotProduct(mPredictor, mLoadIncrements) + mPredictorLoadStep < 0.0)
+        loadStep = -loadStep;
+    mPredictor = mLoadIncrements;
+    for (Vector6& values : mPredictor)
+        values *= loadStep;
+    mPredictorLoadStep = loadStep;
+    mLoadStep = loadStep;
+    mModel.update(mPredictor);
+    // Corrector
+    double loadNorm = mModel.loadNorm();
+    double lastResidualNorm = 0.0;
+    for (quint32 iIteration = 0; iIteration != options.maxNumIterations; ++iIteration)
+    {
+        double loadFactor = mLoadFactor + mLoadStep;
+        double tolerance = options.tolerance * std::max(std::abs(loadFactor) * loadNorm, 1.0);
+        mResidualNorm = mModel.computeResidual(loadFactor, mResidual);
+        if (mResidualNorm <= tolerance)
+            return true;
+        if (!std::isfinite(mResidualNorm))
+            break;
+        // The factorization is reused while the iterations converge fast enough
+        if (iIteration > 0 && mResidualNorm > skMaxContractionRatio * lastResidualNorm)
+        {
+            if (!factorizeTangent(loadFactor))
+                return false;
+        }
+        lastResidualNorm = mResidualNorm;
+        computeLoadIncrements();
+        mIncrements = mResidual;
+        for (Vector6& values : mIncrements)
+            values *= -1.0;
+        mTangent.solve(mIncrements);
+        mModel.expand(mIncrements);
+        double denominator = computeDotProduct(mPredictor, mLoadIncrements) + mPredictorLoadStep;
+        double loadIncrement = -computeDotProduct(mPredictor, mIncrements) / denominator;
+        for (quint32 i = 0; i != numStations; ++i)
+            mIncrements[i] += loadIncrement * mLoadIncrements[i];
+        mModel.update(mIncrements);
+        mLoadStep += loadIncrement;
+        ++mNumStepIterations;
+        ++mNumIterations;
+        // Once the increments are negligible, the residual is dominated by rounding errors of the internal loads
+        double incrementNorm = std::max(mModel.computeIncrementNorm(mIncrements), std::abs(loadIncrement));
+        if (incrementNorm <= options.tolerance)
+        {
+            mResidualNorm = mModel.computeResidual(mLoadFactor + mLoadStep, mResidual);
+            return true;
+        }
+        if (incrementNorm > RodModel::skMaxIncrementNorm || !std::isfinite(incrementNorm))
+            break;
+    }
+    mErrorMessage = QString("Equilibrium of the rod has not been found at the load factor %1").arg(mLoadFactor + mLoadStep);
+    return false;
+}
+
+//! Compute the dot product of increments of the stations, where the translations are relative to the length of the rod
+double RodContinuationSolver::computeDotProduct(std::vector<Vector6> const& first, std::vector<Vector6> const& second) const
+{
+    double squaredLength = mModel.length() * mModel.length();
+    double result = 0.0;
+    quint32 numStations = first.size();
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector6 const& a = first[i];
+        Vector6 const& b = second[i];
+        result += (a[0] * b[0] + a[1] * b[1] + a[2] * b[2]) / squaredLength + a[3] * b[3] + a[4] * b[4] + a[5] * b[5];
+    }
+    return result;
+}
@@ -0,0 +1,97 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodContinuationSolver class
+ */
+
+#ifndef RODCONTINUATIONSOLVER_H
+#define RODCONTINUATIONSOLVER_H
+
+#include "rodmodel.h"
+
+namespace QRS::Core
+{
+
+//! Settings of the continuation over the load factor
+struct RodContinuationOptions
+{
+    //! Maximum number of points of the path
+    quint32 maxNumSteps = 100;
+    //! Absolute value of the load factor which the path stops at
+    double maxLoadFactor = 1.0;
+    //! Increment of the load factor at the first step, which determines the initial arc length
+    double initialLoadStep = 0.1;
+    //! Number of iterations per step which the arc length is adapted to
+    quint32 desiredNumIterations = 5;
+    //! Maximum number of iterations at each step
+    quint32 maxNumIterations = 20;
+    //! Tolerance of the residual relative to the norm of the applied loads and of the increments of the stations
+    double tolerance = 1e-8;
+    //! Time which the coefficients of the loads are evaluated at
+    double time = 0.0;
+};
+
+/*!
+ * \brief Solver which traces the equilibrium path of a rod as the load factor changes
+ *
+ * The path is parametrized by its arc length in the space of the load factor and the increments of the stations,
+ * where the translations are relative to the length of the rod. Each step is predicted along the tangent of the path
+ * and corrected in the plane normal to the prediction, as proposed by Riks, so that limit points and snap-through are
+ * passed. The factorization of the tangent matrix is kept from the previous iterations and steps as long as the
+ * residual decreases fast enough, so most iterations take only an assembly of the residual and two substitutions.
+ * The arc length is adapted to the number of iterations of the previous step.
+ */
+class RodContinuationSolver
+{
+public:
+    bool solve(RodBuffers const& buffers, RodContinuationOptions const& options = RodContinuationOptions(),
+               RodStateWriterFun const& writer = RodStateWriterFun());
+    RodModel const& model() const { return mModel; }
+    RodState const& state() const { return mState; }
+    //! Load factor of the last converged state
+    double loadFactor() const { return mLoadFactor; }
+    //! Number of converged states along the path
+    quint32 numSteps() const { return mNumSteps; }
+    //! Total number of iterations over all the steps
+    quint32 numIterations() const { return mNumIterations; }
+    //! Number of times the tangent matrix has been factorized
+    quint32 numFactorizations() const { return mNumFactorizations; }
+    double residualNorm() const { return mResidualNorm; }
+    QString const& errorMessage() const { return mErrorMessage; }
+
+private:
+    bool factorizeTangent(double loadFactor);
+    void computeLoadIncrements();
+    bool solveStep(RodContinuationOptions const& options);
+    double computeDotProduct(std::vector<Vector6> const& first, std::vector<Vector6> const& second) const;
+
+private:
+    RodModel mModel;
+    RodState mState;
+    BlockTridiagonalMatrix mTangent;
+    std::vector<Vector6> mResidual;
+    std::vector<Vector6> mLoads;
+    // Solutions of the tangent system for the residual and for the loads
+    std::vector<Vector6> mIncrements;
+    std::vector<Vector6> mLoadIncrements;
+    // Predictor of the current step, which gives the direction of the path to the next one
+    std::vector<Vector6> mPredictor;
+    double mPredictorLoadStep = 0.0;
+    double mArcLength = 0.0;
+    double mLoadFactor = 0.0;
+    double mLoadStep = 0.0;
+    // Configuration at the last equilibrium
+    std::vector<Vector3> mDisplacements;
+    std::vector<Matrix33> mRotations;
+    quint32 mNumSteps = 0;
+    quint32 mNumStepIterations = 0;
+    quint32 mNumIterations = 0;
+    quint32 mNumFactorizations = 0;
+    double mResidualNorm = 0.0;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // RODCONTINUATIONSOLVER_H
@@ -0,0 +1,233 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodDynamicSolver class
+ */
+
+#include "roddynamicsolver.h"
+#include "rotations.h"
+
+using namespace QRS::Core;
+using namespace QRS::Core::Rotations;
+
+//! Safety factor and bounds of the ratio of consecutive time steps
+double const skTimeStepSafety = 0.9;
+double const skMinTimeStepRatio = 0.2;
+double const skMaxTimeStepRatio = 2.0;
+
+/*!
+ * \brief Integrate the motion of the rod which starts at rest in the reference configuration
+ *
+ * If the iterations do not converge at a step or its local error is too large, the step is repeated with a smaller
+ * time step. The state at the start time and at each accepted step is passed to the writer.
+ * \param writer Function which is called with the time and state of the rod
+ * \return Whether the end time has been reached. Otherwise, the reason is given by errorMessage()
+ */
+bool RodDynamicSolver::solve(RodBuffers const& buffers, RodDynamicOptions const& options, RodStateWriterFun const& writer)
+{
+    mTime = options.startTime;
+    mNumSteps = 0;
+    mNumRejectedSteps = 0;
+    mNumIterations = 0;
+    mErrorMessage.clear();
+    if (!mModel.initialize(buffers, mTime))
+    {
+        mErrorMessage = mModel.errorMessage();
+        return false;
+    }
+    setCoefficients(options.spectralRadius);
+    // Work arrays
+    quint32 numStations = mModel.numStations();
+    mDisplacements = mModel.displacements();
+    mRotations = mModel.rotations();
+    mVelocities.assign(numStations, Vector6::zeros());
+    mAccelerations.assign(numStations, Vector6::zeros());
+    mMotion.velocities.assign(numStations, Vector6::zeros());
+    mMotion.accelerations.assign(numStations, Vector6::zeros());
+    mNextPseudoAccelerations.assign(numStations, Vector6::zeros());
+    mIncrements.assign(numStations, Vector6::zeros());
+    mResidual.assign(numStations, Vector6::zeros());
+    mTangent.resize(numStations);
+    computeInitialAccelerations();
+    mPseudoAccelerations = mAccelerations;
+    mModel.exportState(mState);
+    if (writer && !writer(mTime, mState))
+        return true;
+    // Time steps
+    bool isAdaptive = options.errorTolerance > 0.0;
+    double timeStep = std::clamp(options.initialTimeStep, options.minTimeStep, options.maxTimeStep);
+    while (mTime < options.endTime)
+    {
+        double remainingTime = options.endTime - mTime;
+        bool isLast = timeStep >= (1.0 - RodModel::skTimeTolerance) * remainingTime;
+        double currentTimeStep = isLast ? remainingTime : timeStep;
+        bool isConverged = solveStep(currentTimeStep, options);
+        double error = isConverged && isAdaptive ? estimateError(currentTimeStep) : 0.0;
+        double ratio = skMaxTimeStepRatio;
+        if (error > 0.0)
+            ratio = std::clamp(skTimeStepSafety * std::cbrt(options.errorTolerance / error), skMinTimeStepRatio, skMaxTimeStepRatio);
+        if (!isConverged || error > options.errorTolerance)
+        {
+            ++mNumRejectedSteps;
+            mModel.setConfiguration(mDisplacements, mRotations);
+            timeStep = currentTimeStep * (isConverged ? ratio : 0.5);
+            if (timeStep < options.minTimeStep)
+            {
+                mModel.setTime(mTime);
+                mErrorMessage = QString("Time step of the rod has been reduced below the minimum at the time %1").arg(mTime);
+                return false;
+            }
+            continue;
+        }
+        // Accept the step
+        mTime = isLast ? options.endTime : mTime + currentTimeStep;
+        ++mNumSteps;
+        mDisplacements = mModel.displacements();
+        mRotations = mModel.rotations();
+        std::swap(mVelocities, mMotion.velocities);
+        std::swap(mAccelerations, mMotion.accelerations);
+        std::swap(mPseudoAccelerations, mNextPseudoAccelerations);
+        mModel.exportState(mState);
+        if (writer && !writer(mTime, mState))
+            break;
+        if (isAdaptive)
+            timeStep = std::clamp(ratio * currentTimeStep, options.minTimeStep, options.maxTimeStep);
+    }
+    mErrorMessage.clear();
+    return true;
+}
+
+/*!
+ * \brief Compute the coefficients of the scheme which is second-order accurate and has the given spectral radius
+ *
+ * The coefficients are the ones proposed by Chung and Hulbert.
+ */
+void RodDynamicSolver::setCoefficients(double spectralRadius)
+{
+    double radius = std::clamp(spectralRadius, 0.0, 1.0);
+    mAlphaM = (2.0 * radius - 1.0) / (radius + 1.0);
+    mAlphaF = radius / (radius + 1.0);
+    mGamma = 0.5 + mAlphaF - mAlphaM;
+    mBeta = 0.25 * std::pow(mGamma + 0.5, 2);
+}
+
+/*!
+ * \brief Find the accelerations at rest under the loads at the start time
+ *
+ * Degrees of freedom without inertia are not accelerated.
+ */
+void RodDynamicSolver::computeInitialAccelerations()
+{
+    quint32 numStations = mModel.numStations();
+    mModel.computeResidual(1.0, mResidual);
+    mModel.computeMass(mMass);
+    std::array<int, 6> pivots;
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Matrix66 mass = mMass[i];
+        Vector6& acceleration = mAccelerations[i];
+        acceleration = -1.0 * mResidual[i];
+        for (int k = 0; k != 6; ++k)
+        {
+            if (mass(k, k) <= 0.0)
+            {
+                mass(k, k) = 1.0;
+                acceleration[k] = 0.0;
+            }
+        }
+        if (factorizeLU(mass, pivots))
+            solveLU(mass, pivots, acceleration);
+        else
+            acceleration = Vector6::zeros();
+    }
+    mModel.expand(mAccelerations);
+}
+
+//! Find the configuration at the end of the step by the Newton method starting from the constant acceleration
+bool RodDynamicSolver::solveStep(double timeStep, RodDynamicOptions const& options)
+{
+    quint32 numStations = mModel.numStations();
+    mModel.setTime(mTime + timeStep);
+    mMotion.accelerationFactor = (1.0 - mAlphaM) / ((1.0 - mAlphaF) * mBeta * timeStep * timeStep);
+    mMotion.velocityFactor = mGamma / (mBeta * timeStep);
+    // Predictor
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector6 pseudoAcceleration = (1.0 / (1.0 - mAlphaM)) * (mAccelerations[i] - mAlphaM * mPseudoAccelerations[i]);
+        mIncrements[i] = timeStep * (mVelocities[i] + timeStep * ((0.5 - mBeta) * mPseudoAccelerations[i] + mBeta * pseudoAcceleration));
+    }
+    mModel.update(mIncrements);
+    // Corrector
+    for (quint32 iIteration = 0; iIteration != options.maxNumIterations; ++iIteration)
+    {
+        updateMotion(timeStep);
+        double residualNorm = mModel.computeTangent(1.0, mTangent, mResidual, &mMotion);
+        if (!std::isfinite(residualNorm))
+            break;
+        if (!mTangent.factorize())
+        {
+            mErrorMessage = QString("Tangent matrix of the rod is singular");
+            return false;
+        }
+        for (quint32 i = 0; i != numStations; ++i)
+            mIncrements[i] = -1.0 * mResidual[i];
+        mTangent.solve(mIncrements);
+        mModel.expand(mIncrements);
+        mModel.update(mIncrements);
+        ++mNumIterations;
+        double incrementNorm = mModel.computeIncrementNorm(mIncrements);
+        if (incrementNorm <= options.tolerance)
+        {
+            updateMotion(timeStep);
+            return true;
+        }
+        if (incrementNorm > RodModel::skMaxIncrementNorm)
+            break;
+    }
+    mErrorMessage = QString("Motion of the rod has not been found at the time %1").arg(mTime + timeStep);
+    return false;
+}
+
+/*!
+ * \brief Compute velocities and accelerations at the end of the step from the current configuration
+ *
+ * The increment of a frame over the step is the exponential of the spatial rotation vector R_n log(R_n^T R).
+ */
+void RodDynamicSolver::updateMotion(double timeStep)
+{
+    quint32 numStations = mModel.numStations();
+    std::vector<Vector3> const& displacements = mModel.displacements();
+    std::vector<Matrix33> const& rotations = mModel.rotations();
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector3 translation = displacements[i] - mDisplacements[i];
+        Vector3 rotation = mRotations[i] * logMap(transposeProduct(mRotations[i], rotations[i]));
+        Vector6 increment = {translation[0], translation[1], translation[2], rotation[0], rotation[1], rotation[2]};
+        Vector6 const& velocity = mVelocities[i];
+        Vector6 const& acceleration = mAccelerations[i];
+        Vector6 const& lastPseudoAcceleration = mPseudoAccelerations[i];
+        Vector6& pseudoAcceleration = mNextPseudoAccelerations[i];
+        pseudoAcceleration = (1.0 / (mBeta * timeStep))
+                             * ((1.0 / timeStep) * increment - velocity - ((0.5 - mBeta) * timeStep) * lastPseudoAcceleration);
+        mMotion.accelerations[i] = (1.0 / (1.0 - mAlphaF))
+                                   * ((1.0 - mAlphaM) * pseudoAcceleration + mAlphaM * lastPseudoAcceleration - mAlphaF * acceleration);
+        mMotion.velocities[i] = velocity + timeStep * ((1.0 - mGamma) * lastPseudoAcceleration + mGamma * pseudoAcceleration);
+    }
+}
+
+//! Estimate the local error of the configuration by the change of the accelerations over the step
+double RodDynamicSolver::estimateError(double timeStep) const
+{
+    double factor = timeStep * timeStep * std::abs(mBeta - 1.0 / 6.0);
+    double result = 0.0;
+    quint32 numStations = mModel.numStations();
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector6 difference = mNextPseudoAccelerations[i] - mPseudoAccelerations[i];
+        Vector3 translation = {difference[0], difference[1], difference[2]};
+        Vector3 rotation = {difference[3], difference[4], difference[5]};
+        result = std::max({result, norm(translation) / mModel.length(), norm(rotation)});
+    }
+    return factor * result;
+}
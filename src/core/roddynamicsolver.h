@@ -0,0 +1,99 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodDynamicSolver class
+ */
+
+#ifndef RODDYNAMICSOLVER_H
+#define RODDYNAMICSOLVER_H
+
+#include "rodmodel.h"
+
+namespace QRS::Core
+{
+
+//! Settings of the transient analysis
+struct RodDynamicOptions
+{
+    //! Time which the rod is at rest in the reference configuration
+    double startTime = 0.0;
+    double endTime = 1.0;
+    double initialTimeStep = 1e-3;
+    double minTimeStep = 1e-9;
+    double maxTimeStep = 1e-1;
+    //! Spectral radius at infinite frequencies, which sets the numerical damping of high frequencies
+    double spectralRadius = 0.8;
+    //! Tolerance of the local error of the translations relative to the length of the rod and of the rotations.
+    //! Zero keeps the time step constant
+    double errorTolerance = 1e-4;
+    //! Maximum number of Newton iterations at each time step
+    quint32 maxNumIterations = 10;
+    //! Tolerance of the increments of the stations
+    double tolerance = 1e-8;
+};
+
+/*!
+ * \brief Integrator of the motion of a rod by the generalized-α method
+ *
+ * Rotations are integrated on the rotation group: the increment of each frame over a time step is the exponential of a
+ * spatial rotation vector, which is combined with the velocities and accelerations as the translations are. The
+ * equilibrium is enforced at the end of each step, where the nonlinear equations are solved by the Newton method with
+ * the block-tridiagonal tangent matrix. The time step is adapted to the local error estimated from the change of the
+ * accelerations. All the work arrays are allocated before the first step, so the steps do not allocate memory.
+ */
+class RodDynamicSolver
+{
+public:
+    bool solve(RodBuffers const& buffers, RodDynamicOptions const& options = RodDynamicOptions(),
+               RodStateWriterFun const& writer = RodStateWriterFun());
+    RodModel const& model() const { return mModel; }
+    RodState const& state() const { return mState; }
+    //! Time of the last accepted step
+    double time() const { return mTime; }
+    //! Translational and angular velocities of the stations at the last accepted step
+    std::vector<Vector6> const& velocities() const { return mVelocities; }
+    quint32 numSteps() const { return mNumSteps; }
+    quint32 numRejectedSteps() const { return mNumRejectedSteps; }
+    //! Total number of iterations over all the steps
+    quint32 numIterations() const { return mNumIterations; }
+    QString const& errorMessage() const { return mErrorMessage; }
+
+private:
+    void setCoefficients(double spectralRadius);
+    void computeInitialAccelerations();
+    bool solveStep(double timeStep, RodDynamicOptions const& options);
+    void updateMotion(double timeStep);
+    double estimateError(double timeStep) const;
+
+private:
+    RodModel mModel;
+    RodState mState;
+    BlockTridiagonalMatrix mTangent;
+    std::vector<Matrix66> mMass;
+    std::vector<Vector6> mResidual;
+    std::vector<Vector6> mIncrements;
+    // Coefficients of the scheme
+    double mAlphaM = 0.0;
+    double mAlphaF = 0.0;
+    double mBeta = 0.25;
+    double mGamma = 0.5;
+    // State at the beginning of the step
+    double mTime = 0.0;
+    std::vector<Vector3> mDisplacements;
+    std::vector<Matrix33> mRotations;
+    std::vector<Vector6> mVelocities;
+    std::vector<Vector6> mAccelerations;
+    std::vector<Vector6> mPseudoAccelerations;
+    // Motion at the end of the step
+    RodMotion mMotion;
+    std::vector<Vector6> mNextPseudoAccelerations;
+    quint32 mNumSteps = 0;
+    quint32 mNumRejectedSteps = 0;
+    quint32 mNumIterations = 0;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // RODDYNAMICSOLVER_H
@@ -0,0 +1,315 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodExplicitSolver class
+ */
+
+#include <bit>
+#include <limits>
+#include "rodexplicitsolver.h"
+#include "tasks.h"
+
+using namespace QRS::Core;
+
+//! Number of elements or stations which are processed by a task
+quint32 const skChunkSize = 1u << 10;
+
+/*!
+ * \brief Integrate the motion of the rod which starts at rest in the reference configuration
+ *
+ * The time step is constant except for the last one, which ends at the end time. The state at the start time and
+ * at the steps which follow the write interval is passed to the writer.
+ * \param writer Function which is called with the time and state of the rod
+ * \return Whether the end time has been reached. Otherwise, the reason is given by errorMessage()
+ */
+bool RodExplicitSolver::solve(RodBuffers const& buffers, RodExplicitOptions const& options, RodStateWriterFun const& writer)
+{
+    mTime = options.startTime;
+    mNumSteps = 0;
+    mNumEvaluations = 0;
+    mErrorMessage.clear();
+    if (!mModel.initialize(buffers, mTime))
+    {
+        mErrorMessage = mModel.errorMessage();
+        return false;
+    }
+    if (!setTimeSteps(options))
+        return false;
+    // Work arrays
+    quint32 numStations = mModel.numStations();
+    mVelocities.assign(numStations, Vector6::zeros());
+    mAngularMomenta.assign(numStations, Vector3::zeros());
+    mSubsteps.assign(numStations, 0);
+    mElementLoads.resize(mElementLevels.size());
+    mLoads.resize(numStations);
+    mModel.exportState(mState);
+    if (writer && !writer(mTime, mState))
+        return true;
+    evaluate(0);
+    // Time steps
+    bool isTimeDependent = mModel.isTimeDependent();
+    quint32 numSubsteps = 1u << mMaxLevel;
+    double writeTime = options.startTime + options.writeInterval;
+    while (mTime < options.endTime)
+    {
+        double remainingTime = options.endTime - mTime;
+        bool isLast = mTimeStep >= (1.0 - RodModel::skTimeTolerance) * remainingTime;
+        double timeStep = isLast ? remainingTime : mTimeStep;
+        double substep = timeStep / numSubsteps;
+        // The stations are kicked by halves of the steps at their ends, so the loads evaluated at the end of the last
+        // step are used at the start of the next one
+        kick(0, substep, 0.5);
+        for (quint32 iSubstep = 1; iSubstep != numSubsteps; ++iSubstep)
+        {
+            quint32 level = mMaxLevel - std::countr_zero(iSubstep);
+            if (isTimeDependent)
+                mModel.setTime(mTime + iSubstep * substep);
+            drift(level, iSubstep, substep);
+            evaluate(level);
+            kick(level, substep, 1.0);
+        }
+        mTime = isLast ? options.endTime : mTime + timeStep;
+        if (isTimeDependent)
+            mModel.setTime(mTime);
+        drift(0, numSubsteps, substep);
+        evaluate(0);
+        kick(0, substep, 0.5);
+        std::fill(mSubsteps.begin(), mSubsteps.end(), 0);
+        ++mNumSteps;
+        if (!isFinite())
+        {
+            mErrorMessage = QString("Motion of the rod has become unstable at the time %1").arg(mTime);
+            return false;
+        }
+        if (writer && (isLast || mTime >= writeTime))
+        {
+            if (options.writeInterval > 0.0)
+                writeTime = options.startTime + options.writeInterval * (std::floor((mTime - options.startTime) / options.writeInterval) + 1.0);
+            mModel.exportState(mState);
+            if (!writer(mTime, mState))
+                return true;
+        }
+    }
+    mModel.exportState(mState);
+    return true;
+}
+
+/*!
+ * \brief Choose the time step of the rod and the subcycling levels of the elements and stations
+ *
+ * The time step of the rod is the smallest stable one multiplied by the largest number of subcycles which does not
+ * exceed the largest stable time step. Each element is assigned the lowest level whose time step is stable for both
+ * of its stations, and each station is kicked at the substeps of the finest of its elements.
+ */
+bool RodExplicitSolver::setTimeSteps(RodExplicitOptions const& options)
+{
+    quint32 numStations = mModel.numStations();
+    quint32 numElements = numStations - 1;
+    std::vector<double> timeSteps;
+    mModel.computeStableTimeSteps(timeSteps);
+    double minTimeStep = std::numeric_limits<double>::infinity();
+    double maxTimeStep = 0.0;
+    for (double& timeStep : timeSteps)
+    {
+        timeStep *= options.stabilityFactor;
+        minTimeStep = std::min(minTimeStep, timeStep);
+        if (std::isfinite(timeStep))
+            maxTimeStep = std::max(maxTimeStep, timeStep);
+    }
+    if (!(minTimeStep > 0.0))
+    {
+        mErrorMessage = QString("Free degrees of freedom of the rod should have positive masses and inertia moments");
+        return false;
+    }
+    // Fully constrained rods do not move
+    if (!std::isfinite(minTimeStep))
+        minTimeStep = maxTimeStep = std::max(options.endTime - options.startTime, 0.0);
+    mMaxLevel = 0;
+    while ((2u << mMaxLevel) <= options.maxNumSubcycles && (2u << mMaxLevel) * minTimeStep <= maxTimeStep)
+        ++mMaxLevel;
+    mTimeStep = (1u << mMaxLevel) * minTimeStep;
+    // Levels
+    mStationLevels.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        quint32 level = 0;
+        while (level < mMaxLevel && mTimeStep / (1u << level) > timeSteps[i])
+            ++level;
+        mStationLevels[i] = level;
+    }
+    mElementLevels.resize(numElements);
+    for (quint32 i = 0; i != numElements; ++i)
+        mElementLevels[i] = std::max(mStationLevels[i], mStationLevels[i + 1]);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        quint32 firstLevel = i > 0 ? mElementLevels[i - 1] : 0;
+        quint32 secondLevel = i < numElements ? mElementLevels[i] : 0;
+        mStationLevels[i] = std::max(firstLevel, secondLevel);
+    }
+    // Chunks of each level. The stations of the active elements are active as well
+    mElementChunks.assign(mMaxLevel + 1, {});
+    mStationChunks.assign(mMaxLevel + 1, {});
+    mNumLevelElements.assign(mMaxLevel + 1, 0);
+    for (quint32 level = 0; level <= mMaxLevel; ++level)
+    {
+        addRanges(mElementLevels, level, mElementChunks[level]);
+        addRanges(mStationLevels, level, mStationChunks[level]);
+        for (Range const& range : mElementChunks[level])
+            mNumLevelElements[level] += range.iEnd - range.iStart;
+    }
+    // Inverse inertia, which is zero where the degrees of freedom are constrained
+    std::vector<double> const& masses = mModel.masses();
+    std::vector<Vector3> const& inertiaMoments = mModel.inertiaMoments();
+    mInverseMasses.resize(numStations);
+    mInverseInertiaMoments.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        mInverseMasses[i] = masses[i] > 0.0 ? 1.0 / masses[i] : 0.0;
+        for (int k = 0; k != 3; ++k)
+            mInverseInertiaMoments[i][k] = inertiaMoments[i][k] > 0.0 ? 1.0 / inertiaMoments[i][k] : 0.0;
+    }
+    return true;
+}
+
+//! Split the ranges of the items whose levels are not lower than the given one into chunks which are processed by separate tasks
+void RodExplicitSolver::addRanges(std::vector<quint32> const& levels, quint32 level, std::vector<Range>& chunks) const
+{
+    quint32 numItems = levels.size();
+    quint32 i = 0;
+    while (i != numItems)
+    {
+        if (levels[i] < level)
+        {
+            ++i;
+            continue;
+        }
+        quint32 iStart = i;
+        while (i != numItems && levels[i] >= level && i - iStart != skChunkSize)
+            ++i;
+        chunks.push_back({iStart, i});
+    }
+}
+
+//! Compute the loads of the elements and the external loads of the stations of the given level and higher ones
+void RodExplicitSolver::evaluate(quint32 level)
+{
+    std::vector<Range> const& elementChunks = mElementChunks[level];
+    std::vector<Range> const& stationChunks = mStationChunks[level];
+    int numElementTasks = elementChunks.size();
+    runTasks(numElementTasks + stationChunks.size(), [&](int iTask)
+    {
+        if (iTask < numElementTasks)
+        {
+            Range const& range = elementChunks[iTask];
+            mModel.computeElementLoads(range.iStart, range.iEnd, mElementLoads);
+        }
+        else
+        {
+            Range const& range = stationChunks[iTask - numElementTasks];
+            mModel.computeLoads(range.iStart, range.iEnd, mLoads);
+        }
+    }, mIsParallel);
+    mNumEvaluations += mNumLevelElements[level];
+}
+
+//! Move the stations of the given level and higher ones to the substep
+void RodExplicitSolver::drift(quint32 level, quint32 iSubstep, double timeStep)
+{
+    std::vector<Range> const& chunks = mStationChunks[level];
+    runTasks(chunks.size(), [&](int iTask)
+    {
+        Range const& range = chunks[iTask];
+        for (quint32 i = range.iStart; i != range.iEnd; ++i)
+        {
+            mModel.update(i, i + 1, mVelocities, (iSubstep - mSubsteps[i]) * timeStep);
+            mSubsteps[i] = iSubstep;
+        }
+    }, mIsParallel);
+}
+
+/*!
+ * \brief Kick the stations of the given level and higher ones by the last loads
+ * \param timeStep Substep of the elements of the highest level
+ * \param kickFactor Ratio of the kicks to the time steps of the elements and stations
+ */
+void RodExplicitSolver::kick(quint32 level, double timeStep, double kickFactor)
+{
+    std::vector<Range> const& chunks = mStationChunks[level];
+    runTasks(chunks.size(), [&](int iTask)
+    {
+        Range const& range = chunks[iTask];
+        for (quint32 i = range.iStart; i != range.iEnd; ++i)
+            kick(i, level, kickFactor * timeStep);
+    }, mIsParallel);
+}
+
+/*!
+ * \brief Change the velocity and angular momentum of a station by the impulse of the loads of the active elements
+ * and the external and damping loads
+ *
+ * Each load acts over the time step of the element or station which it belongs to. The angular velocity is the spatial
+ * angular momentum multiplied by the inverse inertia tensor of the current frame.
+ */
+void RodExplicitSolver::kick(quint32 iStation, quint32 level, double timeStep)
+{
+    quint32 numElements = mElementLevels.size();
+    Vector6& velocity = mVelocities[iStation];
+    Vector6 impulse = Vector6::zeros();
+    if (iStation > 0 && mElementLevels[iStation - 1] >= level)
+    {
+        RodElementLoads const& loads = mElementLoads[iStation - 1];
+        double elementTimeStep = timeStep * (1u << (mMaxLevel - mElementLevels[iStation - 1]));
+        for (int k = 0; k != 3; ++k)
+        {
+            impulse[k] += elementTimeStep * loads.force[k];
+            impulse[3 + k] += elementTimeStep * loads.secondMoment[k];
+        }
+    }
+    if (iStation < numElements && mElementLevels[iStation] >= level)
+    {
+        RodElementLoads const& loads = mElementLoads[iStation];
+        double elementTimeStep = timeStep * (1u << (mMaxLevel - mElementLevels[iStation]));
+        for (int k = 0; k != 3; ++k)
+        {
+            impulse[k] -= elementTimeStep * loads.force[k];
+            impulse[3 + k] += elementTimeStep * loads.firstMoment[k];
+        }
+    }
+    Vector6 const& load = mLoads[iStation];
+    Vector6 const& damping = mModel.dampings()[iStation];
+    double stationTimeStep = timeStep * (1u << (mMaxLevel - mStationLevels[iStation]));
+    for (int k = 0; k != 6; ++k)
+        impulse[k] += stationTimeStep * (damping[k] * velocity[k] - load[k]);
+    mModel.project(iStation, impulse);
+    // Momenta
+    Vector3& angularMomentum = mAngularMomenta[iStation];
+    double inverseMass = mInverseMasses[iStation];
+    for (int k = 0; k != 3; ++k)
+    {
+        velocity[k] -= inverseMass * impulse[k];
+        angularMomentum[k] -= impulse[3 + k];
+    }
+    Matrix33 const& rotation = mModel.rotations()[iStation];
+    Vector3 materialVelocity = transposeProduct(rotation, angularMomentum);
+    for (int k = 0; k != 3; ++k)
+        materialVelocity[k] *= mInverseInertiaMoments[iStation][k];
+    Vector3 angularVelocity = rotation * materialVelocity;
+    for (int k = 0; k != 3; ++k)
+        velocity[3 + k] = angularVelocity[k];
+    mModel.project(iStation, velocity);
+}
+
+//! Check whether the velocities of all the stations are finite
+bool RodExplicitSolver::isFinite() const
+{
+    for (Vector6 const& velocity : mVelocities)
+    {
+        for (int k = 0; k != 6; ++k)
+        {
+            if (!std::isfinite(velocity[k]))
+                return false;
+        }
+    }
+    return true;
+}
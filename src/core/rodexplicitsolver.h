@@ -0,0 +1,111 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodExplicitSolver class
+ */
+
+#ifndef RODEXPLICITSOLVER_H
+#define RODEXPLICITSOLVER_H
+
+#include "rodmodel.h"
+
+namespace QRS::Core
+{
+
+//! Settings of the explicit transient analysis
+struct RodExplicitOptions
+{
+    //! Time which the rod is at rest in the reference configuration
+    double startTime = 0.0;
+    double endTime = 1.0;
+    //! Ratio of the time steps to the estimated stable ones
+    double stabilityFactor = 0.9;
+    //! Maximum number of substeps which the stiffest elements divide a time step into. It is rounded down to a power of
+    //! two, and one disables subcycling
+    quint32 maxNumSubcycles = 1;
+    //! Interval between the states passed to the writer. Zero passes the state at each step
+    double writeInterval = 0.0;
+};
+
+/*!
+ * \brief Integrator of the motion of a rod by the explicit leapfrog method
+ *
+ * Velocities are kicked by the loads at the ends of time steps, and the stations drift with the velocities between
+ * them. Translations are integrated by the symplectic central difference scheme, whereas spatial angular momenta of the
+ * stations are kicked by the moments, and the frames are rotated by the angular velocities which correspond to the
+ * momenta at the start of each drift. The time steps are the stable ones estimated from the stiffness of the elements
+ * and the lumped masses. Elements whose stable time steps are shorter than the one of the rod subcycle it by powers of
+ * two: each element kicks both of its stations at its own substeps, so the momentum is conserved, and only the stations
+ * of the active elements are moved and kicked. Loads are evaluated by batches of elements in chunks which are processed
+ * in parallel, and then each station gathers the loads of its elements. The chunks do not depend on the number of
+ * threads, so the results are the same whether the computation is parallel or not.
+ */
+class RodExplicitSolver
+{
+public:
+    bool solve(RodBuffers const& buffers, RodExplicitOptions const& options = RodExplicitOptions(),
+               RodStateWriterFun const& writer = RodStateWriterFun());
+    void setParallel(bool isParallel) { mIsParallel = isParallel; }
+    RodModel const& model() const { return mModel; }
+    RodState const& state() const { return mState; }
+    //! Time of the last step
+    double time() const { return mTime; }
+    //! Time step of the rod, which the stiffest elements divide into substeps
+    double timeStep() const { return mTimeStep; }
+    quint32 numSubcycles() const { return 1u << mMaxLevel; }
+    //! Translational and angular velocities of the stations at the last step
+    std::vector<Vector6> const& velocities() const { return mVelocities; }
+    quint32 numSteps() const { return mNumSteps; }
+    //! Number of evaluations of the loads of the elements over all the steps
+    quint64 numEvaluations() const { return mNumEvaluations; }
+    QString const& errorMessage() const { return mErrorMessage; }
+
+private:
+    //! Range of elements or stations [iStart, iEnd)
+    struct Range
+    {
+        quint32 iStart;
+        quint32 iEnd;
+    };
+    bool setTimeSteps(RodExplicitOptions const& options);
+    void addRanges(std::vector<quint32> const& levels, quint32 level, std::vector<Range>& chunks) const;
+    void evaluate(quint32 level);
+    void drift(quint32 level, quint32 iSubstep, double timeStep);
+    void kick(quint32 level, double timeStep, double kickFactor);
+    void kick(quint32 iStation, quint32 level, double timeStep);
+    bool isFinite() const;
+
+private:
+    RodModel mModel;
+    RodState mState;
+    double mTime = 0.0;
+    double mTimeStep = 0.0;
+    // Subcycling levels of the elements and stations, each of which halves the time step
+    quint32 mMaxLevel = 0;
+    std::vector<quint32> mElementLevels;
+    std::vector<quint32> mStationLevels;
+    //! Chunks of the elements and stations whose levels are not lower than the given one
+    std::vector<std::vector<Range>> mElementChunks;
+    std::vector<std::vector<Range>> mStationChunks;
+    std::vector<quint32> mNumLevelElements;
+    // Inverse masses and principal inertia moments, which are zero at the constrained degrees of freedom
+    std::vector<double> mInverseMasses;
+    std::vector<Vector3> mInverseInertiaMoments;
+    // State of the stations
+    std::vector<Vector6> mVelocities;
+    std::vector<Vector3> mAngularMomenta;
+    //! Substeps which the stations have drifted up to
+    std::vector<quint32> mSubsteps;
+    // Last loads of the elements and external loads of the stations
+    std::vector<RodElementLoads> mElementLoads;
+    std::vector<Vector6> mLoads;
+    quint32 mNumSteps = 0;
+    quint64 mNumEvaluations = 0;
+    bool mIsParallel = true;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // RODEXPLICITSOLVER_H
@@ -0,0 +1,345 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodModalSolver class
+ */
+
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include <random>
+#include "rodmodalsolver.h"
+
+using namespace QRS::Core;
+
+double const skMachineEpsilon = std::numeric_limits<double>::epsilon();
+//! Maximum number of QL iterations per eigenvalue of the tridiagonal matrix
+int const skMaxNumQLIterations = 30;
+
+//! Compute the dot product of vectors of the degrees of freedom of stations
+static double dotProduct(std::vector<Vector6> const& first, std::vector<Vector6> const& second)
+{
+    double result = 0.0;
+    quint32 numStations = first.size();
+    for (quint32 i = 0; i != numStations; ++i)
+        result += dot(first[i], second[i]);
+    return result;
+}
+
+/*!
+ * \brief Find eigenvalues and eigenvectors of a symmetric tridiagonal matrix by the QL method with implicit shifts
+ * \param diagonal Diagonal of the matrix, which is substituted by the eigenvalues
+ * \param offDiagonal Elements next to the diagonal, which are destroyed. The last element is not used
+ * \param eigenvectors Row-major matrix whose columns are the eigenvectors
+ * \return Whether all the eigenvalues have converged
+ */
+static bool diagonalizeTridiagonal(std::vector<double>& diagonal, std::vector<double>& offDiagonal,
+                                   std::vector<double>& eigenvectors)
+{
+    int size = diagonal.size();
+    eigenvectors.assign(size * size, 0.0);
+    for (int i = 0; i != size; ++i)
+        eigenvectors[i * size + i] = 1.0;
+    offDiagonal[size - 1] = 0.0;
+    for (int l = 0; l != size; ++l)
+    {
+        int numIterations = 0;
+        while (true)
+        {
+            // Split the matrix at a negligible off-diagonal element
+            int m = l;
+            for (; m < size - 1; ++m)
+            {
+                double scale = std::abs(diagonal[m]) + std::abs(diagonal[m + 1]);
+                if (std::abs(offDiagonal[m]) <= skMachineEpsilon * scale)
+                    break;
+            }
+            if (m == l)
+                break;
+            if (numIterations++ == skMaxNumQLIterations)
+                return false;
+            double g = (diagonal[l + 1] - diagonal[l]) / (2.0 * offDiagonal[l]);
+            double r = std::hypot(g, 1.0);
+            g = diagonal[m] - diagonal[l] + offDiagonal[l] / (g + std::copysign(r, g));
+            double s = 1.0;
+            double c = 1.0;
+            double p = 0.0;
+            int i = m - 1;
+            for (; i >= l; --i)
+            {
+                double f = s * offDiagonal[i];
+                double b = c * offDiagonal[i];
+                r = std::hypot(f, g);
+                offDiagonal[i + 1] = r;
+                if (r == 0.0)
+                {
+                    diagonal[i + 1] -= p;
+                    offDiagonal[m] = 0.0;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = diagonal[i + 1] - p;
+                r = (diagonal[i] - g) * s + 2.0 * c * b;
+                p = s * r;
+                diagonal[i + 1] = g + p;
+                g = c * r - b;
+                for (int k = 0; k != size; ++k)
+                {
+                    double& first = eigenvectors[k * size + i];
+                    double& second = eigenvectors[k * size + i + 1];
+                    f = second;
+                    second = s * first + c * f;
+                    first = c * first - s * f;
+                }
+            }
+            if (r == 0.0 && i >= l)
+                continue;
+            diagonal[l] -= p;
+            offDiagonal[l] = g;
+            offDiagonal[m] = 0.0;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Find the natural modes of the rod which are nearest to the shift
+ *
+ * The Lanczos iterations stop when the requested number of modes has converged, when the maximum number of vectors
+ * is generated, or when the vectors span an invariant subspace. The converged modes are available through modes()
+ * even if there are fewer of them than requested.
+ * \return Whether all the requested modes have been found. Otherwise, the reason is given by errorMessage()
+ */
+bool RodModalSolver::solve(RodBuffers const& buffers, RodModalOptions const& options)
+{
+    mBasis.clear();
+    mAlphas.clear();
+    mBetas.clear();
+    mModes.clear();
+    mOrthogonality = {1.0};
+    mLastOrthogonality.clear();
+    mIsReorthogonalizationPending = false;
+    mNumReorthogonalizations = 0;
+    mErrorMessage.clear();
+    if (!mModel.initialize(buffers))
+    {
+        mErrorMessage = mModel.errorMessage();
+        return false;
+    }
+    // Shifted stiffness matrix
+    quint32 numStations = mModel.numStations();
+    mShift = options.shift;
+    mModel.computeMass(mMass);
+    mModel.computeTangent(0.0, mOperator, mResidual);
+    for (quint32 i = 0; i != numStations; ++i)
+        mOperator.diagonal(i) -= mShift * mMass[i];
+    if (!mOperator.factorize())
+    {
+        mErrorMessage = QString("Stiffness matrix of the rod is singular at the shift");
+        return false;
+    }
+    // The starting vector is mapped by the operator to exclude the degrees of freedom without inertia
+    std::mt19937 generator;
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::vector<Vector6> vector(numStations);
+    for (Vector6& values : vector)
+    {
+        for (int k = 0; k != 6; ++k)
+            values[k] = distribution(generator);
+    }
+    applyOperator(vector, mResidual);
+    multiplyMass(mResidual, mProduct);
+    double beta = std::sqrt(dotProduct(mResidual, mProduct));
+    if (!(beta > 0.0))
+    {
+        mErrorMessage = QString("Mass of the rod should be positive");
+        return false;
+    }
+    quint32 maxNumVectors = std::max(std::min(options.maxNumVectors, 6 * numStations), 1u);
+    mBasis.reserve(maxNumVectors);
+    quint32 numConverged = 0;
+    while (true)
+    {
+        for (Vector6& values : mResidual)
+            values *= 1.0 / beta;
+        mBasis.push_back(mResidual);
+        quint32 j = mBasis.size() - 1;
+        std::vector<Vector6> const& current = mBasis[j];
+        // Three-term recurrence
+        applyOperator(current, mResidual);
+        double alpha = dotProduct(mProduct, mResidual);
+        for (quint32 i = 0; i != numStations; ++i)
+        {
+            mResidual[i] -= alpha * current[i];
+            if (j > 0)
+                mResidual[i] -= mBetas[j - 1] * mBasis[j - 1][i];
+        }
+        mAlphas.push_back(alpha);
+        multiplyMass(mResidual, mProduct);
+        beta = std::sqrt(dotProduct(mResidual, mProduct));
+        bool isReorthogonalized = options.reorthogonalization == RodModalOptions::kFull || estimateOrthogonality(beta);
+        if (isReorthogonalized)
+        {
+            reorthogonalize(mResidual);
+            multiplyMass(mResidual, mProduct);
+            beta = std::sqrt(dotProduct(mResidual, mProduct));
+        }
+        mBetas.push_back(beta);
+        numConverged = computeRitzPairs(options);
+        if (numConverged >= options.numModes || mBasis.size() == maxNumVectors)
+            break;
+        // The vectors span an invariant subspace
+        if (beta <= skMachineEpsilon * std::abs(alpha))
+            break;
+    }
+    exportModes(std::min(numConverged, options.numModes));
+    if (mModes.size() < options.numModes)
+    {
+        mErrorMessage = QString("Only %1 of %2 modes of the rod have been found").arg(mModes.size()).arg(options.numModes);
+        return false;
+    }
+    return true;
+}
+
+//! Multiply a vector by the mass matrix and solve the shifted stiffness matrix for the product
+void RodModalSolver::applyOperator(std::vector<Vector6> const& vector, std::vector<Vector6>& result)
+{
+    multiplyMass(vector, mProduct);
+    result = mProduct;
+    mOperator.solve(result);
+}
+
+//! Multiply a vector by the block-diagonal mass matrix
+void RodModalSolver::multiplyMass(std::vector<Vector6> const& vector, std::vector<Vector6>& result) const
+{
+    quint32 numStations = vector.size();
+    result.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+        result[i] = mMass[i] * vector[i];
+}
+
+//! Orthogonalize a vector against all the Lanczos vectors with respect to the mass matrix by two passes of Gram-Schmidt
+void RodModalSolver::reorthogonalize(std::vector<Vector6>& vector)
+{
+    quint32 numStations = vector.size();
+    quint32 numVectors = mBasis.size();
+    std::vector<double> coefficients(numVectors);
+    for (int iPass = 0; iPass != 2; ++iPass)
+    {
+        multiplyMass(vector, mProduct);
+        for (quint32 j = 0; j != numVectors; ++j)
+            coefficients[j] = dotProduct(mBasis[j], mProduct);
+        for (quint32 j = 0; j != numVectors; ++j)
+        {
+            std::vector<Vector6> const& basisVector = mBasis[j];
+            for (quint32 i = 0; i != numStations; ++i)
+                vector[i] -= coefficients[j] * basisVector[i];
+        }
+    }
+    ++mNumReorthogonalizations;
+}
+
+/*!
+ * \brief Estimate the products of the next Lanczos vector by all the previous ones
+ *
+ * The estimates follow the recurrence of Simon, which mirrors the three-term recurrence of the vectors themselves. Once
+ * the orthogonality is lost, the next two vectors are orthogonalized against all the previous ones.
+ * \return Whether the next vector should be orthogonalized
+ */
+bool RodModalSolver::estimateOrthogonality(double beta)
+{
+    quint32 j = mAlphas.size() - 1;
+    std::vector<double> next(j + 2);
+    double maxValue = 0.0;
+    for (quint32 k = 0; k < j; ++k)
+    {
+        double value = mBetas[k] * mOrthogonality[k + 1] + (mAlphas[k] - mAlphas[j]) * mOrthogonality[k];
+        if (k > 0)
+            value += mBetas[k - 1] * mOrthogonality[k - 1];
+        value -= mBetas[j - 1] * mLastOrthogonality[k];
+        // Rounding errors of the recurrence itself
+        value += std::copysign(skMachineEpsilon * (mBetas[k] + beta), value);
+        next[k] = value / beta;
+        maxValue = std::max(maxValue, std::abs(next[k]));
+    }
+    next[j] = skMachineEpsilon;
+    next[j + 1] = 1.0;
+    bool isReorthogonalized = mIsReorthogonalizationPending || maxValue > std::sqrt(skMachineEpsilon);
+    mIsReorthogonalizationPending = isReorthogonalized && !mIsReorthogonalizationPending;
+    if (isReorthogonalized)
+        std::fill(next.begin(), next.begin() + j, skMachineEpsilon);
+    mLastOrthogonality = std::move(mOrthogonality);
+    mOrthogonality = std::move(next);
+    return isReorthogonalized;
+}
+
+/*!
+ * \brief Compute the eigenpairs of the tridiagonal matrix of the Lanczos coefficients
+ *
+ * The error bound of each Ritz value is the product of the last coefficient by the last component of its eigenvector.
+ * \return Number of the Ritz values of the largest magnitude which have converged in a row
+ */
+quint32 RodModalSolver::computeRitzPairs(RodModalOptions const& options)
+{
+    quint32 numVectors = mAlphas.size();
+    mRitzValues = mAlphas;
+    std::vector<double> offDiagonal = mBetas;
+    if (!diagonalizeTridiagonal(mRitzValues, offDiagonal, mRitzVectors))
+        return 0;
+    mRitzErrors.resize(numVectors);
+    for (quint32 i = 0; i != numVectors; ++i)
+        mRitzErrors[i] = std::abs(mBetas.back() * mRitzVectors[(numVectors - 1) * numVectors + i]);
+    // Eigenvalues nearest to the shift correspond to the Ritz values of the largest magnitude
+    mRitzOrder.resize(numVectors);
+    std::iota(mRitzOrder.begin(), mRitzOrder.end(), 0);
+    std::sort(mRitzOrder.begin(), mRitzOrder.end(),
+              [this](quint32 i, quint32 j) { return std::abs(mRitzValues[i]) > std::abs(mRitzValues[j]); });
+    quint32 numConverged = 0;
+    quint32 numWanted = std::min(options.numModes, numVectors);
+    while (numConverged != numWanted)
+    {
+        quint32 i = mRitzOrder[numConverged];
+        if (mRitzErrors[i] > options.tolerance * std::abs(mRitzValues[i]))
+            break;
+        ++numConverged;
+    }
+    return numConverged;
+}
+
+//! Compute frequencies and shapes of the given number of modes from the Ritz pairs
+void RodModalSolver::exportModes(quint32 numModes)
+{
+    quint32 numStations = mModel.numStations();
+    quint32 numVectors = mAlphas.size();
+    std::vector<Vector6> shape(numStations);
+    mModes.resize(numModes);
+    for (quint32 iMode = 0; iMode != numModes; ++iMode)
+    {
+        quint32 iRitz = mRitzOrder[iMode];
+        double eigenvalue = mShift + 1.0 / mRitzValues[iRitz];
+        std::fill(shape.begin(), shape.end(), Vector6::zeros());
+        for (quint32 j = 0; j != numVectors; ++j)
+        {
+            double coefficient = mRitzVectors[j * numVectors + iRitz];
+            std::vector<Vector6> const& basisVector = mBasis[j];
+            for (quint32 i = 0; i != numStations; ++i)
+                shape[i] += coefficient * basisVector[i];
+        }
+        mModel.expand(shape);
+        RodMode& mode = mModes[iMode];
+        mode.frequency = std::sqrt(std::max(eigenvalue, 0.0)) / (2.0 * std::numbers::pi);
+        for (int k = 0; k != 3; ++k)
+        {
+            mode.displacements[k].resize(numStations);
+            mode.rotations[k].resize(numStations);
+            for (quint32 i = 0; i != numStations; ++i)
+            {
+                mode.displacements[k][i] = shape[i][k];
+                mode.rotations[k][i] = shape[i][3 + k];
+            }
+        }
+    }
+    std::sort(mModes.begin(), mModes.end(), [](RodMode const& first, RodMode const& second) { return first.frequency < second.frequency; });
+}
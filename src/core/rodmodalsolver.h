@@ -0,0 +1,106 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodModalSolver class
+ */
+
+#ifndef RODMODALSOLVER_H
+#define RODMODALSOLVER_H
+
+#include "rodmodel.h"
+
+namespace QRS::Core
+{
+
+//! Settings of the modal analysis
+struct RodModalOptions
+{
+    //! Ways to keep the Lanczos vectors orthogonal
+    enum Reorthogonalization
+    {
+        //! Against all the previous vectors at each step
+        kFull,
+        //! Only when the estimated loss of orthogonality exceeds the square root of the machine precision
+        kPartial
+    };
+    //! Number of modes to compute
+    quint32 numModes = 10;
+    //! Squared circular frequency which the computed modes are nearest to
+    double shift = 0.0;
+    //! Maximum number of Lanczos vectors, which determines the memory used
+    quint32 maxNumVectors = 60;
+    Reorthogonalization reorthogonalization = kFull;
+    //! Tolerance of the eigenvalues relative to their magnitude
+    double tolerance = 1e-10;
+};
+
+//! Natural mode of a rod
+struct RodMode
+{
+    //! Natural frequency in cycles per unit time
+    double frequency;
+    //! Shape sampled at stations, normalized by the mass matrix
+    std::array<std::vector<double>, 3> displacements;
+    std::array<std::vector<double>, 3> rotations;
+};
+
+/*!
+ * \brief Solver of the natural modes of a rod about its reference configuration
+ *
+ * The stiffness matrix is the tangent one of the unloaded rod, and the mass matrix is lumped at the stations, so both
+ * are banded by blocks of the stations. The modes nearest to the shift are found by the Lanczos method applied to the
+ * inverse of the shifted stiffness matrix, which is factorized once. The Lanczos vectors are orthogonal with respect to
+ * the mass matrix, and their number limits the memory which is proportional to the number of stations. Since a single
+ * starting vector is used, each multiple frequency is found once.
+ */
+class RodModalSolver
+{
+public:
+    bool solve(RodBuffers const& buffers, RodModalOptions const& options = RodModalOptions());
+    RodModel const& model() const { return mModel; }
+    //! Modes sorted by frequency
+    std::vector<RodMode> const& modes() const { return mModes; }
+    //! Number of Lanczos vectors generated
+    quint32 numVectors() const { return mBasis.size(); }
+    //! Number of Lanczos vectors which have been orthogonalized against all the previous ones
+    quint32 numReorthogonalizations() const { return mNumReorthogonalizations; }
+    QString const& errorMessage() const { return mErrorMessage; }
+
+private:
+    void applyOperator(std::vector<Vector6> const& vector, std::vector<Vector6>& result);
+    void multiplyMass(std::vector<Vector6> const& vector, std::vector<Vector6>& result) const;
+    void reorthogonalize(std::vector<Vector6>& vector);
+    bool estimateOrthogonality(double beta);
+    quint32 computeRitzPairs(RodModalOptions const& options);
+    void exportModes(quint32 numModes);
+
+private:
+    RodModel mModel;
+    std::vector<Matrix66> mMass;
+    //! Shifted stiffness matrix which is factorized
+    BlockTridiagonalMatrix mOperator;
+    // Lanczos vectors and coefficients of the tridiagonal matrix
+    std::vector<std::vector<Vector6>> mBasis;
+    std::vector<double> mAlphas;
+    std::vector<double> mBetas;
+    // Estimates of the products of the last two Lanczos vectors by all the previous ones
+    std::vector<double> mOrthogonality;
+    std::vector<double> mLastOrthogonality;
+    bool mIsReorthogonalizationPending = false;
+    // Ritz values, their error bounds and vectors in the basis of the Lanczos ones
+    std::vector<double> mRitzValues;
+    std::vector<double> mRitzErrors;
+    std::vector<double> mRitzVectors;
+    std::vector<quint32> mRitzOrder;
+    std::vector<Vector6> mResidual;
+    std::vector<Vector6> mProduct;
+    double mShift = 0.0;
+    quint32 mNumReorthogonalizations = 0;
+    std::vector<RodMode> mModes;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // RODMODALSOLVER_H
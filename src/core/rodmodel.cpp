@@ -0,0 +1,972 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodModel class
+ */
+
+#include <limits>
+#include "rodmodel.h"
+#include "rotations.h"
+
+using namespace QRS::Core;
+using namespace QRS::Core::Rotations;
+
+quint8 const skTranslationMask = 0b000111;
+quint8 const skRotationMask = 0b111000;
+//! Angle below which the derivative of the inverse Jacobian is evaluated by its Taylor series
+double const skJacobianSeriesAngle = 0.1;
+
+//! Add a 3x3 matrix to a 6x6 block at the given offsets
+static void addBlock(Matrix66& block, int iRow, int iCol, Matrix33 const& matrix)
+{
+    for (int i = 0; i != 3; ++i)
+    {
+        for (int j = 0; j != 3; ++j)
+            block(iRow + i, iCol + j) += matrix(i, j);
+    }
+}
+
+//! Multiply rows of a matrix by the product of a factor and the consecutive elements of a vector
+static Matrix33 scaleRows(Matrix33 matrix, double factor, Vector6 const& values, int iStart)
+{
+    for (int i = 0; i != 3; ++i)
+    {
+        double rowFactor = factor * values[iStart + i];
+        for (int j = 0; j != 3; ++j)
+            matrix(i, j) *= rowFactor;
+    }
+    return matrix;
+}
+
+//! Add a vector to a part of a 6-vector
+static void addVector(Vector6& result, int iStart, Vector3 const& vector)
+{
+    for (int i = 0; i != 3; ++i)
+        result[iStart + i] += vector[i];
+}
+
+/*!
+ * \brief Compute the derivative of the product of the transposed inverse Jacobian by a vector with respect to the rotation
+ *
+ * The inverse Jacobian is I - [φ] / 2 + c(θ) [φ]^2, where c(θ) = 1 / θ^2 - (1 + cos(θ)) / (2 θ sin(θ)).
+ */
+static Matrix33 differentiateInverseJacobian(Vector3 const& rotation, Vector3 const& vector)
+{
+    double squaredAngle = dot(rotation, rotation);
+    // Coefficient c(θ) and its derivative divided by θ
+    double coefficient, derivative;
+    if (squaredAngle < skJacobianSeriesAngle * skJacobianSeriesAngle)
+    {
+        coefficient = 1.0 / 12.0 + squaredAngle / 720.0 * (1.0 + squaredAngle / 42.0);
+        derivative = 1.0 / 360.0 + squaredAngle / 7560.0 * (1.0 + squaredAngle * 3.0 / 80.0);
+    }
+    else
+    {
+        double angle = std::sqrt(squaredAngle);
+        double halfSine = std::sin(0.5 * angle);
+        double halfCotangent = std::cos(0.5 * angle) / halfSine;
+        coefficient = 1.0 / squaredAngle - 0.5 * halfCotangent / angle;
+        derivative = (-2.0 / (squaredAngle * angle) + 0.25 / (angle * halfSine * halfSine)
+                      + 0.5 * halfCotangent / squaredAngle) / angle;
+    }
+    Matrix33 rotationMatrix = skew(rotation);
+    Matrix33 vectorMatrix = skew(vector);
+    Vector3 product = rotationMatrix * (rotationMatrix * vector);
+    Matrix33 result = -0.5 * vectorMatrix - coefficient * (skew(cross(rotation, vector)) + rotationMatrix * vectorMatrix);
+    for (int i = 0; i != 3; ++i)
+    {
+        for (int j = 0; j != 3; ++j)
+            result(i, j) += derivative * product[i] * rotation[j];
+    }
+    return result;
+}
+
+//! Compute the inertia tensor in the global coordinate system from its principal moments in the material frame
+static Matrix33 rotateInertia(Matrix33 const& rotation, Vector3 const& moments)
+{
+    Matrix33 result;
+    for (int i = 0; i != 3; ++i)
+    {
+        for (int j = 0; j != 3; ++j)
+        {
+            double value = 0.0;
+            for (int k = 0; k != 3; ++k)
+                value += rotation(i, k) * moments[k] * rotation(j, k);
+            result(i, j) = value;
+        }
+    }
+    return result;
+}
+
+//! Evaluate the time coefficient of a load by linear interpolation, which is constant outside of the keys
+static double interpolateTimeCoefficient(std::vector<double> const& keys, std::vector<double> const& values, double time)
+{
+    if (keys.empty())
+        return 1.0;
+    if (time <= keys.front())
+        return values.front();
+    if (time >= keys.back())
+        return values.back();
+    auto iter = std::upper_bound(keys.begin(), keys.end(), time);
+    quint32 i = iter - keys.begin();
+    double ratio = (time - keys[i - 1]) / (keys[i] - keys[i - 1]);
+    return values[i - 1] + ratio * (values[i] - values[i - 1]);
+}
+
+/*!
+ * \brief Set the reference configuration, properties, loads and constraints of the rod
+ *
+ * The reference configuration is free of stresses. Distributed loads, masses and dampers are lumped at stations by
+ * their tributary lengths, whereas point ones are applied at the last station. Point masses are isotropic and equal to
+ * the norms of their vectors, point inertia moments are given in the material frame, and the coefficients of dampers
+ * act along the global axes.
+ * \param time Time which the coefficients of the loads are evaluated at
+ * \return Whether the model is complete. Otherwise, the reason is given by errorMessage()
+ */
+bool RodModel::initialize(RodBuffers const& buffers, double time)
+{
+    mErrorMessage.clear();
+    quint32 numStations = buffers.numStations();
+    if (numStations < 2 || buffers.frames[0].size() != numStations)
+    {
+        mErrorMessage = QString("Rod should be assembled with two stations at least");
+        return false;
+    }
+    // Reference configuration
+    mReferencePositions.resize(numStations);
+    mReferenceRotations.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        for (int k = 0; k != 3; ++k)
+            mReferencePositions[i][k] = buffers.positions[k][i];
+        Matrix33 frame;
+        for (int k = 0; k != 9; ++k)
+            frame[k] = buffers.frames[k][i];
+        // Sampled frames are orthonormalized through the nearest quaternion
+        Quaternion quaternion = toQuaternion(frame);
+        mReferenceRotations[i] = fromQuaternion((1.0 / norm(quaternion)) * quaternion);
+    }
+    reset();
+    mLength = buffers.arcLengths.back() - buffers.arcLengths.front();
+    // Elements
+    quint32 numElements = numStations - 1;
+    mElements.resize(numElements);
+    for (quint32 i = 0; i != numElements; ++i)
+    {
+        Element& element = mElements[i];
+        element.length = buffers.arcLengths[i + 1] - buffers.arcLengths[i];
+        if (element.length <= 0.0)
+        {
+            mErrorMessage = QString("Stations %1 and %2 of the rod coincide").arg(i).arg(i + 1);
+            return false;
+        }
+        element.referenceDistance = mReferencePositions[i + 1] - mReferencePositions[i];
+        auto average = [i](std::vector<double> const& values) { return 0.5 * (values[i] + values[i + 1]); };
+        element.stiffness = {average(buffers.shearStiffness), average(buffers.shearStiffness),
+                             average(buffers.tensionStiffness), average(buffers.bendingStiffnessX),
+                             average(buffers.bendingStiffnessY), average(buffers.torsionalStiffness)};
+        for (int k = 0; k != 6; ++k)
+        {
+            if (element.stiffness[k] <= 0.0)
+            {
+                mErrorMessage = QString("Stiffness of the rod should be positive");
+                return false;
+            }
+        }
+        // Strains are measured from the reference configuration
+        element.referenceStrain = Vector3::zeros();
+        element.referenceCurvature = Vector3::zeros();
+        Kinematics kinematics;
+        computeKinematics(i, kinematics);
+        for (int k = 0; k != 3; ++k)
+        {
+            element.referenceStrain[k] = kinematics.materialForce[k] / element.stiffness[k];
+            element.referenceCurvature[k] = kinematics.materialMoment[k] / element.stiffness[3 + k];
+        }
+    }
+    // Inertia and damping
+    mMasses.resize(numStations);
+    mInertiaMoments.resize(numStations);
+    mDampings.assign(numStations, Vector6::zeros());
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        double tributaryLength = computeTributaryLength(i);
+        mMasses[i] = buffers.linearMassDensity[i] * tributaryLength;
+        mInertiaMoments[i] = {buffers.inertiaMassMomentX[i], buffers.inertiaMassMomentY[i], buffers.inertiaMassMomentZ[i]};
+        mInertiaMoments[i] *= tributaryLength;
+    }
+    // Constraints
+    mConstraintMasks = buffers.constraintMasks;
+    mLocalConstraintMasks = buffers.localConstraintMasks;
+    if (std::all_of(mConstraintMasks.begin(), mConstraintMasks.end(), [](quint8 mask) { return mask == 0; }))
+    {
+        mErrorMessage = QString("Rod should be constrained");
+        return false;
+    }
+    // Loads
+    mLoads.clear();
+    for (RodLoadBuffer const& load : buffers.loads)
+    {
+        Load lumpedLoad = {load.isFollowing, load.timeKeys, load.timeValues, {}};
+        lumpedLoad.values.assign(numStations, Vector6::zeros());
+        bool isLumped = false;
+        for (quint32 i = 0; i != numStations; ++i)
+        {
+            double tributaryLength = computeTributaryLength(i);
+            bool isLast = i == numElements;
+            Vector3 values = {load.values[0][i], load.values[1][i], load.values[2][i]};
+            int iStart = 0;
+            double factor = 0.0;
+            switch (load.type)
+            {
+            case LoadRodComponent::kDistributedForce:
+                factor = tributaryLength;
+                break;
+            case LoadRodComponent::kDistributedMoment:
+                iStart = 3;
+                factor = tributaryLength;
+                break;
+            case LoadRodComponent::kAcceleration:
+                factor = buffers.linearMassDensity[i] * tributaryLength;
+                break;
+            case LoadRodComponent::kPointForce:
+                factor = isLast;
+                break;
+            case LoadRodComponent::kPointMoment:
+                iStart = 3;
+                factor = isLast;
+                break;
+            // Inertia and damping do not depend on time
+            case LoadRodComponent::kPointMass:
+                if (isLast)
+                    mMasses[i] += norm(values);
+                break;
+            case LoadRodComponent::kPointInertiaMoment:
+                if (isLast)
+                    mInertiaMoments[i] += values;
+                break;
+            case LoadRodComponent::kPointLinearDamper:
+                if (isLast)
+                    addVector(mDampings[i], 0, values);
+                break;
+            case LoadRodComponent::kPointRotationalDamper:
+                if (isLast)
+                    addVector(mDampings[i], 3, values);
+                break;
+            case LoadRodComponent::kDisplacementDamping:
+                addVector(mDampings[i], 0, tributaryLength * values);
+                break;
+            case LoadRodComponent::kRotationDamping:
+                addVector(mDampings[i], 3, tributaryLength * values);
+                break;
+            default:
+                break;
+            }
+            if (factor == 0.0)
+                continue;
+            values *= factor;
+            // Following loads are stored in the material frames, so that they are rotated with the stations
+            if (load.isFollowing)
+                values = transposeProduct(mReferenceRotations[i], values);
+            addVector(lumpedLoad.values[i], iStart, values);
+            isLumped = true;
+        }
+        if (isLumped)
+            mLoads.push_back(std::move(lumpedLoad));
+    }
+    mFixedLoads.resize(numStations);
+    mFollowingLoads.resize(numStations);
+    setTime(time);
+    return true;
+}
+
+/*!
+ * \brief Scale the loads by their coefficients at the given time
+ *
+ * The memory of the model is not reallocated, so that this can be called at each time step.
+ */
+void RodModel::setTime(double time)
+{
+    mTime = time;
+    std::fill(mFixedLoads.begin(), mFixedLoads.end(), Vector6::zeros());
+    std::fill(mFollowingLoads.begin(), mFollowingLoads.end(), Vector6::zeros());
+    quint32 numStations = this->numStations();
+    for (Load const& load : mLoads)
+    {
+        double coefficient = interpolateTimeCoefficient(load.timeKeys, load.timeValues, time);
+        if (coefficient == 0.0)
+            continue;
+        std::vector<Vector6>& loads = load.isFollowing ? mFollowingLoads : mFixedLoads;
+        for (quint32 i = 0; i != numStations; ++i)
+            loads[i] += coefficient * load.values[i];
+    }
+    double squaredNorm = 0.0;
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector6 values = mFixedLoads[i] + mFollowingLoads[i];
+        squaredNorm += dot(values, values);
+    }
+    mLoadNorm = std::sqrt(squaredNorm);
+}
+
+//! Return the rod to the reference configuration
+void RodModel::reset()
+{
+    mDisplacements.assign(mReferencePositions.size(), Vector3::zeros());
+    mRotations = mReferenceRotations;
+}
+
+//! Set the displacements and rotations of all the stations
+void RodModel::setConfiguration(std::vector<Vector3> const& displacements, std::vector<Matrix33> const& rotations)
+{
+    mDisplacements = displacements;
+    mRotations = rotations;
+}
+
+/*!
+ * \brief Compute the residual of the equilibrium equations with the constrained degrees of freedom excluded
+ *
+ * The residual is the difference of the internal and external loads of each station. If the motion is given, the
+ * inertial and damping loads are added to it. The degrees of freedom of stations which are constrained locally are
+ * expressed in the reference frames of the stations.
+ * \return Norm of the residual
+ */
+double RodModel::computeResidual(double loadFactor, std::vector<Vector6>& residual, RodMotion const* pMotion) const
+{
+    return assemble(loadFactor, residual, nullptr, pMotion);
+}
+
+/*!
+ * \brief Compute the tangent matrix along with the residual with the constrained degrees of freedom excluded
+ *
+ * The rotational degrees of freedom are spatial rotation vectors which are applied to the current rotations.
+ * \return Norm of the residual
+ */
+double RodModel::computeTangent(double loadFactor, BlockTridiagonalMatrix& tangent, std::vector<Vector6>& residual,
+                                RodMotion const* pMotion) const
+{
+    tangent.resize(numStations());
+    tangent.setZero();
+    return assemble(loadFactor, residual, &tangent, pMotion);
+}
+
+/*!
+ * \brief Compute the external loads at the unit load factor with the constrained degrees of freedom excluded
+ *
+ * This is the derivative of the residual with respect to the load factor with the opposite sign. Following loads
+ * are rotated by the current frames of the stations.
+ * \return Norm of the loads
+ */
+double RodModel::computeLoads(std::vector<Vector6>& loads) const
+{
+    loads.assign(numStations(), Vector6::zeros());
+    addExternalLoads(0, numStations(), -1.0, loads, nullptr);
+    return constrain(loads, nullptr);
+}
+
+/*!
+ * \brief Compute the external loads of the stations in the range [iStart, iEnd) at the unit load factor
+ *
+ * Unlike the loads of the whole rod, the constrained degrees of freedom are kept, and the local constraints are not
+ * applied to the result.
+ */
+void RodModel::computeLoads(quint32 iStart, quint32 iEnd, std::vector<Vector6>& loads) const
+{
+    for (quint32 i = iStart; i != iEnd; ++i)
+        loads[i] = Vector6::zeros();
+    addExternalLoads(iStart, iEnd, -1.0, loads, nullptr);
+}
+
+/*!
+ * \brief Compute the loads which the elements in the range [iStart, iEnd) exert on their stations
+ *
+ * The elements are evaluated by batches, and the loads of each element do not depend on the range, so the ranges
+ * can be processed in parallel.
+ */
+void RodModel::computeElementLoads(quint32 iStart, quint32 iEnd, std::vector<RodElementLoads>& loads) const
+{
+    BatchLoads batchLoads;
+    for (quint32 iBatch = iStart; iBatch < iEnd; iBatch += skBatchWidth)
+    {
+        computeBatchLoads(iBatch, batchLoads);
+        quint32 numLanes = std::min<quint32>(skBatchWidth, iEnd - iBatch);
+        for (quint32 l = 0; l != numLanes; ++l)
+        {
+            RodElementLoads& values = loads[iBatch + l];
+            values.force = batchLoads.forces.get(l);
+            values.firstMoment = batchLoads.firstMoments.get(l);
+            values.secondMoment = batchLoads.secondMoments.get(l);
+        }
+    }
+}
+
+/*!
+ * \brief Compute the lumped mass matrices of the stations with the constrained degrees of freedom excluded
+ *
+ * Inertia moments are rotated by the current frames of the stations. The rows and columns of the constrained degrees
+ * of freedom are zeroed.
+ */
+void RodModel::computeMass(std::vector<Matrix66>& mass) const
+{
+    quint32 numStations = this->numStations();
+    mass.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Matrix66& values = mass[i];
+        values = Matrix66::zeros();
+        for (int k = 0; k != 3; ++k)
+            values(k, k) = mMasses[i];
+        addBlock(values, 3, 3, rotateInertia(mRotations[i], mInertiaMoments[i]));
+        if (mLocalConstraintMasks[i])
+        {
+            Matrix66 transformation = computeTransformation(i);
+            values = transposeProduct(transformation, values * transformation);
+        }
+        quint8 mask = mConstraintMasks[i];
+        for (int k = 0; k != 6; ++k)
+        {
+            if (mask & (1u << k))
+            {
+                for (int l = 0; l != 6; ++l)
+                {
+                    values(k, l) = 0.0;
+                    values(l, k) = 0.0;
+                }
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Estimate the largest time steps of the stations which are stable for the explicit integration
+ *
+ * The squared highest natural frequency of a station is bounded by the Gershgorin sum over its rows of the stiffness
+ * matrix scaled symmetrically by the lumped masses. The stiffness of the elements is taken at the reference
+ * configuration, where the shear couples the translations and rotations of the stations. Stations which are fully
+ * constrained have infinite time steps. If any free degree of freedom has no inertia, all the time steps are zero.
+ */
+void RodModel::computeStableTimeSteps(std::vector<double>& timeSteps) const
+{
+    quint32 numStations = this->numStations();
+    quint32 numElements = mElements.size();
+    // Inverse square roots of the masses and smallest inertia moments of the free degrees of freedom
+    std::vector<double> translationFactors(numStations);
+    std::vector<double> rotationFactors(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        quint8 mask = mConstraintMasks[i];
+        double mass = mMasses[i];
+        double inertiaMoment = std::min({mInertiaMoments[i][0], mInertiaMoments[i][1], mInertiaMoments[i][2]});
+        bool isTranslationFree = (mask & skTranslationMask) != skTranslationMask;
+        bool isRotationFree = (mask & skRotationMask) != skRotationMask;
+        if ((isTranslationFree && mass <= 0.0) || (isRotationFree && inertiaMoment <= 0.0))
+        {
+            timeSteps.assign(numStations, 0.0);
+            return;
+        }
+        translationFactors[i] = isTranslationFree ? 1.0 / std::sqrt(mass) : 0.0;
+        rotationFactors[i] = isRotationFree ? 1.0 / std::sqrt(inertiaMoment) : 0.0;
+    }
+    timeSteps.resize(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        double translationFactor = translationFactors[i];
+        double rotationFactor = rotationFactors[i];
+        double translationSum = 0.0;
+        double rotationSum = 0.0;
+        for (quint32 iElement = i > 0 ? i - 1 : 0; iElement != std::min(i + 1, numElements); ++iElement)
+        {
+            Element const& element = mElements[iElement];
+            Vector6 const& stiffness = element.stiffness;
+            quint32 j = iElement == i ? i + 1 : iElement;
+            double translationStiffness = std::max(stiffness[0], stiffness[2]) / element.length;
+            double rotationStiffness = std::max({stiffness[3], stiffness[4], stiffness[5]}) / element.length
+                                       + 0.25 * stiffness[0] * element.length;
+            double couplingStiffness = 0.5 * stiffness[0];
+            double translationSumFactors = translationFactor + translationFactors[j];
+            double rotationSumFactors = rotationFactor + rotationFactors[j];
+            translationSum += translationFactor * (translationStiffness * translationSumFactors + couplingStiffness * rotationSumFactors);
+            rotationSum += rotationFactor * (rotationStiffness * rotationSumFactors + couplingStiffness * translationSumFactors);
+        }
+        double squaredFrequency = std::max(translationSum, rotationSum);
+        timeSteps[i] = squaredFrequency > 0.0 ? 2.0 / std::sqrt(squaredFrequency) : std::numeric_limits<double>::infinity();
+    }
+}
+
+//! Check whether the coefficients of any load vary over time
+bool RodModel::isTimeDependent() const
+{
+    return std::any_of(mLoads.begin(), mLoads.end(), [](Load const& load) { return load.timeKeys.size() > 1; });
+}
+
+//! Transform increments of the locally constrained stations back to the global coordinate system
+void RodModel::expand(std::vector<Vector6>& increments) const
+{
+    quint32 numStations = this->numStations();
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        if (mLocalConstraintMasks[i])
+            increments[i] = computeTransformation(i) * increments[i];
+    }
+}
+
+//! Displace the stations and rotate their frames by the scaled increments
+void RodModel::update(std::vector<Vector6> const& increments, double scale)
+{
+    update(0, numStations(), increments, scale);
+}
+
+//! Displace the stations in the range [iStart, iEnd) and rotate their frames by the scaled increments
+void RodModel::update(quint32 iStart, quint32 iEnd, std::vector<Vector6> const& increments, double scale)
+{
+    for (quint32 i = iStart; i != iEnd; ++i)
+    {
+        Vector6 const& increment = increments[i];
+        for (int k = 0; k != 3; ++k)
+            mDisplacements[i][k] += scale * increment[k];
+        Vector3 rotation = {scale * increment[3], scale * increment[4], scale * increment[5]};
+        mRotations[i] = expMap(rotation) * mRotations[i];
+    }
+}
+
+//! Compute the largest increment of the stations, where the translations are relative to the length of the rod
+double RodModel::computeIncrementNorm(std::vector<Vector6> const& increments) const
+{
+    double result = 0.0;
+    for (Vector6 const& values : increments)
+    {
+        Vector3 translation = {values[0], values[1], values[2]};
+        Vector3 rotation = {values[3], values[4], values[5]};
+        result = std::max({result, norm(translation) / mLength, norm(rotation)});
+    }
+    return result;
+}
+
+//! Write the positions, frames and stress resultants of the current configuration
+void RodModel::exportState(RodState& state) const
+{
+    quint32 numStations = this->numStations();
+    quint32 numElements = mElements.size();
+    for (auto& values : state.positions)
+        values.resize(numStations);
+    for (auto& values : state.frames)
+        values.resize(numStations);
+    for (auto& values : state.forces)
+        values.resize(numElements);
+    for (auto& values : state.moments)
+        values.resize(numElements);
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        for (int k = 0; k != 3; ++k)
+            state.positions[k][i] = mReferencePositions[i][k] + mDisplacements[i][k];
+        for (int k = 0; k != 9; ++k)
+            state.frames[k][i] = mRotations[i][k];
+    }
+    Kinematics kinematics;
+    for (quint32 i = 0; i != numElements; ++i)
+    {
+        computeKinematics(i, kinematics);
+        for (int k = 0; k != 3; ++k)
+        {
+            state.forces[k][i] = kinematics.materialForce[k];
+            state.moments[k][i] = kinematics.materialMoment[k];
+        }
+    }
+}
+
+/*!
+ * \brief Compute strains and stress resultants of an element
+ *
+ * The relative rotation φ of the element is the logarithm of the product of the transposed rotation of the first station
+ * by the rotation of the second one. Its increment is the product of the inverse Jacobian by the relative spin of
+ * the stations expressed in the frame of the first one.
+ */
+void RodModel::computeKinematics(quint32 iElement, Kinematics& kinematics) const
+{
+    Element const& element = mElements[iElement];
+    Matrix33 const& firstRotation = mRotations[iElement];
+    Matrix33 const& secondRotation = mRotations[iElement + 1];
+    double invLength = 1.0 / element.length;
+    kinematics.distance = element.referenceDistance + (mDisplacements[iElement + 1] - mDisplacements[iElement]);
+    kinematics.relativeRotation = logMap(transposeProduct(firstRotation, secondRotation));
+    kinematics.inverseJacobian = inverseLeftJacobian(kinematics.relativeRotation);
+    Vector3 strain = (0.5 * invLength) * transposeProduct(firstRotation + secondRotation, kinematics.distance);
+    strain -= element.referenceStrain;
+    Vector3 curvature = invLength * kinematics.relativeRotation - element.referenceCurvature;
+    for (int k = 0; k != 3; ++k)
+    {
+        kinematics.materialForce[k] = element.stiffness[k] * strain[k];
+        kinematics.materialMoment[k] = element.stiffness[3 + k] * curvature[k];
+    }
+    kinematics.firstForce = firstRotation * kinematics.materialForce;
+    kinematics.secondForce = secondRotation * kinematics.materialForce;
+    kinematics.moment = firstRotation * transposeProduct(kinematics.inverseJacobian, kinematics.materialMoment);
+}
+
+/*!
+ * \brief Compute the loads which a batch of consecutive elements exert on their stations
+ *
+ * This is the vectorized counterpart of computeKinematics() which skips the quantities needed only for the tangent
+ * matrix. The moment conjugate to the relative spin is evaluated through the cross products by the relative rotation,
+ * since the transposed inverse Jacobian is I + [φ]/2 + c [φ]^2. Lanes beyond the last element repeat it.
+ */
+void RodModel::computeBatchLoads(quint32 iStartElement, BatchLoads& loads) const
+{
+    int const kWidth = skBatchWidth;
+    quint32 iLastElement = mElements.size() - 1;
+    BatchMatrix33<> firstRotations, secondRotations, relativeRotations;
+    BatchVector3<> distances, relativeRotationVectors, referenceStrains, referenceCurvatures;
+    BatchMatrix<6, 1> stiffness;
+    alignas(64) double invLengths[kWidth];
+    for (int l = 0; l != kWidth; ++l)
+    {
+        quint32 i = std::min<quint32>(iStartElement + l, iLastElement);
+        Element const& element = mElements[i];
+        firstRotations.set(l, mRotations[i]);
+        secondRotations.set(l, mRotations[i + 1]);
+        distances.set(l, element.referenceDistance + (mDisplacements[i + 1] - mDisplacements[i]));
+        stiffness.set(l, element.stiffness);
+        referenceStrains.set(l, element.referenceStrain);
+        referenceCurvatures.set(l, element.referenceCurvature);
+        invLengths[l] = 1.0 / element.length;
+    }
+    transposeProduct(firstRotations, secondRotations, relativeRotations);
+    logMap(relativeRotations, relativeRotationVectors);
+    // Stress resultants in the material frame
+    BatchVector3<> materialForces, materialMoments;
+    for (int k = 0; k != 3; ++k)
+    {
+        for (int l = 0; l != kWidth; ++l)
+        {
+            double strain = 0.0;
+            for (int j = 0; j != 3; ++j)
+                strain += (firstRotations(j, k)[l] + secondRotations(j, k)[l]) * distances[j][l];
+            strain = 0.5 * invLengths[l] * strain - referenceStrains[k][l];
+            double curvature = invLengths[l] * relativeRotationVectors[k][l] - referenceCurvatures[k][l];
+            materialForces[k][l] = stiffness[k][l] * strain;
+            materialMoments[k][l] = stiffness[3 + k][l] * curvature;
+        }
+    }
+    // Moments which are conjugate to the relative spins in the frames of the first stations
+    alignas(64) double coefficients[kWidth];
+    for (int l = 0; l != kWidth; ++l)
+    {
+        double x = relativeRotationVectors[0][l], y = relativeRotationVectors[1][l], z = relativeRotationVectors[2][l];
+        coefficients[l] = computeInverseJacobianCoefficient(x * x + y * y + z * z);
+    }
+    BatchVector3<> conjugateMoments;
+    for (int l = 0; l != kWidth; ++l)
+    {
+        double x = relativeRotationVectors[0][l], y = relativeRotationVectors[1][l], z = relativeRotationVectors[2][l];
+        double mx = materialMoments[0][l], my = materialMoments[1][l], mz = materialMoments[2][l];
+        double ax = y * mz - z * my, ay = z * mx - x * mz, az = x * my - y * mx;
+        double bx = y * az - z * ay, by = z * ax - x * az, bz = x * ay - y * ax;
+        conjugateMoments[0][l] = mx + 0.5 * ax + coefficients[l] * bx;
+        conjugateMoments[1][l] = my + 0.5 * ay + coefficients[l] * by;
+        conjugateMoments[2][l] = mz + 0.5 * az + coefficients[l] * bz;
+    }
+    // Loads in the global coordinate system
+    BatchVector3<> firstForces, secondForces, moments;
+    multiply(firstRotations, materialForces, firstForces);
+    multiply(secondRotations, materialForces, secondForces);
+    multiply(firstRotations, conjugateMoments, moments);
+    for (int k = 0; k != 3; ++k)
+    {
+        int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+        for (int l = 0; l != kWidth; ++l)
+        {
+            double firstArm = firstForces[k1][l] * distances[k2][l] - firstForces[k2][l] * distances[k1][l];
+            double secondArm = secondForces[k1][l] * distances[k2][l] - secondForces[k2][l] * distances[k1][l];
+            loads.forces[k][l] = 0.5 * (firstForces[k][l] + secondForces[k][l]);
+            loads.firstMoments[k][l] = 0.5 * firstArm - moments[k][l];
+            loads.secondMoments[k][l] = 0.5 * secondArm + moments[k][l];
+        }
+    }
+}
+
+//! Compute the residual and, optionally, the tangent matrix and exclude the constrained degrees of freedom from them
+double RodModel::assemble(double loadFactor, std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent,
+                          RodMotion const* pMotion) const
+{
+    quint32 numStations = this->numStations();
+    residual.assign(numStations, Vector6::zeros());
+    addInternalLoads(residual, pTangent);
+    addExternalLoads(0, numStations, loadFactor, residual, pTangent);
+    if (pMotion)
+        addInertialLoads(*pMotion, residual, pTangent);
+    return constrain(residual, pTangent);
+}
+
+/*!
+ * \brief Add the internal loads of the elements to the residual and, optionally, their tangent matrices
+ *
+ * Without the tangent matrix, the elements are evaluated by batches.
+ */
+void RodModel::addInternalLoads(std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent) const
+{
+    quint32 numElements = mElements.size();
+    if (!pTangent)
+    {
+        BatchLoads loads;
+        for (quint32 iBatch = 0; iBatch < numElements; iBatch += skBatchWidth)
+        {
+            computeBatchLoads(iBatch, loads);
+            quint32 numLanes = std::min<quint32>(skBatchWidth, numElements - iBatch);
+            for (quint32 l = 0; l != numLanes; ++l)
+            {
+                quint32 i = iBatch + l;
+                Vector3 force = loads.forces.get(l);
+                addVector(residual[i], 0, -1.0 * force);
+                addVector(residual[i], 3, loads.firstMoments.get(l));
+                addVector(residual[i + 1], 0, force);
+                addVector(residual[i + 1], 3, loads.secondMoments.get(l));
+            }
+        }
+        return;
+    }
+    Kinematics kinematics;
+    for (quint32 i = 0; i != numElements; ++i)
+    {
+        computeKinematics(i, kinematics);
+        Vector3 force = 0.5 * (kinematics.firstForce + kinematics.secondForce);
+        addVector(residual[i], 0, -1.0 * force);
+        addVector(residual[i], 3, 0.5 * cross(kinematics.firstForce, kinematics.distance) - kinematics.moment);
+        addVector(residual[i + 1], 0, force);
+        addVector(residual[i + 1], 3, 0.5 * cross(kinematics.secondForce, kinematics.distance) + kinematics.moment);
+        assembleElement(i, kinematics, *pTangent);
+    }
+}
+
+/*!
+ * \brief Add the tangent matrix of an element
+ *
+ * The material part is L B^T C B, where the rows of B are the variations of strains and curvatures with respect to
+ * the degrees of freedom of both stations. The geometric part is the variation of the internal loads at fixed stress
+ * resultants. Both parts are exact, so the Newton iterations converge quadratically.
+ */
+void RodModel::assembleElement(quint32 iElement, Kinematics const& kinematics, BlockTridiagonalMatrix& tangent) const
+{
+    Element const& element = mElements[iElement];
+    double invLength = 1.0 / element.length;
+    Matrix33 const& firstRotation = mRotations[iElement];
+    Matrix33 const& secondRotation = mRotations[iElement + 1];
+    Matrix33 distanceMatrix = skew(kinematics.distance);
+    // Variations of the strain with respect to the translations, which differ only by the sign, and the rotations
+    std::array<Matrix33, 3> strainMatrices = {(0.5 * invLength) * (firstRotation + secondRotation).transpose(),
+                                              (0.5 * invLength) * transposeProduct(firstRotation, distanceMatrix),
+                                              (0.5 * invLength) * transposeProduct(secondRotation, distanceMatrix)};
+    // Variation of the curvature with respect to the rotation of the second station, which is opposite for the first one
+    Matrix33 curvatureMatrix = invLength * (kinematics.inverseJacobian * firstRotation.transpose());
+    // Material part
+    std::array<std::array<Matrix33, 3>, 3> products;
+    for (int b = 0; b != 3; ++b)
+    {
+        Matrix33 strainProduct = scaleRows(strainMatrices[b], element.length, element.stiffness, 0);
+        for (int a = 0; a != 3; ++a)
+            products[a][b] = transposeProduct(strainMatrices[a], strainProduct);
+    }
+    Matrix33 curvatureProduct = transposeProduct(curvatureMatrix,
+                                                 scaleRows(curvatureMatrix, element.length, element.stiffness, 3));
+    // Degrees of freedom of the element are ordered as translations and rotations of the first and second stations
+    std::array<int, 4> const indices = {0, 1, 0, 2};
+    std::array<double, 4> const signs = {-1.0, 1.0, 1.0, 1.0};
+    std::array<std::array<Matrix33, 4>, 4> blocks;
+    for (int a = 0; a != 4; ++a)
+    {
+        for (int b = 0; b != 4; ++b)
+            blocks[a][b] = (signs[a] * signs[b]) * products[indices[a]][indices[b]];
+    }
+    blocks[1][1] += curvatureProduct;
+    blocks[1][3] -= curvatureProduct;
+    blocks[3][1] -= curvatureProduct;
+    blocks[3][3] += curvatureProduct;
+    // Geometric part due to the rotation of the force with the frames of the stations
+    Matrix33 firstForce = 0.5 * skew(kinematics.firstForce);
+    Matrix33 secondForce = 0.5 * skew(kinematics.secondForce);
+    blocks[0][1] += firstForce;
+    blocks[0][3] += secondForce;
+    blocks[2][1] -= firstForce;
+    blocks[2][3] -= secondForce;
+    // Geometric part due to the lever of the force
+    blocks[1][1] += distanceMatrix * firstForce;
+    blocks[3][3] += distanceMatrix * secondForce;
+    blocks[1][0] -= firstForce;
+    blocks[1][2] += firstForce;
+    blocks[3][0] -= secondForce;
+    blocks[3][2] += secondForce;
+    // Geometric part due to the rotation of the moment and the variation of the inverse Jacobian
+    Matrix33 momentMatrix = skew(kinematics.moment);
+    Matrix33 jacobianMatrix = differentiateInverseJacobian(kinematics.relativeRotation, kinematics.materialMoment);
+    jacobianMatrix = firstRotation * jacobianMatrix * curvatureMatrix;
+    jacobianMatrix *= element.length;
+    blocks[1][1] += momentMatrix + jacobianMatrix;
+    blocks[1][3] -= jacobianMatrix;
+    blocks[3][1] -= momentMatrix + jacobianMatrix;
+    blocks[3][3] += jacobianMatrix;
+    // Scatter the blocks of the element
+    Matrix66& firstDiagonal = tangent.diagonal(iElement);
+    Matrix66& secondDiagonal = tangent.diagonal(iElement + 1);
+    Matrix66& upper = tangent.upper(iElement);
+    Matrix66& lower = tangent.lower(iElement);
+    for (int a = 0; a != 2; ++a)
+    {
+        for (int b = 0; b != 2; ++b)
+        {
+            addBlock(firstDiagonal, 3 * a, 3 * b, blocks[a][b]);
+            addBlock(upper, 3 * a, 3 * b, blocks[a][2 + b]);
+            addBlock(lower, 3 * a, 3 * b, blocks[2 + a][b]);
+            addBlock(secondDiagonal, 3 * a, 3 * b, blocks[2 + a][2 + b]);
+        }
+    }
+}
+
+//! Subtract the external loads scaled by the load factor from the residual of the stations in the range [iStart, iEnd) and add the tangent of the following ones
+void RodModel::addExternalLoads(quint32 iStart, quint32 iEnd, double loadFactor, std::vector<Vector6>& residual,
+                                BlockTridiagonalMatrix* pTangent) const
+{
+    for (quint32 i = iStart; i != iEnd; ++i)
+    {
+        Vector6 const& fixedLoad = mFixedLoads[i];
+        Vector6 const& followingLoad = mFollowingLoads[i];
+        Matrix33 const& rotation = mRotations[i];
+        Vector3 force = {followingLoad[0], followingLoad[1], followingLoad[2]};
+        Vector3 moment = {followingLoad[3], followingLoad[4], followingLoad[5]};
+        force = loadFactor * (rotation * force);
+        moment = loadFactor * (rotation * moment);
+        Vector6& values = residual[i];
+        for (int k = 0; k != 3; ++k)
+        {
+            values[k] -= loadFactor * fixedLoad[k] + force[k];
+            values[3 + k] -= loadFactor * fixedLoad[3 + k] + moment[k];
+        }
+        // Following loads rotate together with the station
+        if (pTangent)
+        {
+            Matrix66& diagonal = pTangent->diagonal(i);
+            addBlock(diagonal, 0, 3, skew(force));
+            addBlock(diagonal, 3, 3, skew(moment));
+        }
+    }
+}
+
+/*!
+ * \brief Add the inertial and damping loads of the stations and their derivatives
+ *
+ * The inertial moment is J ω' + ω × J ω, where J is the inertia tensor rotated by the current frame. The derivative
+ * of the tensor with respect to the rotation is neglected in the tangent matrix, which affects only the convergence
+ * rate of the iterations.
+ */
+void RodModel::addInertialLoads(RodMotion const& motion, std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent) const
+{
+    quint32 numStations = this->numStations();
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector6 const& velocity = motion.velocities[i];
+        Vector6 const& acceleration = motion.accelerations[i];
+        Vector6 const& damping = mDampings[i];
+        Vector3 angularVelocity = {velocity[3], velocity[4], velocity[5]};
+        Vector3 angularAcceleration = {acceleration[3], acceleration[4], acceleration[5]};
+        Matrix33 inertia = rotateInertia(mRotations[i], mInertiaMoments[i]);
+        Vector3 angularMomentum = inertia * angularVelocity;
+        Vector3 moment = inertia * angularAcceleration + cross(angularVelocity, angularMomentum);
+        Vector6& values = residual[i];
+        for (int k = 0; k != 3; ++k)
+        {
+            values[k] += mMasses[i] * acceleration[k] + damping[k] * velocity[k];
+            values[3 + k] += moment[k] + damping[3 + k] * velocity[3 + k];
+        }
+        if (pTangent)
+        {
+            Matrix66& diagonal = pTangent->diagonal(i);
+            Matrix33 gyroscopic = skew(angularVelocity) * inertia - skew(angularMomentum);
+            addBlock(diagonal, 3, 3, motion.accelerationFactor * inertia + motion.velocityFactor * gyroscopic);
+            for (int k = 0; k != 3; ++k)
+            {
+                diagonal(k, k) += motion.accelerationFactor * mMasses[i] + motion.velocityFactor * damping[k];
+                diagonal(3 + k, 3 + k) += motion.velocityFactor * damping[3 + k];
+            }
+        }
+    }
+}
+
+//! Zero the components of a vector of a station along its constrained degrees of freedom, which follow the reference frame of the station if they are constrained locally
+void RodModel::project(quint32 iStation, Vector6& values) const
+{
+    quint8 mask = mConstraintMasks[iStation];
+    if (!mask)
+        return;
+    bool isLocal = mLocalConstraintMasks[iStation];
+    Matrix66 transformation;
+    if (isLocal)
+    {
+        transformation = computeTransformation(iStation);
+        values = transposeProduct(transformation, values);
+    }
+    for (int k = 0; k != 6; ++k)
+    {
+        if (mask & (1u << k))
+            values[k] = 0.0;
+    }
+    if (isLocal)
+        values = transformation * values;
+}
+
+//! Compute the half of the lengths of the elements adjacent to a station
+double RodModel::computeTributaryLength(quint32 iStation) const
+{
+    double result = 0.0;
+    if (iStation > 0)
+        result += 0.5 * mElements[iStation - 1].length;
+    if (iStation < mElements.size())
+        result += 0.5 * mElements[iStation].length;
+    return result;
+}
+
+//! Compute the matrix which maps the degrees of freedom of a station in its local coordinate system to the global ones
+Matrix66 RodModel::computeTransformation(quint32 iStation) const
+{
+    Matrix66 result = Matrix66::identity();
+    quint8 mask = mLocalConstraintMasks[iStation];
+    Matrix33 const& rotation = mReferenceRotations[iStation];
+    if (mask & skTranslationMask)
+        addBlock(result, 0, 0, rotation - Matrix33::identity());
+    if (mask & skRotationMask)
+        addBlock(result, 3, 3, rotation - Matrix33::identity());
+    return result;
+}
+
+/*!
+ * \brief Exclude the constrained degrees of freedom from the residual and tangent matrix
+ *
+ * Translations or rotations of a station are expressed in its reference frame if any of them is constrained locally.
+ * \return Norm of the residual over the free degrees of freedom
+ */
+double RodModel::constrain(std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent) const
+{
+    quint32 numStations = this->numStations();
+    double squaredNorm = 0.0;
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector6& values = residual[i];
+        quint8 mask = mConstraintMasks[i];
+        if (mLocalConstraintMasks[i])
+        {
+            Matrix66 transformation = computeTransformation(i);
+            values = transposeProduct(transformation, values);
+            if (pTangent)
+                pTangent->transform(i, transformation);
+        }
+        for (int k = 0; k != 6; ++k)
+        {
+            if (mask & (1u << k))
+            {
+                values[k] = 0.0;
+                if (pTangent)
+                    pTangent->constrain(i, k);
+            }
+        }
+        squaredNorm += dot(values, values);
+    }
+    return std::sqrt(squaredNorm);
+}
@@ -0,0 +1,197 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodModel class
+ */
+
+#ifndef RODMODEL_H
+#define RODMODEL_H
+
+#include <functional>
+#include <QString>
+#include "rodassembly.h"
+#include "blocktridiagonalmatrix.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Deformed state of a rod sampled at stations
+ *
+ * Positions and frames are stored like the ones of RodBuffers. Internal forces and moments are given for each element
+ * between consecutive stations in the material frame of the element.
+ */
+struct RodState
+{
+    quint32 numStations() const { return positions[0].size(); }
+    std::array<std::vector<double>, 3> positions;
+    std::array<std::vector<double>, 9> frames;
+    std::array<std::vector<double>, 3> forces;
+    std::array<std::vector<double>, 3> moments;
+};
+
+//! Function which receives states of a rod along with their parameters, such as load factors or time, and returns whether the analysis should go on
+using RodStateWriterFun = std::function<bool(double parameter, RodState const& state)>;
+
+/*!
+ * \brief Motion of the stations of a rod which gives rise to inertial and damping loads
+ *
+ * Velocities and accelerations consist of translational and angular parts in the global coordinate system. The factors
+ * are derivatives of velocities and accelerations with respect to the increments of the stations, which are defined by
+ * the time integration scheme.
+ */
+struct RodMotion
+{
+    std::vector<Vector6> velocities;
+    std::vector<Vector6> accelerations;
+    double velocityFactor = 0.0;
+    double accelerationFactor = 0.0;
+};
+
+/*!
+ * \brief Loads which an element exerts on its stations in the global coordinate system
+ *
+ * The loads are contributions to the residual: the first station receives the opposite force and the first moment,
+ * whereas the second one receives the force and the second moment.
+ */
+struct RodElementLoads
+{
+    Vector3 force;
+    Vector3 firstMoment;
+    Vector3 secondMoment;
+};
+
+/*!
+ * \brief Geometrically exact finite element model of a rod
+ *
+ * Each station is a node with three translations and three rotations, and each pair of consecutive stations is an
+ * element. The strain of an element is its chord measured in the average of the frames of its stations, and the
+ * curvature is the relative rotation of the frames divided by the length. Rotations of the nodes are updated
+ * multiplicatively by spatial rotation vectors. Since an element couples only two neighbouring nodes, the tangent
+ * matrix is block-tridiagonal.
+ */
+class RodModel
+{
+public:
+    //! Increment of the stations beyond which the iterations of the solvers are considered to be diverging
+    static constexpr double skMaxIncrementNorm = 3.0;
+    //! Relative remainder of the time interval which is merged into the last step of the time integration
+    static constexpr double skTimeTolerance = 1e-8;
+    bool initialize(RodBuffers const& buffers, double time = 0.0);
+    void setTime(double time);
+    double time() const { return mTime; }
+    void reset();
+    quint32 numStations() const { return mDisplacements.size(); }
+    //! Length of the rod in the reference configuration
+    double length() const { return mLength; }
+    std::vector<Vector3> const& displacements() const { return mDisplacements; }
+    std::vector<Matrix33> const& rotations() const { return mRotations; }
+    void setConfiguration(std::vector<Vector3> const& displacements, std::vector<Matrix33> const& rotations);
+    //! Norm of the external loads at the unit load factor
+    double loadNorm() const { return mLoadNorm; }
+    double computeResidual(double loadFactor, std::vector<Vector6>& residual, RodMotion const* pMotion = nullptr) const;
+    double computeTangent(double loadFactor, BlockTridiagonalMatrix& tangent, std::vector<Vector6>& residual,
+                          RodMotion const* pMotion = nullptr) const;
+    double computeLoads(std::vector<Vector6>& loads) const;
+    void computeLoads(quint32 iStart, quint32 iEnd, std::vector<Vector6>& loads) const;
+    void computeElementLoads(quint32 iStart, quint32 iEnd, std::vector<RodElementLoads>& loads) const;
+    void computeMass(std::vector<Matrix66>& mass) const;
+    void computeStableTimeSteps(std::vector<double>& timeSteps) const;
+    bool isTimeDependent() const;
+    //! Masses, principal inertia moments in the material frames and damping coefficients of the stations
+    std::vector<double> const& masses() const { return mMasses; }
+    std::vector<Vector3> const& inertiaMoments() const { return mInertiaMoments; }
+    std::vector<Vector6> const& dampings() const { return mDampings; }
+    void project(quint32 iStation, Vector6& values) const;
+    void expand(std::vector<Vector6>& increments) const;
+    void update(std::vector<Vector6> const& increments, double scale = 1.0);
+    void update(quint32 iStart, quint32 iEnd, std::vector<Vector6> const& increments, double scale = 1.0);
+    double computeIncrementNorm(std::vector<Vector6> const& increments) const;
+    void exportState(RodState& state) const;
+    QString const& errorMessage() const { return mErrorMessage; }
+
+private:
+    //! Properties of an element which do not change during deformation
+    struct Element
+    {
+        double length;
+        //! Chord of the element in the reference configuration
+        Vector3 referenceDistance;
+        //! Diagonal of the stiffness matrix: shear, tension, bending and torsional stiffness
+        Vector6 stiffness;
+        //! Strains of the reference configuration
+        Vector3 referenceStrain;
+        Vector3 referenceCurvature;
+    };
+    //! Load lumped at stations, which is scaled by the coefficient interpolated over time
+    struct Load
+    {
+        bool isFollowing;
+        std::vector<double> timeKeys;
+        std::vector<double> timeValues;
+        std::vector<Vector6> values;
+    };
+    //! Kinematic quantities and stress resultants of an element
+    struct Kinematics
+    {
+        Vector3 distance;
+        Vector3 relativeRotation;
+        Matrix33 inverseJacobian;
+        Vector3 materialForce;
+        Vector3 materialMoment;
+        //! Material force rotated by the frames of the first and second stations
+        Vector3 firstForce;
+        Vector3 secondForce;
+        //! Moment which is conjugate to the spin of the second station relative to the first one
+        Vector3 moment;
+    };
+    //! Loads which a batch of elements exert on their stations in the global coordinate system
+    struct BatchLoads
+    {
+        //! Force applied to the second station, whereas the opposite one is applied to the first station
+        BatchVector3<> forces;
+        BatchVector3<> firstMoments;
+        BatchVector3<> secondMoments;
+    };
+    void computeKinematics(quint32 iElement, Kinematics& kinematics) const;
+    void computeBatchLoads(quint32 iStartElement, BatchLoads& loads) const;
+    double assemble(double loadFactor, std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent,
+                    RodMotion const* pMotion) const;
+    void assembleElement(quint32 iElement, Kinematics const& kinematics, BlockTridiagonalMatrix& tangent) const;
+    void addInternalLoads(std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent) const;
+    void addExternalLoads(quint32 iStart, quint32 iEnd, double loadFactor, std::vector<Vector6>& residual,
+                          BlockTridiagonalMatrix* pTangent) const;
+    void addInertialLoads(RodMotion const& motion, std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent) const;
+    double computeTributaryLength(quint32 iStation) const;
+    Matrix66 computeTransformation(quint32 iStation) const;
+    double constrain(std::vector<Vector6>& residual, BlockTridiagonalMatrix* pTangent) const;
+
+private:
+    QString mErrorMessage;
+    // Reference configuration
+    std::vector<Vector3> mReferencePositions;
+    std::vector<Matrix33> mReferenceRotations;
+    std::vector<Element> mElements;
+    double mLength = 0.0;
+    // Current configuration. Displacements are stored instead of positions to keep chords of short elements accurate
+    std::vector<Vector3> mDisplacements;
+    std::vector<Matrix33> mRotations;
+    // Masses, principal inertia moments and damping coefficients of the stations lumped by their tributary lengths
+    std::vector<double> mMasses;
+    std::vector<Vector3> mInertiaMoments;
+    std::vector<Vector6> mDampings;
+    // Loads at unit coefficients and their sums at the current time. Loads which follow the rotations of stations are
+    // given in the material frames
+    std::vector<Load> mLoads;
+    double mTime = 0.0;
+    std::vector<Vector6> mFixedLoads;
+    std::vector<Vector6> mFollowingLoads;
+    double mLoadNorm = 0.0;
+    std::vector<quint8> mConstraintMasks;
+    std::vector<quint8> mLocalConstraintMasks;
+};
+
+}
+
+#endif // RODMODEL_H
@@ -0,0 +1,164 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodSampler class
+ */
+
+#include <algorithm>
+#include <numeric>
+#include "rodsampler.h"
+#include "tasks.h"
+
+using namespace QRS::Core;
+
+//! Minimal number of values to be sampled which is worth distributing between threads
+quint32 const skMinParallelWork = 1u << 15;
+
+//! Request to write an element of a data object to the given buffer
+void RodSampler::addField(AbstractDataObject const* pDataObject, IndexType iElement, double* pValues, double defaultValue)
+{
+    mFields.push_back({pDataObject, iElement, pValues, defaultValue});
+}
+
+//! Remove all the fields
+void RodSampler::clear()
+{
+    mFields.clear();
+    mSources.clear();
+    mGrids.clear();
+    mNumGrids = 0;
+}
+
+/*!
+ * \brief Interpolate all the fields at the given parameters
+ *
+ * Buffers of the fields must be able to hold as many values as there are parameters. Items of the data objects are
+ * requested before the parallel section, so that derived objects are evaluated in the calling thread.
+ */
+void RodSampler::sample(std::vector<double> const& parameters)
+{
+    mNumParameters = parameters.size();
+    quint32 numFields = mFields.size();
+    // Stations are usually placed along a rod, otherwise they are sorted and the results are scattered back
+    mOrder.clear();
+    mpParameters = parameters.data();
+    if (!std::is_sorted(parameters.begin(), parameters.end()))
+    {
+        mOrder.resize(mNumParameters);
+        std::iota(mOrder.begin(), mOrder.end(), 0);
+        std::sort(mOrder.begin(), mOrder.end(), [&parameters](quint32 i, quint32 j) { return parameters[i] < parameters[j]; });
+        mSortedParameters.resize(mNumParameters);
+        for (quint32 i = 0; i != mNumParameters; ++i)
+            mSortedParameters[i] = parameters[mOrder[i]];
+        mpParameters = mSortedParameters.data();
+    }
+    // Group the fields by data objects. Fields of missing or empty objects are filled with default values at once
+    for (auto& item : mSources)
+        item.second.fieldIndices.clear();
+    for (quint32 i = 0; i != numFields; ++i)
+    {
+        Field const& field = mFields[i];
+        if (!field.pDataObject || field.pDataObject->getItems().empty())
+            std::fill(field.pValues, field.pValues + mNumParameters, field.defaultValue);
+        else
+            mSources[field.pDataObject].fieldIndices.push_back(i);
+    }
+    std::erase_if(mSources, [](auto const& item) { return item.second.fieldIndices.empty(); });
+    // Flatten the modified objects and find the ranges of stations once for all the objects which share keys
+    std::vector<Source*> sources;
+    mNumGrids = 0;
+    for (auto& [pDataObject, source] : mSources)
+    {
+        flattenSource(pDataObject, source);
+        sources.push_back(&source);
+        auto iGrid = std::find_if(mGrids.begin(), mGrids.begin() + mNumGrids, [&source](Grid const& grid) { return grid.keys == source.keys; });
+        source.iGrid = iGrid - mGrids.begin();
+        if (source.iGrid != mNumGrids)
+            continue;
+        // Buffers of grids are reused between samplings
+        if (mNumGrids == mGrids.size())
+            mGrids.emplace_back();
+        Grid& grid = mGrids[mNumGrids++];
+        grid.keys = source.keys;
+        // Number of stations which precede each key
+        quint32 numKeys = grid.keys.size();
+        grid.offsets.resize(numKeys);
+        quint32 iStation = 0;
+        for (quint32 k = 0; k != numKeys; ++k)
+        {
+            while (iStation != mNumParameters && mpParameters[iStation] < grid.keys[k])
+                ++iStation;
+            grid.offsets[k] = iStation;
+        }
+    }
+    // Interpolate the values of each object
+    bool isParallel = mIsParallel && (quint64)mNumParameters * numFields >= skMinParallelWork;
+    runTasks(sources.size(), [this, &sources](int iSource) { sampleSource(*sources[iSource]); }, isParallel);
+}
+
+//! Copy keys and requested elements of a data object unless they are up to date
+void RodSampler::flattenSource(AbstractDataObject const* pDataObject, Source& source)
+{
+    quint32 numSourceFields = source.fieldIndices.size();
+    std::vector<IndexType> elements(numSourceFields);
+    for (quint32 k = 0; k != numSourceFields; ++k)
+        elements[k] = mFields[source.fieldIndices[k]].iElement;
+    if (source.version == pDataObject->version() && source.elements == elements)
+        return;
+    DataHolder const& items = pDataObject->getItems();
+    quint32 numKeys = items.size();
+    source.version = pDataObject->version();
+    source.elements = std::move(elements);
+    source.keys.resize(numKeys);
+    source.values.resize(numKeys * numSourceFields);
+    quint32 iKey = 0;
+    for (auto const& [key, array] : items)
+    {
+        source.keys[iKey] = key;
+        for (quint32 k = 0; k != numSourceFields; ++k)
+        {
+            IndexType iElement = source.elements[k];
+            source.values[k * numKeys + iKey] = array.size() > iElement ? array.data()[iElement] : array.data()[0];
+        }
+        ++iKey;
+    }
+}
+
+/*!
+ * \brief Interpolate the flattened elements of a data object over its grid
+ *
+ * Values are constant before the first key and after the last one. Between keys, they are computed segment by segment,
+ * so the inner loop runs over contiguous stations without any searching or branching.
+ */
+void RodSampler::sampleSource(Source const& source) const
+{
+    Grid const& grid = mGrids[source.iGrid];
+    DataKeyType const* pKeys = grid.keys.data();
+    quint32 const* pOffsets = grid.offsets.data();
+    quint32 numKeys = grid.keys.size();
+    quint32 numSourceFields = source.fieldIndices.size();
+    std::vector<double> sorted(mOrder.empty() ? 0 : mNumParameters);
+    for (quint32 k = 0; k != numSourceFields; ++k)
+    {
+        double const* pValues = source.values.data() + k * numKeys;
+        double* pResult = mOrder.empty() ? mFields[source.fieldIndices[k]].pValues : sorted.data();
+        std::fill(pResult, pResult + pOffsets[0], pValues[0]);
+        for (quint32 i = 0; i + 1 < numKeys; ++i)
+        {
+            quint32 iEnd = pOffsets[i + 1];
+            double startKey = pKeys[i];
+            double startValue = pValues[i];
+            double slope = (pValues[i + 1] - startValue) / (pKeys[i + 1] - startKey);
+            for (quint32 j = pOffsets[i]; j != iEnd; ++j)
+                pResult[j] = startValue + slope * (mpParameters[j] - startKey);
+        }
+        std::fill(pResult + pOffsets[numKeys - 1], pResult + mNumParameters, pValues[numKeys - 1]);
+        if (!mOrder.empty())
+        {
+            double* pOriginal = mFields[source.fieldIndices[k]].pValues;
+            for (quint32 j = 0; j != mNumParameters; ++j)
+                pOriginal[mOrder[j]] = sorted[j];
+        }
+    }
+}
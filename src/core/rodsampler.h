@@ -0,0 +1,83 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodSampler class
+ */
+
+#ifndef RODSAMPLER_H
+#define RODSAMPLER_H
+
+#include <vector>
+#include <unordered_map>
+#include "abstractdataobject.h"
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Sampler which interpolates many fields of data objects at the same stations in a single pass
+ *
+ * Each field is an element of arrays of a data object which is written into a buffer provided by a caller.
+ * Items of each data object are traversed once regardless of how many of their elements are requested, and the
+ * flattened values are kept until the version of the object changes. Objects with the same keys share the search
+ * of segments which the stations fall into. Stations of each segment are contiguous, so values are
+ * interpolated by tight loops over them. Data objects are processed in parallel when there is enough work.
+ * Values are interpolated linearly and clamped at the ends as RodAssembly::sampleElement() does.
+ */
+class RodSampler
+{
+public:
+    void addField(AbstractDataObject const* pDataObject, IndexType iElement, double* pValues, double defaultValue = 0.0);
+    void clear();
+    void sample(std::vector<double> const& parameters);
+    quint32 numFields() const { return mFields.size(); }
+    //! Number of distinct grids of keys found during the last sampling
+    quint32 numGrids() const { return mNumGrids; }
+    void setParallel(bool isParallel) { mIsParallel = isParallel; }
+
+private:
+    //! Destination of an element of a data object
+    struct Field
+    {
+        AbstractDataObject const* pDataObject;
+        IndexType iElement;
+        double* pValues;
+        double defaultValue;
+    };
+    //! Keys together with the ranges of stations which fall between them
+    struct Grid
+    {
+        std::vector<DataKeyType> keys;
+        std::vector<quint32> offsets;
+    };
+    //! Requested elements of a data object stored contiguously by fields
+    struct Source
+    {
+        quint64 version = 0;
+        std::vector<IndexType> elements;
+        std::vector<DataKeyType> keys;
+        std::vector<double> values;
+        std::vector<quint32> fieldIndices;
+        quint32 iGrid = 0;
+    };
+    void flattenSource(AbstractDataObject const* pDataObject, Source& source);
+    void sampleSource(Source const& source) const;
+
+private:
+    std::vector<Field> mFields;
+    // Parameters in the increasing order and their original positions if they were not sorted
+    double const* mpParameters = nullptr;
+    quint32 mNumParameters = 0;
+    std::vector<double> mSortedParameters;
+    std::vector<quint32> mOrder;
+    //! Flattened objects which are kept until their versions change
+    std::unordered_map<AbstractDataObject const*, Source> mSources;
+    std::vector<Grid> mGrids;
+    quint32 mNumGrids = 0;
+    bool mIsParallel = true;
+};
+
+}
+
+#endif // RODSAMPLER_H
@@ -0,0 +1,103 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Implementation of the RodStaticSolver class
+ */
+
+#include "rodstaticsolver.h"
+
+using namespace QRS::Core;
+
+//! Maximum number of times a load step is bisected when the iterations diverge
+int const skMaxNumCutbacks = 10;
+
+/*!
+ * \brief Find the equilibrium of the rod under the full loads
+ *
+ * The loads are increased by the given number of steps. If the iterations do not converge at a step, it is restarted
+ * from the previous equilibrium with half the increment of the loads. The deformed state is available through state()
+ * even if the solution has not converged.
+ * \return Whether the equilibrium has been found at all the load steps. Otherwise, the reason is given by errorMessage()
+ */
+bool RodStaticSolver::solve(RodBuffers const& buffers, RodStaticOptions const& options)
+{
+    mNumIterations = 0;
+    mResidualNorm = 0.0;
+    mIsConverged = false;
+    mErrorMessage.clear();
+    if (!mModel.initialize(buffers, options.time))
+    {
+        mErrorMessage = mModel.errorMessage();
+        return false;
+    }
+    // Load steps which fail to converge are bisected, and the step grows back after each success
+    double maxStep = 1.0 / std::max(options.numLoadSteps, 1u);
+    double minStep = maxStep / (1u << skMaxNumCutbacks);
+    double step = maxStep;
+    double loadFactor = 0.0;
+    while (loadFactor < 1.0)
+    {
+        double nextLoadFactor = std::min(loadFactor + step, 1.0);
+        mDisplacements = mModel.displacements();
+        mRotations = mModel.rotations();
+        if (solveStep(nextLoadFactor, options))
+        {
+            loadFactor = nextLoadFactor;
+            step = std::min(2.0 * step, maxStep);
+            continue;
+        }
+        mModel.setConfiguration(mDisplacements, mRotations);
+        step *= 0.5;
+        if (step < minStep)
+        {
+            mModel.exportState(mState);
+            return false;
+        }
+    }
+    mErrorMessage.clear();
+    mIsConverged = true;
+    mModel.exportState(mState);
+    return mIsConverged;
+}
+
+//! Iterate the configuration until the residual at the given load factor is small enough
+bool RodStaticSolver::solveStep(double loadFactor, RodStaticOptions const& options)
+{
+    double loadNorm = loadFactor * mModel.loadNorm();
+    double tolerance = options.tolerance * (loadNorm > 0.0 ? loadNorm : 1.0);
+    for (quint32 iIteration = 0; iIteration != options.maxNumIterations; ++iIteration)
+    {
+        mResidualNorm = mModel.computeTangent(loadFactor, mTangent, mResidual);
+        if (mResidualNorm <= tolerance)
+            return true;
+        if (!std::isfinite(mResidualNorm))
+            break;
+        if (!mTangent.factorize())
+        {
+            mErrorMessage = QString("Tangent matrix of the rod is singular");
+            return false;
+        }
+        mIncrements = mResidual;
+        for (Vector6& values : mIncrements)
+            values *= -1.0;
+        mTangent.solve(mIncrements);
+        mModel.expand(mIncrements);
+        mModel.update(mIncrements);
+        ++mNumIterations;
+        // Once the increments are negligible, the residual is dominated by rounding errors of the internal loads
+        double incrementNorm = mModel.computeIncrementNorm(mIncrements);
+        if (incrementNorm <= options.tolerance)
+        {
+            mResidualNorm = mModel.computeResidual(loadFactor, mResidual);
+            return true;
+        }
+        if (incrementNorm > RodModel::skMaxIncrementNorm)
+            break;
+    }
+    mResidualNorm = mModel.computeResidual(loadFactor, mResidual);
+    if (mResidualNorm <= tolerance)
+        return true;
+    mErrorMessage = QString("Equilibrium of the rod has not been found at the load factor %1").arg(loadFactor);
+    return false;
+}
@@ -0,0 +1,68 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodStaticSolver class
+ */
+
+#ifndef RODSTATICSOLVER_H
+#define RODSTATICSOLVER_H
+
+#include "rodmodel.h"
+
+namespace QRS::Core
+{
+
+//! Settings of the static analysis
+struct RodStaticOptions
+{
+    //! Number of equal increments which the loads are applied by, unless they have to be reduced
+    quint32 numLoadSteps = 1;
+    //! Maximum number of Newton iterations at each load step
+    quint32 maxNumIterations = 30;
+    //! Tolerance of the residual relative to the norm of the applied loads and of the increments of the stations
+    double tolerance = 1e-8;
+    //! Time which the coefficients of the loads are evaluated at
+    double time = 0.0;
+};
+
+/*!
+ * \brief Solver of the nonlinear static equilibrium of a rod
+ *
+ * The loads are applied incrementally, and the equilibrium at each load step is found by the Newton method. The
+ * iterations stop when either the residual or the increments of the stations are small enough. The tangent matrix is
+ * block-tridiagonal, so each iteration takes time and memory proportional to the number of stations.
+ */
+class RodStaticSolver
+{
+public:
+    bool solve(RodBuffers const& buffers, RodStaticOptions const& options = RodStaticOptions());
+    RodModel const& model() const { return mModel; }
+    RodState const& state() const { return mState; }
+    //! Total number of iterations over all the load steps
+    quint32 numIterations() const { return mNumIterations; }
+    double residualNorm() const { return mResidualNorm; }
+    bool isConverged() const { return mIsConverged; }
+    QString const& errorMessage() const { return mErrorMessage; }
+
+private:
+    bool solveStep(double loadFactor, RodStaticOptions const& options);
+
+private:
+    RodModel mModel;
+    RodState mState;
+    BlockTridiagonalMatrix mTangent;
+    std::vector<Vector6> mResidual;
+    std::vector<Vector6> mIncrements;
+    // Configuration at the last equilibrium
+    std::vector<Vector3> mDisplacements;
+    std::vector<Matrix33> mRotations;
+    quint32 mNumIterations = 0;
+    double mResidualNorm = 0.0;
+    bool mIsConverged = false;
+    QString mErrorMessage;
+};
+
+}
+
+#endif // RODSTATICSOLVER_H
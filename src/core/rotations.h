@@ -0,0 +1,344 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration and implementation of kernels which operate on rotations
+ */
+
+#ifndef ROTATIONS_H
+#define ROTATIONS_H
+
+#include "smallmatrix.h"
+
+namespace QRS::Core::Rotations
+{
+
+//! Unit quaternion stored as the scalar part followed by the vector one
+using Quaternion = SmallMatrix<4, 1>;
+template<int W = skBatchWidth>
+using BatchQuaternion = BatchMatrix<4, 1, W>;
+
+//! Angle below which the coefficients of the exponential map are evaluated by their Taylor series
+double const skSeriesAngle = 1e-2;
+
+/*!
+ * \brief Compute the coefficients sin(θ) / θ and (1 - cos(θ)) / θ^2 of the exponential map
+ *
+ * Both are expanded near the zero angle, where the direct formulas lose accuracy due to the cancellation.
+ */
+inline void computeExpCoefficients(double squaredAngle, double& first, double& second)
+{
+    if (squaredAngle < skSeriesAngle * skSeriesAngle)
+    {
+        first = 1.0 - squaredAngle / 6.0 * (1.0 - squaredAngle / 20.0);
+        second = 0.5 - squaredAngle / 24.0 * (1.0 - squaredAngle / 30.0);
+        return;
+    }
+    double angle = std::sqrt(squaredAngle);
+    first = std::sin(angle) / angle;
+    second = (1.0 - std::cos(angle)) / squaredAngle;
+}
+
+//! Compute the coefficient θ / sin(θ / 2) which maps the vector part of a quaternion onto the rotation vector
+inline double computeLogCoefficient(double scalar, double vectorNorm)
+{
+    return vectorNorm > 0.0 ? 2.0 * std::atan2(vectorNorm, scalar) / vectorNorm : 2.0 / scalar;
+}
+
+//! Create the skew-symmetric matrix which multiplies vectors as the cross product by the given one
+inline Matrix33 skew(Vector3 const& vector)
+{
+    return {0.0, -vector[2], vector[1],
+            vector[2], 0.0, -vector[0],
+            -vector[1], vector[0], 0.0};
+}
+
+//! Extract the vector of the skew-symmetric part of a matrix
+inline Vector3 unskew(Matrix33 const& matrix)
+{
+    return {0.5 * (matrix(2, 1) - matrix(1, 2)),
+            0.5 * (matrix(0, 2) - matrix(2, 0)),
+            0.5 * (matrix(1, 0) - matrix(0, 1))};
+}
+
+//! Compute the rotation matrix of the rotation vector by the Rodrigues formula
+inline Matrix33 expMap(Vector3 const& vector)
+{
+    double first, second;
+    computeExpCoefficients(dot(vector, vector), first, second);
+    Matrix33 result = Matrix33::identity();
+    Matrix33 matrix = skew(vector);
+    Matrix33 squaredMatrix = matrix * matrix;
+    for (int i = 0; i != 9; ++i)
+        result[i] += first * matrix[i] + second * squaredMatrix[i];
+    return result;
+}
+
+/*!
+ * \brief Convert a rotation matrix to the unit quaternion with the nonnegative scalar part
+ *
+ * The largest of the components is computed from the diagonal, the rest of them are found through it, so that the result
+ * is accurate for all the angles.
+ */
+inline Quaternion toQuaternion(Matrix33 const& matrix)
+{
+    double trace = matrix(0, 0) + matrix(1, 1) + matrix(2, 2);
+    Quaternion result;
+    if (trace >= matrix(0, 0) && trace >= matrix(1, 1) && trace >= matrix(2, 2))
+    {
+        double scalar = 0.5 * std::sqrt(std::max(1.0 + trace, 0.0));
+        double factor = 0.25 / scalar;
+        result = {scalar, factor * (matrix(2, 1) - matrix(1, 2)), factor * (matrix(0, 2) - matrix(2, 0)),
+                  factor * (matrix(1, 0) - matrix(0, 1))};
+    }
+    else
+    {
+        // Axis of the largest diagonal element
+        int i = matrix(1, 1) > matrix(0, 0) ? 1 : 0;
+        if (matrix(2, 2) > matrix(i, i))
+            i = 2;
+        int j = (i + 1) % 3;
+        int k = (i + 2) % 3;
+        double component = 0.5 * std::sqrt(std::max(1.0 + matrix(i, i) - matrix(j, j) - matrix(k, k), 0.0));
+        double factor = 0.25 / component;
+        result[0] = factor * (matrix(k, j) - matrix(j, k));
+        result[1 + i] = component;
+        result[1 + j] = factor * (matrix(j, i) + matrix(i, j));
+        result[1 + k] = factor * (matrix(k, i) + matrix(i, k));
+        if (result[0] < 0.0)
+            result *= -1.0;
+    }
+    return result;
+}
+
+//! Convert a unit quaternion to the rotation matrix
+inline Matrix33 fromQuaternion(Quaternion const& quaternion)
+{
+    double w = quaternion[0], x = quaternion[1], y = quaternion[2], z = quaternion[3];
+    return {1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y - w * z), 2.0 * (x * z + w * y),
+            2.0 * (x * y + w * z), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z - w * x),
+            2.0 * (x * z - w * y), 2.0 * (y * z + w * x), 1.0 - 2.0 * (x * x + y * y)};
+}
+
+//! Compute the rotation vector of a rotation matrix, whose angle does not exceed π
+inline Vector3 logMap(Matrix33 const& matrix)
+{
+    Quaternion quaternion = toQuaternion(matrix);
+    Vector3 result = {quaternion[1], quaternion[2], quaternion[3]};
+    return computeLogCoefficient(quaternion[0], norm(result)) * result;
+}
+
+//! Compute the rotation matrix of the Cayley transform (I - S / 2)^-1 (I + S / 2) of the skew matrix S of a vector
+inline Matrix33 cayley(Vector3 const& vector)
+{
+    double factor = 4.0 / (4.0 + dot(vector, vector));
+    Matrix33 result = Matrix33::identity();
+    Matrix33 matrix = skew(vector);
+    Matrix33 squaredMatrix = matrix * matrix;
+    for (int i = 0; i != 9; ++i)
+        result[i] += factor * (matrix[i] + 0.5 * squaredMatrix[i]);
+    return result;
+}
+
+//! Compute the vector whose Cayley transform is the rotation matrix, whose angle is less than π
+inline Vector3 inverseCayley(Matrix33 const& matrix)
+{
+    double trace = matrix(0, 0) + matrix(1, 1) + matrix(2, 2);
+    return (4.0 / (1.0 + trace)) * unskew(matrix);
+}
+
+/*!
+ * \brief Compute the left Jacobian of the exponential map
+ *
+ * It relates the increment of a rotation vector to the spatial spin of the rotation: exp(φ + δφ) = exp(J δφ) exp(φ).
+ */
+inline Matrix33 leftJacobian(Vector3 const& vector)
+{
+    double squaredAngle = dot(vector, vector);
+    double first, second, third;
+    computeExpCoefficients(squaredAngle, first, second);
+    // Coefficient (θ - sin(θ)) / θ^3
+    if (squaredAngle < skSeriesAngle * skSeriesAngle)
+        third = 1.0 / 6.0 - squaredAngle / 120.0 * (1.0 - squaredAngle / 42.0);
+    else
+        third = (1.0 - first) / squaredAngle;
+    Matrix33 result = Matrix33::identity();
+    Matrix33 matrix = skew(vector);
+    Matrix33 squaredMatrix = matrix * matrix;
+    for (int i = 0; i != 9; ++i)
+        result[i] += second * matrix[i] + third * squaredMatrix[i];
+    return result;
+}
+
+//! Compute the coefficient 1 / θ^2 - (1 + cos(θ)) / (2 θ sin(θ)) of the inverse of the left Jacobian
+inline double computeInverseJacobianCoefficient(double squaredAngle)
+{
+    if (squaredAngle < skSeriesAngle * skSeriesAngle)
+        return 1.0 / 12.0 + squaredAngle / 720.0 * (1.0 + squaredAngle / 42.0);
+    double angle = std::sqrt(squaredAngle);
+    return 1.0 / squaredAngle - (1.0 + std::cos(angle)) / (2.0 * angle * std::sin(angle));
+}
+
+//! Compute the inverse of the left Jacobian of the exponential map, which is defined for angles less than 2π
+inline Matrix33 inverseLeftJacobian(Vector3 const& vector)
+{
+    double coefficient = computeInverseJacobianCoefficient(dot(vector, vector));
+    Matrix33 result = Matrix33::identity();
+    Matrix33 matrix = skew(vector);
+    Matrix33 squaredMatrix = matrix * matrix;
+    for (int i = 0; i != 9; ++i)
+        result[i] += -0.5 * matrix[i] + coefficient * squaredMatrix[i];
+    return result;
+}
+
+//! Create skew-symmetric matrices of each lane
+template<int W>
+void skew(BatchVector3<W> const& vectors, BatchMatrix33<W>& result)
+{
+    for (int l = 0; l != W; ++l)
+    {
+        result(0, 0)[l] = 0.0;
+        result(0, 1)[l] = -vectors[2][l];
+        result(0, 2)[l] = vectors[1][l];
+        result(1, 0)[l] = vectors[2][l];
+        result(1, 1)[l] = 0.0;
+        result(1, 2)[l] = -vectors[0][l];
+        result(2, 0)[l] = -vectors[1][l];
+        result(2, 1)[l] = vectors[0][l];
+        result(2, 2)[l] = 0.0;
+    }
+}
+
+/*!
+ * \brief Compute rotation matrices of the rotation vectors of each lane
+ *
+ * The coefficients are evaluated per lane, the rest of the Rodrigues formula is expanded into the lane loops.
+ */
+template<int W>
+void expMap(BatchVector3<W> const& vectors, BatchMatrix33<W>& result)
+{
+    alignas(64) double first[W], second[W];
+    for (int l = 0; l != W; ++l)
+    {
+        double x = vectors[0][l], y = vectors[1][l], z = vectors[2][l];
+        computeExpCoefficients(x * x + y * y + z * z, first[l], second[l]);
+    }
+    for (int l = 0; l != W; ++l)
+    {
+        double x = vectors[0][l], y = vectors[1][l], z = vectors[2][l];
+        double a = first[l], b = second[l];
+        result(0, 0)[l] = 1.0 - b * (y * y + z * z);
+        result(0, 1)[l] = -a * z + b * x * y;
+        result(0, 2)[l] = a * y + b * x * z;
+        result(1, 0)[l] = a * z + b * x * y;
+        result(1, 1)[l] = 1.0 - b * (x * x + z * z);
+        result(1, 2)[l] = -a * x + b * y * z;
+        result(2, 0)[l] = -a * y + b * x * z;
+        result(2, 1)[l] = a * x + b * y * z;
+        result(2, 2)[l] = 1.0 - b * (x * x + y * y);
+    }
+}
+
+/*!
+ * \brief Convert rotation matrices of each lane to unit quaternions
+ *
+ * All the lanes are converted through the trace first, which is accurate while the angle does not exceed 2π / 3.
+ * This is the case for rotations between neighbouring stations, so the lanes of larger angles are rare, and they are
+ * converted again one by one.
+ */
+template<int W>
+void toQuaternion(BatchMatrix33<W> const& matrices, BatchQuaternion<W>& result)
+{
+    bool isAccurate = true;
+    for (int l = 0; l != W; ++l)
+    {
+        double trace = matrices(0, 0)[l] + matrices(1, 1)[l] + matrices(2, 2)[l];
+        double scalar = 0.5 * std::sqrt(std::max(1.0 + trace, 1.0));
+        double factor = 0.25 / scalar;
+        result[0][l] = scalar;
+        result[1][l] = factor * (matrices(2, 1)[l] - matrices(1, 2)[l]);
+        result[2][l] = factor * (matrices(0, 2)[l] - matrices(2, 0)[l]);
+        result[3][l] = factor * (matrices(1, 0)[l] - matrices(0, 1)[l]);
+        isAccurate &= trace > 0.0;
+    }
+    if (isAccurate)
+        return;
+    for (int l = 0; l != W; ++l)
+    {
+        if (matrices(0, 0)[l] + matrices(1, 1)[l] + matrices(2, 2)[l] <= 0.0)
+            result.set(l, toQuaternion(matrices.get(l)));
+    }
+}
+
+//! Convert unit quaternions of each lane to rotation matrices
+template<int W>
+void fromQuaternion(BatchQuaternion<W> const& quaternions, BatchMatrix33<W>& result)
+{
+    for (int l = 0; l != W; ++l)
+    {
+        double w = quaternions[0][l], x = quaternions[1][l], y = quaternions[2][l], z = quaternions[3][l];
+        result(0, 0)[l] = 1.0 - 2.0 * (y * y + z * z);
+        result(0, 1)[l] = 2.0 * (x * y - w * z);
+        result(0, 2)[l] = 2.0 * (x * z + w * y);
+        result(1, 0)[l] = 2.0 * (x * y + w * z);
+        result(1, 1)[l] = 1.0 - 2.0 * (x * x + z * z);
+        result(1, 2)[l] = 2.0 * (y * z - w * x);
+        result(2, 0)[l] = 2.0 * (x * z - w * y);
+        result(2, 1)[l] = 2.0 * (y * z + w * x);
+        result(2, 2)[l] = 1.0 - 2.0 * (x * x + y * y);
+    }
+}
+
+//! Compute rotation vectors of the rotation matrices of each lane
+template<int W>
+void logMap(BatchMatrix33<W> const& matrices, BatchVector3<W>& result)
+{
+    BatchQuaternion<W> quaternions;
+    toQuaternion(matrices, quaternions);
+    for (int l = 0; l != W; ++l)
+    {
+        double x = quaternions[1][l], y = quaternions[2][l], z = quaternions[3][l];
+        double factor = computeLogCoefficient(quaternions[0][l], std::sqrt(x * x + y * y + z * z));
+        result[0][l] = factor * x;
+        result[1][l] = factor * y;
+        result[2][l] = factor * z;
+    }
+}
+
+//! Compute Cayley transforms of the vectors of each lane
+template<int W>
+void cayley(BatchVector3<W> const& vectors, BatchMatrix33<W>& result)
+{
+    for (int l = 0; l != W; ++l)
+    {
+        double x = vectors[0][l], y = vectors[1][l], z = vectors[2][l];
+        double a = 4.0 / (4.0 + x * x + y * y + z * z);
+        double b = 0.5 * a;
+        result(0, 0)[l] = 1.0 - b * (y * y + z * z);
+        result(0, 1)[l] = -a * z + b * x * y;
+        result(0, 2)[l] = a * y + b * x * z;
+        result(1, 0)[l] = a * z + b * x * y;
+        result(1, 1)[l] = 1.0 - b * (x * x + z * z);
+        result(1, 2)[l] = -a * x + b * y * z;
+        result(2, 0)[l] = -a * y + b * x * z;
+        result(2, 1)[l] = a * x + b * y * z;
+        result(2, 2)[l] = 1.0 - b * (x * x + y * y);
+    }
+}
+
+//! Compute vectors whose Cayley transforms are the rotation matrices of each lane
+template<int W>
+void inverseCayley(BatchMatrix33<W> const& matrices, BatchVector3<W>& result)
+{
+    for (int l = 0; l != W; ++l)
+    {
+        double factor = 2.0 / (1.0 + matrices(0, 0)[l] + matrices(1, 1)[l] + matrices(2, 2)[l]);
+        result[0][l] = factor * (matrices(2, 1)[l] - matrices(1, 2)[l]);
+        result[1][l] = factor * (matrices(0, 2)[l] - matrices(2, 0)[l]);
+        result[2][l] = factor * (matrices(1, 0)[l] - matrices(0, 1)[l]);
+    }
+}
+
+}
+
+#endif // ROTATIONS_H
@@ -9,7 +9,7 @@
 
 using namespace QRS::Core;
 
-quint32 ScalarDataObject::smNumInstances = 0;
+std::atomic<quint32> ScalarDataObject::smNumInstances = 0;
 
 //! Construct a scalar data object
 ScalarDataObject::ScalarDataObject(QString const& name)
@@ -29,15 +29,17 @@ DataItemType& ScalarDataObject::addItem(DataValueType key)
 {
     DataValueType rightKey = getAvailableItemKey(key);
     mItems.emplace(rightKey, DataItemType(1, 1));
+    markModified();
     return mItems.at(rightKey);
 }
 
 //! Clone a scalar data object
 AbstractDataObject* ScalarDataObject::clone() const
 {
-    ScalarDataObject* obj = new ScalarDataObject(mName);
+    ScalarDataObject* obj = new ScalarDataObject(name());
     obj->mItems = mItems;
     obj->mID = mID;
+    obj->mVersion = mVersion;
     --smNumInstances;
     return obj;
 }
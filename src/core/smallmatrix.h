@@ -0,0 +1,384 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration and implementation of matrices of fixed dimensions and their batches
+ */
+
+#ifndef SMALLMATRIX_H
+#define SMALLMATRIX_H
+
+#include <QtGlobal>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cmath>
+
+namespace QRS::Core
+{
+
+//! Number of stations which batched kernels process at once
+int const skBatchWidth = 4;
+
+//! Matrix of fixed dimensions whose elements are stored in the row-major order
+template<int M, int N>
+struct SmallMatrix
+{
+    static SmallMatrix zeros() { return SmallMatrix{}; }
+    static SmallMatrix identity();
+    static constexpr int rows() { return M; }
+    static constexpr int cols() { return N; }
+    double& operator()(int iRow, int iCol) { return data[N * iRow + iCol]; }
+    double operator()(int iRow, int iCol) const { return data[N * iRow + iCol]; }
+    //! Access an element by its index in the row-major order, which is convenient for vectors
+    double& operator[](int i) { return data[i]; }
+    double operator[](int i) const { return data[i]; }
+    SmallMatrix<N, M> transpose() const;
+    SmallMatrix& operator+=(SmallMatrix const& another);
+    SmallMatrix& operator-=(SmallMatrix const& another);
+    SmallMatrix& operator*=(double factor);
+    std::array<double, M * N> data = {};
+};
+
+using Vector3 = SmallMatrix<3, 1>;
+using Vector6 = SmallMatrix<6, 1>;
+using Matrix33 = SmallMatrix<3, 3>;
+using Matrix66 = SmallMatrix<6, 6>;
+
+//! Create the identity matrix
+template<int M, int N>
+SmallMatrix<M, N> SmallMatrix<M, N>::identity()
+{
+    SmallMatrix result;
+    for (int i = 0; i != std::min(M, N); ++i)
+        result(i, i) = 1.0;
+    return result;
+}
+
+//! Swap rows and columns
+template<int M, int N>
+SmallMatrix<N, M> SmallMatrix<M, N>::transpose() const
+{
+    SmallMatrix<N, M> result;
+    for (int i = 0; i != M; ++i)
+    {
+        for (int j = 0; j != N; ++j)
+            result(j, i) = (*this)(i, j);
+    }
+    return result;
+}
+
+//! Add another matrix elementwise
+template<int M, int N>
+SmallMatrix<M, N>& SmallMatrix<M, N>::operator+=(SmallMatrix const& another)
+{
+    for (int i = 0; i != M * N; ++i)
+        data[i] += another.data[i];
+    return *this;
+}
+
+//! Subtract another matrix elementwise
+template<int M, int N>
+SmallMatrix<M, N>& SmallMatrix<M, N>::operator-=(SmallMatrix const& another)
+{
+    for (int i = 0; i != M * N; ++i)
+        data[i] -= another.data[i];
+    return *this;
+}
+
+//! Scale all the elements
+template<int M, int N>
+SmallMatrix<M, N>& SmallMatrix<M, N>::operator*=(double factor)
+{
+    for (double& value : data)
+        value *= factor;
+    return *this;
+}
+
+//! Sum two matrices
+template<int M, int N>
+SmallMatrix<M, N> operator+(SmallMatrix<M, N> first, SmallMatrix<M, N> const& second)
+{
+    return first += second;
+}
+
+//! Subtract the second matrix from the first one
+template<int M, int N>
+SmallMatrix<M, N> operator-(SmallMatrix<M, N> first, SmallMatrix<M, N> const& second)
+{
+    return first -= second;
+}
+
+//! Scale a matrix
+template<int M, int N>
+SmallMatrix<M, N> operator*(double factor, SmallMatrix<M, N> matrix)
+{
+    return matrix *= factor;
+}
+
+//! Multiply two matrices
+template<int M, int K, int N>
+SmallMatrix<M, N> operator*(SmallMatrix<M, K> const& first, SmallMatrix<K, N> const& second)
+{
+    SmallMatrix<M, N> result;
+    for (int i = 0; i != M; ++i)
+    {
+        for (int k = 0; k != K; ++k)
+        {
+            double value = first(i, k);
+            for (int j = 0; j != N; ++j)
+                result(i, j) += value * second(k, j);
+        }
+    }
+    return result;
+}
+
+//! Multiply the transposed first matrix by the second one without forming the transpose
+template<int K, int M, int N>
+SmallMatrix<M, N> transposeProduct(SmallMatrix<K, M> const& first, SmallMatrix<K, N> const& second)
+{
+    SmallMatrix<M, N> result;
+    for (int k = 0; k != K; ++k)
+    {
+        for (int i = 0; i != M; ++i)
+        {
+            double value = first(k, i);
+            for (int j = 0; j != N; ++j)
+                result(i, j) += value * second(k, j);
+        }
+    }
+    return result;
+}
+
+//! Compute the dot product of two vectors
+template<int M>
+double dot(SmallMatrix<M, 1> const& first, SmallMatrix<M, 1> const& second)
+{
+    double result = 0.0;
+    for (int i = 0; i != M; ++i)
+        result += first[i] * second[i];
+    return result;
+}
+
+//! Compute the Euclidean norm of a vector
+template<int M>
+double norm(SmallMatrix<M, 1> const& vector)
+{
+    return std::sqrt(dot(vector, vector));
+}
+
+//! Compute the cross product of two vectors
+inline Vector3 cross(Vector3 const& first, Vector3 const& second)
+{
+    return {first[1] * second[2] - first[2] * second[1],
+            first[2] * second[0] - first[0] * second[2],
+            first[0] * second[1] - first[1] * second[0]};
+}
+
+/*!
+ * \brief Factorize a square matrix in place by the LU decomposition with partial pivoting
+ * \return Whether the matrix is nonsingular
+ */
+template<int M>
+bool factorizeLU(SmallMatrix<M, M>& matrix, std::array<int, std::size_t(M)>& pivots)
+{
+    for (int k = 0; k != M; ++k)
+    {
+        int iPivot = k;
+        for (int i = k + 1; i != M; ++i)
+        {
+            if (std::abs(matrix(i, k)) > std::abs(matrix(iPivot, k)))
+                iPivot = i;
+        }
+        pivots[k] = iPivot;
+        if (matrix(iPivot, k) == 0.0)
+            return false;
+        if (iPivot != k)
+        {
+            for (int j = 0; j != M; ++j)
+                std::swap(matrix(k, j), matrix(iPivot, j));
+        }
+        double inversePivot = 1.0 / matrix(k, k);
+        for (int i = k + 1; i != M; ++i)
+        {
+            double factor = matrix(i, k) * inversePivot;
+            matrix(i, k) = factor;
+            for (int j = k + 1; j != M; ++j)
+                matrix(i, j) -= factor * matrix(k, j);
+        }
+    }
+    return true;
+}
+
+//! Solve a system whose matrix has been factorized by factorizeLU() for several right-hand sides in place
+template<int M, int N>
+void solveLU(SmallMatrix<M, M> const& factors, std::array<int, std::size_t(M)> const& pivots, SmallMatrix<M, N>& values)
+{
+    for (int k = 0; k != M; ++k)
+    {
+        if (pivots[k] != k)
+        {
+            for (int j = 0; j != N; ++j)
+                std::swap(values(k, j), values(pivots[k], j));
+        }
+    }
+    for (int i = 1; i < M; ++i)
+    {
+        for (int k = 0; k != i; ++k)
+        {
+            double factor = factors(i, k);
+            for (int j = 0; j != N; ++j)
+                values(i, j) -= factor * values(k, j);
+        }
+    }
+    for (int i = M - 1; i >= 0; --i)
+    {
+        for (int k = i + 1; k < M; ++k)
+        {
+            double factor = factors(i, k);
+            for (int j = 0; j != N; ++j)
+                values(i, j) -= factor * values(k, j);
+        }
+        double inverseDiagonal = 1.0 / factors(i, i);
+        for (int j = 0; j != N; ++j)
+            values(i, j) *= inverseDiagonal;
+    }
+}
+
+/*!
+ * \brief Matrices of several stations interleaved element by element
+ *
+ * Each element is stored contiguously for all the stations of the batch, so that every operation is a loop over lanes
+ * of the fixed length which compilers vectorize. Batches are loaded from and stored to buffers which keep each
+ * element contiguously over all the stations, as RodBuffers does.
+ */
+template<int M, int N, int W = skBatchWidth>
+struct BatchMatrix
+{
+    static constexpr int width() { return W; }
+    double* operator()(int iRow, int iCol) { return data[N * iRow + iCol]; }
+    double const* operator()(int iRow, int iCol) const { return data[N * iRow + iCol]; }
+    double* operator[](int i) { return data[i]; }
+    double const* operator[](int i) const { return data[i]; }
+    SmallMatrix<M, N> get(int iLane) const;
+    void set(int iLane, SmallMatrix<M, N> const& matrix);
+    void load(std::array<std::vector<double>, M * N> const& elements, quint32 iStart);
+    void store(std::array<std::vector<double>, M * N>& elements, quint32 iStart) const;
+    alignas(64) double data[M * N][W] = {};
+};
+
+template<int W = skBatchWidth>
+using BatchVector3 = BatchMatrix<3, 1, W>;
+template<int W = skBatchWidth>
+using BatchMatrix33 = BatchMatrix<3, 3, W>;
+template<int W = skBatchWidth>
+using BatchMatrix66 = BatchMatrix<6, 6, W>;
+
+//! Extract the matrix of a lane
+template<int M, int N, int W>
+SmallMatrix<M, N> BatchMatrix<M, N, W>::get(int iLane) const
+{
+    SmallMatrix<M, N> result;
+    for (int i = 0; i != M * N; ++i)
+        result.data[i] = data[i][iLane];
+    return result;
+}
+
+//! Substitute the matrix of a lane
+template<int M, int N, int W>
+void BatchMatrix<M, N, W>::set(int iLane, SmallMatrix<M, N> const& matrix)
+{
+    for (int i = 0; i != M * N; ++i)
+        data[i][iLane] = matrix.data[i];
+}
+
+//! Gather matrices starting from the given station. Lanes beyond the end of buffers repeat the last station
+template<int M, int N, int W>
+void BatchMatrix<M, N, W>::load(std::array<std::vector<double>, M * N> const& elements, quint32 iStart)
+{
+    quint32 numStations = elements[0].size();
+    for (int i = 0; i != M * N; ++i)
+    {
+        double const* pValues = elements[i].data();
+        for (int k = 0; k != W; ++k)
+            data[i][k] = pValues[std::min(iStart + k, numStations - 1)];
+    }
+}
+
+//! Scatter matrices starting from the given station. Lanes beyond the end of buffers are skipped
+template<int M, int N, int W>
+void BatchMatrix<M, N, W>::store(std::array<std::vector<double>, M * N>& elements, quint32 iStart) const
+{
+    quint32 numStations = elements[0].size();
+    int numLanes = std::min((quint32)W, numStations - iStart);
+    for (int i = 0; i != M * N; ++i)
+    {
+        double* pValues = elements[i].data() + iStart;
+        for (int k = 0; k != numLanes; ++k)
+            pValues[k] = data[i][k];
+    }
+}
+
+//! Multiply matrices of each lane
+template<int M, int K, int N, int W>
+void multiply(BatchMatrix<M, K, W> const& first, BatchMatrix<K, N, W> const& second, BatchMatrix<M, N, W>& result)
+{
+    for (int i = 0; i != M; ++i)
+    {
+        for (int j = 0; j != N; ++j)
+        {
+            double* pResult = result(i, j);
+            for (int l = 0; l != W; ++l)
+                pResult[l] = 0.0;
+            for (int k = 0; k != K; ++k)
+            {
+                double const* pFirst = first(i, k);
+                double const* pSecond = second(k, j);
+                for (int l = 0; l != W; ++l)
+                    pResult[l] += pFirst[l] * pSecond[l];
+            }
+        }
+    }
+}
+
+//! Multiply the transposed first matrices by the second ones in each lane
+template<int K, int M, int N, int W>
+void transposeProduct(BatchMatrix<K, M, W> const& first, BatchMatrix<K, N, W> const& second, BatchMatrix<M, N, W>& result)
+{
+    for (int i = 0; i != M; ++i)
+    {
+        for (int j = 0; j != N; ++j)
+        {
+            double* pResult = result(i, j);
+            for (int l = 0; l != W; ++l)
+                pResult[l] = 0.0;
+            for (int k = 0; k != K; ++k)
+            {
+                double const* pFirst = first(k, i);
+                double const* pSecond = second(k, j);
+                for (int l = 0; l != W; ++l)
+                    pResult[l] += pFirst[l] * pSecond[l];
+            }
+        }
+    }
+}
+
+//! Transpose matrices of each lane
+template<int M, int N, int W>
+void transpose(BatchMatrix<M, N, W> const& matrix, BatchMatrix<N, M, W>& result)
+{
+    for (int i = 0; i != M; ++i)
+    {
+        for (int j = 0; j != N; ++j)
+        {
+            double const* pMatrix = matrix(i, j);
+            double* pResult = result(j, i);
+            for (int l = 0; l != W; ++l)
+                pResult[l] = pMatrix[l];
+        }
+    }
+}
+
+}
+
+#endif // SMALLMATRIX_H
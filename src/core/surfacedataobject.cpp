@@ -9,7 +9,7 @@
 
 using namespace QRS::Core;
 
-quint32 SurfaceDataObject::smNumInstances = 0;
+std::atomic<quint32> SurfaceDataObject::smNumInstances = 0;
 
 //! Construct a surface data object
 SurfaceDataObject::SurfaceDataObject(QString const& name)
@@ -31,28 +31,44 @@ DataItemType& SurfaceDataObject::addItem(DataValueType key)
 {
     DataValueType rightKey = getAvailableItemKey(key);
     mItems.emplace(rightKey, DataItemType(1, mLeadingItems.size()));
+    markModified();
     return mItems.at(rightKey);
 }
 
 //! Clone a surface data object
 AbstractDataObject* SurfaceDataObject::clone() const
 {
-    SurfaceDataObject* obj = new SurfaceDataObject(mName);
+    SurfaceDataObject* obj = new SurfaceDataObject(name());
     obj->mLeadingItems = mLeadingItems;
     obj->mItems = mItems;
     obj->mID = mID;
+    obj->mVersion = mVersion;
     --smNumInstances;
     return obj;
 }
 
+//! Copy a name, items and leading items of another surface
+void SurfaceDataObject::assign(AbstractDataObject const& another)
+{
+    if (another.type() != mkType)
+        return;
+    AbstractDataObject::assign(another);
+    mLeadingItems = ((SurfaceDataObject const&)another).mLeadingItems;
+}
+
 //! Add a leading item
 DataKeyType SurfaceDataObject::addLeadingItem(DataValueType key)
 {
     DataValueType rightKey = getAvailableItemKey(key, &mLeadingItems);
     mLeadingItems.emplace(rightKey, Array<double>());
     quint32 numLeadingItems = mLeadingItems.size();
+    int iColumn = std::distance(mLeadingItems.begin(), mLeadingItems.find(rightKey));
     for (auto& item : mItems)
+    {
         item.second.resize(1, numLeadingItems);
+        item.second.moveColumn(numLeadingItems - 1, iColumn);
+    }
+    markModified();
     return rightKey;
 }
 
@@ -65,6 +81,7 @@ void SurfaceDataObject::removeLeadingItem(DataValueType key)
     for (auto& item : mItems)
         item.second.removeColumn(iColumn);
     mLeadingItems.erase(key);
+    markModified();
 }
 
 //! Modify a leading item key
@@ -76,7 +93,8 @@ bool SurfaceDataObject::changeLeadingItemKey(DataKeyType oldKey, DataKeyType new
     {
         int iNewColumn = std::distance(mLeadingItems.begin(), mLeadingItems.find(newKey));
         for (auto& item : mItems)
-            item.second.swapColumns(iOldColumn, iNewColumn);
+            item.second.moveColumn(iOldColumn, iNewColumn);
+        markModified();
     }
     return isOkay;
 }
@@ -16,10 +16,13 @@ namespace QRS::Core
 //! Surface data object
 class SurfaceDataObject : public AbstractDataObject
 {
+    friend class DataObjectDelta;
+
 public:
     SurfaceDataObject(QString const& name);
     ~SurfaceDataObject();
     AbstractDataObject* clone() const override;
+    void assign(AbstractDataObject const& another) override;
     DataItemType& addItem(DataValueType key) override;
     DataKeyType addLeadingItem(DataValueType key);
     void removeLeadingItem(DataValueType key);
@@ -32,7 +35,7 @@ public:
     virtual void import(QTextStream& stream) override;
 
 private:
-    static quint32 smNumInstances;
+    static std::atomic<quint32> smNumInstances;
     DataHolder mLeadingItems;
 };
 
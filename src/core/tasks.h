@@ -0,0 +1,57 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration and implementation of the function to run tasks in the global thread pool
+ */
+
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <QThreadPool>
+#include <QSemaphore>
+#include <algorithm>
+#include <atomic>
+
+namespace QRS::Core
+{
+
+/*!
+ * \brief Run the tasks numbered from zero to numTasks - 1 in the global thread pool
+ *
+ * The calling thread participates as well, so the tasks proceed even if the pool is busy. The tasks are run
+ * in the calling thread if the parallel execution is disabled or there is only one thread to use.
+ */
+template<typename Function>
+void runTasks(int numTasks, Function const& function, bool isParallel = true)
+{
+    QThreadPool* pPool = QThreadPool::globalInstance();
+    int numThreads = std::min(pPool->maxThreadCount(), numTasks);
+    if (!isParallel || numThreads < 2)
+    {
+        for (int i = 0; i < numTasks; ++i)
+            function(i);
+        return;
+    }
+    std::atomic<int> iNextTask = 0;
+    auto worker = [&function, &iNextTask, numTasks]()
+    {
+        for (int i = iNextTask++; i < numTasks; i = iNextTask++)
+            function(i);
+    };
+    QSemaphore semaphore;
+    for (int i = 1; i != numThreads; ++i)
+    {
+        pPool->start([&worker, &semaphore]()
+        {
+            worker();
+            semaphore.release();
+        });
+    }
+    worker();
+    semaphore.acquire(numThreads - 1);
+}
+
+}
+
+#endif // TASKS_H
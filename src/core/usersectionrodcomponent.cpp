@@ -30,5 +30,5 @@ AbstractRodComponent* UserSectionRodComponent::clone() const
 //! Some of properties may be of zero values to achieve infinite stiffness
 bool UserSectionRodComponent::isDataComplete() const
 {
-    return mpArea;
+    return area();
 }
@@ -23,24 +23,24 @@ public:
     bool isDataComplete() const override;
     // Getters
     // Area
-    ScalarDataObject const* area() const { return mpArea; }
+    ScalarDataObject const* area() const { return (ScalarDataObject const*)resolveDataObject(mArea); }
     // Inertia moments
-    ScalarDataObject const* inertiaMomentTorsional() const { return mpInertiaMomentTorsional; }
-    ScalarDataObject const* inertiaMomentX() const { return mpInertiaMomentX; }
-    ScalarDataObject const* inertiaMomentY() const { return mpInertiaMomentY; }
+    ScalarDataObject const* inertiaMomentTorsional() const { return (ScalarDataObject const*)resolveDataObject(mInertiaMomentTorsional); }
+    ScalarDataObject const* inertiaMomentX() const { return (ScalarDataObject const*)resolveDataObject(mInertiaMomentX); }
+    ScalarDataObject const* inertiaMomentY() const { return (ScalarDataObject const*)resolveDataObject(mInertiaMomentY); }
     // Center coordinates
-    ScalarDataObject const* centerCoordinateX() const { return mpCenterCoordinateX; }
-    ScalarDataObject const* centerCoordinateY() const { return mpCenterCoordinateY; }
+    ScalarDataObject const* centerCoordinateX() const { return (ScalarDataObject const*)resolveDataObject(mCenterCoordinateX); }
+    ScalarDataObject const* centerCoordinateY() const { return (ScalarDataObject const*)resolveDataObject(mCenterCoordinateY); }
     // Setters
     // Area
-    void setArea(ScalarDataObject const* pArea) { mpArea = pArea; }
+    void setArea(ScalarDataObject const* pArea) { setReference(kArea, mArea, pArea); }
     // Inertia moments
-    void setInertiaMomentTorsional(ScalarDataObject const* pInertiaMomentTorsional) { mpInertiaMomentTorsional = pInertiaMomentTorsional; }
-    void setInertiaMomentX(ScalarDataObject const* pInertiaMomentX) { mpInertiaMomentX = pInertiaMomentX; }
-    void setInertiaMomentY(ScalarDataObject const* pInertiaMomentY) { mpInertiaMomentY = pInertiaMomentY; }
+    void setInertiaMomentTorsional(ScalarDataObject const* pInertiaMomentTorsional) { setReference(kInertiaMomentTorsional, mInertiaMomentTorsional, pInertiaMomentTorsional); }
+    void setInertiaMomentX(ScalarDataObject const* pInertiaMomentX) { setReference(kInertiaMomentX, mInertiaMomentX, pInertiaMomentX); }
+    void setInertiaMomentY(ScalarDataObject const* pInertiaMomentY) { setReference(kInertiaMomentY, mInertiaMomentY, pInertiaMomentY); }
     // Center coordinates
-    void setCenterCoordinateX(ScalarDataObject const* pCenterCoordinateX) { mpCenterCoordinateX = pCenterCoordinateX; }
-    void setCenterCoordinateY(ScalarDataObject const* pCenterCoordinateY) { mpCenterCoordinateY = pCenterCoordinateY; }
+    void setCenterCoordinateX(ScalarDataObject const* pCenterCoordinateX) { setReference(kCenterCoordinateX, mCenterCoordinateX, pCenterCoordinateX); }
+    void setCenterCoordinateY(ScalarDataObject const* pCenterCoordinateY) { setReference(kCenterCoordinateY, mCenterCoordinateY, pCenterCoordinateY); }
 };
 
 }
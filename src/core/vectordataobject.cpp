@@ -9,7 +9,7 @@
 
 using namespace QRS::Core;
 
-quint32 VectorDataObject::smNumInstances = 0;
+std::atomic<quint32> VectorDataObject::smNumInstances = 0;
 const IndexType skNumElements = 3;
 
 //! Construct a vector data object
@@ -30,15 +30,17 @@ DataItemType& VectorDataObject::addItem(DataValueType key)
 {
     DataValueType rightKey = getAvailableItemKey(key);
     mItems.emplace(rightKey, DataItemType(1, skNumElements));
+    markModified();
     return mItems.at(rightKey);
 }
 
 //! Clone a vector data object
 AbstractDataObject* VectorDataObject::clone() const
 {
-    VectorDataObject* obj = new VectorDataObject(mName);
+    VectorDataObject* obj = new VectorDataObject(name());
     obj->mItems = mItems;
     obj->mID = mID;
+    obj->mVersion = mVersion;
     --smNumInstances;
     return obj;
 }
@@ -25,7 +25,7 @@ public:
     virtual void import(QTextStream& stream) override;
 
 private:
-    static quint32 smNumInstances;
+    static std::atomic<quint32> smNumInstances;
 };
 
 }
@@ -8,12 +8,15 @@
 #include <QMessageBox>
 #include <QSettings>
 #include <QToolBar>
+#include <QLineEdit>
 
 #include "abstractmanager.h"
 #include "central/uiconstants.h"
+#include "models/hierarchy/hierarchyfiltermodel.h"
 #include "DockManager.h"
 
 using namespace QRS::Managers;
+using namespace QRS::HierarchyModels;
 using ads::CDockManager;
 
 AbstractManager::AbstractManager(QString& lastPath, QSettings& settings,
@@ -91,6 +94,31 @@ void AbstractManager::closeEvent(QCloseEvent* pEvent)
     }
 }
 
+/*!
+ * \brief Block interaction with the manager while its data is being prepared
+ *
+ * The window stays responsive, so it can be moved or closed before the data is ready
+ */
+void AbstractManager::setLoading(bool isLoading)
+{
+    if (mIsLoading == isLoading)
+        return;
+    mIsLoading = isLoading;
+    for (QWidget* pWidget : findChildren<QWidget*>(QString(), Qt::FindDirectChildrenOnly))
+        pWidget->setEnabled(!isLoading);
+    if (isLoading)
+    {
+        mTitle = windowTitle();
+        setWindowTitle(mTitle + tr(" (Loading...)"));
+        setCursor(Qt::BusyCursor);
+    }
+    else
+    {
+        setWindowTitle(mTitle);
+        unsetCursor();
+    }
+}
+
 //! Helper function to add a shortcut hint to all actions which a toolbar contains
 void AbstractManager::setToolBarShortcutHints(QToolBar* pToolBar)
 {
@@ -105,3 +133,13 @@ void AbstractManager::setToolBarShortcutHints(QToolBar* pToolBar)
             action->setText(QString(action->text() + " (%1)").arg(shortCut));
     }
 }
+
+//! Create a field to filter items of a hierarchy by names while typing
+QLineEdit* AbstractManager::createSearchEdit(HierarchyFilterModel* pFilterModel)
+{
+    QLineEdit* pEdit = new QLineEdit();
+    pEdit->setPlaceholderText(tr("Search"));
+    pEdit->setClearButtonEnabled(true);
+    connect(pEdit, &QLineEdit::textChanged, pFilterModel, &HierarchyFilterModel::setPattern);
+    return pEdit;
+}
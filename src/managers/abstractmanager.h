@@ -13,6 +13,7 @@
 QT_BEGIN_NAMESPACE
 class QSettings;
 class QToolBar;
+class QLineEdit;
 QT_END_NAMESPACE
 
 namespace ads
@@ -23,6 +24,11 @@ class CDockManager;
 namespace QRS
 {
 
+namespace HierarchyModels
+{
+class HierarchyFilterModel;
+}
+
 namespace Managers
 {
 
@@ -43,6 +49,8 @@ public:
     virtual ~AbstractManager() = 0;
     void saveSettings();
     void restoreSettings();
+    void setLoading(bool isLoading);
+    bool isLoading() const { return mIsLoading; }
 
 signals:
     void closed(QRS::Managers::AbstractManager::ManagerType type);
@@ -53,6 +61,7 @@ public slots:
 protected:
     void closeEvent(QCloseEvent* pEvent) override;
     void setToolBarShortcutHints(QToolBar* pToolBar);
+    QLineEdit* createSearchEdit(HierarchyModels::HierarchyFilterModel* pFilterModel);
 
 protected:
     // Dock manager
@@ -64,6 +73,8 @@ private:
     QSettings& mSettings;
     ManagerType const mkType;
     QString const mkGroupName;
+    bool mIsLoading = false;
+    QString mTitle;
 };
 
 }
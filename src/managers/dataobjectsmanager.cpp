@@ -6,6 +6,7 @@
  */
 
 #include <QTreeView>
+#include <QLineEdit>
 #include <QSettings>
 #include <QHBoxLayout>
 #include <QToolBar>
@@ -15,6 +16,11 @@
 #include <QSpacerItem>
 #include <QShortcut>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QClipboard>
+#include <QGuiApplication>
+#include <QSet>
 #include "DockManager.h"
 #include "DockWidget.h"
 #include "DockAreaWidget.h"
@@ -25,11 +31,14 @@
 #include "core/vectordataobject.h"
 #include "core/matrixdataobject.h"
 #include "core/surfacedataobject.h"
+#include "core/deriveddataobject.h"
+#include "core/movingframes.h"
 #include "core/utilities.h"
 #include "models/table/basetablemodel.h"
 #include "models/table/matrixtablemodel.h"
 #include "models/table/surfacetablemodel.h"
 #include "models/hierarchy/dataobjectshierarchymodel.h"
+#include "models/hierarchy/hierarchyfiltermodel.h"
 #include "doublespinboxitemdelegate.h"
 
 using ads::CDockManager;
@@ -45,11 +54,8 @@ const static QSize skToolBarIconSize = QSize(22, 22);
 void setToolBarShortcutHints(QToolBar* pToolBar);
 QIcon getDataObjectIcon(AbstractDataObject::ObjectType type);
 
-DataObjectsManager::DataObjectsManager(DataObjects&& dataObjects, HierarchyTree&& hierarchyDataObjects,
-                                       QString& lastPath, QSettings& settings, QWidget* parent)
+DataObjectsManager::DataObjectsManager(QString& lastPath, QSettings& settings, QWidget* parent)
     : AbstractManager(lastPath, settings, kDataObjects, "DataObjectsManager", parent)
-    , mDataObjects(std::move(dataObjects))
-    , mHierarchyDataObjects(std::move(hierarchyDataObjects))
 {
     setWindowTitle("Data Objects Manager[*]");
     setGeometry(0, 0, 700, 700);
@@ -67,6 +73,24 @@ DataObjectsManager::~DataObjectsManager()
     mDataObjects.clear();
 }
 
+//! Set copies of data objects to modify
+void DataObjectsManager::setContent(DataObjects&& dataObjects, HierarchyTree&& hierarchyDataObjects)
+{
+    clearDataObjectRepresentation();
+    for (auto iter = mDataObjects.begin(); iter != mDataObjects.end(); ++iter)
+        delete iter->second;
+    mDataObjects = std::move(dataObjects);
+    mHierarchyDataObjects = std::move(hierarchyDataObjects);
+    mChangeSet.clear();
+    mpTreeDataObjectsModel->updateContent();
+    mEditHistory.clear();
+    if (mPendingSelectionID != 0)
+    {
+        selectDataObjectByID(mPendingSelectionID);
+        mPendingSelectionID = 0;
+    }
+}
+
 //! Create all the widgets
 void DataObjectsManager::createContent()
 {
@@ -96,6 +120,7 @@ CDockWidget* DataObjectsManager::createDataTableWidget()
     // Editor of table values
     DoubleSpinBoxItemDelegate* pItemDelegate = new DoubleSpinBoxItemDelegate();
     mpDataTable->setItemDelegate(pItemDelegate);
+    connect(pItemDelegate, &QAbstractItemDelegate::commitData, this, [this]() { setDataObjectModified(true); });
     // Models
     mpBaseTableModel = new BaseTableModel(mpDataTable);
     mpMatrixTableModel = new MatrixTableModel(mpDataTable);
@@ -110,6 +135,12 @@ CDockWidget* DataObjectsManager::createDataTableWidget()
     pAction = pToolBar->addAction(QIcon(":/icons/arrows-collapse.svg"), tr("Collapse"), mpDataTable, &QTreeView::collapseAll);
     pAction->setShortcut(Qt::Key_C);
     pToolBar->addSeparator();
+    // History actions
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-undo.svg"), tr("Undo"), this, &DataObjectsManager::undo);
+    pAction->setShortcut(QKeySequence::Undo);
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-redo.svg"), tr("Redo"), this, &DataObjectsManager::redo);
+    pAction->setShortcut(QKeySequence::Redo);
+    pToolBar->addSeparator();
     // Rows actions
     pAction = pToolBar->addAction(QIcon(":/icons/table-row-add.svg"), tr("Add Row"), this, &DataObjectsManager::insertItemAfterSelected);
     pAction->setShortcut(Qt::Key_A);
@@ -123,6 +154,21 @@ CDockWidget* DataObjectsManager::createDataTableWidget()
     pAction = pToolBar->addAction(QIcon(":/icons/table-column-delete.svg"), tr("Remove Column"),
                                   this, &DataObjectsManager::removeSelectedLeadingItem);
     pAction->setShortcut(QKeySequence("Ctrl+D"));
+    pToolBar->addSeparator();
+    // Clipboard actions
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-copy.svg"), tr("Copy"), this, &DataObjectsManager::copySelectedValues);
+    pAction->setShortcut(QKeySequence::Copy);
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-paste.svg"), tr("Paste"), this, &DataObjectsManager::pasteValues);
+    pAction->setShortcut(QKeySequence::Paste);
+    // Bulk actions
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-table.svg"), tr("Fill"), this, &DataObjectsManager::fillSelectedValues);
+    pAction->setShortcut(QKeySequence("Ctrl+Shift+F"));
+    pAction = pToolBar->addAction(QIcon(":/icons/plus.svg"), tr("Offset"), this, &DataObjectsManager::offsetSelectedValues);
+    pAction->setShortcut(QKeySequence("Ctrl+Shift+O"));
+    pAction = pToolBar->addAction(QIcon(":/icons/view-measurement.svg"), tr("Scale"), this, &DataObjectsManager::scaleSelectedValues);
+    pAction->setShortcut(QKeySequence("Ctrl+Shift+S"));
+    pAction = pToolBar->addAction(QIcon(":/icons/code.svg"), tr("Expression"), this, &DataObjectsManager::evaluateExpression);
+    pAction->setShortcut(QKeySequence("Ctrl+Shift+X"));
     // Import action
     pToolBar->addSeparator();
     pToolBar->addAction(QIcon(":/icons/link-import.svg"), tr("Import"), this, &DataObjectsManager::importDataObjects);
@@ -149,8 +195,28 @@ CDockWidget* DataObjectsManager::createHierarchyWidget()
     // Hierarchy model
     mpTreeDataObjectsModel = new DataObjectsHierarchyModel(mDataObjects, mHierarchyDataObjects,
                                                            "dataobjectsmanager/hierarchy", mpTreeDataObjects);
-    mpTreeDataObjects->setModel(mpTreeDataObjectsModel);
-    connect(mpTreeDataObjectsModel, &DataObjectsHierarchyModel::hierarchyChanged, [this]() { setWindowModified(true); });
+    HierarchyFilterModel* pFilterModel = new HierarchyFilterModel(mpTreeDataObjectsModel, mpTreeDataObjects);
+    mpTreeDataObjects->setModel(pFilterModel);
+    mpTreeDataObjectsModel->setDeltaRecorded(true);
+    connect(mpTreeDataObjectsModel, &DataObjectsHierarchyModel::hierarchyChanged, [this]()
+    {
+        mChangeSet.setHierarchyChanged();
+        recordHierarchyEdit();
+        setWindowModified(true);
+    });
+    connect(mpTreeDataObjectsModel, &DataObjectsHierarchyModel::objectRenamed, [this](DataIDType id)
+    {
+        mChangeSet.setRenamed(id);
+        DerivedDataObject::resolveAllReferences(mDataObjects);
+        setWindowModified(true);
+    });
+    connect(mpTreeDataObjectsModel, &DataObjectsHierarchyModel::objectRemoved, [this](DataIDType id)
+    {
+        mChangeSet.setRemoved(id);
+        // The object is about to be deleted, so its copy is kept to be restored
+        mRemovedDataObjects.push_back(mDataObjects.at(id)->clone());
+        setWindowModified(true);
+    });
     connect(mpTreeDataObjectsModel, &DataObjectsHierarchyModel::selected,
             this, &DataObjectsManager::representDataObject);
     connect(mpTreeDataObjects->selectionModel(), &QItemSelectionModel::selectionChanged,
@@ -170,10 +236,16 @@ CDockWidget* DataObjectsManager::createHierarchyWidget()
     pAction->setShortcut(QKeySequence("Ctrl+3"));
     pAction = pToolBar->addAction(QIcon(":/icons/letter-xy.svg"), tr("Surface"), this, &DataObjectsManager::addSurface);
     pAction->setShortcut(QKeySequence("Ctrl+4"));
+    pAction = pToolBar->addAction(QIcon(":/icons/link.svg"), tr("Derived"), this, &DataObjectsManager::addDerived);
+    pAction->setShortcut(QKeySequence("Ctrl+5"));
+    pAction = pToolBar->addAction(QIcon(":/icons/std-coordinatesystem.svg"), tr("Frames"), this, &DataObjectsManager::addFrames);
+    pAction->setShortcut(QKeySequence("Ctrl+6"));
     pToolBar->addSeparator();
     pAction = pToolBar->addAction(QIcon(":/icons/delete.svg"), tr("Remove"),
                                   mpTreeDataObjectsModel, &DataObjectsHierarchyModel::removeSelectedItems);
     pAction->setShortcut(Qt::Key_R);
+    pToolBar->addSeparator();
+    pToolBar->addWidget(createSearchEdit(pFilterModel));
     setToolBarShortcutHints(pToolBar);
     return pDockWidget;
 }
@@ -194,7 +266,8 @@ QLayout* DataObjectsManager::createDialogControls()
 //! Apply all the changes made by user
 void DataObjectsManager::apply()
 {
-    emit applied(mDataObjects, mHierarchyDataObjects);
+    emit applied(mDataObjects, mHierarchyDataObjects, mChangeSet);
+    mChangeSet.clear();
     setWindowModified(false);
     qInfo() << tr("Data objects were modified through the manager");
 }
@@ -202,9 +275,7 @@ void DataObjectsManager::apply()
 //! Add a scalar object
 AbstractDataObject* DataObjectsManager::addScalar()
 {
-    static QString const kScalarName = "Scalar ";
-    QString name = kScalarName + QString::number(ScalarDataObject::numberInstances() + 1);
-    AbstractDataObject* pObject = new ScalarDataObject(name);
+    AbstractDataObject* pObject = createDataObject(AbstractDataObject::ObjectType::kScalar);
     emplaceDataObject(pObject);
     return pObject;
 }
@@ -212,9 +283,7 @@ AbstractDataObject* DataObjectsManager::addScalar()
 //! Add a vector object
 AbstractDataObject* DataObjectsManager::addVector()
 {
-    static QString const kVectorName = "Vector ";
-    QString name = kVectorName + QString::number(VectorDataObject::numberInstances() + 1);
-    AbstractDataObject* pObject = new VectorDataObject(name);
+    AbstractDataObject* pObject = createDataObject(AbstractDataObject::ObjectType::kVector);
     emplaceDataObject(pObject);
     return pObject;
 }
@@ -222,9 +291,7 @@ AbstractDataObject* DataObjectsManager::addVector()
 //! Add a matrix object
 AbstractDataObject* DataObjectsManager::addMatrix()
 {
-    static QString const kMatrixName = "Matrix ";
-    QString name = kMatrixName + QString::number(MatrixDataObject::numberInstances() + 1);
-    AbstractDataObject* pObject = new MatrixDataObject(name);
+    AbstractDataObject* pObject = createDataObject(AbstractDataObject::ObjectType::kMatrix);
     emplaceDataObject(pObject);
     return pObject;
 }
@@ -232,13 +299,119 @@ AbstractDataObject* DataObjectsManager::addMatrix()
 //! Add a surface object
 AbstractDataObject* DataObjectsManager::addSurface()
 {
-    static QString const kSurfaceName = "Surface ";
-    QString name = kSurfaceName + QString::number(SurfaceDataObject::numberInstances() + 1);
-    AbstractDataObject* pObject = new SurfaceDataObject(name);
+    AbstractDataObject* pObject = createDataObject(AbstractDataObject::ObjectType::kSurface);
     emplaceDataObject(pObject);
     return pObject;
 }
 
+/*!
+ * \brief Add an object which is computed by a formula over other ones
+ *
+ * The type of the object is the largest one among the referenced objects. If a derived object with the given name
+ * exists, its formula is substituted.
+ */
+AbstractDataObject* DataObjectsManager::addDerived()
+{
+    QString const kTitle = tr("Derived");
+    bool isOkay = false;
+    QString text = QInputDialog::getText(this, kTitle,
+                                         tr("Define the object by a formula over other ones, for instance \"EA = [E] * [A]\":"),
+                                         QLineEdit::Normal, QString(), &isOkay);
+    if (!isOkay || text.trimmed().isEmpty())
+        return nullptr;
+    Expression expression(text);
+    QString errorMessage = expression.errorMessage();
+    std::vector<AbstractDataObject*> references;
+    if (expression.isValid() && expression.target().isEmpty())
+        errorMessage = tr("Start the formula with the name of the object");
+    else if (expression.isValid() && expression.references().isEmpty())
+        errorMessage = tr("Refer to at least one data object to define the keys");
+    else if (expression.isValid())
+        expression.resolveReferences(mDataObjects, references, errorMessage);
+    if (!errorMessage.isEmpty())
+    {
+        QMessageBox::warning(this, kTitle, errorMessage);
+        return nullptr;
+    }
+    AbstractDataObject::ObjectType type = AbstractDataObject::ObjectType::kScalar;
+    for (AbstractDataObject const* pReference : references)
+        type = std::max(type, pReference->type());
+    if (type == AbstractDataObject::ObjectType::kSurface)
+    {
+        QMessageBox::warning(this, kTitle, tr("Surfaces cannot be derived from other data objects"));
+        return nullptr;
+    }
+    // Substitute the formula of the existing object
+    QString const& name = expression.target();
+    for (auto const& [id, pDataObject] : mDataObjects)
+    {
+        if (pDataObject->name() != name)
+            continue;
+        if (!pDataObject->isDerived() || pDataObject->type() != type)
+        {
+            QMessageBox::warning(this, kTitle, tr("Data object \"%1\" already exists").arg(name));
+            return nullptr;
+        }
+        DerivedDataObject* pDerivedDataObject = (DerivedDataObject*)pDataObject;
+        AbstractDataObject* pPreviousState = pDataObject->clone();
+        pDerivedDataObject->setFormula(expression.body());
+        pDerivedDataObject->resolveReferences(mDataObjects);
+        DataChangeSet changeSet;
+        changeSet.setModified(id);
+        mChangeSet.append(changeSet);
+        // Deltas of items cannot restore the formula, so the object is substituted by its previous state
+        mEditHistory.pushStructure(mDataObjects, HierarchyDelta(), {pDataObject}, {pPreviousState});
+        setWindowModified(true);
+        mpTreeDataObjectsModel->updateContent(changeSet);
+        selectDataObjectByID(id);
+        return pDataObject;
+    }
+    DerivedDataObject* pDataObject = new DerivedDataObject(type, name, expression.body());
+    emplaceDataObject(pDataObject);
+    selectDataObjectByID(pDataObject->id());
+    return pDataObject;
+}
+
+/*!
+ * \brief Add a matrix object which consists of frames generated along the selected radius vector
+ *
+ * Frames are placed uniformly along the arc length of the curve, so that they can be used as the rotation matrix
+ * of a geometry.
+ */
+AbstractDataObject* DataObjectsManager::addFrames()
+{
+    QString const kTitle = tr("Frames");
+    if (!mpRepresentedDataObject || mpRepresentedDataObject->type() != AbstractDataObject::ObjectType::kVector
+        || mpRepresentedDataObject->getItems().empty())
+    {
+        QMessageBox::warning(this, kTitle, tr("Select a vector object which defines the radius vector of a curve"));
+        return nullptr;
+    }
+    QStringList const kTypeNames = {tr("Rotation-minimizing"), tr("Frenet")};
+    bool isOkay = false;
+    QString typeName = QInputDialog::getItem(this, kTitle, tr("Type of frames:"), kTypeNames, 0, false, &isOkay);
+    if (!isOkay)
+        return nullptr;
+    int numFrames = QInputDialog::getInt(this, kTitle, tr("Number of frames:"), 101, 2, 1000000, 1, &isOkay);
+    if (!isOkay)
+        return nullptr;
+    ArcLengthParametrization parametrization;
+    parametrization.update((VectorDataObject const*)mpRepresentedDataObject);
+    std::vector<double> arcLengths(numFrames);
+    std::vector<double> parameters;
+    for (int i = 0; i != numFrames; ++i)
+        arcLengths[i] = parametrization.length() * i / (numFrames - 1);
+    parametrization.computeParameters(arcLengths, parameters);
+    std::array<std::vector<double>, 9> frames;
+    MovingFrames().compute(parametrization, parameters, (MovingFrames::FrameType)kTypeNames.indexOf(typeName), frames);
+    static QString const kFramesName = "Frames ";
+    QString name = kFramesName + QString::number(MatrixDataObject::numberInstances() + 1);
+    AbstractDataObject* pObject = MovingFrames::createDataObject(name, parameters, frames);
+    emplaceDataObject(pObject);
+    selectDataObjectByID(pObject->id());
+    return pObject;
+}
+
 //! Select a data object by row index
 void DataObjectsManager::selectDataObject(int iRow)
 {
@@ -248,6 +421,11 @@ void DataObjectsManager::selectDataObject(int iRow)
 //! Select a data object by identifier
 void DataObjectsManager::selectDataObjectByID(DataIDType id)
 {
+    if (isLoading())
+    {
+        mPendingSelectionID = id;
+        return;
+    }
     mpTreeDataObjectsModel->selectItemByID(id);
 }
 
@@ -258,6 +436,18 @@ void DataObjectsManager::representDataObject(DataIDType id)
     if (!mDataObjects.contains(id))
         return;
     AbstractDataObject* pObject = mDataObjects[id];
+    mpRepresentedDataObject = pObject;
+    // Derived objects are shown read-only
+    if (pObject->isDerived())
+    {
+        if (!pObject->evaluate())
+            qWarning() << ((DerivedDataObject*)pObject)->errorMessage();
+        mpDataTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    }
+    else
+    {
+        mpDataTable->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+    }
     switch (pObject->type())
     {
     case AbstractDataObject::ObjectType::kScalar:
@@ -289,6 +479,7 @@ void DataObjectsManager::representDataObject(DataIDType id)
 void DataObjectsManager::clearDataObjectRepresentation()
 {
     mpTableModelInterface = nullptr;
+    mpRepresentedDataObject = nullptr;
     mpBaseTableModel->setDataObject(nullptr);
     mpMatrixTableModel->setDataObject(nullptr);
     mpSurfaceTableModel->setDataObject(nullptr);
@@ -300,7 +491,7 @@ void DataObjectsManager::insertItemAfterSelected()
     if (isDataTableModifiable())
     {
         mpTableModelInterface->insertItemAfterSelected(mpDataTable->selectionModel());
-        setWindowModified(true);
+        setDataObjectModified();
     }
 }
 
@@ -310,7 +501,7 @@ void DataObjectsManager::insertLeadingItemAfterSelected()
     if (isDataTableModifiable())
     {
         mpTableModelInterface->insertLeadingItemAfterSelected(mpDataTable->selectionModel());
-        setWindowModified(true);
+        setDataObjectModified();
     }
 }
 
@@ -320,7 +511,7 @@ void DataObjectsManager::removeSelectedItem()
     if (isDataTableModifiable())
     {
         mpTableModelInterface->removeSelectedItem(mpDataTable->selectionModel());
-        setWindowModified(true);
+        setDataObjectModified();
     }
 }
 
@@ -330,10 +521,204 @@ void DataObjectsManager::removeSelectedLeadingItem()
     if (isDataTableModifiable())
     {
         mpTableModelInterface->removeSelectedLeadingItem(mpDataTable->selectionModel());
-        setWindowModified(true);
+        setDataObjectModified();
     }
 }
 
+//! Copy values of selected cells to the clipboard
+void DataObjectsManager::copySelectedValues()
+{
+    if (!mpTableModelInterface)
+        return;
+    QString text = TableModelInterface::copyValues(mpDataTable->selectionModel()->selectedIndexes());
+    if (!text.isEmpty())
+        QGuiApplication::clipboard()->setText(text);
+}
+
+//! Paste values from the clipboard starting from the selected cell
+void DataObjectsManager::pasteValues()
+{
+    if (!isDataTableModifiable())
+        return;
+    ValuesTable values = TableModelInterface::parseValues(QGuiApplication::clipboard()->text());
+    if (values.isEmpty())
+        return;
+    mpTableModelInterface->pasteValues(mpDataTable->selectionModel(), values);
+    setDataObjectModified();
+}
+
+//! Assign the same value to all the selected cells
+void DataObjectsManager::fillSelectedValues()
+{
+    double value;
+    if (requestSelectionValue(tr("Fill"), tr("Value:"), 0.0, value))
+        transformSelectedValues([value](double) { return value; });
+}
+
+//! Add a value to all the selected cells
+void DataObjectsManager::offsetSelectedValues()
+{
+    double value;
+    if (requestSelectionValue(tr("Offset"), tr("Offset:"), 0.0, value))
+        transformSelectedValues([value](double current) { return current + value; });
+}
+
+//! Multiply all the selected cells by a value
+void DataObjectsManager::scaleSelectedValues()
+{
+    double value;
+    if (requestSelectionValue(tr("Scale"), tr("Factor:"), 1.0, value))
+        transformSelectedValues([value](double current) { return current * value; });
+}
+
+/*!
+ * \brief Evaluate an expression over all the values of data objects
+ *
+ * The selected objects are transformed in place. If the expression starts with an assignment, the result is written
+ * to the object with the given name, which is created following the first referenced object if it does not exist.
+ */
+void DataObjectsManager::evaluateExpression()
+{
+    QString const kTitle = tr("Expression");
+    bool isOkay = false;
+    QString text = QInputDialog::getText(this, kTitle,
+                                         tr("Values (x), keys (key) and data objects ([Name]) can be used.\n"
+                                            "Start with \"Name =\" to write the result to another object:"),
+                                         QLineEdit::Normal, mLastExpression, &isOkay);
+    if (!isOkay || text.trimmed().isEmpty())
+        return;
+    mLastExpression = text;
+    Expression expression(text);
+    if (!expression.isValid())
+    {
+        QMessageBox::warning(this, kTitle, expression.errorMessage());
+        return;
+    }
+    // Retrieve the objects to transform
+    QList<AbstractDataObject*> targets;
+    QString const& targetName = expression.target();
+    if (targetName.isEmpty())
+    {
+        for (DataIDType id : mpTreeDataObjectsModel->selectedIDs())
+            targets.push_back(mDataObjects.at(id));
+    }
+    else
+    {
+        for (auto const& [id, pDataObject] : mDataObjects)
+        {
+            if (pDataObject->name() == targetName)
+                targets.push_back(pDataObject);
+        }
+    }
+    QString errorMessage;
+    // Create the object which is assigned
+    if (targets.isEmpty() && !targetName.isEmpty())
+    {
+        AbstractDataObject* pDataObject = createExpressionTarget(expression);
+        if (!pDataObject)
+        {
+            QMessageBox::warning(this, kTitle, tr("Refer to a data object to create \"%1\" of the same structure").arg(targetName));
+            return;
+        }
+        if (!expression.apply(*pDataObject, mDataObjects, errorMessage))
+        {
+            delete pDataObject;
+            QMessageBox::warning(this, kTitle, errorMessage);
+            return;
+        }
+        emplaceDataObject(pDataObject);
+        selectDataObjectByID(pDataObject->id());
+        return;
+    }
+    if (targets.isEmpty())
+    {
+        QMessageBox::warning(this, kTitle, tr("Select data objects to transform"));
+        return;
+    }
+    // Transform the objects in place, so that each of them can be reverted
+    bool isRepresentedModified = false;
+    for (AbstractDataObject* pDataObject : targets)
+    {
+        // Derived objects are changed through their formulas only
+        if (pDataObject->isDerived())
+            continue;
+        AbstractDataObject* pRecordedDataObject = pDataObject->clone();
+        bool isApplied = expression.apply(*pDataObject, mDataObjects, errorMessage);
+        if (isApplied)
+        {
+            mEditHistory.pushDataObject(mDataObjects, DataObjectDelta(*pRecordedDataObject, *pDataObject));
+            mChangeSet.setModified(pDataObject->id());
+            isRepresentedModified = isRepresentedModified || pDataObject == mpRepresentedDataObject;
+        }
+        delete pRecordedDataObject;
+        if (!isApplied)
+        {
+            QMessageBox::warning(this, kTitle, errorMessage);
+            break;
+        }
+    }
+    setWindowModified(true);
+    if (isRepresentedModified)
+        representDataObject(mpRepresentedDataObject->id());
+}
+
+//! Create an empty object to assign an expression to with the structure of the first referenced object
+AbstractDataObject* DataObjectsManager::createExpressionTarget(Expression const& expression)
+{
+    if (expression.references().isEmpty())
+        return nullptr;
+    QString const& templateName = expression.references().first();
+    AbstractDataObject* pTemplate = nullptr;
+    for (auto const& [id, pDataObject] : mDataObjects)
+    {
+        if (pDataObject->name() == templateName)
+        {
+            pTemplate = pDataObject;
+            break;
+        }
+    }
+    if (!pTemplate || !pTemplate->evaluate())
+        return nullptr;
+    AbstractDataObject* pDataObject = nullptr;
+    QString const& name = expression.target();
+    switch (pTemplate->type())
+    {
+    case AbstractDataObject::ObjectType::kScalar:
+        pDataObject = new ScalarDataObject(name);
+        break;
+    case AbstractDataObject::ObjectType::kVector:
+        pDataObject = new VectorDataObject(name);
+        break;
+    case AbstractDataObject::ObjectType::kMatrix:
+        pDataObject = new MatrixDataObject(name);
+        break;
+    case AbstractDataObject::ObjectType::kSurface:
+        pDataObject = new SurfaceDataObject(name);
+        break;
+    }
+    pDataObject->assign(*pTemplate);
+    pDataObject->setName(name);
+    return pDataObject;
+}
+
+//! Ask a user for a value to modify the selected cells
+bool DataObjectsManager::requestSelectionValue(QString const& title, QString const& label, double defaultValue, double& value)
+{
+    if (!isDataTableModifiable() || !mpDataTable->selectionModel()->hasSelection())
+        return false;
+    bool isOkay = false;
+    value = QInputDialog::getDouble(this, title, label, defaultValue, std::numeric_limits<double>::lowest(),
+                                    std::numeric_limits<double>::max(), kNumShowPrecision, &isOkay);
+    return isOkay;
+}
+
+//! Apply a function to all the selected cells at once
+void DataObjectsManager::transformSelectedValues(std::function<double(double)> const& function)
+{
+    mpTableModelInterface->transformSelectedValues(mpDataTable->selectionModel(), function);
+    setDataObjectModified();
+}
+
 //! Import data objects from a file
 void DataObjectsManager::importDataObjects()
 {
@@ -343,26 +728,132 @@ void DataObjectsManager::importDataObjects()
                                                       "Data files (*.prn)");
     if (files.isEmpty())
         return;
+    // All the objects are inserted at once, so that the import is undone as a single edit
+    std::vector<AbstractDataObject*> dataObjects;
     for (auto& filePath : files)
     {
         QFileInfo info(filePath);
-        importDataObject(info.path(), info.fileName());
+        importDataObject(info.path(), info.fileName(), dataObjects);
     }
+    emplaceDataObjects(dataObjects);
     mLastPath = QFileInfo(files[0]).path();
 }
 
-//! Helper function to insert data objects into the manager
+//! Helper function to insert a data object into the manager
 void DataObjectsManager::emplaceDataObject(AbstractDataObject* pDataObject)
 {
-    DataIDType id = pDataObject->id();
-    mDataObjects.emplace(id, pDataObject);
-    mHierarchyDataObjects.appendNode(new HierarchyNode(HierarchyNode::NodeType::kObject, id));
-    mpTreeDataObjectsModel->updateContent();
+    emplaceDataObjects({pDataObject});
+}
+
+/*!
+ * \brief Insert data objects into the manager as a single edit
+ *
+ * The objects are appended to the root of the hierarchy, so only their items are created. References are resolved
+ * for the new derived objects and for the existing ones which refer to the new names.
+ */
+void DataObjectsManager::emplaceDataObjects(std::vector<AbstractDataObject*> const& dataObjects)
+{
+    if (dataObjects.empty())
+        return;
+    HierarchyDelta hierarchy;
+    std::vector<HierarchyNode*> nodes;
+    QSet<QString> names;
+    nodes.reserve(dataObjects.size());
+    for (AbstractDataObject* pDataObject : dataObjects)
+    {
+        DataIDType id = pDataObject->id();
+        mDataObjects.emplace(id, pDataObject);
+        HierarchyNode* pNode = new HierarchyNode(HierarchyNode::NodeType::kObject, id);
+        mHierarchyDataObjects.appendNode(pNode);
+        hierarchy.recordCreated(pNode);
+        nodes.push_back(pNode);
+        names.insert(pDataObject->name());
+        mChangeSet.setCreated(id);
+    }
+    hierarchy.recordAfter();
+    mEditHistory.pushStructure(mDataObjects, std::move(hierarchy), dataObjects);
+    mChangeSet.setHierarchyChanged();
+    for (AbstractDataObject* pDataObject : dataObjects)
+    {
+        if (pDataObject->isDerived())
+            ((DerivedDataObject*)pDataObject)->resolveReferences(mDataObjects);
+    }
+    DerivedDataObject::resolveReferencesTo(mDataObjects, names);
+    mpTreeDataObjectsModel->appendItems(nodes);
+    setWindowModified(true);
+}
+
+/*!
+ * \brief Register a modification of the data object being represented
+ *
+ * The edits recorded by the table model are kept in the history. Consecutive edits of single cells are undone at once.
+ */
+void DataObjectsManager::setDataObjectModified(bool isCellEdit)
+{
+    if (mpRepresentedDataObject)
+    {
+        mpRepresentedDataObject->markModified();
+        mChangeSet.setModified(mpRepresentedDataObject->id());
+        if (mpTableModelInterface)
+            mEditHistory.pushDataObject(mDataObjects, mpTableModelInterface->takeDelta(), isCellEdit);
+    }
+    setWindowModified(true);
+}
+
+//! Register a reorganization of the hierarchy made through the model together with the objects removed
+void DataObjectsManager::recordHierarchyEdit()
+{
+    mEditHistory.pushStructure(mDataObjects, mpTreeDataObjectsModel->takeDelta(), {}, mRemovedDataObjects);
+    if (!mRemovedDataObjects.empty())
+        DerivedDataObject::resolveAllReferences(mDataObjects);
+    mRemovedDataObjects.clear();
+}
+
+//! Revert the last edit
+void DataObjectsManager::undo()
+{
+    DataChangeSet changeSet;
+    if (mEditHistory.undo(changeSet))
+        representEditHistoryStep(changeSet);
+}
+
+//! Repeat the last edit reverted
+void DataObjectsManager::redo()
+{
+    DataChangeSet changeSet;
+    if (mEditHistory.redo(changeSet))
+        representEditHistoryStep(changeSet);
+}
+
+//! Register the changes made by undoing or redoing an edit and show the affected object
+void DataObjectsManager::representEditHistoryStep(DataChangeSet const& changeSet)
+{
+    DataIDType selectedID = mpRepresentedDataObject ? mpRepresentedDataObject->id() : 0;
+    mChangeSet.append(changeSet);
+    for (DataIDSet const* pIDs : {&changeSet.createdIDs(), &changeSet.modifiedIDs()})
+    {
+        for (DataIDType id : *pIDs)
+            selectedID = id;
+    }
+    // Objects could be substituted, so the references to them are resolved again
+    if (changeSet.isStructureChanged())
+    {
+        DerivedDataObject::resolveAllReferences(mDataObjects);
+        mpTreeDataObjectsModel->updateContent(changeSet);
+    }
     setWindowModified(true);
+    // Representation is recreated to synchronize the table with the object
+    if (!mDataObjects.contains(selectedID))
+        return;
+    if (mpRepresentedDataObject && mpRepresentedDataObject->id() == selectedID)
+        representDataObject(selectedID);
+    else
+        selectDataObjectByID(selectedID);
 }
 
-//! Import a data object from a file
-void DataObjectsManager::importDataObject(QString const& path, QString const& fileName)
+//! Import data objects from a file. The objects are created without being inserted into the manager
+void DataObjectsManager::importDataObject(QString const& path, QString const& fileName,
+                                          std::vector<AbstractDataObject*>& dataObjects)
 {
     auto [type, pFile] = Utilities::File::getDataObjectFile(path, fileName);
     if (pFile == nullptr)
@@ -374,30 +865,34 @@ void DataObjectsManager::importDataObject(QString const& path, QString const& fi
     stream.readLine();
     for (quint32 iDataObject = 0; iDataObject != numDataObjects; ++iDataObject)
     {
-        AbstractDataObject* pDataObject = nullptr;
-        switch (type)
-        {
-        case AbstractDataObject::ObjectType::kScalar:
-            pDataObject = addScalar();
-            break;
-        case AbstractDataObject::ObjectType::kVector:
-            pDataObject = addVector();
-            break;
-        case AbstractDataObject::ObjectType::kMatrix:
-            pDataObject = addMatrix();
-            break;
-        case AbstractDataObject::ObjectType::kSurface:
-            pDataObject = addSurface();
-            break;
-        }
-        if (pDataObject)
-            pDataObject->import(stream);
+        AbstractDataObject* pDataObject = createDataObject(type);
+        if (!pDataObject)
+            continue;
+        pDataObject->import(stream);
+        dataObjects.push_back(pDataObject);
     }
     pFile->close();
 }
 
+//! Create an empty data object of a given type with the default name
+AbstractDataObject* DataObjectsManager::createDataObject(AbstractDataObject::ObjectType type)
+{
+    switch (type)
+    {
+    case AbstractDataObject::ObjectType::kScalar:
+        return new ScalarDataObject("Scalar " + QString::number(ScalarDataObject::numberInstances() + 1));
+    case AbstractDataObject::ObjectType::kVector:
+        return new VectorDataObject("Vector " + QString::number(VectorDataObject::numberInstances() + 1));
+    case AbstractDataObject::ObjectType::kMatrix:
+        return new MatrixDataObject("Matrix " + QString::number(MatrixDataObject::numberInstances() + 1));
+    case AbstractDataObject::ObjectType::kSurface:
+        return new SurfaceDataObject("Surface " + QString::number(SurfaceDataObject::numberInstances() + 1));
+    }
+    return nullptr;
+}
+
 //! Helper function to check if it is possible to interact with data object content
 bool DataObjectsManager::isDataTableModifiable()
 {
-    return mpTableModelInterface;
+    return mpTableModelInterface && !mpRepresentedDataObject->isDerived();
 }
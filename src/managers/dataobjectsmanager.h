@@ -9,10 +9,14 @@
 #define DATAOBJECTSMANAGER_H
 
 #include <unordered_map>
+#include <functional>
 #include "abstractmanager.h"
 #include "core/aliasdata.h"
 #include "core/aliasdataset.h"
 #include "core/hierarchytree.h"
+#include "core/datachangeset.h"
+#include "core/edithistory.h"
+#include "core/expression.h"
 
 QT_BEGIN_NAMESPACE
 class QTreeView;
@@ -50,15 +54,16 @@ class DataObjectsManager : public AbstractManager
     Q_OBJECT
 
 public:
-    explicit DataObjectsManager(Core::DataObjects&& dataObjects, Core::HierarchyTree&& hierarchyDataObjects,
-                                QString& lastPath, QSettings& settings, QWidget* parent = nullptr);
+    explicit DataObjectsManager(QString& lastPath, QSettings& settings, QWidget* parent = nullptr);
     ~DataObjectsManager();
+    void setContent(Core::DataObjects&& dataObjects, Core::HierarchyTree&& hierarchyDataObjects);
     void selectDataObject(int iRow);
     void selectDataObjectByID(Core::DataIDType id);
     Core::DataObjects const& getDataObjects() { return mDataObjects; };
 
 signals:
-    void applied(Core::DataObjects const& dataObjects, Core::HierarchyTree const& hierarchyDataObjects);
+    void applied(Core::DataObjects const& dataObjects, Core::HierarchyTree const& hierarchyDataObjects,
+                 Core::DataChangeSet const& changeSet);
 
 public slots:
     void apply() override;
@@ -66,11 +71,21 @@ public slots:
     Core::AbstractDataObject* addVector();
     Core::AbstractDataObject* addMatrix();
     Core::AbstractDataObject* addSurface();
+    Core::AbstractDataObject* addDerived();
+    Core::AbstractDataObject* addFrames();
     void insertItemAfterSelected();
     void insertLeadingItemAfterSelected();
     void removeSelectedItem();
     void removeSelectedLeadingItem();
+    void copySelectedValues();
+    void pasteValues();
+    void fillSelectedValues();
+    void offsetSelectedValues();
+    void scaleSelectedValues();
+    void evaluateExpression();
     void importDataObjects();
+    void undo();
+    void redo();
 
 private:
     // Content
@@ -80,8 +95,17 @@ private:
     QLayout* createDialogControls();
     // Helpers
     void emplaceDataObject(Core::AbstractDataObject* pDataObject);
+    void emplaceDataObjects(std::vector<Core::AbstractDataObject*> const& dataObjects);
+    void setDataObjectModified(bool isCellEdit = false);
     bool isDataTableModifiable();
-    void importDataObject(QString const& path, QString const& fileName);
+    void importDataObject(QString const& path, QString const& fileName, std::vector<Core::AbstractDataObject*>& dataObjects);
+    static Core::AbstractDataObject* createDataObject(Core::AbstractDataObject::ObjectType type);
+    bool requestSelectionValue(QString const& title, QString const& label, double defaultValue, double& value);
+    void transformSelectedValues(std::function<double(double)> const& function);
+    Core::AbstractDataObject* createExpressionTarget(Core::Expression const& expression);
+    // History
+    void recordHierarchyEdit();
+    void representEditHistoryStep(Core::DataChangeSet const& changeSet);
     // Selection
     void representDataObject(Core::DataIDType id);
     void clearDataObjectRepresentation();
@@ -93,6 +117,17 @@ private:
     // Data
     Core::DataObjects mDataObjects;
     Core::HierarchyTree mHierarchyDataObjects;
+    Core::AbstractDataObject* mpRepresentedDataObject = nullptr;
+    //! Changes which have not been applied yet
+    Core::DataChangeSet mChangeSet;
+    //! Edits which can be undone
+    Core::EditHistory mEditHistory;
+    //! Copies of the objects removed by the hierarchy model to be restored
+    std::vector<Core::AbstractDataObject*> mRemovedDataObjects;
+    //! Object to select as soon as the content is set
+    Core::DataIDType mPendingSelectionID = 0;
+    //! Expression evaluated the last time
+    QString mLastExpression;
     // Models
     TableModels::TableModelInterface* mpTableModelInterface = nullptr;
     TableModels::BaseTableModel* mpBaseTableModel;
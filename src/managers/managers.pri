@@ -14,6 +14,7 @@ HEADERS += \
     $$PWD/materialrodcomponentwidget.h \
     $$PWD/mechanicalrodcomponentwidget.h \
     $$PWD/rodcomponentsmanager.h \
+    $$PWD/rodconstructormanager.h \
     $$PWD/usersectionrodcomponentwidget.h
 
 SOURCES += \
@@ -30,4 +31,5 @@ SOURCES += \
     $$PWD/materialrodcomponentwidget.cpp \
     $$PWD/mechanicalrodcomponentwidget.cpp \
     $$PWD/rodcomponentsmanager.cpp \
+    $$PWD/rodconstructormanager.cpp \
     $$PWD/usersectionrodcomponentwidget.cpp
@@ -5,16 +5,32 @@
  * \brief Definition of the ManagersFactory class
  */
 
+#include <QThread>
+#include <QSharedPointer>
 #include "managersfactory.h"
 #include "core/project.h"
 #include "managers/dataobjectsmanager.h"
 #include "managers/rodcomponentsmanager.h"
+#include "managers/rodconstructormanager.h"
 
 using namespace QRS::Core;
 using namespace QRS::Managers;
 
 void moveToCenter(QWidget*);
 
+//! Copies of entities which are made in a background thread and passed to a manager
+template<typename T>
+struct Snapshot
+{
+    ~Snapshot()
+    {
+        for (auto iter = entities.begin(); iter != entities.end(); ++iter)
+            delete iter->second;
+    }
+    std::unordered_map<DataIDType, T*> entities;
+    HierarchyTree hierarchy;
+};
+
 ManagersFactory::ManagersFactory(Project& project, QString& lastPath, QSettings& settings, QWidget* parent)
     : mProject(project)
     , mLastPath(lastPath)
@@ -26,6 +42,13 @@ ManagersFactory::ManagersFactory(Project& project, QString& lastPath, QSettings&
 
 ManagersFactory::~ManagersFactory()
 {
+    // Copying must be finished before the project is destroyed
+    for (QThread* pThread : mPreparingThreads)
+    {
+        pThread->wait();
+        delete pThread;
+    }
+    mPreparingThreads.clear();
     for (auto iter = mManagers.begin(); iter != mManagers.end(); ++iter)
         delete iter->second;
     mManagers.clear();
@@ -47,21 +70,46 @@ bool ManagersFactory::createManager(AbstractManager::ManagerType type)
     {
     case AbstractManager::kDataObjects:
     {
-        DataObjectsManager* pDataObjectManager = new DataObjectsManager(mProject.cloneDataObjects(), mProject.cloneHierarchyDataObjects(),
-                                                                        mLastPath, mSettings, mpParent);
-        specifyConnections(pDataObjectManager);
-        pManager = pDataObjectManager;
+        DataObjectsManager* pDataObjectsManager = new DataObjectsManager(mLastPath, mSettings, mpParent);
+        specifyConnections(pDataObjectsManager);
+        QSharedPointer<Snapshot<AbstractDataObject>> pSnapshot(new Snapshot<AbstractDataObject>);
+        prepareContent(pDataObjectsManager, [this, pSnapshot]()
+        {
+            mProject.snapshotDataObjects(pSnapshot->entities, pSnapshot->hierarchy);
+        },
+        [pDataObjectsManager, pSnapshot]()
+        {
+            pDataObjectsManager->setContent(std::move(pSnapshot->entities), std::move(pSnapshot->hierarchy));
+            pSnapshot->entities.clear();
+        });
+        pManager = pDataObjectsManager;
         break;
     }
     case AbstractManager::kRodComponents:
     {
         RodComponentsManager* pRodComponentsManager = new RodComponentsManager(mProject.mDataObjects, mProject.mHierarchyDataObjects,
-                                                                               mProject.cloneRodComponents(), mProject.cloneHierarchyRodComponents(),
                                                                                mLastPath, mSettings, mpParent);
         specifyConnections(pRodComponentsManager);
+        QSharedPointer<Snapshot<AbstractRodComponent>> pSnapshot(new Snapshot<AbstractRodComponent>);
+        prepareContent(pRodComponentsManager, [this, pSnapshot]()
+        {
+            mProject.snapshotRodComponents(pSnapshot->entities, pSnapshot->hierarchy);
+        },
+        [pRodComponentsManager, pSnapshot]()
+        {
+            pRodComponentsManager->setContent(std::move(pSnapshot->entities), std::move(pSnapshot->hierarchy));
+            pSnapshot->entities.clear();
+        });
         pManager = pRodComponentsManager;
         break;
     }
+    case AbstractManager::kRodConstructor:
+    {
+        RodConstructorManager* pRodConstructorManager = new RodConstructorManager(mProject.mRodComponents, mLastPath, mSettings, mpParent);
+        specifyConnections(pRodConstructorManager);
+        pManager = pRodConstructorManager;
+        break;
+    }
     default:
         return false;
     }
@@ -73,6 +121,32 @@ bool ManagersFactory::createManager(AbstractManager::ManagerType type)
     return true;
 }
 
+/*!
+ * \brief Copy entities of the project in a background thread and pass them to a manager when they are ready
+ *
+ * The manager is shown in the loading state meanwhile. The project locks each entity only while it is being copied,
+ * so that it can be modified in the main thread meanwhile.
+ * If the manager is closed before the copying is finished, the copies are just destroyed.
+ */
+void ManagersFactory::prepareContent(AbstractManager* pManager, std::function<void()> const& funPrepare,
+                                     std::function<void()> const& funPopulate)
+{
+    pManager->setLoading(true);
+    QThread* pThread = QThread::create(funPrepare);
+    mPreparingThreads.insert(pThread);
+    connect(pThread, &QThread::finished, pManager, [pManager, funPopulate]()
+    {
+        pManager->setLoading(false);
+        funPopulate();
+    });
+    connect(pThread, &QThread::finished, this, [this, pThread]()
+    {
+        mPreparingThreads.erase(pThread);
+        pThread->deleteLater();
+    });
+    pThread->start();
+}
+
 //! Destroy a manager by given type
 bool ManagersFactory::deleteManager(AbstractManager::ManagerType type)
 {
@@ -104,11 +178,16 @@ AbstractManager* ManagersFactory::manager(AbstractManager::ManagerType type)
 //! Specify connections of the manager of rod components
 void ManagersFactory::specifyConnections(RodComponentsManager* pManager)
 {
-    connect(pManager, &RodComponentsManager::applied, &mProject, &Project::setRodComponents);
+    connect(pManager, &RodComponentsManager::applied, &mProject, &Project::applyRodComponents);
     connect(&mProject, &Project::dataObjectsSubstituted,
             pManager, &RodComponentsManager::resolveRodComponentsReferences, Qt::DirectConnection);
-    connect(&mProject, &Project::projectHierarchyChanged, pManager, &RodComponentsManager::updateDataObjects);
-    connect(&mProject, &Project::propertiesDataObjectsChanged, pManager, &RodComponentsManager::updateDataObjects);
+    connect(&mProject, &Project::projectHierarchyChanged, pManager, [pManager]()
+    {
+        DataChangeSet changeSet;
+        changeSet.setHierarchyChanged();
+        pManager->updateDataObjects(changeSet);
+    });
+    connect(&mProject, &Project::entitiesChanged, pManager, &RodComponentsManager::updateDataObjects);
     // Enable interactions between the managers of data objects and rod components
     connect(pManager, &RodComponentsManager::editDataObjectRequested, [this](DataIDType id)
     {
@@ -126,5 +205,12 @@ void ManagersFactory::specifyConnections(RodComponentsManager* pManager)
 //! Specify connections of the manager of data objects
 void ManagersFactory::specifyConnections(DataObjectsManager* pManager)
 {
-    connect(pManager, &DataObjectsManager::applied, &mProject, &Project::setDataObjects);
+    connect(pManager, &DataObjectsManager::applied, &mProject, &Project::applyDataObjects);
+}
+
+//! Specify connections of the manager to construct rods
+void ManagersFactory::specifyConnections(RodConstructorManager* pManager)
+{
+    connect(&mProject, &Project::rodComponentsSubstituted, pManager, &RodConstructorManager::updateRodComponents);
+    connect(&mProject, &Project::propertiesRodComponentsChanged, pManager, &RodConstructorManager::updateRodComponents);
 }
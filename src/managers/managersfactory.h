@@ -9,10 +9,13 @@
 #define MANAGERSFACTORY_H
 
 #include <QObject>
+#include <functional>
+#include <unordered_set>
 #include "abstractmanager.h"
 
 QT_BEGIN_NAMESPACE
 class QSettings;
+class QThread;
 QT_END_NAMESPACE
 
 namespace QRS
@@ -28,6 +31,7 @@ namespace Managers
 
 class DataObjectsManager;
 class RodComponentsManager;
+class RodConstructorManager;
 
 //! Factory to create managers which utilize and modify project data
 class ManagersFactory : public QObject
@@ -44,6 +48,8 @@ public:
 private:
     void specifyConnections(DataObjectsManager* pManager);
     void specifyConnections(RodComponentsManager* pManager);
+    void specifyConnections(RodConstructorManager* pManager);
+    void prepareContent(AbstractManager* pManager, std::function<void()> const& funPrepare, std::function<void()> const& funPopulate);
 
 private:
     Core::Project& mProject;
@@ -51,6 +57,8 @@ private:
     QSettings& mSettings;
     QWidget* mpParent;
     std::unordered_map<AbstractManager::ManagerType, AbstractManager*> mManagers;
+    //! Threads which copy project entities for managers
+    std::unordered_set<QThread*> mPreparingThreads;
 };
 
 }
@@ -31,6 +31,7 @@
 #include "managers/mechanicalrodcomponentwidget.h"
 #include "models/hierarchy/dataobjectshierarchymodel.h"
 #include "models/hierarchy/rodcomponentshierarchymodel.h"
+#include "models/hierarchy/hierarchyfiltermodel.h"
 
 using ads::CDockManager;
 using ads::CDockWidget;
@@ -46,13 +47,10 @@ QWidget* addToolbarHeader(QToolBar* pToolBar, QString const& name);
 AbstractRodComponentWidget* createRodComponentWidget(AbstractRodComponent* pRodComponent, ads::CDockWidget* pDockWidget);
 
 RodComponentsManager::RodComponentsManager(DataObjects& dataObjects, HierarchyTree& hieararchyDataObjects,
-                                           RodComponents&& rodComponents, HierarchyTree&& hierarchyRodComponents,
                                            QString& lastPath, QSettings& settings, QWidget* parent)
     : AbstractManager(lastPath, settings, kRodComponents, "RodComponentsManager", parent)
     , mDataObjects(dataObjects)
     , mHierarchyDataObjects(hieararchyDataObjects)
-    , mRodComponents(std::move(rodComponents))
-    , mHierarchyRodComponents(std::move(hierarchyRodComponents))
 {
     setWindowTitle("Rod Components Manager[*]");
     setGeometry(0, 0, 700, 700);
@@ -65,11 +63,29 @@ RodComponentsManager::RodComponentsManager(DataObjects& dataObjects, HierarchyTr
 
 RodComponentsManager::~RodComponentsManager()
 {
+    delete mpRecordedRodComponent;
     for (auto iter = mRodComponents.begin(); iter != mRodComponents.end(); ++iter)
         delete iter->second;
     mRodComponents.clear();
 }
 
+/*!
+ * \brief Set copies of rod components to modify
+ *
+ * The copies are made while the manager is already shown, so the data objects could be changed since then.
+ * That is why references of the components are resolved again.
+ */
+void RodComponentsManager::setContent(RodComponents&& rodComponents, HierarchyTree&& hierarchyRodComponents)
+{
+    for (auto iter = mRodComponents.begin(); iter != mRodComponents.end(); ++iter)
+        delete iter->second;
+    mRodComponents = std::move(rodComponents);
+    mHierarchyRodComponents = std::move(hierarchyRodComponents);
+    resolveRodComponentsReferences();
+    mpTreeRodComponentsModel->updateContent();
+    mEditHistory.clear();
+}
+
 //! Create all the widgets
 void RodComponentsManager::createContent()
 {
@@ -109,8 +125,32 @@ CDockWidget* RodComponentsManager::createHierarchyRodComponentsWidget()
     // Hierarchy model
     mpTreeRodComponentsModel = new RodComponentsHierarchyModel(mRodComponents, mHierarchyRodComponents,
                                                                "rodcomponentsmanager/hierarchy", mpTreeRodComponents);
-    mpTreeRodComponents->setModel(mpTreeRodComponentsModel);
-    connect(mpTreeRodComponentsModel, &RodComponentsHierarchyModel::hierarchyChanged, [this]() { setWindowModified(true); });
+    HierarchyFilterModel* pFilterModel = new HierarchyFilterModel(mpTreeRodComponentsModel, mpTreeRodComponents);
+    mpTreeRodComponents->setModel(pFilterModel);
+    mpTreeRodComponentsModel->setDeltaRecorded(true);
+    QToolBar* pToolBar = pDockWidget->createDefaultToolBar();
+    pToolBar->addWidget(createSearchEdit(pFilterModel));
+    connect(mpTreeRodComponentsModel, &RodComponentsHierarchyModel::hierarchyChanged, [this]()
+    {
+        mChangeSet.setHierarchyChanged();
+        recordHierarchyEdit();
+        setWindowModified(true);
+    });
+    connect(mpTreeRodComponentsModel, &RodComponentsHierarchyModel::objectRenamed, [this](DataIDType id)
+    {
+        mChangeSet.setRenamed(id);
+        // Renaming is not registered as an edit, so the recorded state must not revert it
+        if (mpRecordedRodComponent && mpRecordedRodComponent->id() == id)
+            mpRecordedRodComponent->setName(mRodComponents[id]->name());
+        setWindowModified(true);
+    });
+    connect(mpTreeRodComponentsModel, &RodComponentsHierarchyModel::objectRemoved, [this](DataIDType id)
+    {
+        mChangeSet.setRemoved(id);
+        // The component is about to be deleted, so its copy is kept to be restored
+        mRemovedRodComponents.push_back(mRodComponents.at(id)->clone());
+        setWindowModified(true);
+    });
     connect(mpTreeRodComponentsModel, &RodComponentsHierarchyModel::selected,
             this, &RodComponentsManager::representRodComponent);
     connect(mpTreeRodComponents->selectionModel(), &QItemSelectionModel::selectionChanged,
@@ -136,7 +176,10 @@ ads::CDockWidget* RodComponentsManager::createHierarchyDataObjectsWidget()
     // Hierarchy model
     mpTreeDataObjectsModel = new DataObjectsHierarchyModel(mDataObjects, mHierarchyDataObjects,
                                                            skDataObjectsMimeType, pTreeDataObjects);
-    pTreeDataObjects->setModel(mpTreeDataObjectsModel);
+    HierarchyFilterModel* pFilterModel = new HierarchyFilterModel(mpTreeDataObjectsModel, pTreeDataObjects);
+    pTreeDataObjects->setModel(pFilterModel);
+    QToolBar* pToolBar = pDockWidget->createDefaultToolBar();
+    pToolBar->addWidget(createSearchEdit(pFilterModel));
     return pDockWidget;
 }
 
@@ -168,16 +211,19 @@ void RodComponentsManager::selectRodComponent(int iRow)
     mpTreeRodComponentsModel->selectItem(iRow);
 }
 
-//! Update the representation of data objects
-void RodComponentsManager::updateDataObjects()
+//! Update the representation of data objects and index the names affected by the changes
+void RodComponentsManager::updateDataObjects(DataChangeSet const& changeSet)
 {
-    mpTreeDataObjectsModel->updateContent();
+    if (changeSet.isEmpty())
+        return;
+    mpTreeDataObjectsModel->updateContent(changeSet);
 }
 
 //! Apply all the changes made by user
 void RodComponentsManager::apply()
 {
-    emit applied(mRodComponents, mHierarchyRodComponents);
+    emit applied(mRodComponents, mHierarchyRodComponents, mChangeSet);
+    mChangeSet.clear();
     setWindowModified(false);
     qInfo() << tr("Rod components were modified by means of the manager");
 }
@@ -257,7 +303,6 @@ void RodComponentsManager::resolveRodComponentsReferences()
         pRodComponent = iter.second;
         pRodComponent->resolveReferences(mDataObjects);
     }
-    updateDataObjects();
     mpTreeRodComponentsModel->retrieveSelectedItem();
 }
 
@@ -266,8 +311,17 @@ void RodComponentsManager::emplaceRodComponent(AbstractRodComponent* pRodCompone
 {
     DataIDType id = pRodComponent->id();
     mRodComponents.emplace(id, pRodComponent);
-    mHierarchyRodComponents.appendNode(new HierarchyNode(HierarchyNode::NodeType::kObject, id));
-    mpTreeRodComponentsModel->updateContent();
+    HierarchyNode* pNode = new HierarchyNode(HierarchyNode::NodeType::kObject, id);
+    mHierarchyRodComponents.appendNode(pNode);
+    HierarchyDelta hierarchy;
+    hierarchy.recordCreated(pNode);
+    hierarchy.recordAfter();
+    mEditHistory.pushStructure(mRodComponents, std::move(hierarchy), {pRodComponent});
+    DataChangeSet changeSet;
+    changeSet.setCreated(id);
+    changeSet.setHierarchyChanged();
+    mChangeSet.append(changeSet);
+    mpTreeRodComponentsModel->updateContent(changeSet);
     setWindowModified(true);
 }
 
@@ -278,13 +332,19 @@ void RodComponentsManager::representRodComponent(Core::DataIDType id)
     if (!mRodComponents.contains(id))
         return;
     AbstractRodComponent* pRodComponent = mRodComponents[id];
-    std::function<void()> funModified = [this]() { setWindowModified(true); };
+    std::function<void()> funModified = [this, id]()
+    {
+        mChangeSet.setModified(id);
+        recordRodComponentEdit(id);
+        setWindowModified(true);
+    };
     AbstractRodComponentWidget* pRodComponentWidget = createRodComponentWidget(pRodComponent, mpComponentDockWidget);
     if (pRodComponentWidget)
     {
         connect(pRodComponentWidget, &AbstractRodComponentWidget::modified, funModified);
         connect(pRodComponentWidget, &AbstractRodComponentWidget::editDataObjectRequested, this, &RodComponentsManager::editDataObjectRequested);
         mpComponentDockWidget->setWidget(pRodComponentWidget);
+        mpRecordedRodComponent = pRodComponent->clone();
     }
 }
 
@@ -293,6 +353,53 @@ void RodComponentsManager::clearRodComponentRepresentation()
 {
     QWidget* pWidget = mpComponentDockWidget->takeWidget();
     delete pWidget;
+    delete mpRecordedRodComponent;
+    mpRecordedRodComponent = nullptr;
+}
+
+//! Register a modification of the represented component. The history takes its previous state
+void RodComponentsManager::recordRodComponentEdit(DataIDType id)
+{
+    if (!mpRecordedRodComponent || mpRecordedRodComponent->id() != id)
+        return;
+    mEditHistory.pushRodComponent(mRodComponents, mpRecordedRodComponent);
+    mpRecordedRodComponent = mRodComponents[id]->clone();
+}
+
+//! Register a reorganization of the hierarchy made through the model together with the components removed
+void RodComponentsManager::recordHierarchyEdit()
+{
+    mEditHistory.pushStructure(mRodComponents, mpTreeRodComponentsModel->takeDelta(), {}, mRemovedRodComponents);
+    mRemovedRodComponents.clear();
+}
+
+//! Revert the last edit
+void RodComponentsManager::undo()
+{
+    DataChangeSet changeSet;
+    if (mEditHistory.undo(changeSet))
+        representEditHistoryStep(changeSet);
+}
+
+//! Repeat the last edit reverted
+void RodComponentsManager::redo()
+{
+    DataChangeSet changeSet;
+    if (mEditHistory.redo(changeSet))
+        representEditHistoryStep(changeSet);
+}
+
+//! Register the changes made by undoing or redoing an edit and represent the affected components again
+void RodComponentsManager::representEditHistoryStep(DataChangeSet const& changeSet)
+{
+    DataIDType representedID = mpRecordedRodComponent ? mpRecordedRodComponent->id() : 0;
+    mChangeSet.append(changeSet);
+    // Widgets refer to the components which could be substituted
+    if (changeSet.isStructureChanged())
+        mpTreeRodComponentsModel->updateContent(changeSet);
+    else if (changeSet.modifiedIDs().contains(representedID))
+        representRodComponent(representedID);
+    setWindowModified(true);
 }
 
 //! Create a menu to choose types of components to construct
@@ -388,6 +495,10 @@ QWidget* RodComponentsManager::makeModificationToolBar()
     QAction* pAction = pToolBar->addAction(QIcon(":/icons/delete.svg"), tr("Remove"),
                                            mpTreeRodComponentsModel, &RodComponentsHierarchyModel::removeSelectedItems);
     pAction->setShortcut(Qt::Key_R);
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-undo.svg"), tr("Undo"), this, &RodComponentsManager::undo);
+    pAction->setShortcut(QKeySequence::Undo);
+    pAction = pToolBar->addAction(QIcon(":/icons/edit-redo.svg"), tr("Redo"), this, &RodComponentsManager::redo);
+    pAction->setShortcut(QKeySequence::Redo);
     pToolBar->setIconSize(skToolBarIconSize);
     setToolBarShortcutHints(pToolBar);
     return addToolbarHeader(pToolBar, "Modify");
@@ -11,6 +11,8 @@
 #include "managers/abstractmanager.h"
 #include "core/aliasdataset.h"
 #include "core/hierarchytree.h"
+#include "core/datachangeset.h"
+#include "core/edithistory.h"
 #include "core/abstractsectionrodcomponent.h"
 
 QT_BEGIN_NAMESPACE
@@ -41,14 +43,15 @@ class RodComponentsManager : public AbstractManager
 
 public:
     RodComponentsManager(Core::DataObjects& dataObjects, Core::HierarchyTree& hieararchyDataObjects,
-                         Core::RodComponents&& rodComponents, Core::HierarchyTree&& hierarchyRodComponents,
                          QString& lastPath, QSettings& settings, QWidget* parent = nullptr);
     ~RodComponentsManager();
+    void setContent(Core::RodComponents&& rodComponents, Core::HierarchyTree&& hierarchyRodComponents);
     void selectRodComponent(int iRow);
-    void updateDataObjects();
+    void updateDataObjects(Core::DataChangeSet const& changeSet);
 
 signals:
-    void applied(Core::RodComponents const& rodComponents, Core::HierarchyTree const& hierarchyRodComponents);
+    void applied(Core::RodComponents const& rodComponents, Core::HierarchyTree const& hierarchyRodComponents,
+                 Core::DataChangeSet const& changeSet);
     void editDataObjectRequested(Core::DataIDType id);
 
 public slots:
@@ -60,6 +63,8 @@ public slots:
     Core::AbstractRodComponent* addConstraint();
     Core::AbstractRodComponent* addMechanical();
     void resolveRodComponentsReferences();
+    void undo();
+    void redo();
 
 private:
     // Content
@@ -70,6 +75,10 @@ private:
     ads::CDockWidget* createHierarchyDataObjectsWidget();
     // Helpers
     void emplaceRodComponent(Core::AbstractRodComponent* pRodComponent);
+    // History
+    void recordHierarchyEdit();
+    void recordRodComponentEdit(Core::DataIDType id);
+    void representEditHistoryStep(Core::DataChangeSet const& changeSet);
     // Selection
     void representRodComponent(Core::DataIDType id);
     void clearRodComponentRepresentation();
@@ -93,6 +102,14 @@ private:
     // Rod components data
     Core::RodComponents mRodComponents;
     Core::HierarchyTree mHierarchyRodComponents;
+    //! Changes which have not been applied yet
+    Core::DataChangeSet mChangeSet;
+    //! Edits which can be undone
+    Core::EditHistory mEditHistory;
+    //! Copies of the components removed by the hierarchy model to be restored
+    std::vector<Core::AbstractRodComponent*> mRemovedRodComponents;
+    //! State of the represented component before its following modification
+    Core::AbstractRodComponent* mpRecordedRodComponent = nullptr;
     // Models
     HierarchyModels::DataObjectsHierarchyModel* mpTreeDataObjectsModel;
     HierarchyModels::RodComponentsHierarchyModel* mpTreeRodComponentsModel;
@@ -0,0 +1,237 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Definition of the RodConstructorManager class
+ */
+
+#include <QVBoxLayout>
+#include <QFormLayout>
+#include <QPushButton>
+#include <QComboBox>
+#include <QListWidget>
+#include <QSpinBox>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QLabel>
+#include <QElapsedTimer>
+#include <map>
+#include "DockManager.h"
+#include "DockWidget.h"
+#include "DockAreaWidget.h"
+
+#include "rodconstructormanager.h"
+
+using ads::CDockManager;
+using ads::CDockWidget;
+using ads::CDockAreaWidget;
+using namespace QRS::Core;
+using namespace QRS::Managers;
+
+//! Maximum number of stations which are represented in the table
+quint32 const skMaxNumRepresentedStations = 1000;
+
+RodConstructorManager::RodConstructorManager(RodComponents& rodComponents, QString& lastPath, QSettings& settings, QWidget* parent)
+    : AbstractManager(lastPath, settings, kRodConstructor, "RodConstructorManager", parent)
+    , mRodComponents(rodComponents)
+{
+    setWindowTitle("Rod Constructor Manager[*]");
+    setGeometry(0, 0, 700, 700);
+    setWindowModified(false);
+    createContent();
+    restoreSettings();
+    updateRodComponents();
+}
+
+//! Create all the widgets
+void RodConstructorManager::createContent()
+{
+    CDockAreaWidget* pArea = mpDockManager->addDockWidget(ads::CenterDockWidgetArea, createStationsDockWidget());
+    mpDockManager->addDockWidget(ads::LeftDockWidgetArea, createComponentsDockWidget(), pArea);
+    // Main layout
+    QVBoxLayout* pMainLayout = new QVBoxLayout(this);
+    pMainLayout->setContentsMargins(0, 0, 0, 0);
+    pMainLayout->setSpacing(0);
+    // Arrangement
+    pMainLayout->addWidget(mpDockManager);
+    pMainLayout->addLayout(createDialogControls());
+}
+
+//! Create a widget to choose components of a rod
+CDockWidget* RodConstructorManager::createComponentsDockWidget()
+{
+    CDockWidget* pDockWidget = new CDockWidget("Components");
+    pDockWidget->setFeature(CDockWidget::DockWidgetClosable, false);
+    QWidget* pWidget = new QWidget();
+    QFormLayout* pLayout = new QFormLayout(pWidget);
+    mpGeometryComboBox = new QComboBox();
+    mpSectionComboBox = new QComboBox();
+    mpMaterialComboBox = new QComboBox();
+    mpMechanicalComboBox = new QComboBox();
+    mpStartConstraintComboBox = new QComboBox();
+    mpEndConstraintComboBox = new QComboBox();
+    mpLoadsList = new QListWidget();
+    mpNumStationsSpinBox = new QSpinBox();
+    mpNumStationsSpinBox->setRange(2, 100000);
+    mpNumStationsSpinBox->setValue(RodDefinition().numStations);
+    // Frames are used only if the geometry has no rotation matrix
+    mpFrameTypeComboBox = new QComboBox();
+    mpFrameTypeComboBox->addItem(tr("Rotation-minimizing"), MovingFrames::kRotationMinimizing);
+    mpFrameTypeComboBox->addItem(tr("Frenet"), MovingFrames::kFrenet);
+    pLayout->addRow(tr("Geometry: "), mpGeometryComboBox);
+    pLayout->addRow(tr("Section: "), mpSectionComboBox);
+    pLayout->addRow(tr("Material: "), mpMaterialComboBox);
+    pLayout->addRow(tr("Mechanical: "), mpMechanicalComboBox);
+    pLayout->addRow(tr("Start constraint: "), mpStartConstraintComboBox);
+    pLayout->addRow(tr("End constraint: "), mpEndConstraintComboBox);
+    pLayout->addRow(tr("Loads: "), mpLoadsList);
+    pLayout->addRow(tr("Stations: "), mpNumStationsSpinBox);
+    pLayout->addRow(tr("Frames: "), mpFrameTypeComboBox);
+    pDockWidget->setWidget(pWidget);
+    return pDockWidget;
+}
+
+//! Create a table to represent the assembled rod
+CDockWidget* RodConstructorManager::createStationsDockWidget()
+{
+    CDockWidget* pDockWidget = new CDockWidget("Stations");
+    pDockWidget->setFeature(CDockWidget::DockWidgetClosable, false);
+    mpStationsTable = new QTableWidget();
+    mpStationsTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    QStringList const labels = {"Parameter", "Length", "X", "Y", "Z", "Curvature", "EA", "GJ", "EIx", "EIy", "ρA"};
+    mpStationsTable->setColumnCount(labels.size());
+    mpStationsTable->setHorizontalHeaderLabels(labels);
+    mpStationsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    pDockWidget->setWidget(mpStationsTable);
+    return pDockWidget;
+}
+
+//! Create the status of the last assembly and the button to run it
+QLayout* RodConstructorManager::createDialogControls()
+{
+    QHBoxLayout* pLayout = new QHBoxLayout();
+    pLayout->setContentsMargins(5, 0, 3, 5);
+    mpStatusLabel = new QLabel();
+    QPushButton* pAssembleButton = new QPushButton(QIcon(":/icons/rod.svg"), tr("Assemble"));
+    pAssembleButton->setAutoDefault(false);
+    connect(pAssembleButton, &QPushButton::clicked, this, &RodConstructorManager::apply);
+    pLayout->addWidget(mpStatusLabel);
+    pLayout->addStretch();
+    pLayout->addWidget(pAssembleButton);
+    return pLayout;
+}
+
+//! Assemble a rod from the chosen components
+void RodConstructorManager::apply()
+{
+    QElapsedTimer timer;
+    timer.start();
+    if (!mAssembly.assemble(definition(), mRodComponents))
+    {
+        mpStatusLabel->setText(mAssembly.errorMessage());
+        representBuffers();
+        qWarning() << tr("Rod cannot be assembled: %1").arg(mAssembly.errorMessage());
+        return;
+    }
+    qint64 elapsed = timer.nsecsElapsed() / 1000;
+    if (mAssembly.isCached())
+    {
+        mpStatusLabel->setText(tr("Components have not been changed since the previous assembly"));
+        return;
+    }
+    mpStatusLabel->setText(tr("Rod has been assembled at %1 stations in %2 μs").arg(mAssembly.buffers().numStations()).arg(elapsed));
+    representBuffers();
+}
+
+//! Refill the lists of components while keeping the chosen ones
+void RodConstructorManager::updateRodComponents()
+{
+    using Type = AbstractRodComponent::ComponentType;
+    fillComboBox(mpGeometryComboBox, Type::kGeometry, false);
+    fillComboBox(mpSectionComboBox, Type::kSection, true);
+    fillComboBox(mpMaterialComboBox, Type::kMaterial, true);
+    fillComboBox(mpMechanicalComboBox, Type::kMechanical, true);
+    fillComboBox(mpStartConstraintComboBox, Type::kConstraint, true);
+    fillComboBox(mpEndConstraintComboBox, Type::kConstraint, true);
+    // Loads
+    std::map<QString, DataIDType> loads;
+    for (auto const& [id, pRodComponent] : mRodComponents)
+    {
+        if (pRodComponent->componentType() == Type::kLoad)
+            loads.emplace(pRodComponent->name(), id);
+    }
+    QList<DataIDType> checkedIDs;
+    for (int i = 0; i != mpLoadsList->count(); ++i)
+    {
+        QListWidgetItem* pItem = mpLoadsList->item(i);
+        if (pItem->checkState() == Qt::Checked)
+            checkedIDs.push_back(pItem->data(Qt::UserRole).value<DataIDType>());
+    }
+    mpLoadsList->clear();
+    for (auto const& [name, id] : loads)
+    {
+        QListWidgetItem* pItem = new QListWidgetItem(QIcon(":/icons/load.svg"), name, mpLoadsList);
+        pItem->setData(Qt::UserRole, id);
+        pItem->setCheckState(checkedIDs.contains(id) ? Qt::Checked : Qt::Unchecked);
+    }
+}
+
+//! Set the components of the given type sorted by names as options of a combobox
+void RodConstructorManager::fillComboBox(QComboBox* pComboBox, AbstractRodComponent::ComponentType type, bool isOptional)
+{
+    std::map<QString, DataIDType> components;
+    for (auto const& [id, pRodComponent] : mRodComponents)
+    {
+        if (pRodComponent->componentType() == type)
+            components.emplace(pRodComponent->name(), id);
+    }
+    QVariant currentID = pComboBox->currentData();
+    pComboBox->clear();
+    if (isOptional)
+        pComboBox->addItem(tr("None"), (DataIDType)0);
+    for (auto const& [name, id] : components)
+        pComboBox->addItem(name, id);
+    int iCurrent = pComboBox->findData(currentID);
+    if (iCurrent >= 0)
+        pComboBox->setCurrentIndex(iCurrent);
+}
+
+//! Gather the chosen components
+RodDefinition RodConstructorManager::definition() const
+{
+    RodDefinition result;
+    result.geometryID = mpGeometryComboBox->currentData().value<DataIDType>();
+    result.sectionID = mpSectionComboBox->currentData().value<DataIDType>();
+    result.materialID = mpMaterialComboBox->currentData().value<DataIDType>();
+    result.mechanicalID = mpMechanicalComboBox->currentData().value<DataIDType>();
+    result.startConstraintID = mpStartConstraintComboBox->currentData().value<DataIDType>();
+    result.endConstraintID = mpEndConstraintComboBox->currentData().value<DataIDType>();
+    for (int i = 0; i != mpLoadsList->count(); ++i)
+    {
+        QListWidgetItem* pItem = mpLoadsList->item(i);
+        if (pItem->checkState() == Qt::Checked)
+            result.loadIDs.push_back(pItem->data(Qt::UserRole).value<DataIDType>());
+    }
+    result.numStations = mpNumStationsSpinBox->value();
+    result.frameType = (MovingFrames::FrameType)mpFrameTypeComboBox->currentData().toInt();
+    return result;
+}
+
+//! Show the sampled properties at stations
+void RodConstructorManager::representBuffers()
+{
+    RodBuffers const& buffers = mAssembly.buffers();
+    quint32 numRows = std::min(buffers.numStations(), skMaxNumRepresentedStations);
+    mpStationsTable->setRowCount(numRows);
+    for (quint32 i = 0; i != numRows; ++i)
+    {
+        double const values[] = {buffers.parameters[i], buffers.arcLengths[i],
+                                 buffers.positions[0][i], buffers.positions[1][i], buffers.positions[2][i],
+                                 buffers.curvatures[i],
+                                 buffers.tensionStiffness[i], buffers.torsionalStiffness[i],
+                                 buffers.bendingStiffnessX[i], buffers.bendingStiffnessY[i],
+                                 buffers.linearMassDensity[i]};
+        for (int j = 0; j != mpStationsTable->columnCount(); ++j)
+            mpStationsTable->setItem(i, j, new QTableWidgetItem(QString::number(values[j])));
+    }
+}
@@ -0,0 +1,77 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the RodConstructorManager class
+ */
+
+#ifndef RODCONSTRUCTORMANAGER_H
+#define RODCONSTRUCTORMANAGER_H
+
+#include "managers/abstractmanager.h"
+#include "core/aliasdataset.h"
+#include "core/abstractrodcomponent.h"
+#include "core/rodassembly.h"
+
+QT_BEGIN_NAMESPACE
+class QComboBox;
+class QListWidget;
+class QSpinBox;
+class QTableWidget;
+class QLabel;
+QT_END_NAMESPACE
+
+namespace ads
+{
+class CDockWidget;
+}
+
+namespace QRS::Managers
+{
+
+//! Manager to assemble a rod from the components of a project
+class RodConstructorManager : public AbstractManager
+{
+    Q_OBJECT
+
+public:
+    RodConstructorManager(Core::RodComponents& rodComponents, QString& lastPath, QSettings& settings, QWidget* parent = nullptr);
+    ~RodConstructorManager() = default;
+    Core::RodAssembly const& assembly() const { return mAssembly; }
+
+public slots:
+    void apply() override;
+    void updateRodComponents();
+
+private:
+    // Content
+    void createContent();
+    QLayout* createDialogControls();
+    ads::CDockWidget* createComponentsDockWidget();
+    ads::CDockWidget* createStationsDockWidget();
+    // Helpers
+    void fillComboBox(QComboBox* pComboBox, Core::AbstractRodComponent::ComponentType type, bool isOptional);
+    Core::RodDefinition definition() const;
+    void representBuffers();
+
+private:
+    // Data
+    Core::RodComponents& mRodComponents;
+    Core::RodAssembly mAssembly;
+    // Widgets
+    QComboBox* mpGeometryComboBox;
+    QComboBox* mpSectionComboBox;
+    QComboBox* mpMaterialComboBox;
+    QComboBox* mpMechanicalComboBox;
+    QComboBox* mpStartConstraintComboBox;
+    QComboBox* mpEndConstraintComboBox;
+    QListWidget* mpLoadsList;
+    QSpinBox* mpNumStationsSpinBox;
+    QComboBox* mpFrameTypeComboBox;
+    QTableWidget* mpStationsTable;
+    QLabel* mpStatusLabel;
+};
+
+}
+
+#endif // RODCONSTRUCTORMANAGER_H
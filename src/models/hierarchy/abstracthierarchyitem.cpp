@@ -5,6 +5,7 @@
  * \brief Definition of the AbstractHierarchyItem class
  */
 
+#include <QHash>
 #include "abstracthierarchyitem.h"
 #include "core/hierarchynode.h"
 
@@ -36,3 +37,26 @@ AbstractHierarchyItem* AbstractHierarchyItem::readPointer(QDataStream& in)
     in >> itemAddress;
     return reinterpret_cast<AbstractHierarchyItem*>(itemAddress);
 }
+
+//! Check whether the node has children which are not represented yet
+bool AbstractHierarchyItem::canPopulate() const
+{
+    return !mIsPopulated && mpNode && mpNode->hasChild();
+}
+
+//! Destroy the items of children, so that they can be populated again when needed
+void AbstractHierarchyItem::release()
+{
+    removeRows(0, rowCount());
+    mIsPopulated = false;
+}
+
+//! Retrieve an icon by path, so that all the items share the same instance
+QIcon const& AbstractHierarchyItem::cachedIcon(QString const& path)
+{
+    static QHash<QString, QIcon> sIcons;
+    auto iterator = sIcons.find(path);
+    if (iterator == sIcons.end())
+        iterator = sIcons.insert(path, QIcon(path));
+    return iterator.value();
+}
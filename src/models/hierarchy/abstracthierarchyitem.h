@@ -31,6 +31,7 @@ namespace HierarchyModels
 class AbstractHierarchyItem : public QStandardItem
 {
     friend class AbstractHierarchyModel;
+    friend class HierarchyFilterModel;
     friend class PropertiesModels::AbstractPropertiesModel;
 
 public:
@@ -44,9 +45,17 @@ public:
     void writePointer(QDataStream& out) const;
     static AbstractHierarchyItem* readPointer(QDataStream& in);
     virtual int type() const = 0;
+    virtual AbstractHierarchyItem* createDirectoryItem(Core::HierarchyNode* pNode) const = 0;
+    virtual void populate() = 0;
+    bool isPopulated() const { return mIsPopulated; }
+    bool canPopulate() const;
+    void release();
+    static QIcon const& cachedIcon(QString const& path);
 
 protected:
     Core::HierarchyNode* mpNode = nullptr;
+    //! Whether the children of the node have been already represented by items
+    bool mIsPopulated = false;
 };
 
 }
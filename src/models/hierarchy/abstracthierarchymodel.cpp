@@ -7,21 +7,25 @@
 
 #include <QTreeView>
 #include <QMimeData>
+#include <QAbstractProxyModel>
 #include <unordered_map>
 #include "abstracthierarchymodel.h"
 #include "core/hierarchynode.h"
+#include "core/hierarchytree.h"
 
 using namespace QRS::HierarchyModels;
 using namespace QRS::Core;
 
 static quint32 sNumFolders = 0;
 static const QString skBaseFolderName = "Group ";
+static const int skMaxNumCollapsedItems = 1024;
 
 AbstractHierarchyModel::AbstractHierarchyModel(QString const& mimeType, QTreeView* pView)
     : QStandardItemModel(pView)
     , mkMimeType(mimeType)
 {
-
+    if (pView)
+        connect(pView, &QTreeView::collapsed, this, &AbstractHierarchyModel::releaseCollapsedItem);
 }
 
 AbstractHierarchyModel::~AbstractHierarchyModel()
@@ -29,6 +33,72 @@ AbstractHierarchyModel::~AbstractHierarchyModel()
 
 }
 
+//! Check whether an item has children including the ones which have not been populated yet
+bool AbstractHierarchyModel::hasChildren(QModelIndex const& indexParent) const
+{
+    if (indexParent.isValid())
+    {
+        AbstractHierarchyItem* pItem = (AbstractHierarchyItem*)itemFromIndex(indexParent);
+        if (pItem->canPopulate())
+            return true;
+    }
+    return QStandardItemModel::hasChildren(indexParent);
+}
+
+//! Check whether the children of an item need to be created
+bool AbstractHierarchyModel::canFetchMore(QModelIndex const& indexParent) const
+{
+    if (!indexParent.isValid())
+        return false;
+    return ((AbstractHierarchyItem*)itemFromIndex(indexParent))->canPopulate();
+}
+
+//! Create items to represent the children of an item which is being expanded
+void AbstractHierarchyModel::fetchMore(QModelIndex const& indexParent)
+{
+    if (!indexParent.isValid())
+        return;
+    ((AbstractHierarchyItem*)itemFromIndex(indexParent))->populate();
+}
+
+/*!
+ * \brief Destroy the items of a collapsed subtree if it is large
+ *
+ * Items are created again once the subtree is expanded. Subtrees which contain selected items are kept,
+ * since the selected items can be referenced by other models.
+ */
+void AbstractHierarchyModel::releaseCollapsedItem(QModelIndex const& indexItem)
+{
+    QTreeView* pView = (QTreeView*)parent();
+    AbstractHierarchyItem* pItem = (AbstractHierarchyItem*)itemFromIndex(mapFromView(indexItem));
+    if (!pView || !pItem || !pItem->isPopulated())
+        return;
+    if (countItems(pItem) < skMaxNumCollapsedItems)
+        return;
+    QModelIndexList const indices = pView->selectionModel()->selectedIndexes();
+    for (QModelIndex const& index : indices)
+    {
+        QModelIndex indexParent = index.parent();
+        while (indexParent.isValid())
+        {
+            if (indexParent == indexItem)
+                return;
+            indexParent = indexParent.parent();
+        }
+    }
+    pItem->release();
+}
+
+//! Count all the items created inside a given one
+int AbstractHierarchyModel::countItems(QStandardItem const* pItem) const
+{
+    int numChildren = pItem->rowCount();
+    int numItems = numChildren;
+    for (int i = 0; i != numChildren; ++i)
+        numItems += countItems(pItem->child(i));
+    return numItems;
+}
+
 //! Specify allowed drop actions
 Qt::DropActions AbstractHierarchyModel::supportedDropActions() const
 {
@@ -86,29 +156,136 @@ bool AbstractHierarchyModel::dropMimeData(QMimeData const* pMimeData, Qt::DropAc
         isProcessed = processDropBetweenItems(stream, numItems, indexParent, row);
     else if (indexParent.isValid())
         isProcessed = processDropOnItem(stream, numItems, indexParent);
+    qDeleteAll(mDetachedItems);
+    mDetachedItems.clear();
     if (isProcessed)
-    {
-        updateContentExpanded();
         emit hierarchyChanged();
-    }
+    else
+        mDelta = HierarchyDelta();
     return false;
 }
 
+//! Retrieve the index of the view which corresponds to an index of the model, since the view can represent a filter
+QModelIndex AbstractHierarchyModel::mapToView(QModelIndex const& index) const
+{
+    QTreeView* pView = (QTreeView*)parent();
+    QAbstractProxyModel* pProxyModel = pView ? qobject_cast<QAbstractProxyModel*>(pView->model()) : nullptr;
+    if (pProxyModel && pProxyModel->sourceModel() == this)
+        return pProxyModel->mapFromSource(index);
+    return index;
+}
+
+//! Retrieve the index of the model which corresponds to an index of the view
+QModelIndex AbstractHierarchyModel::mapFromView(QModelIndex const& index) const
+{
+    QTreeView* pView = (QTreeView*)parent();
+    QAbstractProxyModel* pProxyModel = pView ? qobject_cast<QAbstractProxyModel*>(pView->model()) : nullptr;
+    if (pProxyModel && pProxyModel->sourceModel() == this)
+        return pProxyModel->mapToSource(index);
+    return index;
+}
+
+/*!
+ * \brief Collect the nodes of objects with given identifiers together with all their ancestors
+ *
+ * The ancestors are needed to keep the path to every found object in a filtered view
+ */
+void AbstractHierarchyModel::collectNodes(HierarchyNode* pRootNode, DataIDSet const& ids, NodesSet& nodes)
+{
+    if (!pRootNode || ids.empty())
+        return;
+    QList<HierarchyNode*> stack;
+    stack.push_back(pRootNode);
+    while (!stack.isEmpty())
+    {
+        HierarchyNode* pNode = stack.takeLast();
+        if (pNode->type() == HierarchyNode::NodeType::kObject && ids.contains(pNode->value().value<DataIDType>()))
+        {
+            HierarchyNode* pPathNode = pNode;
+            while (pPathNode && nodes.insert(pPathNode).second)
+                pPathNode = pPathNode->parent();
+        }
+        for (HierarchyNode* pChildNode = pNode->firstChild(); pChildNode; pChildNode = pChildNode->nextSibling())
+            stack.push_back(pChildNode);
+    }
+}
+
+//! Retrieve the item which holds a given one (the invisible root item for top-level ones)
+QStandardItem* AbstractHierarchyModel::parentItem(QStandardItem* pItem)
+{
+    QStandardItem* pParentItem = pItem->parent();
+    return pParentItem ? pParentItem : invisibleRootItem();
+}
+
 /*!
- * Since items are destroyed whenever the content is updated,
- * an expanded state of each directory is saved and then set again.
+ * \brief Move an item together with its children to another position
+ *
+ * The item is placed next to the neighbour item if it is specified, otherwise it is appended to the new parent.
+ * Only the expanded state of the moved subtree is preserved, so the rest of the view is left untouched.
  */
-void AbstractHierarchyModel::updateContentExpanded()
+void AbstractHierarchyModel::moveItem(AbstractHierarchyItem* pItem, QStandardItem* pNewParentItem,
+                                      QStandardItem* pNeighbourItem, bool isAfter)
 {
     QTreeView* pView = (QTreeView*)parent();
-    // Preserve an expanded state
     NodesState nodesState;
-    retrieveExpandedState(nodesState, invisibleRootItem()->index(), pView);
-    // Update data
-    updateContent();
-    // Restore an expanded state
-    const QSignalBlocker blocker(pView);
-    setExpandedState(nodesState, invisibleRootItem()->index(), pView);
+    if (pView)
+    {
+        QModelIndex indexItem = pItem->index();
+        nodesState.emplace(pItem->mpNode, pView->isExpanded(mapToView(indexItem)));
+        retrieveExpandedState(nodesState, indexItem, pView);
+    }
+    QStandardItem* pOldParentItem = parentItem(pItem);
+    QList<QStandardItem*> row = pOldParentItem->takeRow(pItem->row());
+    /*
+     The item will be created again when the new parent is populated.
+     It is not destroyed immediately, because other dropped items can still refer to its children.
+    */
+    if (pNewParentItem != invisibleRootItem() && !((AbstractHierarchyItem*)pNewParentItem)->isPopulated())
+    {
+        mDetachedItems.append(row);
+        return;
+    }
+    if (pNeighbourItem)
+        pNewParentItem->insertRow(pNeighbourItem->row() + (isAfter ? 1 : 0), row);
+    else
+        pNewParentItem->appendRow(row);
+    if (pView)
+    {
+        const QSignalBlocker blocker(pView);
+        QModelIndex indexItem = pItem->index();
+        setExpandedState(nodesState, indexItem, pView);
+        pView->setExpanded(mapToView(indexItem), nodesState[pItem->mpNode]);
+    }
+}
+
+//! Retrieve the moves of nodes made since the last call
+HierarchyDelta AbstractHierarchyModel::takeDelta()
+{
+    mDelta.recordAfter();
+    return std::move(mDelta);
+}
+
+//! Register the position of a node which is about to be moved or the one which has just been created
+void AbstractHierarchyModel::recordNode(HierarchyNode* pNode, bool isCreated)
+{
+    if (!mIsDeltaRecorded)
+        return;
+    if (isCreated)
+        mDelta.recordCreated(pNode);
+    else
+        mDelta.recordBefore(pNode);
+}
+
+//! Exclude a node from the hierarchy. If moves are recorded, the node is kept to be restored, otherwise it is deleted
+void AbstractHierarchyModel::removeNode(HierarchyNode* pNode)
+{
+    if (!mIsDeltaRecorded)
+    {
+        HierarchyTree::removeNode(pNode);
+        return;
+    }
+    mDelta.recordBefore(pNode);
+    pNode->place(nullptr, nullptr);
 }
 
 //! Merge several items into one entity
@@ -122,6 +299,8 @@ bool AbstractHierarchyModel::processDropOnItem(QDataStream& stream, int& numItem
     if (pDropItem->type() != pParentItem->type())
         return false;
     HierarchyNode* pParentNode = pParentItem->mpNode;
+    recordNode(pParentNode);
+    recordNode(pDropNode);
     HierarchyNode* pResNode = pParentNode->groupNodes(pDropNode);
     if (!pResNode)
         return false;
@@ -129,12 +308,20 @@ bool AbstractHierarchyModel::processDropOnItem(QDataStream& stream, int& numItem
      When an item is dropped on another item, we create a folder first and then insert both items into it.
      Otherwise, the item is inserted into the existing folder.
     */
+    AbstractHierarchyItem* pResItem = pParentItem;
     if (pParentNode != pResNode && pResNode->type() == HierarchyNode::NodeType::kDirectory)
     {
         ++sNumFolders;
         QVariant varFolder = skBaseFolderName + QString::number(sNumFolders);
         pResNode->value() = varFolder;
+        recordNode(pResNode, true);
+        // Substitute the target item with the folder in the same way as it was done for the nodes
+        pResItem = pParentItem->createDirectoryItem(pResNode);
+        pResItem->mIsPopulated = true;
+        parentItem(pParentItem)->insertRow(pParentItem->row(), pResItem);
+        moveItem(pParentItem, pResItem);
     }
+    moveItem(pDropItem, pResItem);
     // Insert other items into the created folder
     while (numItems > 0)
     {
@@ -142,7 +329,9 @@ bool AbstractHierarchyModel::processDropOnItem(QDataStream& stream, int& numItem
         if (pParentItem->type() == pDropItem->type())
         {
             pDropNode = pDropItem->mpNode;
-            pResNode->groupNodes(pDropNode);
+            recordNode(pDropNode);
+            if (pResNode->groupNodes(pDropNode))
+                moveItem(pDropItem, pResItem);
         }
         --numItems;
     }
@@ -171,14 +360,20 @@ bool AbstractHierarchyModel::processDropBetweenItems(QDataStream& stream, int& n
     if (pCurrentItem->type() != pDropItem->type())
         return false;
     HierarchyNode* pCurrentNode = pCurrentItem->mpNode;
+    // Root nodes cannot have siblings
+    if (!pCurrentNode->hasParent())
+        return false;
     bool isSuccess;
+    recordNode(pDropNode);
     if (isSetAfter)
         isSuccess = pCurrentNode->setAfter(pDropNode);
     else
         isSuccess = pCurrentNode->setBefore(pDropNode);
     if (!isSuccess)
         return false;
+    moveItem(pDropItem, pParentItem, pCurrentItem, isSetAfter);
     pCurrentNode = pDropNode;
+    AbstractHierarchyItem* pLastItem = pDropItem;
     // Set the rest of items after the last one
     while (numItems > 0)
     {
@@ -186,8 +381,13 @@ bool AbstractHierarchyModel::processDropBetweenItems(QDataStream& stream, int& n
         if (pCurrentItem->type() == pDropItem->type())
         {
             pDropNode = pDropItem->mpNode;
-            pCurrentNode->setAfter(pDropNode);
-            pCurrentNode = pDropNode;
+            recordNode(pDropNode);
+            if (pCurrentNode->setAfter(pDropNode))
+            {
+                moveItem(pDropItem, pParentItem, pLastItem, true);
+                pCurrentNode = pDropNode;
+                pLastItem = pDropItem;
+            }
         }
         --numItems;
     }
@@ -203,7 +403,7 @@ void AbstractHierarchyModel::retrieveExpandedState(NodesState& nodesState, QMode
         AbstractHierarchyItem* pCurrentItem = (AbstractHierarchyItem*)itemFromIndex(currentIndex);
         HierarchyNode* pNode = pCurrentItem->mpNode;
         if (pNode && pNode->type() == HierarchyNode::NodeType::kDirectory)
-            nodesState.emplace(pNode, pView->isExpanded(currentIndex));
+            nodesState.emplace(pNode, pView->isExpanded(mapToView(currentIndex)));
         if (hasChildren(currentIndex))
             retrieveExpandedState(nodesState, currentIndex, pView);
     }
@@ -221,6 +421,6 @@ void AbstractHierarchyModel::setExpandedState(NodesState& nodesState, QModelInde
         HierarchyNode* pNode = pCurrentItem->mpNode;
         bool isDir = pNode && pNode->type() == HierarchyNode::NodeType::kDirectory;
         if (isDir && nodesState.contains(pNode))
-            pView->setExpanded(currentIndex, nodesState[pNode]);
+            pView->setExpanded(mapToView(currentIndex), nodesState[pNode]);
     }
 }
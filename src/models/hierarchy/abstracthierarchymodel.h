@@ -9,7 +9,11 @@
 #define ABSTRACTHIERARCHYMODEL_H
 
 #include <QStandardItemModel>
+#include <unordered_map>
+#include <unordered_set>
 #include "abstracthierarchyitem.h"
+#include "core/datachangeset.h"
+#include "core/hierarchydelta.h"
 
 QT_BEGIN_NAMESPACE
 class QTreeView;
@@ -18,15 +22,11 @@ QT_END_NAMESPACE
 namespace QRS
 {
 
-namespace Core
-{
-class HierarchyNode;
-}
-
 namespace HierarchyModels
 {
 
 using NodesState = std::unordered_map<Core::HierarchyNode*, bool>;
+using NodesSet = std::unordered_set<Core::HierarchyNode*>;
 
 //! Hierarchy model which enables one to drag and drop elements of the same type
 class AbstractHierarchyModel : public QStandardItemModel
@@ -38,25 +38,57 @@ public:
     virtual ~AbstractHierarchyModel() = 0;
     virtual void updateContent() = 0;
     virtual void clearContent() = 0;
+    virtual NodesSet findNodes(QString const& pattern) const = 0;
     Qt::DropActions supportedDragActions() const override;
     Qt::DropActions supportedDropActions() const override;
     QStringList mimeTypes() const override;
     QMimeData* mimeData(const QModelIndexList& indicies) const override;
     bool dropMimeData(QMimeData const* pMimeData, Qt::DropAction action, int row, int column, const QModelIndex& parent) override;
+    bool hasChildren(QModelIndex const& indexParent = QModelIndex()) const override;
+    bool canFetchMore(QModelIndex const& indexParent) const override;
+    void fetchMore(QModelIndex const& indexParent) override;
+    void setDeltaRecorded(bool isDeltaRecorded) { mIsDeltaRecorded = isDeltaRecorded; }
+    Core::HierarchyDelta takeDelta();
 
 signals:
     //! Emitted when hierarchical elements get renamed, moved or deleted
     void hierarchyChanged();
+    //! Emitted when an object gets renamed
+    void objectRenamed(QRS::Core::DataIDType id);
+    //! Emitted when an object gets deleted
+    void objectRemoved(QRS::Core::DataIDType id);
+    //! Emitted when names of objects are indexed again, so that search results need to be updated
+    void namesIndexed();
+
+private slots:
+    void releaseCollapsedItem(QModelIndex const& indexItem);
 
 private:
+    int countItems(QStandardItem const* pItem) const;
     bool processDropOnItem(QDataStream& stream, int& numItems, QModelIndex const& indexParent);
     bool processDropBetweenItems(QDataStream& stream, int& numItems, QModelIndex const& indexParent, int row);
     void retrieveExpandedState(NodesState& nodesState, QModelIndex const& indexParent, QTreeView const* pView);
     void setExpandedState(NodesState& nodesState, QModelIndex const& indexParent, QTreeView* pView);
-    void updateContentExpanded();
+
+protected:
+    QModelIndex mapToView(QModelIndex const& index) const;
+    QModelIndex mapFromView(QModelIndex const& index) const;
+    static void collectNodes(Core::HierarchyNode* pRootNode, Core::DataIDSet const& ids, NodesSet& nodes);
+    QStandardItem* parentItem(QStandardItem* pItem);
+    void moveItem(AbstractHierarchyItem* pItem, QStandardItem* pNewParentItem, QStandardItem* pNeighbourItem = nullptr,
+                  bool isAfter = true);
+    void recordNode(Core::HierarchyNode* pNode, bool isCreated = false);
+    void removeNode(Core::HierarchyNode* pNode);
 
 protected:
     QString const mkMimeType;
+
+private:
+    //! Items which were moved to the parents without representation of children
+    QList<QStandardItem*> mDetachedItems;
+    //! Moves of nodes which have been made since the last time they were taken
+    Core::HierarchyDelta mDelta;
+    bool mIsDeltaRecorded = false;
 };
 
 }
@@ -7,6 +7,7 @@
 
 #include "dataobjectshierarchyitem.h"
 #include "core/abstractdataobject.h"
+#include "core/deriveddataobject.h"
 #include "core/hierarchytree.h"
 
 using namespace QRS::HierarchyModels;
@@ -18,14 +19,23 @@ QIcon getDataObjectIcon(AbstractDataObject::ObjectType type);
 DataObjectsHierarchyItem::DataObjectsHierarchyItem(DataObjects& dataObjects, HierarchyTree& hierarchyDataObjects,
                                                    QString const& text, QIcon const& icon)
     : AbstractHierarchyItem(icon, text, hierarchyDataObjects.root())
+    , mpDataObjects(&dataObjects)
 {
-    if (!mpNode->hasChild())
+
+}
+
+//! Represent the children of the node, if they have not been represented yet
+void DataObjectsHierarchyItem::populate()
+{
+    if (mIsPopulated)
         return;
-    appendItems(dataObjects, mpNode->firstChild());
+    mIsPopulated = true;
+    if (mpNode->hasChild())
+        appendItems(mpNode->firstChild());
 }
 
-//! Create items based on the position in the tree structure
-void DataObjectsHierarchyItem::appendItems(DataObjects& dataObjects, HierarchyNode* pNode)
+//! Create items of the nodes which are on the same level of the tree structure
+void DataObjectsHierarchyItem::appendItems(HierarchyNode* pNode)
 {
     HierarchyNode* pNextNode;
     while (pNode)
@@ -34,21 +44,17 @@ void DataObjectsHierarchyItem::appendItems(DataObjects& dataObjects, HierarchyNo
         switch (pNode->type())
         {
         case HierarchyNode::NodeType::kDirectory:
-            pItem = new DataObjectsHierarchyItem(pNode);
+            pItem = new DataObjectsHierarchyItem(pNode, *mpDataObjects);
             break;
         case HierarchyNode::NodeType::kObject:
             DataIDType id = pNode->value().value<DataIDType>();
-            if (!dataObjects.contains(id))
+            if (!mpDataObjects->contains(id))
                 return;
-            pItem = new DataObjectsHierarchyItem(pNode, dataObjects[id]);
+            pItem = new DataObjectsHierarchyItem(pNode, mpDataObjects->at(id));
             break;
         }
         if (pItem)
-        {
             appendRow(pItem);
-            if (pNode->hasChild())
-                pItem->appendItems(dataObjects, pNode->firstChild());
-        }
         pNextNode = pNode->nextSibling();
         pNode = pNextNode;
     }
@@ -56,37 +62,44 @@ void DataObjectsHierarchyItem::appendItems(DataObjects& dataObjects, HierarchyNo
 
 //! Construct an item to represent a data object
 DataObjectsHierarchyItem::DataObjectsHierarchyItem(HierarchyNode* pNode, AbstractDataObject* pDataObject)
-    : AbstractHierarchyItem(getDataObjectIcon(pDataObject->type()), pDataObject->name(), pNode)
+    : AbstractHierarchyItem(pDataObject->isDerived() ? cachedIcon(":/icons/link.svg") : getDataObjectIcon(pDataObject->type()),
+                            pDataObject->name(), pNode)
     , mpDataObject(pDataObject)
 {
+    mIsPopulated = true;
     setFlags(flags() | Qt::ItemIsEditable);
+    if (pDataObject->isDerived())
+        setToolTip(((DerivedDataObject*)pDataObject)->formula());
 }
 
 //! Construct an item to represent a directory
-DataObjectsHierarchyItem::DataObjectsHierarchyItem(HierarchyNode* pNode)
-    : AbstractHierarchyItem(QIcon(":/icons/folder.svg"), pNode->value().toString(), pNode)
+DataObjectsHierarchyItem::DataObjectsHierarchyItem(HierarchyNode* pNode, DataObjects& dataObjects)
+    : AbstractHierarchyItem(cachedIcon(":/icons/folder.svg"), pNode->value().toString(), pNode)
+    , mpDataObjects(&dataObjects)
 {
     setFlags(flags() | Qt::ItemIsEditable);
 }
 
+//! Create an item of the same type to represent a directory
+AbstractHierarchyItem* DataObjectsHierarchyItem::createDirectoryItem(HierarchyNode* pNode) const
+{
+    return new DataObjectsHierarchyItem(pNode, *mpDataObjects);
+}
+
 //! Helper function to assign an appropriate data object icon
 QIcon getDataObjectIcon(AbstractDataObject::ObjectType type)
 {
     switch (type)
     {
     case AbstractDataObject::ObjectType::kScalar:
-        return QIcon(":/icons/letter-s.svg");
+        return AbstractHierarchyItem::cachedIcon(":/icons/letter-s.svg");
     case AbstractDataObject::ObjectType::kVector:
-        return QIcon(":/icons/letter-v.svg");
+        return AbstractHierarchyItem::cachedIcon(":/icons/letter-v.svg");
     case AbstractDataObject::ObjectType::kMatrix:
-        return QIcon(":/icons/letter-m.svg");
+        return AbstractHierarchyItem::cachedIcon(":/icons/letter-m.svg");
     case AbstractDataObject::ObjectType::kSurface:
-        return QIcon(":/icons/letter-xy.svg");
+        return AbstractHierarchyItem::cachedIcon(":/icons/letter-xy.svg");
     default:
         return QIcon();
     }
 }
-
-
-
-
@@ -32,14 +32,17 @@ public:
     DataObjectsHierarchyItem(Core::DataObjects& dataObjects, Core::HierarchyTree& hierarchyDataObjects,
                              QString const& text = "Root", QIcon const& icon = QIcon());
     DataObjectsHierarchyItem(Core::HierarchyNode* pNode, Core::AbstractDataObject* pDataObject);
-    DataObjectsHierarchyItem(Core::HierarchyNode* pNode);
+    DataObjectsHierarchyItem(Core::HierarchyNode* pNode, Core::DataObjects& dataObjects);
     int type() const override { return AbstractHierarchyItem::ItemType::kDataObjects; }
+    AbstractHierarchyItem* createDirectoryItem(Core::HierarchyNode* pNode) const override;
+    void populate() override;
     Core::AbstractDataObject const* getDataObject() const { return mpDataObject; }
 
 private:
-    void appendItems(Core::DataObjects& dataObjects, Core::HierarchyNode* pNode);
+    void appendItems(Core::HierarchyNode* pNode);
 
 private:
+    Core::DataObjects* mpDataObjects = nullptr;
     Core::AbstractDataObject* mpDataObject = nullptr;
 };
 
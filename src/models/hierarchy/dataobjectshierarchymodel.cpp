@@ -25,14 +25,30 @@ DataObjectsHierarchyModel::DataObjectsHierarchyModel(DataObjects& dataObjects, H
     DataObjectsHierarchyModel::updateContent();
 }
 
-//! Update all the content
+//! Update all the content and index the names from scratch
 void DataObjectsHierarchyModel::updateContent()
+{
+    populate();
+    indexNames();
+}
+
+//! Update all the items and index only the names affected by the changes
+void DataObjectsHierarchyModel::updateContent(DataChangeSet const& changeSet)
+{
+    populate();
+    mNameIndex.update(changeSet, mDataObjects);
+    emit namesIndexed();
+}
+
+//! Recreate all the items
+void DataObjectsHierarchyModel::populate()
 {
     clearContent();
     if (isEmpty())
         return;
     QStandardItem* pRootItem = invisibleRootItem();
     AbstractHierarchyItem* pHierarchyItem = new DataObjectsHierarchyItem(mDataObjects, mHierarchyDataObjects);
+    pHierarchyItem->populate();
     int nRows = pHierarchyItem->rowCount();
     QList<QStandardItem*> items(nRows);
     for (int i = 0; i != nRows; ++i)
@@ -41,6 +57,24 @@ void DataObjectsHierarchyModel::updateContent()
     delete pHierarchyItem;
 }
 
+//! Represent the nodes which have just been appended to the root of the hierarchy
+void DataObjectsHierarchyModel::appendItems(std::vector<HierarchyNode*> const& nodes)
+{
+    QList<QStandardItem*> items;
+    items.reserve(nodes.size());
+    for (HierarchyNode* pNode : nodes)
+    {
+        DataIDType id = pNode->value().value<DataIDType>();
+        auto iter = mDataObjects.find(id);
+        if (iter == mDataObjects.end())
+            continue;
+        items.push_back(new DataObjectsHierarchyItem(pNode, iter->second));
+        mNameIndex.insert(id, iter->second->name());
+    }
+    invisibleRootItem()->appendRows(items);
+    emit namesIndexed();
+}
+
 //! Clear all the items
 void DataObjectsHierarchyModel::clearContent()
 {
@@ -48,6 +82,23 @@ void DataObjectsHierarchyModel::clearContent()
     emit selectionCleared();
 }
 
+//! Index the names of all the data objects to search them
+void DataObjectsHierarchyModel::indexNames()
+{
+    mNameIndex.clear();
+    for (auto const& [id, pDataObject] : mDataObjects)
+        mNameIndex.insert(id, pDataObject->name());
+    emit namesIndexed();
+}
+
+//! Find the nodes of the data objects whose names contain a pattern
+NodesSet DataObjectsHierarchyModel::findNodes(QString const& pattern) const
+{
+    NodesSet nodes;
+    collectNodes(mHierarchyDataObjects.root(), mNameIndex.find(pattern), nodes);
+    return nodes;
+}
+
 //! Check if there are data objcects to represent
 inline bool DataObjectsHierarchyModel::isEmpty() const
 {
@@ -60,10 +111,19 @@ void DataObjectsHierarchyModel::renameItem(QStandardItem* pStandardItem)
     DataObjectsHierarchyItem* pItem = (DataObjectsHierarchyItem*)pStandardItem;
     QString newName = pItem->data(Qt::DisplayRole).toString();
     if (pItem->mpDataObject)
+    {
+        QString oldName = pItem->mpDataObject->name();
         pItem->mpDataObject->setName(newName);
+        mNameIndex.rename(pItem->mpDataObject->id(), oldName, newName);
+        emit objectRenamed(pItem->mpDataObject->id());
+        emit namesIndexed();
+    }
     else if (pItem->mpNode->type() == HierarchyNode::NodeType::kDirectory)
+    {
+        recordNode(pItem->mpNode);
         pItem->mpNode->value() = newName;
-    emit hierarchyChanged();
+        emit hierarchyChanged();
+    }
 }
 
 //! Select an item by row index
@@ -77,7 +137,7 @@ void DataObjectsHierarchyModel::selectItem(int iRow)
 //! Select an item by type and identifier
 void DataObjectsHierarchyModel::selectItemByID(DataIDType id)
 {
-    selectItem(findItemByID((DataObjectsHierarchyItem*)invisibleRootItem(), id));
+    selectItem(findItemByID(id));
 }
 
 //! Retrieve a selected data object
@@ -95,7 +155,7 @@ void DataObjectsHierarchyModel::retrieveSelectedItem()
         emit selectionCleared();
         return;
     }
-    DataObjectsHierarchyItem* pItem = (DataObjectsHierarchyItem*)itemFromIndex(indices[0]);
+    DataObjectsHierarchyItem* pItem = (DataObjectsHierarchyItem*)itemFromIndex(mapFromView(indices[0]));
     AbstractDataObject* pDataObject = pItem->mpDataObject;
     if (pDataObject)
         emit selected(pDataObject->id());
@@ -103,6 +163,21 @@ void DataObjectsHierarchyModel::retrieveSelectedItem()
         emit selectionCleared();
 }
 
+//! Retrieve identifiers of all the selected data objects. Directories are skipped
+QList<DataIDType> DataObjectsHierarchyModel::selectedIDs() const
+{
+    QList<DataIDType> ids;
+    QTreeView* pView = (QTreeView*)parent();
+    QModelIndexList const indices = pView->selectionModel()->selectedIndexes();
+    for (QModelIndex const& index : indices)
+    {
+        DataObjectsHierarchyItem* pItem = (DataObjectsHierarchyItem*)itemFromIndex(mapFromView(index));
+        if (pItem && pItem->mpDataObject)
+            ids.push_back(pItem->mpDataObject->id());
+    }
+    return ids;
+}
+
 //! Remove data objects under selection
 void DataObjectsHierarchyModel::removeSelectedItems()
 {
@@ -110,39 +185,71 @@ void DataObjectsHierarchyModel::removeSelectedItems()
     if (pView->selectionModel()->selection().isEmpty())
         return;
     QModelIndexList indices = pView->selectionModel()->selectedIndexes();
+    // Items of nested selected nodes are destroyed together with their parents
+    QList<QPersistentModelIndex> persistentIndices;
     for (QModelIndex const& index : indices)
+        persistentIndices.push_back(index);
+    for (QPersistentModelIndex const& index : persistentIndices)
     {
-        DataObjectsHierarchyItem* pItem = (DataObjectsHierarchyItem*)itemFromIndex(index);
+        if (!index.isValid())
+            continue;
+        DataObjectsHierarchyItem* pItem = (DataObjectsHierarchyItem*)itemFromIndex(mapFromView(index));
         AbstractDataObject* pDataObject = pItem->mpDataObject;
         if (pDataObject)
         {
-            mDataObjects.erase(pDataObject->id());
+            // Receivers can still access the object being removed
+            DataIDType id = pDataObject->id();
+            emit objectRemoved(id);
+            mDataObjects.erase(id);
             delete pDataObject;
+            mNameIndex.remove(id);
         }
-        mHierarchyDataObjects.removeNode(pItem->mpNode);
+        removeNode(pItem->mpNode);
+        parentItem(pItem)->removeRow(pItem->row());
     }
-    updateContent();
+    emit namesIndexed();
     emit hierarchyChanged();
     emit selectionCleared();
 }
 
-//! Find an item by identifier
-DataObjectsHierarchyItem* DataObjectsHierarchyModel::findItemByID(DataObjectsHierarchyItem* pItem, DataIDType const& id)
+/*!
+ * \brief Find an item by identifier
+ *
+ * The node is looked up in the tree first, and then only the items along the path to it are populated.
+ */
+DataObjectsHierarchyItem* DataObjectsHierarchyModel::findItemByID(DataIDType const& id)
 {
-    DataObjectsHierarchyItem* pFoundItem = nullptr;
-    DataObjectsHierarchyItem* pChildItem;
-    int numChildren = pItem->rowCount();
-    for (int i = 0; i != numChildren; ++i)
+    HierarchyNode* pNode = mHierarchyDataObjects.findNode(mHierarchyDataObjects.root(), HierarchyNode::NodeType::kObject, id);
+    if (!pNode)
+        return nullptr;
+    // The root node is represented by the invisible root item
+    QList<HierarchyNode*> path;
+    while (pNode->hasParent())
     {
-        pChildItem = (DataObjectsHierarchyItem*)pItem->child(i);
-        if (pChildItem->hasChildren())
-            pFoundItem = findItemByID(pChildItem, id);
-        if (pFoundItem)
-            return pFoundItem;
-        if (pChildItem->mpDataObject && pChildItem->mpDataObject->id() == id)
-            return pChildItem;
+        path.push_front(pNode);
+        pNode = pNode->parent();
+    }
+    QStandardItem* pCurrentItem = invisibleRootItem();
+    for (HierarchyNode* pPathNode : path)
+    {
+        if (pCurrentItem != invisibleRootItem())
+            ((DataObjectsHierarchyItem*)pCurrentItem)->populate();
+        DataObjectsHierarchyItem* pFoundItem = nullptr;
+        int numChildren = pCurrentItem->rowCount();
+        for (int i = 0; i != numChildren; ++i)
+        {
+            DataObjectsHierarchyItem* pChildItem = (DataObjectsHierarchyItem*)pCurrentItem->child(i);
+            if (pChildItem->mpNode == pPathNode)
+            {
+                pFoundItem = pChildItem;
+                break;
+            }
+        }
+        if (!pFoundItem)
+            return nullptr;
+        pCurrentItem = pFoundItem;
     }
-    return pFoundItem;
+    return (DataObjectsHierarchyItem*)pCurrentItem;
 }
 
 //! Select a specified item
@@ -156,11 +263,11 @@ void DataObjectsHierarchyModel::selectItem(DataObjectsHierarchyItem* pItem)
     QModelIndex parentIndex = selectionIndex.parent();
     while (parentIndex.isValid())
     {
-        pView->setExpanded(parentIndex, true);
+        pView->setExpanded(mapToView(parentIndex), true);
         parentIndex = parentIndex.parent();
     }
     // Process selection
-    pView->selectionModel()->select(selectionIndex, QItemSelectionModel::SelectionFlag::SelectCurrent);
+    pView->selectionModel()->select(mapToView(selectionIndex), QItemSelectionModel::SelectionFlag::SelectCurrent);
     AbstractDataObject const* pDataObject = pItem->mpDataObject;
     if (pDataObject)
         emit selected(pDataObject->id());
@@ -10,6 +10,7 @@
 
 #include "models/hierarchy/abstracthierarchymodel.h"
 #include "core/aliasdataset.h"
+#include "core/nameindex.h"
 
 namespace QRS
 {
@@ -33,10 +34,14 @@ public:
                               QString const& mimeType, QTreeView* pView = nullptr);
     ~DataObjectsHierarchyModel() = default;
     void updateContent() override;
+    void updateContent(Core::DataChangeSet const& changeSet);
     void clearContent() override;
+    void appendItems(std::vector<Core::HierarchyNode*> const& nodes);
+    NodesSet findNodes(QString const& pattern) const override;
     bool isEmpty() const;
     void selectItem(int iRow);
     void selectItemByID(Core::DataIDType id);
+    QList<Core::DataIDType> selectedIDs() const;
 
 signals:
     void selected(Core::DataIDType id);
@@ -50,12 +55,15 @@ private slots:
     void renameItem(QStandardItem* pStandardItem);
 
 private:
-    DataObjectsHierarchyItem* findItemByID(DataObjectsHierarchyItem* pItem, Core::DataIDType const& id);
+    void populate();
+    void indexNames();
+    DataObjectsHierarchyItem* findItemByID(Core::DataIDType const& id);
     void selectItem(DataObjectsHierarchyItem* pItem);
 
 private:
     Core::DataObjects& mDataObjects;
     Core::HierarchyTree& mHierarchyDataObjects;
+    Core::NameIndex mNameIndex;
 };
 
 }
@@ -0,0 +1,74 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Definition of the HierarchyFilterModel class
+ */
+
+#include <QTreeView>
+#include "hierarchyfiltermodel.h"
+
+using namespace QRS::HierarchyModels;
+using namespace QRS::Core;
+
+//! Maximum number of found nodes to expand the paths to them automatically
+static const int skMaxNumExpandedNodes = 512;
+
+HierarchyFilterModel::HierarchyFilterModel(AbstractHierarchyModel* pSourceModel, QTreeView* pView)
+    : QSortFilterProxyModel(pView)
+    , mpSourceModel(pSourceModel)
+{
+    setSourceModel(pSourceModel);
+    connect(pSourceModel, &AbstractHierarchyModel::namesIndexed, this, &HierarchyFilterModel::updateMatchedNodes);
+}
+
+//! Show only the objects whose names contain a pattern
+void HierarchyFilterModel::setPattern(QString const& pattern)
+{
+    QString trimmedPattern = pattern.trimmed();
+    if (mPattern == trimmedPattern)
+        return;
+    mPattern = trimmedPattern;
+    updateMatchedNodes();
+    if (!mPattern.isEmpty() && mMatchedNodes.size() <= skMaxNumExpandedNodes)
+        expandMatchedItems(QModelIndex());
+}
+
+//! Search for the objects again after their names have been changed
+void HierarchyFilterModel::updateMatchedNodes()
+{
+    if (mPattern.isEmpty())
+        mMatchedNodes.clear();
+    else
+        mMatchedNodes = mpSourceModel->findNodes(mPattern);
+    invalidateRowsFilter();
+}
+
+//! Accept the items which represent found objects or the directories which contain them
+bool HierarchyFilterModel::filterAcceptsRow(int iSourceRow, QModelIndex const& sourceParent) const
+{
+    if (mPattern.isEmpty())
+        return true;
+    QModelIndex sourceIndex = mpSourceModel->index(iSourceRow, 0, sourceParent);
+    AbstractHierarchyItem* pItem = (AbstractHierarchyItem*)mpSourceModel->itemFromIndex(sourceIndex);
+    return pItem && mMatchedNodes.contains(pItem->mpNode);
+}
+
+//! Expand the directories which contain found objects. Only the children of accepted items are populated
+void HierarchyFilterModel::expandMatchedItems(QModelIndex const& indexParent)
+{
+    QTreeView* pView = (QTreeView*)parent();
+    if (!pView)
+        return;
+    if (indexParent.isValid())
+    {
+        if (canFetchMore(indexParent))
+            fetchMore(indexParent);
+        if (rowCount(indexParent) == 0)
+            return;
+        pView->expand(indexParent);
+    }
+    int numRows = rowCount(indexParent);
+    for (int iRow = 0; iRow != numRows; ++iRow)
+        expandMatchedItems(index(iRow, 0, indexParent));
+}
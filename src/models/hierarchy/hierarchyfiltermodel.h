@@ -0,0 +1,51 @@
+/*!
+ * \file
+ * \author Pavel Lakiza
+ * \date August 2021
+ * \brief Declaration of the HierarchyFilterModel class
+ */
+
+#ifndef HIERARCHYFILTERMODEL_H
+#define HIERARCHYFILTERMODEL_H
+
+#include <QSortFilterProxyModel>
+#include "abstracthierarchymodel.h"
+
+namespace QRS::HierarchyModels
+{
+
+/*!
+ * \brief Filter which shows only the objects whose names contain a pattern together with their directories
+ *
+ * Matching nodes are found through the name index of the source model, so the items are neither rebuilt
+ * nor populated in advance. Items which are populated later are filtered as soon as they are inserted.
+ */
+class HierarchyFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    HierarchyFilterModel(AbstractHierarchyModel* pSourceModel, QTreeView* pView);
+    ~HierarchyFilterModel() = default;
+    QString const& pattern() const { return mPattern; }
+
+public slots:
+    void setPattern(QString const& pattern);
+
+protected:
+    bool filterAcceptsRow(int iSourceRow, QModelIndex const& sourceParent) const override;
+
+private:
+    void updateMatchedNodes();
+    void expandMatchedItems(QModelIndex const& indexParent);
+
+private:
+    AbstractHierarchyModel* mpSourceModel;
+    QString mPattern;
+    //! Nodes of found objects and their ancestors
+    NodesSet mMatchedNodes;
+};
+
+}
+
+#endif // HIERARCHYFILTERMODEL_H
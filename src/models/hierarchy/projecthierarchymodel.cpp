@@ -9,10 +9,15 @@
 #include "projecthierarchymodel.h"
 #include "dataobjectshierarchyitem.h"
 #include "rodcomponentshierarchyitem.h"
+#include "core/abstractdataobject.h"
+#include "core/abstractrodcomponent.h"
 
 using namespace QRS::HierarchyModels;
 using namespace QRS::Core;
 
+static const int skDataObjectsRow = 0;
+static const int skRodComponentsRow = 1;
+
 ProjectHierarchyModel::ProjectHierarchyModel(QString const& mimeType, QTreeView* pView)
     : AbstractHierarchyModel(mimeType, pView)
 {
@@ -26,10 +31,11 @@ void ProjectHierarchyModel::setProject(Project* pProject)
     updateContent();
 }
 
-//! Update all the content
+//! Update all the content and index the names from scratch
 void ProjectHierarchyModel::updateContent()
 {
     clearContent();
+    indexNames();
     if (!mpProject)
         return;
     QStandardItem* pRootItem = invisibleRootItem();
@@ -44,6 +50,151 @@ void ProjectHierarchyModel::clearContent()
     removeRows(0, rowCount());
 }
 
+//! Recreate the branch of data objects leaving the rest of the items untouched
+void ProjectHierarchyModel::updateDataObjects()
+{
+    if (!mpProject)
+        return;
+    updateNameIndices();
+    substituteRootItem(skDataObjectsRow, retrieveDataObjectsItem());
+}
+
+//! Recreate the branch of rod components leaving the rest of the items untouched
+void ProjectHierarchyModel::updateRodComponents()
+{
+    if (!mpProject)
+        return;
+    updateNameIndices();
+    substituteRootItem(skRodComponentsRow, retrieveRodComponentsItem());
+}
+
+//! Synchronize names of the items with the entities they represent without changing the structure
+void ProjectHierarchyModel::updateNames()
+{
+    updateItemNames(invisibleRootItem());
+    updateNameIndices();
+}
+
+//! Register the entities affected by the changes of the project to index their names at the next update
+void ProjectHierarchyModel::registerChanges(DataChangeSet const& dataObjectChanges, DataChangeSet const& rodComponentChanges)
+{
+    mDataObjectChanges.append(dataObjectChanges);
+    mRodComponentChanges.append(rodComponentChanges);
+}
+
+//! Index the names of all the entities of the project, which is done only when the project is set
+void ProjectHierarchyModel::indexNames()
+{
+    mDataObjectNameIndex.clear();
+    mRodComponentNameIndex.clear();
+    mDataObjectChanges.clear();
+    mRodComponentChanges.clear();
+    if (!mpProject)
+        return;
+    for (auto const& [id, pDataObject] : mpProject->mDataObjects)
+        mDataObjectNameIndex.insert(id, pDataObject->name());
+    for (auto const& [id, pRodComponent] : mpProject->mRodComponents)
+        mRodComponentNameIndex.insert(id, pRodComponent->name());
+    emit namesIndexed();
+}
+
+//! Index only the names of the entities registered since the last update
+void ProjectHierarchyModel::updateNameIndices()
+{
+    if (!mpProject || (mDataObjectChanges.isEmpty() && mRodComponentChanges.isEmpty()))
+        return;
+    mDataObjectNameIndex.update(mDataObjectChanges, mpProject->mDataObjects);
+    mRodComponentNameIndex.update(mRodComponentChanges, mpProject->mRodComponents);
+    mDataObjectChanges.clear();
+    mRodComponentChanges.clear();
+    emit namesIndexed();
+}
+
+//! Find the nodes of the data objects and rod components whose names contain a pattern
+NodesSet ProjectHierarchyModel::findNodes(QString const& pattern) const
+{
+    NodesSet nodes;
+    if (!mpProject)
+        return nodes;
+    collectNodes(mpProject->mHierarchyDataObjects.root(), mDataObjectNameIndex.find(pattern), nodes);
+    collectNodes(mpProject->mHierarchyRodComponents.root(), mRodComponentNameIndex.find(pattern), nodes);
+    return nodes;
+}
+
+/*!
+ * \brief Represent changes of the project at the next iteration of the event loop
+ *
+ * Changes which are reported several times during one iteration lead to a single refresh
+ */
+void ProjectHierarchyModel::scheduleUpdate(Project::Changes changes)
+{
+    bool isScheduled = mScheduledChanges != Project::kNoChanges;
+    mScheduledChanges |= changes;
+    if (!isScheduled && mScheduledChanges != Project::kNoChanges)
+        QMetaObject::invokeMethod(this, &ProjectHierarchyModel::processScheduledUpdate, Qt::QueuedConnection);
+}
+
+//! Refresh only the branches affected by the scheduled changes
+void ProjectHierarchyModel::processScheduledUpdate()
+{
+    Project::Changes changes = mScheduledChanges;
+    mScheduledChanges = Project::kNoChanges;
+    if (changes & Project::kDataObjectsSubstituted)
+        updateDataObjects();
+    if (changes & Project::kRodComponentsSubstituted)
+        updateRodComponents();
+    if (changes & (Project::kDataObjectNamesChanged | Project::kRodComponentNamesChanged))
+        updateNames();
+}
+
+//! Replace one of the top-level items
+void ProjectHierarchyModel::substituteRootItem(int iRow, AbstractHierarchyItem* pItem)
+{
+    QStandardItem* pRootItem = invisibleRootItem();
+    if (iRow >= pRootItem->rowCount())
+    {
+        delete pItem;
+        updateContent();
+        return;
+    }
+    pRootItem->removeRow(iRow);
+    pRootItem->insertRow(iRow, pItem);
+}
+
+//! Rename the children of a given item according to the entities they represent
+void ProjectHierarchyModel::updateItemNames(QStandardItem* pParentItem)
+{
+    int numChildren = pParentItem->rowCount();
+    for (int i = 0; i != numChildren; ++i)
+    {
+        QStandardItem* pChildItem = pParentItem->child(i);
+        QString const* pName = nullptr;
+        switch (pChildItem->type())
+        {
+        case AbstractHierarchyItem::ItemType::kDataObjects:
+        {
+            AbstractDataObject const* pDataObject = ((DataObjectsHierarchyItem*)pChildItem)->getDataObject();
+            if (pDataObject)
+                pName = &pDataObject->name();
+            break;
+        }
+        case AbstractHierarchyItem::ItemType::kRodComponents:
+        {
+            AbstractRodComponent const* pRodComponent = ((RodComponentsHierarchyItem*)pChildItem)->getRodComponent();
+            if (pRodComponent)
+                pName = &pRodComponent->name();
+            break;
+        }
+        default:
+            break;
+        }
+        if (pName && pChildItem->text() != *pName)
+            pChildItem->setText(*pName);
+        if (pChildItem->hasChildren())
+            updateItemNames(pChildItem);
+    }
+}
+
 //! Check if an item selection is correct and if it is not -- correct it
 void ProjectHierarchyModel::validateItemSelection()
 {
@@ -53,7 +204,7 @@ void ProjectHierarchyModel::validateItemSelection()
     QModelIndexList indices = selectionModel->selectedIndexes();
     if (indices.isEmpty())
         return;
-    AbstractHierarchyItem* pItem = (AbstractHierarchyItem*)itemFromIndex(indices[0]);
+    AbstractHierarchyItem* pItem = (AbstractHierarchyItem*)itemFromIndex(mapFromView(indices[0]));
     int mainType = pItem->type();
     int numSelection = indices.size();
     // Add the first item by default
@@ -62,11 +213,11 @@ void ProjectHierarchyModel::validateItemSelection()
     // Deselect the items which have types different to the main one
     for (int i = 1; i != numSelection; ++i)
     {
-        pItem = (AbstractHierarchyItem*)itemFromIndex(indices[i]);
+        pItem = (AbstractHierarchyItem*)itemFromIndex(mapFromView(indices[i]));
         if (pItem->type() == mainType)
             validatedItems.push_back(pItem);
         else
-            selectionModel->select(pItem->index(), QItemSelectionModel::SelectionFlag::Deselect);
+            selectionModel->select(indices[i], QItemSelectionModel::SelectionFlag::Deselect);
     }
     emit selectionValidated(validatedItems);
 }
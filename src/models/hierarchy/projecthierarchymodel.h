@@ -11,6 +11,7 @@
 #include "models/hierarchy/abstracthierarchymodel.h"
 #include "core/aliasdata.h"
 #include "core/project.h"
+#include "core/nameindex.h"
 
 namespace QRS::HierarchyModels
 {
@@ -27,6 +28,7 @@ public:
     ProjectHierarchyModel(QString const& mimeType, QTreeView* pView = nullptr);
     void updateContent() override;
     void clearContent() override;
+    NodesSet findNodes(QString const& pattern) const override;
     void setProject(Core::Project* pProject);
 
 signals:
@@ -34,13 +36,31 @@ signals:
 
 public slots:
     void validateItemSelection();
+    void updateDataObjects();
+    void updateRodComponents();
+    void updateNames();
+    void registerChanges(QRS::Core::DataChangeSet const& dataObjectChanges, QRS::Core::DataChangeSet const& rodComponentChanges);
+    void scheduleUpdate(QRS::Core::Project::Changes changes);
 
 private:
+    void processScheduledUpdate();
+    void indexNames();
+    void updateNameIndices();
     DataObjectsHierarchyItem* retrieveDataObjectsItem();
     RodComponentsHierarchyItem* retrieveRodComponentsItem();
+    void substituteRootItem(int iRow, AbstractHierarchyItem* pItem);
+    void updateItemNames(QStandardItem* pParentItem);
 
 private:
     Core::Project* mpProject = nullptr;
+    //! Changes to be represented at the next iteration of the event loop
+    Core::Project::Changes mScheduledChanges;
+    //! Data objects whose names are to be indexed again
+    Core::DataChangeSet mDataObjectChanges;
+    //! Rod components whose names are to be indexed again
+    Core::DataChangeSet mRodComponentChanges;
+    Core::NameIndex mDataObjectNameIndex;
+    Core::NameIndex mRodComponentNameIndex;
 };
 
 }
@@ -19,14 +19,23 @@ QIcon getRodComponentIcon(AbstractRodComponent const* pRodComponent);
 RodComponentsHierarchyItem::RodComponentsHierarchyItem(RodComponents& rodComponents, HierarchyTree& hierarchyRodComponents,
                                                        QString const& text, QIcon const& icon)
     : AbstractHierarchyItem(icon, text, hierarchyRodComponents.root())
+    , mpRodComponents(&rodComponents)
 {
-    if (!mpNode->hasChild())
+
+}
+
+//! Represent the children of the node, if they have not been represented yet
+void RodComponentsHierarchyItem::populate()
+{
+    if (mIsPopulated)
         return;
-    appendItems(rodComponents, mpNode->firstChild());
+    mIsPopulated = true;
+    if (mpNode->hasChild())
+        appendItems(mpNode->firstChild());
 }
 
-//! Create items based on the position in the tree structure
-void RodComponentsHierarchyItem::appendItems(RodComponents& rodComponents, HierarchyNode* pNode)
+//! Create items of the nodes which are on the same level of the tree structure
+void RodComponentsHierarchyItem::appendItems(HierarchyNode* pNode)
 {
     HierarchyNode* pNextNode;
     while (pNode)
@@ -35,21 +44,17 @@ void RodComponentsHierarchyItem::appendItems(RodComponents& rodComponents, Hiera
         switch (pNode->type())
         {
         case HierarchyNode::NodeType::kDirectory:
-            pItem = new RodComponentsHierarchyItem(pNode);
+            pItem = new RodComponentsHierarchyItem(pNode, *mpRodComponents);
             break;
         case HierarchyNode::NodeType::kObject:
             DataIDType id = pNode->value().value<DataIDType>();
-            if (!rodComponents.contains(id))
+            if (!mpRodComponents->contains(id))
                 return;
-            pItem = new RodComponentsHierarchyItem(pNode, rodComponents[id]);
+            pItem = new RodComponentsHierarchyItem(pNode, mpRodComponents->at(id));
             break;
         }
         if (pItem)
-        {
             appendRow(pItem);
-            if (pNode->hasChild())
-                pItem->appendItems(rodComponents, pNode->firstChild());
-        }
         pNextNode = pNode->nextSibling();
         pNode = pNextNode;
     }
@@ -60,16 +65,24 @@ RodComponentsHierarchyItem::RodComponentsHierarchyItem(HierarchyNode* pNode, Abs
     : AbstractHierarchyItem(getRodComponentIcon(pRodComponent), pRodComponent->name(), pNode)
     , mpRodComponent(pRodComponent)
 {
+    mIsPopulated = true;
     setFlags(flags() | Qt::ItemIsEditable);
 }
 
 //! Construct an item to represent a directory
-RodComponentsHierarchyItem::RodComponentsHierarchyItem(HierarchyNode* pNode)
-    : AbstractHierarchyItem(QIcon(":/icons/folder.svg"), pNode->value().toString(), pNode)
+RodComponentsHierarchyItem::RodComponentsHierarchyItem(HierarchyNode* pNode, RodComponents& rodComponents)
+    : AbstractHierarchyItem(cachedIcon(":/icons/folder.svg"), pNode->value().toString(), pNode)
+    , mpRodComponents(&rodComponents)
 {
     setFlags(flags() | Qt::ItemIsEditable);
 }
 
+//! Create an item of the same type to represent a directory
+AbstractHierarchyItem* RodComponentsHierarchyItem::createDirectoryItem(HierarchyNode* pNode) const
+{
+    return new RodComponentsHierarchyItem(pNode, *mpRodComponents);
+}
+
 //! Helper function to assign an appropriate rod component icon
 QIcon getRodComponentIcon(AbstractRodComponent const* pRodComponent)
 {
@@ -77,7 +90,7 @@ QIcon getRodComponentIcon(AbstractRodComponent const* pRodComponent)
     switch (pRodComponent->componentType())
     {
     case AbstractRodComponent::ComponentType::kGeometry:
-        icon = QIcon(":/icons/axis.svg");
+        icon = AbstractHierarchyItem::cachedIcon(":/icons/axis.svg");
         break;
     case AbstractRodComponent::ComponentType::kSection:
     {
@@ -85,24 +98,23 @@ QIcon getRodComponentIcon(AbstractRodComponent const* pRodComponent)
         switch (pSection->sectionType())
         {
         case AbstractSectionRodComponent::SectionType::kUserDefined:
-            icon = QIcon(":/icons/abstract-shape.svg");
+            icon = AbstractHierarchyItem::cachedIcon(":/icons/abstract-shape.svg");
             break;
         }
         break;
     }
     case AbstractRodComponent::ComponentType::kMaterial:
-        icon = QIcon(":/icons/material.svg");
+        icon = AbstractHierarchyItem::cachedIcon(":/icons/material.svg");
         break;
     case AbstractRodComponent::ComponentType::kLoad:
-        icon = QIcon(":/icons/load.svg");
+        icon = AbstractHierarchyItem::cachedIcon(":/icons/load.svg");
         break;
     case AbstractRodComponent::ComponentType::kConstraint:
-        icon = QIcon(":/icons/clamp.svg");
+        icon = AbstractHierarchyItem::cachedIcon(":/icons/clamp.svg");
         break;
     case AbstractRodComponent::ComponentType::kMechanical:
-        icon = QIcon(":/icons/mechanical.svg");
+        icon = AbstractHierarchyItem::cachedIcon(":/icons/mechanical.svg");
         break;
     }
     return icon;
 }
-
@@ -26,13 +26,17 @@ public:
     RodComponentsHierarchyItem(Core::RodComponents& rodComponents, Core::HierarchyTree& hierarchyRodComponents,
                                QString const& text = "Root", QIcon const& icon = QIcon());
     RodComponentsHierarchyItem(Core::HierarchyNode* pNode, Core::AbstractRodComponent* pRodComponent);
-    RodComponentsHierarchyItem(Core::HierarchyNode* pNode);
+    RodComponentsHierarchyItem(Core::HierarchyNode* pNode, Core::RodComponents& rodComponents);
     int type() const override { return AbstractHierarchyItem::ItemType::kRodComponents; }
+    AbstractHierarchyItem* createDirectoryItem(Core::HierarchyNode* pNode) const override;
+    void populate() override;
+    Core::AbstractRodComponent const* getRodComponent() const { return mpRodComponent; }
 
 private:
-    void appendItems(Core::RodComponents& rodComponents, Core::HierarchyNode* pNode);
+    void appendItems(Core::HierarchyNode* pNode);
 
 private:
+    Core::RodComponents* mpRodComponents = nullptr;
     Core::AbstractRodComponent* mpRodComponent = nullptr;
 };
 
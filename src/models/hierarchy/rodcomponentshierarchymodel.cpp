@@ -25,14 +25,30 @@ RodComponentsHierarchyModel::RodComponentsHierarchyModel(RodComponents& rodCompo
     RodComponentsHierarchyModel::updateContent();
 }
 
-//! Update all the content
+//! Update all the content and index the names from scratch
 void RodComponentsHierarchyModel::updateContent()
+{
+    populate();
+    indexNames();
+}
+
+//! Update all the items and index only the names affected by the changes
+void RodComponentsHierarchyModel::updateContent(DataChangeSet const& changeSet)
+{
+    populate();
+    mNameIndex.update(changeSet, mRodComponents);
+    emit namesIndexed();
+}
+
+//! Recreate all the items
+void RodComponentsHierarchyModel::populate()
 {
     clearContent();
     if (isEmpty())
         return;
     QStandardItem* pRootItem = invisibleRootItem();
     AbstractHierarchyItem* pHierarchyItem = new RodComponentsHierarchyItem(mRodComponents, mHierarchyRodComponents);
+    pHierarchyItem->populate();
     int nRows = pHierarchyItem->rowCount();
     QList<QStandardItem*> items(nRows);
     for (int i = 0; i != nRows; ++i)
@@ -48,6 +64,23 @@ void RodComponentsHierarchyModel::clearContent()
     emit selectionCleared();
 }
 
+//! Index the names of all the rod components to search them
+void RodComponentsHierarchyModel::indexNames()
+{
+    mNameIndex.clear();
+    for (auto const& [id, pRodComponent] : mRodComponents)
+        mNameIndex.insert(id, pRodComponent->name());
+    emit namesIndexed();
+}
+
+//! Find the nodes of the rod components whose names contain a pattern
+NodesSet RodComponentsHierarchyModel::findNodes(QString const& pattern) const
+{
+    NodesSet nodes;
+    collectNodes(mHierarchyRodComponents.root(), mNameIndex.find(pattern), nodes);
+    return nodes;
+}
+
 //! Check if there are data objcects to represent
 inline bool RodComponentsHierarchyModel::isEmpty() const
 {
@@ -60,10 +93,19 @@ void RodComponentsHierarchyModel::renameItem(QStandardItem* pStandardItem)
     RodComponentsHierarchyItem* pItem = (RodComponentsHierarchyItem*)pStandardItem;
     QString newName = pItem->data(Qt::DisplayRole).toString();
     if (pItem->mpRodComponent)
+    {
+        QString oldName = pItem->mpRodComponent->name();
         pItem->mpRodComponent->setName(newName);
+        mNameIndex.rename(pItem->mpRodComponent->id(), oldName, newName);
+        emit objectRenamed(pItem->mpRodComponent->id());
+        emit namesIndexed();
+    }
     else if (pItem->mpNode->type() == HierarchyNode::NodeType::kDirectory)
+    {
+        recordNode(pItem->mpNode);
         pItem->mpNode->value() = newName;
-    emit hierarchyChanged();
+        emit hierarchyChanged();
+    }
 }
 
 //! Select an item by row index
@@ -74,7 +116,7 @@ void RodComponentsHierarchyModel::selectItem(int iRow)
     RodComponentsHierarchyItem* pItem = (RodComponentsHierarchyItem*)invisibleRootItem()->child(iRow);
     QModelIndex const& selectionIndex = pItem->index();
     QTreeView* pView = (QTreeView*)parent();
-    pView->selectionModel()->select(selectionIndex, QItemSelectionModel::SelectionFlag::SelectCurrent);
+    pView->selectionModel()->select(mapToView(selectionIndex), QItemSelectionModel::SelectionFlag::SelectCurrent);
     AbstractRodComponent const* pRodComponent = pItem->mpRodComponent;
     if (pRodComponent)
         emit selected(pRodComponent->id());
@@ -97,7 +139,7 @@ void RodComponentsHierarchyModel::retrieveSelectedItem()
         emit selectionCleared();
         return;
     }
-    RodComponentsHierarchyItem* pItem = (RodComponentsHierarchyItem*)itemFromIndex(indices[0]);
+    RodComponentsHierarchyItem* pItem = (RodComponentsHierarchyItem*)itemFromIndex(mapFromView(indices[0]));
     AbstractRodComponent* pRodComponent = pItem->mpRodComponent;
     if (pRodComponent)
         emit selected(pRodComponent->id());
@@ -112,18 +154,29 @@ void RodComponentsHierarchyModel::removeSelectedItems()
     if (pView->selectionModel()->selection().isEmpty())
         return;
     QModelIndexList indices = pView->selectionModel()->selectedIndexes();
+    // Items of nested selected nodes are destroyed together with their parents
+    QList<QPersistentModelIndex> persistentIndices;
     for (QModelIndex const& index : indices)
+        persistentIndices.push_back(index);
+    for (QPersistentModelIndex const& index : persistentIndices)
     {
-        RodComponentsHierarchyItem* pItem = (RodComponentsHierarchyItem*)itemFromIndex(index);
+        if (!index.isValid())
+            continue;
+        RodComponentsHierarchyItem* pItem = (RodComponentsHierarchyItem*)itemFromIndex(mapFromView(index));
         AbstractRodComponent* pRodComponent = pItem->mpRodComponent;
         if (pRodComponent)
         {
-            mRodComponents.erase(pRodComponent->id());
+            // Receivers can still access the component being removed
+            DataIDType id = pRodComponent->id();
+            emit objectRemoved(id);
+            mRodComponents.erase(id);
             delete pRodComponent;
+            mNameIndex.remove(id);
         }
-        mHierarchyRodComponents.removeNode(pItem->mpNode);
+        removeNode(pItem->mpNode);
+        parentItem(pItem)->removeRow(pItem->row());
     }
-    updateContent();
+    emit namesIndexed();
     emit hierarchyChanged();
     emit selectionCleared();
 }
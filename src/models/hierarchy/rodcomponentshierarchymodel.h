@@ -10,6 +10,7 @@
 
 #include "models/hierarchy/abstracthierarchymodel.h"
 #include "core/aliasdataset.h"
+#include "core/nameindex.h"
 
 namespace QRS
 {
@@ -27,7 +28,9 @@ public:
                                 QString const& mimeType, QTreeView* pView = nullptr);
     ~RodComponentsHierarchyModel() = default;
     void updateContent() override;
+    void updateContent(Core::DataChangeSet const& changeSet);
     void clearContent() override;
+    NodesSet findNodes(QString const& pattern) const override;
     bool isEmpty() const;
     void selectItem(int iRow);
 
@@ -42,9 +45,14 @@ public slots:
 private slots:
     void renameItem(QStandardItem* pStandardItem);
 
+private:
+    void populate();
+    void indexNames();
+
 private:
     Core::RodComponents& mRodComponents;
     Core::HierarchyTree& mHierarchyRodComponents;
+    Core::NameIndex mNameIndex;
 };
 
 }
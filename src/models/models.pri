@@ -5,6 +5,7 @@ HEADERS += \
     $$PWD/hierarchy/abstracthierarchymodel.h \
     $$PWD/hierarchy/dataobjectshierarchyitem.h \
     $$PWD/hierarchy/dataobjectshierarchymodel.h \
+    $$PWD/hierarchy/hierarchyfiltermodel.h \
     $$PWD/hierarchy/projecthierarchymodel.h \
     $$PWD/hierarchy/rodcomponentshierarchyitem.h \
     $$PWD/hierarchy/rodcomponentshierarchymodel.h \
@@ -20,6 +21,7 @@ SOURCES += \
     $$PWD/hierarchy/abstracthierarchymodel.cpp \
     $$PWD/hierarchy/dataobjectshierarchyitem.cpp \
     $$PWD/hierarchy/dataobjectshierarchymodel.cpp \
+    $$PWD/hierarchy/hierarchyfiltermodel.cpp \
     $$PWD/hierarchy/projecthierarchymodel.cpp \
     $$PWD/hierarchy/rodcomponentshierarchyitem.cpp \
     $$PWD/hierarchy/rodcomponentshierarchymodel.cpp \
@@ -67,19 +67,6 @@ void AbstractPropertiesModel::setDirectoryAttributes()
 }
 
 
-//! Change names of selected directories
-void AbstractPropertiesModel::modifyDirectoryName(QString const& name)
-{
-    int numItems = mItems.size();
-    AbstractHierarchyItem* pItem;
-    for (int i = 0; i != numItems; ++i)
-    {
-        pItem = mItems[i];
-        pItem->mpNode->value() = name;
-        pItem->setText(name);
-    }
-}
-
 //! Prepare a row to insert into the table
 QList<QStandardItem*> AbstractPropertiesModel::preparePropertyRow(int type, QString const& title,
                                                                   QVariant const& value, bool isValueEditable) const
@@ -39,7 +39,6 @@ signals:
 
 protected slots:
     virtual void modifyProperty(QStandardItem* pChangedProperty) = 0;
-    void modifyDirectoryName(QString const& name);
 
 protected:
     void setDirectoryAttributes();
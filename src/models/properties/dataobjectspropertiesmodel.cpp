@@ -10,6 +10,7 @@
 #include "core/abstractdataobject.h"
 #include "core/surfacedataobject.h"
 #include "core/hierarchynode.h"
+#include "core/project.h"
 #include "models/hierarchy/abstracthierarchymodel.h"
 #include "models/hierarchy/dataobjectshierarchyitem.h"
 
@@ -17,8 +18,10 @@ using namespace QRS::PropertiesModels;
 using namespace QRS::HierarchyModels;
 using namespace QRS::Core;
 
-DataObjectsPropertiesModel::DataObjectsPropertiesModel(QTableView* pView, QVector<AbstractHierarchyItem*> items)
+DataObjectsPropertiesModel::DataObjectsPropertiesModel(Project& project, QTableView* pView,
+                                                       QVector<AbstractHierarchyItem*> items)
     : AbstractPropertiesModel(pView, items)
+    , mProject(project)
 {
     if (mItems.isEmpty())
         return;
@@ -90,24 +93,26 @@ void DataObjectsPropertiesModel::setObjectAttributes()
     pRoot->appendRow(preparePropertyRow(PropertyDataObject::kID, tr("Identifier"), identifier, false));
 }
 
-//! Modify the selected property of all items
+//! Modify the selected property of all items. The project is modified first, since it can be copied in another thread
 void DataObjectsPropertiesModel::modifyProperty(QStandardItem* pChangedProperty)
 {
     QString newName = pChangedProperty->data(Qt::DisplayRole).toString();
+    int numItems = mItems.size();
     if (mIsDirectory)
     {
-        modifyDirectoryName(newName);
+        std::vector<HierarchyNode*> nodes(numItems);
+        for (int i = 0; i != numItems; ++i)
+            nodes[i] = ((DataObjectsHierarchyItem*)mItems[i])->mpNode;
+        mProject.renameDataObjectDirectories(nodes, newName);
     }
     else
     {
-        int numItems = mItems.size();
-        DataObjectsHierarchyItem* pItem;
+        std::vector<DataIDType> ids(numItems);
         for (int i = 0; i != numItems; ++i)
-        {
-            pItem = (DataObjectsHierarchyItem*)mItems[i];
-            pItem->mpDataObject->setName(newName);
-            pItem->setText(newName);
-        }
+            ids[i] = ((DataObjectsHierarchyItem*)mItems[i])->mpDataObject->id();
+        mProject.renameDataObjects(ids, newName);
     }
+    for (AbstractHierarchyItem* pItem : mItems)
+        pItem->setText(newName);
     emit propertyChanged();
 }
@@ -17,6 +17,11 @@ QT_END_NAMESPACE
 namespace QRS
 {
 
+namespace Core
+{
+class Project;
+}
+
 namespace HierarchyModels
 {
 class AbstractHierarchyItem;
@@ -31,7 +36,7 @@ class DataObjectsPropertiesModel : public AbstractPropertiesModel
     Q_OBJECT
 
 public:
-    DataObjectsPropertiesModel(QTableView* pView, QVector<HierarchyModels::AbstractHierarchyItem*> items);
+    DataObjectsPropertiesModel(Core::Project& project, QTableView* pView, QVector<HierarchyModels::AbstractHierarchyItem*> items);
 
 protected slots:
     void modifyProperty(QStandardItem* pChangedProperty) override;
@@ -46,6 +51,10 @@ private:
         kID
     };
     void setObjectAttributes();
+
+private:
+    //! Project which owns the data objects, so that they are renamed under its lock
+    Core::Project& mProject;
 };
 
 }
@@ -6,6 +6,7 @@
  */
 
 #include <QTreeView>
+#include <QtMath>
 
 #include "basetablemodel.h"
 #include "core/abstractdataobject.h"
@@ -23,6 +24,7 @@ BaseTableModel::BaseTableModel(QWidget* parent)
 void BaseTableModel::setDataObject(AbstractDataObject* pDataObject)
 {
     mpDataObject = pDataObject;
+    mDelta = DataObjectDelta(pDataObject ? pDataObject->id() : 0);
     if (!mpDataObject)
     {
         clearContent();
@@ -50,13 +52,47 @@ void BaseTableModel::updateContent()
     clearContent();
     if (!mpDataObject)
         return;
-    QStandardItem* rootItem = invisibleRootItem();
     auto& map = mpDataObject->getItems();
-    for (auto& iterator : map)
+    int numRows = map.size();
+    if (numRows == 0)
+        return;
+    // Create all the rows at once and notify views only after they are filled
+    setRowCount(numRows);
+    {
+        QSignalBlocker const blocker(this);
+        int iRow = 0;
+        for (auto& iterator : map)
+        {
+            QList<QStandardItem*> row = prepareRow(iterator.first, iterator.second, 0);
+            int numColumns = row.size();
+            for (int iColumn = 0; iColumn != numColumns; ++iColumn)
+                setItem(iRow, iColumn, row[iColumn]);
+            ++iRow;
+        }
+    }
+    emit dataChanged(index(0, 0), index(numRows - 1, columnCount() - 1));
+}
+
+//! Synchronize the items of the specified rows with the data object and notify views once
+void BaseTableModel::updateValues(int iStartRow, int iEndRow)
+{
+    auto& map = mpDataObject->getItems();
+    iEndRow = qMin(iEndRow, (int)map.size() - 1);
+    if (iStartRow > iEndRow)
+        return;
+    int numColumns = columnCount();
     {
-        DataItemType const& array = iterator.second;
-        rootItem->appendRow(prepareRow(iterator.first, array, 0));
+        QSignalBlocker const blocker(this);
+        auto iterator = std::next(map.begin(), iStartRow);
+        for (int iRow = iStartRow; iRow <= iEndRow; ++iRow, ++iterator)
+        {
+            setItemValue(item(iRow, 0), iterator->first);
+            DataItemType const& array = iterator->second;
+            for (int iColumn = 1; iColumn < numColumns; ++iColumn)
+                setItemValue(item(iRow, iColumn), array[0][iColumn - 1]);
+        }
     }
+    emit dataChanged(index(iStartRow, 0), index(iEndRow, numColumns - 1));
 }
 
 //! Clear previously created items
@@ -70,66 +106,164 @@ bool BaseTableModel::setData(const QModelIndex& indexEdit, const QVariant& value
 {
     if (role != Qt::UserRole)
         return false;
-    double key = data(index(indexEdit.row(), 0), Qt::UserRole).toDouble();
+    int iRow = indexEdit.row();
+    double key = data(index(iRow, 0), Qt::UserRole).toDouble();
     double newValue = value.toDouble();
     bool isOkay = false;
-    bool isSort = false;
     // Check whether a key or value was changed
     short iColumn = indexEdit.column();
     if (iColumn == 0)
-    {
-        isOkay = mpDataObject->changeItemKey(key, newValue);
-        isSort = true;
-    }
+        isOkay = mDelta.changeItemKey(*mpDataObject, key, newValue);
     else
-    {
-        isOkay = mpDataObject->setArrayValue(key, newValue, 0, iColumn - 1);
-    }
+        isOkay = mDelta.setArrayValue(*mpDataObject, key, newValue, 0, iColumn - 1);
+    if (!isOkay)
+        return false;
     // Display the changed value
-    if (isOkay)
+    QStandardItemModel::setData(indexEdit, value, Qt::UserRole);
+    QStandardItemModel::setData(indexEdit, QString::number(newValue, 'g', kNumShowPrecision), Qt::EditRole);
+    // Move the row with the modified key to its sorted position
+    if (iColumn == 0)
     {
-        QStandardItemModel::setData(indexEdit, value, Qt::UserRole);
-        QStandardItemModel::setData(indexEdit, QString::number(newValue, 'g', kNumShowPrecision), Qt::EditRole);
-        if (isSort)
-            sort(0, Qt::AscendingOrder);
+        auto& items = mpDataObject->getItems();
+        int iNewRow = std::distance(items.begin(), items.find(newValue));
+        if (iNewRow != iRow)
+            insertRow(iNewRow, takeRow(iRow));
     }
-    return isOkay;
+    return true;
 }
 
 //! Insert a new item after selected one
 void BaseTableModel::insertItemAfterSelected(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    QList<double> keys;
     if (listSelected.isEmpty())
     {
-        mpDataObject->addItem(0.0);
+        keys.push_back(0.0);
     }
     else
     {
-        quint32 iRow;
-        double key;
         for (QModelIndex& currentIndex : listSelected)
-        {
-            iRow = currentIndex.row();
-            key = index(iRow, 0).data(Qt::UserRole).toDouble();
-            mpDataObject->addItem(key);
-        }
+            keys.push_back(index(currentIndex.row(), 0).data(Qt::UserRole).toDouble());
+    }
+    // Insert only the rows created
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
+    {
+        double newKey = mpDataObject->getAvailableItemKey(key);
+        DataItemType const& array = mDelta.addItem(*mpDataObject, newKey);
+        int iRow = std::distance(items.begin(), items.find(newKey));
+        insertRow(iRow, prepareRow(newKey, array, 0));
     }
-    updateContent();
 }
 
 //! Remove an array under selection
 void BaseTableModel::removeSelectedItem(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
-    quint32 iRow;
-    double key;
-    for (QModelIndex& ind : listSelected)
+    QList<double> keys;
+    for (QModelIndex& currentIndex : listSelected)
+        keys.push_back(index(currentIndex.row(), 0).data(Qt::UserRole).toDouble());
+    // Remove only the rows which correspond to the deleted items
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
     {
-        iRow = ind.row();
-        key = index(iRow, 0).data(Qt::UserRole).toDouble();
-        mpDataObject->removeItem(key);
+        auto iterator = items.find(key);
+        if (iterator == items.end())
+            continue;
+        int iRow = std::distance(items.begin(), iterator);
+        mDelta.removeItem(*mpDataObject, key);
+        removeRow(iRow);
     }
-    updateContent();
 }
 
+/*!
+ * \brief Paste values starting from the upper left selected cell
+ *
+ * All the values are applied to the data object first. Items which do not fit are appended to the data object.
+ * Then views are notified once: either the whole content is represented again, if keys were modified, or the affected rows are updated.
+ */
+void BaseTableModel::pasteValues(QItemSelectionModel* pSelectionModel, ValuesTable const& values)
+{
+    if (!mpDataObject || values.isEmpty())
+        return;
+    QModelIndex indexStart = getTopLeftIndex(pSelectionModel->selectedIndexes());
+    int iStartRow = indexStart.isValid() ? indexStart.row() : 0;
+    int iStartColumn = indexStart.isValid() ? indexStart.column() : 0;
+    int numColumns = columnCount();
+    // Keys in the order they are represented
+    auto& items = mpDataObject->getItems();
+    QList<double> keys;
+    keys.reserve(qMax((int)items.size(), iStartRow + (int)values.size()));
+    for (auto& iterator : items)
+        keys.push_back(iterator.first);
+    bool isKeysChanged = false;
+    int numValuesRows = values.size();
+    for (int i = 0; i != numValuesRows; ++i)
+    {
+        QList<double> const& rowValues = values[i];
+        int iRow = iStartRow + i;
+        // Create an item if the values do not fit
+        if (iRow >= keys.size())
+        {
+            double key = keys.isEmpty() ? 0.0 : keys.last();
+            if (iStartColumn == 0 && !qIsNaN(rowValues[0]))
+                key = rowValues[0];
+            key = mpDataObject->getAvailableItemKey(key);
+            mDelta.addItem(*mpDataObject, key);
+            keys.push_back(key);
+            isKeysChanged = true;
+        }
+        int numRowValues = qMin((int)rowValues.size(), numColumns - iStartColumn);
+        for (int j = 0; j < numRowValues; ++j)
+        {
+            double value = rowValues[j];
+            int iColumn = iStartColumn + j;
+            if (qIsNaN(value))
+                continue;
+            if (iColumn == 0)
+            {
+                // Keys which are already used are shifted, so that the pasted rows are kept
+                double key = mpDataObject->getAvailableItemKey(value);
+                if (value != keys[iRow] && mDelta.changeItemKey(*mpDataObject, keys[iRow], key))
+                {
+                    keys[iRow] = key;
+                    isKeysChanged = true;
+                }
+            }
+            else
+            {
+                mDelta.setArrayValue(*mpDataObject, keys[iRow], value, 0, iColumn - 1);
+            }
+        }
+    }
+    if (isKeysChanged)
+        updateContent();
+    else
+        updateValues(iStartRow, iStartRow + numValuesRows - 1);
+}
+
+//! Modify values of selected cells except for keys by the given function
+void BaseTableModel::transformSelectedValues(QItemSelectionModel* pSelectionModel, std::function<double(double)> const& function)
+{
+    if (!mpDataObject)
+        return;
+    QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    int iStartRow = rowCount();
+    int iEndRow = -1;
+    for (QModelIndex& currentIndex : listSelected)
+    {
+        int iColumn = currentIndex.column();
+        if (iColumn == 0)
+            continue;
+        int iRow = currentIndex.row();
+        double key = index(iRow, 0).data(Qt::UserRole).toDouble();
+        double value = currentIndex.data(Qt::UserRole).toDouble();
+        if (mDelta.setArrayValue(*mpDataObject, key, function(value), 0, iColumn - 1))
+        {
+            iStartRow = qMin(iStartRow, iRow);
+            iEndRow = qMax(iEndRow, iRow);
+        }
+    }
+    updateValues(iStartRow, iEndRow);
+}
@@ -36,9 +36,12 @@ public:
     void insertLeadingItemAfterSelected(QItemSelectionModel* /*pSelectionModel*/) override { };
     void removeSelectedItem(QItemSelectionModel* pSelectionModel) override;
     void removeSelectedLeadingItem(QItemSelectionModel* /*pSelectionModel*/) override { };
+    void pasteValues(QItemSelectionModel* pSelectionModel, ValuesTable const& values) override;
+    void transformSelectedValues(QItemSelectionModel* pSelectionModel, std::function<double(double)> const& function) override;
 
 private:
     void updateContent();
+    void updateValues(int iStartRow, int iEndRow);
     void clearContent();
 
 private:
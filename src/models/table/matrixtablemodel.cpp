@@ -6,6 +6,7 @@
  */
 
 #include <QTreeView>
+#include <QtMath>
 
 #include "matrixtablemodel.h"
 #include "core/abstractdataobject.h"
@@ -25,6 +26,7 @@ MatrixTableModel::MatrixTableModel(QWidget* parent)
 void MatrixTableModel::setDataObject(AbstractDataObject* pDataObject)
 {
     mpDataObject = pDataObject;
+    mDelta = DataObjectDelta(pDataObject ? pDataObject->id() : 0);
     if (!mpDataObject)
     {
         clearContent();
@@ -39,27 +41,75 @@ void MatrixTableModel::updateContent()
     clearContent();
     if (!mpDataObject)
         return;
-    QStandardItem* rootItem = invisibleRootItem();
     auto& mapMatrices = mpDataObject->getItems();
-    for (auto& iterator : mapMatrices)
+    int numRows = mapMatrices.size();
+    if (numRows == 0)
+        return;
+    // Create all the rows at once and notify views only after they are filled
+    setRowCount(numRows);
+    {
+        QSignalBlocker const blocker(this);
+        int iRow = 0;
+        for (auto& iterator : mapMatrices)
+        {
+            QList<QStandardItem*> row = prepareMatrixRow(iterator.first, iterator.second);
+            int numColumns = row.size();
+            for (int iColumn = 0; iColumn != numColumns; ++iColumn)
+                setItem(iRow, iColumn, row[iColumn]);
+            ++iRow;
+        }
+    }
+    emit dataChanged(index(0, 0), index(numRows - 1, columnCount() - 1));
+}
+
+//! Synchronize the items of the specified matrices with the data object and notify views once per matrix
+void MatrixTableModel::updateValues(int iStartRow, int iEndRow)
+{
+    auto& mapMatrices = mpDataObject->getItems();
+    iEndRow = qMin(iEndRow, (int)mapMatrices.size() - 1);
+    if (iStartRow > iEndRow)
+        return;
+    int numColumns = columnCount();
+    auto iterator = std::next(mapMatrices.begin(), iStartRow);
+    for (int iRow = iStartRow; iRow <= iEndRow; ++iRow, ++iterator)
     {
-        QStandardItem* keyItem = TableModelInterface::makeDoubleItem(iterator.first);
-        rootItem->appendRow(keyItem);
-        DataItemType const& array = iterator.second;
-        quint32 nRows = array.rows();
-        quint32 iRow = keyItem->row();
-        for (quint32 i = 0; i != nRows; ++i)
-            keyItem->appendRow(prepareRow(QString(), array, i));
-        // Forbid to modify an array header
-        for (quint32 j = 1; j != 4; ++j)
+        QStandardItem* pKeyItem = item(iRow, 0);
+        DataItemType const& array = iterator->second;
+        int numMatrixRows = qMin((int)array.rows(), pKeyItem->rowCount());
         {
-            QStandardItem* arrayHeaderItem = new QStandardItem();
-            arrayHeaderItem->setFlags(Qt::NoItemFlags);
-            setItem(iRow, j, arrayHeaderItem);
+            QSignalBlocker const blocker(this);
+            setItemValue(pKeyItem, iterator->first);
+            for (int i = 0; i != numMatrixRows; ++i)
+            {
+                for (int j = 1; j < numColumns; ++j)
+                    setItemValue(pKeyItem->child(i, j), array[i][j - 1]);
+            }
         }
+        emit dataChanged(index(iRow, 0), index(iRow, 0));
+        QModelIndex indexParent = index(iRow, 0);
+        emit dataChanged(index(0, 0, indexParent), index(numMatrixRows - 1, numColumns - 1, indexParent));
     }
 }
 
+//! Create a key row which holds all the rows of the associated matrix as children
+QList<QStandardItem*> MatrixTableModel::prepareMatrixRow(double key, DataItemType const& array)
+{
+    QList<QStandardItem*> resultList;
+    QStandardItem* keyItem = TableModelInterface::makeDoubleItem(key);
+    quint32 nRows = array.rows();
+    for (quint32 i = 0; i != nRows; ++i)
+        keyItem->appendRow(prepareRow(QString(), array, i));
+    resultList.push_back(keyItem);
+    // Forbid to modify an array header
+    for (quint32 j = 1; j != 4; ++j)
+    {
+        QStandardItem* arrayHeaderItem = new QStandardItem();
+        arrayHeaderItem->setFlags(Qt::NoItemFlags);
+        resultList.push_back(arrayHeaderItem);
+    }
+    return resultList;
+}
+
 //! Clear previously created items
 void MatrixTableModel::clearContent()
 {
@@ -82,36 +132,36 @@ bool MatrixTableModel::setData(const QModelIndex& indexEdit, const QVariant& val
     double key = data(index(iKeyRow, 0), Qt::UserRole).toDouble();
     double newValue = value.toDouble();
     bool isOkay = false;
-    bool isSort = false;
     // Check whether a key or value was changed
     short iColumn = indexEdit.column();
     if (isKeyEdited)
-    {
-        isOkay = mpDataObject->changeItemKey(key, newValue);
-        isSort = true;
-    }
+        isOkay = mDelta.changeItemKey(*mpDataObject, key, newValue);
     else
-    {
-        isOkay = mpDataObject->setArrayValue(key, newValue, indexEdit.row(), iColumn - 1);
-    }
+        isOkay = mDelta.setArrayValue(*mpDataObject, key, newValue, indexEdit.row(), iColumn - 1);
+    if (!isOkay)
+        return false;
     // Display the changed value
-    if (isOkay)
+    QStandardItemModel::setData(indexEdit, value, Qt::UserRole);
+    QStandardItemModel::setData(indexEdit, QString::number(newValue, 'g', kNumShowPrecision), Qt::EditRole);
+    // Move the key row together with its children to the sorted position
+    if (isKeyEdited)
     {
-        QStandardItemModel::setData(indexEdit, value, Qt::UserRole);
-        QStandardItemModel::setData(indexEdit, QString::number(newValue, 'g', kNumShowPrecision), Qt::EditRole);
-        if (isSort)
-            sort(0, Qt::AscendingOrder);
+        auto& items = mpDataObject->getItems();
+        int iNewRow = std::distance(items.begin(), items.find(newValue));
+        if (iNewRow != iKeyRow)
+            insertRow(iNewRow, takeRow(iKeyRow));
     }
-    return isOkay;
+    return true;
 }
 
 //! Insert a new item after selected one
 void MatrixTableModel::insertItemAfterSelected(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    QList<double> keys;
     if (listSelected.isEmpty())
     {
-        mpDataObject->addItem(0.0);
+        keys.push_back(0.0);
     }
     else
     {
@@ -119,31 +169,145 @@ void MatrixTableModel::insertItemAfterSelected(QItemSelectionModel* pSelectionMo
         {
             // If it is a parent
             if (currentIndex.parent().row() < 0)
-            {
-                quint32 iRow = currentIndex.row();
-                double key = index(iRow, 0).data(Qt::UserRole).toDouble();
-                mpDataObject->addItem(key);
-            }
+                keys.push_back(index(currentIndex.row(), 0).data(Qt::UserRole).toDouble());
         }
     }
-    updateContent();
+    // Insert only the rows created
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
+    {
+        double newKey = mpDataObject->getAvailableItemKey(key);
+        DataItemType const& array = mDelta.addItem(*mpDataObject, newKey);
+        int iRow = std::distance(items.begin(), items.find(newKey));
+        insertRow(iRow, prepareMatrixRow(newKey, array));
+    }
 }
 
 //! Remove an array under selection
 void MatrixTableModel::removeSelectedItem(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    QList<double> keys;
     QStandardItem* itemTable;
     for (QModelIndex& currentIndex : listSelected)
     {
         itemTable = itemFromIndex(currentIndex);
         // If it is a parent
         if (itemTable->rowCount() > 0)
+            keys.push_back(index(currentIndex.row(), 0).data(Qt::UserRole).toDouble());
+    }
+    // Remove only the rows which correspond to the deleted items
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
+    {
+        auto iterator = items.find(key);
+        if (iterator == items.end())
+            continue;
+        int iRow = std::distance(items.begin(), iterator);
+        mDelta.removeItem(*mpDataObject, key);
+        removeRow(iRow);
+    }
+}
+
+/*!
+ * \brief Paste values starting from the upper left selected cell
+ *
+ * If a key is selected, the first column of values is pasted as keys, and matrices which do not fit are appended.
+ * Otherwise, the values are written to the rows of the selected matrix and then to the rows of the following ones.
+ * Views are notified after all the values are applied.
+ */
+void MatrixTableModel::pasteValues(QItemSelectionModel* pSelectionModel, ValuesTable const& values)
+{
+    if (!mpDataObject || values.isEmpty())
+        return;
+    QModelIndex indexStart = getTopLeftIndex(pSelectionModel->selectedIndexes());
+    auto& items = mpDataObject->getItems();
+    int numValuesRows = values.size();
+    // Paste keys of matrices
+    if (!indexStart.isValid() || !indexStart.parent().isValid())
+    {
+        int iStartRow = indexStart.isValid() ? indexStart.row() : 0;
+        QList<double> keys;
+        keys.reserve(qMax((int)items.size(), iStartRow + numValuesRows));
+        for (auto& iterator : items)
+            keys.push_back(iterator.first);
+        bool isKeysChanged = false;
+        for (int i = 0; i != numValuesRows; ++i)
         {
-            quint32 iRow = currentIndex.row();
-            double key = index(iRow, 0).data(Qt::UserRole).toDouble();
-            mpDataObject->removeItem(key);
+            double value = values[i][0];
+            int iRow = iStartRow + i;
+            if (iRow >= keys.size())
+            {
+                double key = mpDataObject->getAvailableItemKey(qIsNaN(value) ? (keys.isEmpty() ? 0.0 : keys.last()) : value);
+                mDelta.addItem(*mpDataObject, key);
+                keys.push_back(key);
+                isKeysChanged = true;
+            }
+            else if (!qIsNaN(value) && value != keys[iRow])
+            {
+                // Keys which are already used are shifted, so that the pasted matrices are kept
+                double key = mpDataObject->getAvailableItemKey(value);
+                if (mDelta.changeItemKey(*mpDataObject, keys[iRow], key))
+                {
+                    keys[iRow] = key;
+                    isKeysChanged = true;
+                }
+            }
         }
+        if (isKeysChanged)
+            updateContent();
+        return;
     }
-    updateContent();
+    // Paste matrix values
+    int numColumns = columnCount();
+    int iStartColumn = indexStart.column();
+    int iStartMatrix = indexStart.parent().row();
+    int iMatrix = iStartMatrix;
+    IndexType iMatrixRow = indexStart.row();
+    auto iterator = std::next(items.begin(), iMatrix);
+    for (int i = 0; i != numValuesRows && iterator != items.end(); ++i)
+    {
+        QList<double> const& rowValues = values[i];
+        int numRowValues = qMin((int)rowValues.size(), numColumns - iStartColumn);
+        for (int j = 0; j < numRowValues; ++j)
+        {
+            double value = rowValues[j];
+            int iColumn = iStartColumn + j;
+            if (iColumn > 0 && !qIsNaN(value))
+                mDelta.setArrayValue(*mpDataObject, iterator->first, value, iMatrixRow, iColumn - 1);
+        }
+        // Proceed to the next matrix
+        if (++iMatrixRow == iterator->second.rows() && i + 1 != numValuesRows)
+        {
+            ++iterator;
+            ++iMatrix;
+            iMatrixRow = 0;
+        }
+    }
+    updateValues(iStartMatrix, iMatrix);
+}
+
+//! Modify values of selected matrix cells by the given function
+void MatrixTableModel::transformSelectedValues(QItemSelectionModel* pSelectionModel, std::function<double(double)> const& function)
+{
+    if (!mpDataObject)
+        return;
+    QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    int iStartMatrix = rowCount();
+    int iEndMatrix = -1;
+    for (QModelIndex& currentIndex : listSelected)
+    {
+        int iMatrix = currentIndex.parent().row();
+        int iColumn = currentIndex.column();
+        if (iMatrix < 0 || iColumn == 0)
+            continue;
+        double key = index(iMatrix, 0).data(Qt::UserRole).toDouble();
+        double value = currentIndex.data(Qt::UserRole).toDouble();
+        if (mDelta.setArrayValue(*mpDataObject, key, function(value), currentIndex.row(), iColumn - 1))
+        {
+            iStartMatrix = qMin(iStartMatrix, iMatrix);
+            iEndMatrix = qMax(iEndMatrix, iMatrix);
+        }
+    }
+    updateValues(iStartMatrix, iEndMatrix);
 }
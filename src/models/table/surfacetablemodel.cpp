@@ -6,6 +6,7 @@
  */
 
 #include <QTreeView>
+#include <QtMath>
 
 #include "surfacetablemodel.h"
 #include "core/surfacedataobject.h"
@@ -23,6 +24,7 @@ SurfaceTableModel::SurfaceTableModel(QWidget* parent)
 void SurfaceTableModel::setDataObject(SurfaceDataObject* pDataObject)
 {
     mpDataObject = pDataObject;
+    mDelta = DataObjectDelta(pDataObject ? pDataObject->id() : 0);
     if (!mpDataObject)
     {
         clearContent();
@@ -37,23 +39,55 @@ void SurfaceTableModel::updateContent()
     clearContent();
     if (!mpDataObject)
         return;
-    QStandardItem* rootItem = invisibleRootItem();
     auto& mapLeadingItems = mpDataObject->getLeadingItems();
-    // Creating a header
-    QList<QStandardItem*> header;
-    header.push_back(makeLabelItem("XY"));
-    for (auto& leadingItem : mapLeadingItems)
+    auto& mapItems = mpDataObject->getItems();
+    int numRows = mapItems.size() + 1;
+    int numColumns = mapLeadingItems.size() + 1;
+    // Create all the cells at once and notify views only after they are filled
+    setRowCount(numRows);
+    setColumnCount(numColumns);
     {
-        header.push_back(makeDoubleItem(leadingItem.first));
+        QSignalBlocker const blocker(this);
+        // Creating a header
+        setItem(0, 0, makeLabelItem("XY"));
+        int iColumn = 1;
+        for (auto& leadingItem : mapLeadingItems)
+            setItem(0, iColumn++, makeDoubleItem(leadingItem.first));
+        // Setting row items
+        int iRow = 1;
+        for (auto& rowItem : mapItems)
+        {
+            QList<QStandardItem*> row = prepareRow(rowItem.first, rowItem.second, 0);
+            int numRowItems = row.size();
+            for (int j = 0; j != numRowItems; ++j)
+                setItem(iRow, j, row[j]);
+            ++iRow;
+        }
     }
-    rootItem->appendRow(header);
-    // Setting row items
+    emit dataChanged(index(0, 0), index(numRows - 1, numColumns - 1));
+}
+
+//! Synchronize the items of the specified rows with the data object and notify views once
+void SurfaceTableModel::updateValues(int iStartRow, int iEndRow)
+{
     auto& mapItems = mpDataObject->getItems();
-    for (auto& rowItem : mapItems)
+    iStartRow = qMax(iStartRow, 1);
+    iEndRow = qMin(iEndRow, (int)mapItems.size());
+    if (iStartRow > iEndRow)
+        return;
+    int numColumns = columnCount();
     {
-        DataItemType const& array = rowItem.second;
-        rootItem->appendRow(prepareRow(rowItem.first, array, 0));
+        QSignalBlocker const blocker(this);
+        auto iterator = std::next(mapItems.begin(), iStartRow - 1);
+        for (int iRow = iStartRow; iRow <= iEndRow; ++iRow, ++iterator)
+        {
+            setItemValue(item(iRow, 0), iterator->first);
+            DataItemType const& array = iterator->second;
+            for (int iColumn = 1; iColumn < numColumns; ++iColumn)
+                setItemValue(item(iRow, iColumn), array[0][iColumn - 1]);
+        }
     }
+    emit dataChanged(index(iStartRow, 0), index(iEndRow, numColumns - 1));
 }
 
 //! Clear previously created items
@@ -69,109 +103,267 @@ bool SurfaceTableModel::setData(const QModelIndex& indexEdit, const QVariant& va
     if (role != Qt::UserRole)
         return false;
     int iRow = indexEdit.row();
+    int iColumn = indexEdit.column();
     double currentValue = data(indexEdit, Qt::UserRole).toDouble();
     double newValue = value.toDouble();
     bool isOkay = false;
     // Changing a leading key
     if (iRow == 0)
     {
-        isOkay = mpDataObject->changeLeadingItemKey(currentValue, newValue);
+        isOkay = mDelta.changeLeadingItemKey(*mpDataObject, currentValue, newValue);
     }
     else
     {
-        int iColumn = indexEdit.column();
         // Check whether a key or value was changed
         if (iColumn == 0)
         {
-            isOkay = mpDataObject->changeItemKey(currentValue, newValue);
+            isOkay = mDelta.changeItemKey(*mpDataObject, currentValue, newValue);
         }
         else
         {
             double key = data(index(iRow, 0), Qt::UserRole).toDouble();
-            isOkay = mpDataObject->setArrayValue(key, newValue, 0, iColumn - 1);
+            isOkay = mDelta.setArrayValue(*mpDataObject, key, newValue, 0, iColumn - 1);
         }
     }
-    // Display the results
-    if (isOkay)
-        updateContent();
-    return isOkay;
+    if (!isOkay)
+        return false;
+    // Display the changed value
+    QStandardItemModel::setData(indexEdit, value, Qt::UserRole);
+    QStandardItemModel::setData(indexEdit, QString::number(newValue, 'g', kNumShowPrecision), Qt::EditRole);
+    // Move either the column or the row to the sorted position
+    if (iRow == 0)
+    {
+        auto& leadingItems = mpDataObject->getLeadingItems();
+        int iNewColumn = 1 + std::distance(leadingItems.begin(), leadingItems.find(newValue));
+        if (iNewColumn != iColumn)
+            insertColumn(iNewColumn, takeColumn(iColumn));
+    }
+    else if (iColumn == 0)
+    {
+        auto& items = mpDataObject->getItems();
+        int iNewRow = 1 + std::distance(items.begin(), items.find(newValue));
+        if (iNewRow != iRow)
+            insertRow(iNewRow, takeRow(iRow));
+    }
+    return true;
 }
 
 //! Insert a new item after selected one
 void SurfaceTableModel::insertItemAfterSelected(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    QList<double> keys;
     if (listSelected.isEmpty())
     {
-        mpDataObject->addItem(0.0);
+        keys.push_back(0.0);
     }
     else
     {
-        quint32 iRow;
-        double key;
         for (QModelIndex& currentIndex : listSelected)
         {
-            iRow = currentIndex.row();
+            int iRow = currentIndex.row();
             if (iRow != 0)
-            {
-                key = index(iRow, 0).data(Qt::UserRole).toDouble();
-                mpDataObject->addItem(key);
-            }
+                keys.push_back(index(iRow, 0).data(Qt::UserRole).toDouble());
         }
     }
-    updateContent();
+    // Insert only the rows created
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
+    {
+        double newKey = mpDataObject->getAvailableItemKey(key);
+        DataItemType const& array = mDelta.addItem(*mpDataObject, newKey);
+        int iRow = 1 + std::distance(items.begin(), items.find(newKey));
+        insertRow(iRow, prepareRow(newKey, array, 0));
+    }
 }
 
 //! Remove an array under selection
 void SurfaceTableModel::removeSelectedItem(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
-    quint32 iRow;
-    double key;
+    QList<double> keys;
     for (QModelIndex& currentIndex : listSelected)
     {
-        iRow = currentIndex.row();
+        int iRow = currentIndex.row();
         if (iRow != 0)
-        {
-            key = index(iRow, 0).data(Qt::UserRole).toDouble();
-            mpDataObject->removeItem(key);
-        }
+            keys.push_back(index(iRow, 0).data(Qt::UserRole).toDouble());
+    }
+    // Remove only the rows which correspond to the deleted items
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
+    {
+        auto iterator = items.find(key);
+        if (iterator == items.end())
+            continue;
+        int iRow = 1 + std::distance(items.begin(), iterator);
+        mDelta.removeItem(*mpDataObject, key);
+        removeRow(iRow);
     }
-    updateContent();
 }
 
 //! Add a new leading item after selected one
 void SurfaceTableModel::insertLeadingItemAfterSelected(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
-    int iColumn;
-    double key;
+    QList<double> keys;
     for (QModelIndex& currentIndex : listSelected)
     {
-        iColumn = currentIndex.column();
+        int iColumn = currentIndex.column();
         if (iColumn > 0)
-        {
-            key = index(0, iColumn).data(Qt::UserRole).toDouble();
-            mpDataObject->addLeadingItem(key);
-        }
+            keys.push_back(index(0, iColumn).data(Qt::UserRole).toDouble());
+    }
+    // Insert only the columns created
+    auto& leadingItems = mpDataObject->getLeadingItems();
+    auto& items = mpDataObject->getItems();
+    for (double key : keys)
+    {
+        double newKey = mDelta.addLeadingItem(*mpDataObject, key);
+        int iColumn = 1 + std::distance(leadingItems.begin(), leadingItems.find(newKey));
+        QList<QStandardItem*> column;
+        column.push_back(makeDoubleItem(newKey));
+        for (auto& rowItem : items)
+            column.push_back(makeDoubleItem(rowItem.second[0][iColumn - 1]));
+        insertColumn(iColumn, column);
     }
-    updateContent();
 }
 
 //! Remove a selected leading item
 void SurfaceTableModel::removeSelectedLeadingItem(QItemSelectionModel* pSelectionModel)
 {
     QModelIndexList listSelected = pSelectionModel->selectedIndexes();
-    quint32 iColumn;
-    double key;
+    QList<double> keys;
     for (QModelIndex& currentIndex : listSelected)
     {
-        iColumn = currentIndex.column();
+        int iColumn = currentIndex.column();
         if (iColumn > 0)
+            keys.push_back(index(0, iColumn).data(Qt::UserRole).toDouble());
+    }
+    // Remove only the columns which correspond to the deleted leading items
+    auto& leadingItems = mpDataObject->getLeadingItems();
+    for (double key : keys)
+    {
+        auto iterator = leadingItems.find(key);
+        if (iterator == leadingItems.end() || leadingItems.size() == 1)
+            continue;
+        int iColumn = 1 + std::distance(leadingItems.begin(), iterator);
+        mDelta.removeLeadingItem(*mpDataObject, key);
+        removeColumn(iColumn);
+    }
+}
+
+/*!
+ * \brief Paste values starting from the upper left selected cell
+ *
+ * The first row of the table holds leading keys, and the first column holds keys of items.
+ * Items which do not fit are appended to the data object, while values beyond the last leading item are skipped.
+ * Views are notified once after all the values are applied.
+ */
+void SurfaceTableModel::pasteValues(QItemSelectionModel* pSelectionModel, ValuesTable const& values)
+{
+    if (!mpDataObject || values.isEmpty())
+        return;
+    QModelIndex indexStart = getTopLeftIndex(pSelectionModel->selectedIndexes());
+    int iStartRow = indexStart.isValid() ? indexStart.row() : 1;
+    int iStartColumn = indexStart.isValid() ? indexStart.column() : 0;
+    int numColumns = columnCount();
+    // Keys in the order they are represented
+    auto& items = mpDataObject->getItems();
+    QList<double> keys;
+    keys.reserve(qMax((int)items.size(), iStartRow + (int)values.size()));
+    for (auto& iterator : items)
+        keys.push_back(iterator.first);
+    QList<double> leadingKeys;
+    for (auto& iterator : mpDataObject->getLeadingItems())
+        leadingKeys.push_back(iterator.first);
+    bool isKeysChanged = false;
+    QList<double> const* pLeadingValues = nullptr;
+    int numValuesRows = values.size();
+    for (int i = 0; i != numValuesRows; ++i)
+    {
+        QList<double> const& rowValues = values[i];
+        int iRow = iStartRow + i;
+        int numRowValues = qMin((int)rowValues.size(), numColumns - iStartColumn);
+        // Leading keys are processed at the end, since their modification changes the order of columns
+        if (iRow == 0)
+        {
+            pLeadingValues = &rowValues;
+            continue;
+        }
+        // Create an item if the values do not fit
+        int iItem = iRow - 1;
+        if (iItem >= keys.size())
         {
-            key = index(0, iColumn).data(Qt::UserRole).toDouble();
-            mpDataObject->removeLeadingItem(key);
+            double key = keys.isEmpty() ? 0.0 : keys.last();
+            if (iStartColumn == 0 && !qIsNaN(rowValues[0]))
+                key = rowValues[0];
+            key = mpDataObject->getAvailableItemKey(key);
+            mDelta.addItem(*mpDataObject, key);
+            keys.push_back(key);
+            isKeysChanged = true;
+        }
+        for (int j = 0; j < numRowValues; ++j)
+        {
+            double value = rowValues[j];
+            int iColumn = iStartColumn + j;
+            if (qIsNaN(value))
+                continue;
+            if (iColumn == 0)
+            {
+                // Keys which are already used are shifted, so that the pasted rows are kept
+                double key = mpDataObject->getAvailableItemKey(value);
+                if (value != keys[iItem] && mDelta.changeItemKey(*mpDataObject, keys[iItem], key))
+                {
+                    keys[iItem] = key;
+                    isKeysChanged = true;
+                }
+            }
+            else
+            {
+                mDelta.setArrayValue(*mpDataObject, keys[iItem], value, 0, iColumn - 1);
+            }
         }
     }
-    updateContent();
+    if (pLeadingValues)
+    {
+        int numRowValues = qMin((int)pLeadingValues->size(), numColumns - iStartColumn);
+        for (int j = 0; j < numRowValues; ++j)
+        {
+            double value = pLeadingValues->at(j);
+            int iColumn = iStartColumn + j;
+            if (iColumn == 0 || qIsNaN(value) || value == leadingKeys[iColumn - 1])
+                continue;
+            double key = mpDataObject->getAvailableItemKey(value, &mpDataObject->getLeadingItems());
+            if (mDelta.changeLeadingItemKey(*mpDataObject, leadingKeys[iColumn - 1], key))
+                isKeysChanged = true;
+        }
+    }
+    if (isKeysChanged)
+        updateContent();
+    else
+        updateValues(iStartRow, iStartRow + numValuesRows - 1);
+}
+
+//! Modify values of selected cells except for keys by the given function
+void SurfaceTableModel::transformSelectedValues(QItemSelectionModel* pSelectionModel, std::function<double(double)> const& function)
+{
+    if (!mpDataObject)
+        return;
+    QModelIndexList listSelected = pSelectionModel->selectedIndexes();
+    int iStartRow = rowCount();
+    int iEndRow = -1;
+    for (QModelIndex& currentIndex : listSelected)
+    {
+        int iRow = currentIndex.row();
+        int iColumn = currentIndex.column();
+        if (iRow == 0 || iColumn == 0)
+            continue;
+        double key = index(iRow, 0).data(Qt::UserRole).toDouble();
+        double value = currentIndex.data(Qt::UserRole).toDouble();
+        if (mDelta.setArrayValue(*mpDataObject, key, function(value), 0, iColumn - 1))
+        {
+            iStartRow = qMin(iStartRow, iRow);
+            iEndRow = qMax(iEndRow, iRow);
+        }
+    }
+    updateValues(iStartRow, iEndRow);
 }
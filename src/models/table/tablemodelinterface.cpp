@@ -6,21 +6,139 @@
  */
 
 #include <QStandardItem>
+#include <QLocale>
+#include <QtMath>
+#include <algorithm>
 #include "tablemodelinterface.h"
 #include "core/array.h"
 
 using namespace QRS::TableModels;
 using namespace QRS::Core;
 
+//! Retrieve the edits of the data object made since the last call
+DataObjectDelta TableModelInterface::takeDelta()
+{
+    DataObjectDelta delta(mDelta.id());
+    std::swap(delta, mDelta);
+    return delta;
+}
+
 //! Helper function to make an item which holds a double value
 QStandardItem* TableModelInterface::makeDoubleItem(double value)
 {
     QStandardItem* item = new QStandardItem;
-    item->setData(value, Qt::UserRole);
-    item->setData(QString::number(value, 'g', kNumShowPrecision), Qt::EditRole);
+    setItemValue(item, value);
     return item;
 }
 
+//! Helper function to assign a double value to an item
+void TableModelInterface::setItemValue(QStandardItem* pItem, double value)
+{
+    pItem->setData(value, Qt::UserRole);
+    pItem->setData(QString::number(value, 'g', kNumShowPrecision), Qt::EditRole);
+}
+
+//! Compare indices by position in a table, so that rows of nested items follow their parents
+static bool isIndexBefore(QModelIndex const& first, QModelIndex const& second)
+{
+    int iFirstParentRow = first.parent().row();
+    int iSecondParentRow = second.parent().row();
+    if (iFirstParentRow != iSecondParentRow)
+        return iFirstParentRow < iSecondParentRow;
+    if (first.row() != second.row())
+        return first.row() < second.row();
+    return first.column() < second.column();
+}
+
+//! Retrieve the upper left index of a selection
+QModelIndex TableModelInterface::getTopLeftIndex(QModelIndexList const& indices)
+{
+    if (indices.isEmpty())
+        return QModelIndex();
+    return *std::min_element(indices.begin(), indices.end(), isIndexBefore);
+}
+
+/*!
+ * \brief Write values of indices using the format which spreadsheets accept
+ *
+ * Values are separated by tabulations and rows are separated by new lines. Cells which do not hold a number are left empty.
+ */
+QString TableModelInterface::copyValues(QModelIndexList indices)
+{
+    QString text;
+    if (indices.isEmpty())
+        return text;
+    std::sort(indices.begin(), indices.end(), isIndexBefore);
+    int iMinColumn = indices.first().column();
+    for (QModelIndex const& index : indices)
+        iMinColumn = qMin(iMinColumn, index.column());
+    QModelIndex const* pPreviousIndex = nullptr;
+    for (QModelIndex const& index : indices)
+    {
+        int iPreviousColumn = iMinColumn;
+        if (pPreviousIndex && pPreviousIndex->row() == index.row() && pPreviousIndex->parent() == index.parent())
+            iPreviousColumn = pPreviousIndex->column();
+        else if (pPreviousIndex)
+            text += '\n';
+        text += QString(index.column() - iPreviousColumn, '\t');
+        QVariant value = index.data(Qt::UserRole);
+        if (value.isValid())
+            text += QString::number(value.toDouble(), 'g', 17);
+        pPreviousIndex = &index;
+    }
+    text += '\n';
+    return text;
+}
+
+/*!
+ * \brief Parse rows of values in one pass
+ *
+ * Values are separated by tabulations or semicolons if the text contains them. Then commas are decimal separators,
+ * as spreadsheets write them in some locales. Otherwise, values are separated by commas unless the current locale
+ * uses them as decimal separators. Cells which do not contain a number are set to NaN, so that the corresponding
+ * values are left untouched while being pasted.
+ */
+ValuesTable TableModelInterface::parseValues(QString const& text)
+{
+    QChar separator = '\n';
+    if (text.contains('\t'))
+        separator = '\t';
+    else if (text.contains(';'))
+        separator = ';';
+    else if (QLocale().decimalPoint() != QString(','))
+        separator = ',';
+    bool isDecimalComma = separator != ',';
+    ValuesTable values;
+    QList<double> row;
+    QStringView const textView(text);
+    qsizetype const numSymbols = text.size();
+    qsizetype iStart = 0;
+    for (qsizetype i = 0; i <= numSymbols; ++i)
+    {
+        QChar symbol = i < numSymbols ? text[i] : QChar('\n');
+        bool isEndRow = symbol == '\n';
+        if (!isEndRow && symbol != separator)
+            continue;
+        QStringView token = textView.mid(iStart, i - iStart).trimmed();
+        bool isOkay = false;
+        double value;
+        if (isDecimalComma && token.contains(','))
+            value = token.toString().replace(',', '.').toDouble(&isOkay);
+        else
+            value = token.toDouble(&isOkay);
+        row.push_back(isOkay ? value : qQNaN());
+        iStart = i + 1;
+        if (isEndRow)
+        {
+            // Skip empty lines such as the trailing one
+            if (row.size() > 1 || !token.isEmpty())
+                values.push_back(row);
+            row.clear();
+        }
+    }
+    return values;
+}
+
 //! Helper function to create an item which holds a string and cannot be modfifed
 QStandardItem* TableModelInterface::makeLabelItem(QString const& name)
 {
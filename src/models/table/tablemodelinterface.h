@@ -9,6 +9,8 @@
 #define TABLEMODELINTERFACE_H
 
 #include <QItemSelection>
+#include <functional>
+#include "core/dataobjectdelta.h"
 
 QT_BEGIN_NAMESPACE
 class QStandardItem;
@@ -17,18 +19,15 @@ QT_END_NAMESPACE
 namespace QRS
 {
 
-namespace Core
-{
-template <typename T>
-class Array;
-}
-
 namespace TableModels
 {
 
 static const short kNumShowPrecision = 9;
 
-//! User interface to add and remove items
+//! Rows of values to exchange with the clipboard
+using ValuesTable = QList<QList<double>>;
+
+//! User interface to add and remove items. Edits of a data object are recorded to be undone
 class TableModelInterface
 {
 public:
@@ -36,12 +35,23 @@ public:
     virtual void insertLeadingItemAfterSelected(QItemSelectionModel* pSelectionModel) = 0;
     virtual void removeSelectedItem(QItemSelectionModel* pSelectionModel) = 0;
     virtual void removeSelectedLeadingItem(QItemSelectionModel* pSelectionModel) = 0;
+    virtual void pasteValues(QItemSelectionModel* pSelectionModel, ValuesTable const& values) = 0;
+    virtual void transformSelectedValues(QItemSelectionModel* pSelectionModel, std::function<double(double)> const& function) = 0;
     virtual ~TableModelInterface() { };
+    static QString copyValues(QModelIndexList indices);
+    static ValuesTable parseValues(QString const& text);
+    static QModelIndex getTopLeftIndex(QModelIndexList const& indices);
+    static void setItemValue(QStandardItem* pItem, double value);
     static QStandardItem* makeDoubleItem(double value);
     static QList<QStandardItem*> prepareRow(Core::Array<double> const& array, quint32 iRow);
     static QList<QStandardItem*> prepareRow(double const& key, Core::Array<double> const& array, quint32 iRow);
     static QList<QStandardItem*> prepareRow(QString const& name, Core::Array<double> const& array, quint32 iRow);
     static QStandardItem* makeLabelItem(QString const& name);
+    Core::DataObjectDelta takeDelta();
+
+protected:
+    //! Edits which have been made since the last time they were taken
+    Core::DataObjectDelta mDelta;
 };
 
 }
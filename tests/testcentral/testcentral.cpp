@@ -11,6 +11,8 @@
 
 #include "ui_mainwindow.h"
 #include "mainwindow.h"
+#include "logmodel.h"
+#include "logwidget.h"
 #include "utilities.h"
 
 using namespace QRS::Utilities;
@@ -28,6 +30,8 @@ public:
 private slots:
     void initTestCase();
     void cleanupTestCase();
+    void bufferMessages();
+    void writeLogFile();
     void testRun();
 
 private:
@@ -55,6 +59,61 @@ void TestCentral::initTestCase()
     mWindow->openProject("../../../../examples/test.qrs");
 }
 
+//! Queue messages in the circular buffer which overwrites the oldest ones
+void TestCentral::bufferMessages()
+{
+    int const kCapacity = 4;
+    int const kNumMessages = 10;
+    LogBuffer buffer(kCapacity);
+    QCOMPARE(buffer.capacity(), kCapacity);
+    QVERIFY(buffer.take().isEmpty());
+    int numDiscarded = 0;
+    for (int i = 0; i != kNumMessages; ++i)
+    {
+        if (!buffer.push({QTime::currentTime(), QtInfoMsg, QString::number(i)}))
+            ++numDiscarded;
+        QCOMPARE(buffer.size(), qMin(i + 1, kCapacity));
+    }
+    QCOMPARE(numDiscarded, kNumMessages - kCapacity);
+    QList<LogMessage> messages = buffer.take();
+    QCOMPARE(messages.size(), kCapacity);
+    for (int i = 0; i != kCapacity; ++i)
+        QCOMPARE(messages[i].text, QString::number(kNumMessages - kCapacity + i));
+    QCOMPARE(buffer.size(), 0);
+    QVERIFY(buffer.push({QTime::currentTime(), QtWarningMsg, "last"}));
+    messages = buffer.take();
+    QCOMPARE(messages.size(), 1);
+    QCOMPARE(messages.front().text, QString("last"));
+    // Rows of the log model are looked up and evicted through the buffer
+    buffer.push({QTime::currentTime(), QtInfoMsg, "first"});
+    buffer.push({QTime::currentTime(), QtInfoMsg, "second"});
+    QCOMPARE(buffer.at(1).text, QString("second"));
+    buffer.discard(1);
+    QCOMPARE(buffer.size(), 1);
+    QCOMPARE(buffer.at(0).text, QString("second"));
+    buffer.clear();
+    QCOMPARE(buffer.size(), 0);
+}
+
+//! Write all the logged messages to a file before the sink is removed
+void TestCentral::writeLogFile()
+{
+    int const kNumMessages = 1000;
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QString filePath = dir.filePath("test.log");
+    LogWidget widget;
+    QVERIFY(widget.setFileSink(filePath));
+    for (int i = 0; i != kNumMessages; ++i)
+        LogWidget::log(QtInfoMsg, QString("Message %1").arg(i));
+    widget.removeFileSink();
+    QFile file(filePath);
+    QVERIFY(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    QString content = QTextStream(&file).readAll();
+    for (int i = 0; i != kNumMessages; ++i)
+        QVERIFY(content.contains(QString("\tMessage %1\n").arg(i)));
+}
+
 //! Test run
 void TestCentral::testRun()
 {
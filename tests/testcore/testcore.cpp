@@ -6,6 +6,9 @@
  */
 
 #include <QtTest/QTest>
+#include <algorithm>
+#include <cmath>
+#include <numbers>
 
 #include "core/array.h"
 #include "core/project.h"
@@ -13,12 +16,26 @@
 #include "core/vectordataobject.h"
 #include "core/matrixdataobject.h"
 #include "core/hierarchytree.h"
+#include "core/edithistory.h"
+#include "core/expression.h"
+#include "core/deriveddataobject.h"
+#include "core/nameindex.h"
 #include "core/geometryrodcomponent.h"
 #include "core/usersectionrodcomponent.h"
 #include "core/materialrodcomponent.h"
 #include "core/loadrodcomponent.h"
 #include "core/constraintrodcomponent.h"
 #include "core/mechanicalrodcomponent.h"
+#include "core/rodassembly.h"
+#include "core/rodsampler.h"
+#include "core/arclengthparametrization.h"
+#include "core/movingframes.h"
+#include "core/rotations.h"
+#include "core/rodstaticsolver.h"
+#include "core/rodcontinuationsolver.h"
+#include "core/rodmodalsolver.h"
+#include "core/roddynamicsolver.h"
+#include "core/rodexplicitsolver.h"
 
 using namespace QRS::Core;
 
@@ -29,10 +46,18 @@ class TestCore : public QObject
 private slots:
     void initTestCase();
     void createArray();
+    void internNames();
+    void searchNames();
     void modifyArray();
     void importDataObjects();
     void saveProject();
     void readProject();
+    void applyDataObjects();
+    void commitTransaction();
+    void indexDependencies();
+    void undoEdits();
+    void evaluateExpression();
+    void deriveDataObject();
     void createHierarchyTree();
     void reorganizeHierarchyTree();
     void createGeometry();
@@ -41,6 +66,31 @@ private slots:
     void createLoad();
     void createConstraint();
     void createMechaincalComponent();
+    void assembleRod();
+    void sampleFields();
+    void parametrizeArcLength();
+    void generateFrames();
+    void multiplySmallMatrices();
+    void mapRotations();
+    void solveRodStatics();
+    void traceRodPath();
+    void solveRodModes();
+    void solveRodDynamics();
+    void solveRodExplicit();
+    void benchmarkSampling_data();
+    void benchmarkSampling();
+    void benchmarkRotations_data();
+    void benchmarkRotations();
+    void benchmarkExpression_data();
+    void benchmarkExpression();
+    void benchmarkRodStatics_data();
+    void benchmarkRodStatics();
+    void benchmarkRodModes_data();
+    void benchmarkRodModes();
+    void benchmarkRodDynamics_data();
+    void benchmarkRodDynamics();
+    void benchmarkRodExplicit_data();
+    void benchmarkRodExplicit();
     void cleanupTestCase();
 
 private:
@@ -50,6 +100,71 @@ private:
     const QString mImportPath = mBasePath + "preparation/dwds/input";
 };
 
+//! Whether rods with 10^5 stations are benchmarked. It takes long, so it is enabled by the environment variable
+static bool isLargeBenchmarksEnabled()
+{
+    return qEnvironmentVariableIsSet("QRS_LARGE_BENCHMARKS");
+}
+
+//! Cantilever along the Z axis which is clamped at the start and loaded by a point force at the tip in the X direction
+struct Cantilever
+{
+    static constexpr double kLength = 10.0;
+
+    explicit Cantilever(double bendingStiffnessY = 100.0)
+    {
+        radius.addItem(0.0)[0][2] = 0.0;
+        radius.addItem(kLength)[0][2] = kLength;
+        stiffness.addItem(0.0)[0][0] = 100.0;
+        bendingStiffness.addItem(0.0)[0][0] = bendingStiffnessY;
+        tensionStiffness.addItem(0.0)[0][0] = 1e5;
+        linearMassDensity.addItem(0.0)[0][0] = 1.0;
+        inertiaMassMoment.addItem(0.0)[0][0] = 1e-3;
+        direction.addItem(0.0)[0][0] = 1.0;
+        geometry.setRadiusVector(&radius);
+        mechanical.setTensionStiffness(&tensionStiffness);
+        mechanical.setTorsionalStiffness(&stiffness);
+        mechanical.setBendingStiffnessX(&stiffness);
+        mechanical.setBendingStiffnessY(&bendingStiffness);
+        mechanical.setLinearMassDensity(&linearMassDensity);
+        mechanical.setInertiaMassMomentX(&inertiaMassMoment);
+        mechanical.setInertiaMassMomentY(&inertiaMassMoment);
+        mechanical.setInertiaMassMomentZ(&inertiaMassMoment);
+        force.setType(LoadRodComponent::LoadType::kPointForce);
+        force.setDirectionVector(&direction);
+        for (int i = 0; i != 6; ++i)
+            clamp.setConstraint((ConstraintRodComponent::ConstraintType)i, ConstraintRodComponent::kGlobal);
+    }
+
+    RodComponents components()
+    {
+        return {{geometry.id(), &geometry}, {mechanical.id(), &mechanical}, {force.id(), &force}, {clamp.id(), &clamp}};
+    }
+
+    RodDefinition definition(quint32 numStations = RodDefinition().numStations) const
+    {
+        RodDefinition result;
+        result.geometryID = geometry.id();
+        result.mechanicalID = mechanical.id();
+        result.startConstraintID = clamp.id();
+        result.loadIDs = {force.id()};
+        result.numStations = numStations;
+        return result;
+    }
+
+    VectorDataObject radius{"Radius"};
+    ScalarDataObject stiffness{"Stiffness"};
+    ScalarDataObject bendingStiffness{"Bending stiffness"};
+    ScalarDataObject tensionStiffness{"Tension stiffness"};
+    ScalarDataObject linearMassDensity{"Linear mass density"};
+    ScalarDataObject inertiaMassMoment{"Inertia mass moment"};
+    VectorDataObject direction{"Direction"};
+    GeometryRodComponent geometry{"Geometry"};
+    MechanicalRodComponent mechanical{"Mechanical"};
+    LoadRodComponent force{"Force"};
+    ConstraintRodComponent clamp{"Clamp"};
+};
+
 //! Initialize data
 void TestCore::initTestCase()
 {
@@ -116,6 +231,80 @@ void TestCore::createArray()
     QCOMPARE(matrix.cols(), quint32(0));
 }
 
+//! Test sharing of names between data objects
+void TestCore::internNames()
+{
+    NamePool& pool = NamePool::instance();
+    quint32 numNames = pool.size();
+    ScalarDataObject first("Interned");
+    VectorDataObject second("Interned");
+    QCOMPARE(&first.name(), &second.name());
+    QCOMPARE(pool.size(), numNames + 1);
+    second.setName("Renamed");
+    QCOMPARE(first.name(), "Interned");
+    QCOMPARE(second.name(), "Renamed");
+    QCOMPARE(pool.size(), numNames + 2);
+    // Names are looked up by the strings which the pool owns rather than the ones passed
+    quint32 index;
+    {
+        QString name = QString("Temporary");
+        index = pool.acquire(name);
+        name.append(" name");
+    }
+    QCOMPARE(pool.name(index), "Temporary");
+    QCOMPARE(pool.acquire("Temporary"), index);
+    pool.release(index);
+    pool.release(index);
+    QCOMPARE(pool.size(), numNames + 2);
+}
+
+//! Test searching of entities by parts of their names
+void TestCore::searchNames()
+{
+    NameIndex index;
+    index.insert(1, "Stiffness 4213");
+    index.insert(2, "Stiffness 42");
+    index.insert(3, "Damping");
+    QVERIFY(index.find("stiff") == DataIDSet({1, 2}));
+    QVERIFY(index.find("4213") == DataIDSet({1}));
+    QVERIFY(index.find("a") == DataIDSet({3}));
+    QVERIFY(index.find("3124").empty());
+    QVERIFY(index.find("").empty());
+    // Trigrams of the pattern are present, but in another order
+    index.insert(4, "abcdbcde");
+    QVERIFY(index.find("abcde").empty());
+    // Renaming and removing
+    index.insert(3, "Stiffness 1");
+    QVERIFY(index.find("STIFFNESS") == DataIDSet({1, 2, 3}));
+    QVERIFY(index.find("damp").empty());
+    index.remove(1);
+    QVERIFY(index.find("stiffness 4") == DataIDSet({2}));
+    QCOMPARE(index.size(), quint32(3));
+    index.rename(2, "Stiffness 42", "Mass 42");
+    QVERIFY(index.find("stiff") == DataIDSet({3}));
+    QVERIFY(index.find("ss 4") == DataIDSet({2}));
+    // Following changes of entities
+    ScalarDataObject first("Length");
+    ScalarDataObject second("Width");
+    ScalarDataObject third("Height");
+    DataObjects dataObjects = {{first.id(), &first}, {second.id(), &second}};
+    index.clear();
+    for (auto const& [id, pDataObject] : dataObjects)
+        index.insert(id, pDataObject->name());
+    DataChangeSet changeSet;
+    dataObjects.erase(first.id());
+    changeSet.setRemoved(first.id());
+    second.setName("Depth");
+    changeSet.setRenamed(second.id());
+    dataObjects.emplace(third.id(), &third);
+    changeSet.setCreated(third.id());
+    index.update(changeSet, dataObjects);
+    QVERIFY(index.find("h") == DataIDSet({second.id(), third.id()}));
+    QVERIFY(index.find("wid").empty());
+    QVERIFY(index.find("len").empty());
+    QCOMPARE(index.size(), quint32(2));
+}
+
 //! Test how an array object can be modified
 void TestCore::modifyArray()
 {
@@ -127,6 +316,15 @@ void TestCore::modifyArray()
     t[1][1] = 15;
     QCOMPARE(map[1.0][0][0], 10);
     QCOMPARE(map[1.0][1][1], 15);
+    Array<double> row(1, 4);
+    for (quint32 j = 0; j != 4; ++j)
+        row[0][j] = j;
+    row.moveColumn(0, 2);
+    QCOMPARE(row[0][0], 1);
+    QCOMPARE(row[0][2], 0);
+    row.moveColumn(2, 0);
+    QCOMPARE(row[0][0], 0);
+    QCOMPARE(row[0][3], 3);
 }
 
 //! Try importing data objects
@@ -155,6 +353,271 @@ void TestCore::readProject()
     QCOMPARE(mpProject->numberRodComponents(), tempProject.numberRodComponents());
 }
 
+//! Apply a set of changes of data objects to a project
+void TestCore::applyDataObjects()
+{
+    Project tempProject("changed");
+    AbstractDataObject* pModified = tempProject.addDataObject(AbstractDataObject::ObjectType::kScalar);
+    AbstractDataObject* pRemoved = tempProject.addDataObject(AbstractDataObject::ObjectType::kVector);
+    GeometryRodComponent* pGeometry = (GeometryRodComponent*)tempProject.addGeometry();
+    pGeometry->setRadiusVector((VectorDataObject*)pRemoved);
+    DataObjects dataObjects = tempProject.cloneDataObjects();
+    HierarchyTree hierarchyDataObjects = tempProject.cloneHierarchyDataObjects();
+    DataChangeSet changeSet;
+    // Modifying
+    AbstractDataObject* pDataObject = dataObjects[pModified->id()];
+    pDataObject->addItem(1.0);
+    pDataObject->setName("Modified");
+    changeSet.setModified(pModified->id());
+    // Removing
+    DataIDType removedID = pRemoved->id();
+    delete dataObjects[removedID];
+    dataObjects.erase(removedID);
+    changeSet.setRemoved(removedID);
+    // Creating
+    pDataObject = new MatrixDataObject("Created");
+    dataObjects.emplace(pDataObject->id(), pDataObject);
+    DataIDType createdID = pDataObject->id();
+    changeSet.setCreated(createdID);
+    DataChangeSet reportedChanges;
+    QObject::connect(&tempProject, &Project::entitiesChanged, [&reportedChanges](DataChangeSet const& dataObjectChanges)
+    {
+        reportedChanges = dataObjectChanges;
+    });
+    tempProject.applyDataObjects(dataObjects, hierarchyDataObjects, changeSet);
+    QCOMPARE(tempProject.numberDataObjects(), DataIDType(2));
+    // Objects added to the project are reported with the applied changes
+    QVERIFY(reportedChanges.createdIDs() == DataIDSet({pModified->id(), createdID}));
+    QVERIFY(reportedChanges.removedIDs().empty());
+    QCOMPARE(pModified->name(), QString("Modified"));
+    QCOMPARE(pModified->numberItems(), quint32(1));
+    QVERIFY(!pGeometry->radiusVector());
+    for (auto& item : dataObjects)
+        delete item.second;
+    // Renaming in place
+    tempProject.renameDataObjects({pModified->id()}, "Renamed");
+    QCOMPARE(pModified->name(), QString("Renamed"));
+    QVERIFY(reportedChanges.renamedIDs() == DataIDSet({pModified->id()}));
+}
+
+//! Check that changes made within a transaction are reported once
+void TestCore::commitTransaction()
+{
+    Project tempProject("transaction");
+    AbstractDataObject* pRemoved = tempProject.addDataObject(AbstractDataObject::ObjectType::kVector);
+    GeometryRodComponent* pGeometry = (GeometryRodComponent*)tempProject.addGeometry();
+    pGeometry->setRadiusVector((VectorDataObject*)pRemoved);
+    int numNotifications = 0;
+    Project::Changes changes;
+    QObject::connect(&tempProject, &Project::changed, [&numNotifications, &changes](Project::Changes newChanges)
+    {
+        ++numNotifications;
+        changes = newChanges;
+    });
+    {
+        ProjectTransaction transaction(tempProject);
+        DataChangeSet changeSet;
+        changeSet.setRemoved(pRemoved->id());
+        tempProject.applyDataObjects(DataObjects(), tempProject.cloneHierarchyDataObjects(), changeSet);
+        tempProject.applyRodComponents(RodComponents(), tempProject.cloneHierarchyRodComponents(), DataChangeSet());
+        changeSet.clear();
+        changeSet.setHierarchyChanged();
+        tempProject.applyRodComponents(RodComponents(), tempProject.cloneHierarchyRodComponents(), changeSet);
+        QCOMPARE(numNotifications, 0);
+        QVERIFY(pGeometry->radiusVector());
+    }
+    QCOMPARE(numNotifications, 1);
+    QCOMPARE(changes, Project::kDataObjectsSubstituted | Project::kRodComponentsSubstituted);
+    QVERIFY(!pGeometry->radiusVector());
+}
+
+//! Check that the reverse index of references follows modifications of rod components
+void TestCore::indexDependencies()
+{
+    Project tempProject("dependencies");
+    ScalarDataObject* pScalar = (ScalarDataObject*)tempProject.addDataObject(AbstractDataObject::ObjectType::kScalar);
+    MaterialRodComponent* pMaterial = (MaterialRodComponent*)tempProject.addMaterial();
+    MechanicalRodComponent* pMechanical = (MechanicalRodComponent*)tempProject.addMechanical();
+    pMaterial->setElasticModulus(pScalar);
+    pMaterial->setDensity(pScalar);
+    pMechanical->setTensionStiffness(pScalar);
+    DataDependents const& dependents = tempProject.dependentRodComponents(pScalar->id());
+    QCOMPARE(dependents.size(), size_t(2));
+    pMaterial->setElasticModulus(nullptr);
+    QCOMPARE(dependents.size(), size_t(2));
+    pMaterial->setDensity(nullptr);
+    QCOMPARE(dependents.size(), size_t(1));
+    QVERIFY(dependents.contains(pMechanical));
+    // Derived objects are indexed by the names they refer to
+    DependencyIndex index;
+    DerivedDataObject derived(AbstractDataObject::ObjectType::kScalar, "EA", "[E] * [A]");
+    index.insertDerived(&derived);
+    QVERIFY(index.derivedDependents("E").contains(derived.id()));
+    QVERIFY(index.derivedDependents("A").contains(derived.id()));
+    derived.setFormula("[E] * 2");
+    index.insertDerived(&derived);
+    QVERIFY(index.derivedDependents("A").empty());
+    index.removeDerived(derived.id());
+    QVERIFY(index.derivedDependents("E").empty());
+}
+
+//! Undo and redo edits of data objects and their hierarchy by means of deltas
+void TestCore::undoEdits()
+{
+    const int kNumItems = 10000;
+    DataObjects dataObjects;
+    VectorDataObject* pVector = new VectorDataObject("Edited");
+    dataObjects.emplace(pVector->id(), pVector);
+    for (int i = 0; i != kNumItems; ++i)
+        pVector->addItem(i);
+    EditHistory history;
+    // Changing a value of each item
+    DataObjectDelta delta(pVector->id());
+    for (int i = 0; i != kNumItems; ++i)
+        QVERIFY(delta.setArrayValue(*pVector, i, 1.0, 0, 1));
+    QVERIFY(!delta.setArrayValue(*pVector, 0, 1.0, 0, 1));
+    QVERIFY(delta.isValuesOnly());
+    QVERIFY(delta.memorySize() < size_t(kNumItems) * 64);
+    history.pushDataObject(dataObjects, std::move(delta), true);
+    // Changing a key is not merged with the values
+    delta = DataObjectDelta(pVector->id());
+    QVERIFY(delta.changeItemKey(*pVector, 0, -1.0));
+    history.pushDataObject(dataObjects, std::move(delta), true);
+    QCOMPARE(history.numberEdits(), quint32(2));
+    DataChangeSet changeSet;
+    QVERIFY(history.undo(changeSet));
+    QVERIFY(changeSet.modifiedIDs().contains(pVector->id()));
+    QCOMPARE(pVector->getItems().begin()->first, 0.0);
+    QVERIFY(history.undo(changeSet));
+    QCOMPARE(pVector->getItems().at(kNumItems - 1)[0][1], 0.0);
+    QVERIFY(!history.canUndo());
+    QVERIFY(history.redo(changeSet));
+    QCOMPARE(pVector->getItems().at(kNumItems - 1)[0][1], 1.0);
+    // Removing an item
+    delta = DataObjectDelta(pVector->id());
+    delta.removeItem(*pVector, 1);
+    history.pushDataObject(dataObjects, std::move(delta));
+    QVERIFY(!history.canRedo());
+    QVERIFY(history.undo(changeSet));
+    QCOMPARE(pVector->getItems().at(1)[0][1], 1.0);
+    // Moving nodes of the hierarchy
+    HierarchyTree hierarchy;
+    HierarchyNode* pRootNode = hierarchy.root();
+    HierarchyNode* pNode = new HierarchyNode(HierarchyNode::NodeType::kObject, pVector->id());
+    HierarchyNode* pFolder = new HierarchyNode(HierarchyNode::NodeType::kDirectory, QString("Folder"));
+    pRootNode->appendChild(pNode);
+    pRootNode->appendChild(pFolder);
+    HierarchyDelta hierarchyDelta;
+    hierarchyDelta.recordBefore(pNode);
+    pNode->place(pFolder, nullptr);
+    hierarchyDelta.recordAfter();
+    QVERIFY(!hierarchyDelta.isEmpty());
+    history.pushStructure(dataObjects, std::move(hierarchyDelta));
+    QVERIFY(history.undo(changeSet));
+    QVERIFY(changeSet.isStructureChanged());
+    QCOMPARE(pNode->parent(), pRootNode);
+    QCOMPARE(pFolder->previousSibling(), pNode);
+    QVERIFY(history.redo(changeSet));
+    QCOMPARE(pNode->parent(), pFolder);
+    // Removing the object together with its node
+    hierarchyDelta = HierarchyDelta();
+    hierarchyDelta.recordBefore(pFolder);
+    pFolder->place(nullptr, nullptr);
+    hierarchyDelta.recordAfter();
+    dataObjects.erase(pVector->id());
+    history.pushStructure(dataObjects, std::move(hierarchyDelta), {}, {pVector});
+    QVERIFY(dataObjects.empty());
+    changeSet = DataChangeSet();
+    QVERIFY(history.undo(changeSet));
+    QVERIFY(changeSet.createdIDs().contains(pVector->id()));
+    QCOMPARE(dataObjects.at(pVector->id()), pVector);
+    QCOMPARE(pFolder->parent(), pRootNode);
+    QVERIFY(history.redo(changeSet));
+    QVERIFY(dataObjects.empty());
+    // The history owns the removed object and its nodes
+    history.clear();
+    QCOMPARE(pRootNode->numberChildren(), quint32(0));
+}
+
+//! Compile expressions and evaluate them over data objects
+void TestCore::evaluateExpression()
+{
+    // Compilation
+    QVERIFY(!Expression("1 +").isValid());
+    QVERIFY(!Expression("sin(1, 2)").isValid());
+    QVERIFY(!Expression("unknown").isValid());
+    QCOMPARE(Expression("2 * pi / 4").numberInstructions(), quint32(1));
+    Expression assignment("EA = [E] * [A]");
+    QVERIFY(assignment.isValid());
+    QCOMPARE(assignment.target(), "EA");
+    QCOMPARE(assignment.references(), QStringList({"E", "A"}));
+    // Evaluation of the values given
+    Expression expression("-2 ^ 2 + max(x, key) / 2");
+    double values[] = {1.0, 6.0};
+    double keys[] = {4.0, 2.0};
+    double const* variables[] = {values, keys};
+    expression.evaluate(variables, values, 2);
+    QCOMPARE(values[0], -2.0);
+    QCOMPARE(values[1], -1.0);
+    // Transformation of data objects, one of which is interpolated
+    ScalarDataObject modulus("E");
+    ScalarDataObject area("A");
+    ScalarDataObject stiffness("EA");
+    for (int i = 0; i != 3; ++i)
+    {
+        modulus.addItem(i)[0][0] = 100.0;
+        area.addItem(2 * i)[0][0] = i;
+        stiffness.addItem(i);
+    }
+    DataObjects dataObjects = {{modulus.id(), &modulus}, {area.id(), &area}, {stiffness.id(), &stiffness}};
+    QString errorMessage;
+    QVERIFY(assignment.apply(stiffness, dataObjects, errorMessage));
+    QCOMPARE(stiffness.getItems().at(1)[0][0], 50.0);
+    QCOMPARE(stiffness.getItems().at(2)[0][0], 100.0);
+    QVERIFY(!Expression("[Unknown] + 1").apply(stiffness, dataObjects, errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+//! Evaluate a data object by a formula on demand
+void TestCore::deriveDataObject()
+{
+    ScalarDataObject modulus("E");
+    ScalarDataObject area("A");
+    modulus.addItem(0.0)[0][0] = 100.0;
+    modulus.addItem(2.0)[0][0] = 100.0;
+    area.addItem(1.0)[0][0] = 2.0;
+    area.addItem(2.0)[0][0] = 4.0;
+    DerivedDataObject stiffness(AbstractDataObject::ObjectType::kScalar, "EA", "[E] * [A]");
+    DataObjects dataObjects = {{modulus.id(), &modulus}, {area.id(), &area}, {stiffness.id(), &stiffness}};
+    QVERIFY(!stiffness.evaluate());
+    DerivedDataObject::resolveAllReferences(dataObjects);
+    // Keys of both the inputs are merged
+    QCOMPARE(stiffness.getItems().size(), size_t(3));
+    QCOMPARE(stiffness.getItems().at(0.0)[0][0], 200.0);
+    QCOMPARE(stiffness.getItems().at(2.0)[0][0], 400.0);
+    // Items are recomputed only after the inputs are modified
+    quint64 version = stiffness.version();
+    QVERIFY(stiffness.evaluate());
+    QCOMPARE(stiffness.version(), version);
+    modulus.setArrayValue(2.0, 50.0);
+    QCOMPARE(stiffness.getItems().at(2.0)[0][0], 200.0);
+    QVERIFY(stiffness.version() != version);
+    // Only the formula is written
+    QByteArray data;
+    QDataStream outStream(&data, QIODevice::WriteOnly);
+    outStream << stiffness;
+    QDataStream inStream(data);
+    quint32 type;
+    QString name;
+    inStream >> type >> name;
+    QVERIFY(type & DerivedDataObject::kSerializationFlag);
+    DerivedDataObject copy((AbstractDataObject::ObjectType)(type & ~DerivedDataObject::kSerializationFlag), name);
+    copy.deserialize(inStream);
+    QCOMPARE(copy.formula(), stiffness.formula());
+    QVERIFY(copy.resolveReferences(dataObjects));
+    QCOMPARE(copy.getItems().at(1.0)[0][0], 150.0);
+}
+
 //! Try creating a hierarchial tree
 void TestCore::createHierarchyTree()
 {
@@ -224,10 +687,15 @@ void TestCore::createGeometry()
     MatrixDataObject* pRotationMatrix = new MatrixDataObject("Rotation");
     GeometryRodComponent geometry("Geometry");
     geometry.setRadiusVector(pRadiusVector);
+    QVERIFY(geometry.isDataComplete());
     geometry.setRotationMatrix(pRotationMatrix);
     QVERIFY(geometry.isDataComplete());
     delete pRadiusVector;
     QVERIFY(!geometry.isDataComplete());
+    // The slot of the deleted object is reused, but the stale reference is still rejected
+    VectorDataObject* pReusedVector = new VectorDataObject("Reused");
+    QVERIFY(!geometry.radiusVector());
+    delete pReusedVector;
     delete pRotationMatrix;
 }
 
@@ -287,6 +755,986 @@ void TestCore::createMechaincalComponent()
     delete pUniversal;
 }
 
+//! Compile rod components into buffers sampled at stations
+void TestCore::assembleRod()
+{
+    VectorDataObject radius("Radius");
+    radius.addItem(0.0)[0][0] = 0.0;
+    radius.addItem(10.0)[0][0] = 10.0;
+    ScalarDataObject area("Area");
+    area.addItem(0.0)[0][0] = 1.0;
+    area.addItem(10.0)[0][0] = 3.0;
+    ScalarDataObject inertiaMoment("Inertia moment");
+    inertiaMoment.addItem(0.0)[0][0] = 0.5;
+    ScalarDataObject modulus("E");
+    modulus.addItem(0.0)[0][0] = 100.0;
+    ScalarDataObject poissonsRatio("Nu");
+    poissonsRatio.addItem(0.0)[0][0] = 0.25;
+    VectorDataObject direction("Direction");
+    direction.addItem(0.0)[0][2] = -1.0;
+    GeometryRodComponent geometry("Geometry");
+    geometry.setRadiusVector(&radius);
+    UserSectionRodComponent section("Section");
+    section.setArea(&area);
+    section.setInertiaMomentX(&inertiaMoment);
+    section.setInertiaMomentY(&inertiaMoment);
+    MaterialRodComponent material("Material");
+    material.setElasticModulus(&modulus);
+    material.setPoissonsRatio(&poissonsRatio);
+    LoadRodComponent load("Load");
+    load.setType(LoadRodComponent::LoadType::kDistributedForce);
+    load.setDirectionVector(&direction);
+    load.setMultiplier(2.0);
+    ConstraintRodComponent constraint("Clamp");
+    constraint.setConstraint(ConstraintRodComponent::kDisplacementX, ConstraintRodComponent::kGlobal);
+    constraint.setConstraint(ConstraintRodComponent::kRotationZ, ConstraintRodComponent::kLocal);
+    RodComponents rodComponents = {{geometry.id(), &geometry}, {section.id(), &section}, {material.id(), &material},
+                                   {load.id(), &load}, {constraint.id(), &constraint}};
+    RodDefinition definition;
+    definition.geometryID = geometry.id();
+    definition.numStations = 11;
+    RodAssembly assembly;
+    QVERIFY(!assembly.assemble(definition, rodComponents));
+    definition.sectionID = section.id();
+    definition.materialID = material.id();
+    definition.loadIDs = {load.id()};
+    definition.startConstraintID = constraint.id();
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    QVERIFY(!assembly.isCached());
+    RodBuffers const& buffers = assembly.buffers();
+    QCOMPARE(buffers.numStations(), quint32(11));
+    QCOMPARE(buffers.arcLengths[10], 10.0);
+    QCOMPARE(buffers.positions[0][5], 5.0);
+    QCOMPARE(buffers.curvatures[5], 0.0);
+    // Frames are generated, so the tangent is the third column
+    QCOMPARE(buffers.frames[2][5], 1.0);
+    QCOMPARE(buffers.tensionStiffness[5], 200.0);
+    QCOMPARE(buffers.bendingStiffnessX[10], 50.0);
+    QCOMPARE(buffers.torsionalStiffness[0], 40.0);
+    QCOMPARE(buffers.loads.size(), size_t(1));
+    QCOMPARE(buffers.loads[0].values[2][3], -2.0);
+    QCOMPARE(buffers.constraintMasks[0], quint8(0b100001));
+    QCOMPARE(buffers.localConstraintMasks[0], quint8(0b100000));
+    QCOMPARE(buffers.constraintMasks[10], quint8(0));
+    // Buffers are reused until one of the inputs is modified
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    QVERIFY(assembly.isCached());
+    modulus.setArrayValue(0.0, 200.0);
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    QVERIFY(!assembly.isCached());
+    QCOMPARE(buffers.tensionStiffness[5], 400.0);
+}
+
+//! Check that the fused sampling coincides with the sampling of each object separately
+void TestCore::sampleFields()
+{
+    ScalarDataObject first("First");
+    ScalarDataObject second("Second");
+    VectorDataObject vector("Vector");
+    for (int i = 0; i != 5; ++i)
+    {
+        first.addItem(i)[0][0] = i * i;
+        second.addItem(i)[0][0] = -i;
+        DataItemType& item = vector.addItem(0.5 * i);
+        item[0][0] = i;
+        item[0][2] = 1.0 - i;
+    }
+    std::vector<double> parameters = {-1.0, 0.0, 0.25, 1.5, 2.0, 3.9, 4.0, 7.0};
+    quint32 numParameters = parameters.size();
+    std::vector<std::vector<double>> fused(6, std::vector<double>(numParameters));
+    RodSampler sampler;
+    sampler.addField(&first, 0, fused[0].data());
+    sampler.addField(&second, 0, fused[1].data());
+    sampler.addField(&vector, 0, fused[2].data());
+    sampler.addField(&vector, 2, fused[3].data());
+    sampler.addField(nullptr, 0, fused[4].data(), 1.0);
+    sampler.addField(&first, 5, fused[5].data());
+    sampler.sample(parameters);
+    // Both the scalars share the same keys
+    QCOMPARE(sampler.numGrids(), quint32(2));
+    auto isEqual = [&parameters](AbstractDataObject const* pDataObject, IndexType iElement, std::vector<double> const& values)
+    {
+        std::vector<double> separate;
+        RodAssembly::sampleElement(pDataObject, iElement, parameters, separate);
+        return std::equal(separate.begin(), separate.end(), values.begin(),
+                          [](double first, double second) { return std::abs(first - second) < 1e-12; });
+    };
+    QVERIFY(isEqual(&first, 0, fused[0]));
+    QVERIFY(isEqual(&second, 0, fused[1]));
+    QVERIFY(isEqual(&vector, 0, fused[2]));
+    QVERIFY(isEqual(&vector, 2, fused[3]));
+    QVERIFY(std::all_of(fused[4].begin(), fused[4].end(), [](double value) { return value == 1.0; }));
+    // Elements of scalars are broadcasted
+    QVERIFY(fused[5] == fused[0]);
+    // Flattened objects are updated as soon as they are modified
+    second.setArrayValue(4.0, 0.0);
+    sampler.sample(parameters);
+    QVERIFY(isEqual(&second, 0, fused[1]));
+    // Stations may be given in any order
+    std::vector<double> sorted = fused[0];
+    std::reverse(parameters.begin(), parameters.end());
+    sampler.sample(parameters);
+    std::reverse(fused[0].begin(), fused[0].end());
+    QVERIFY(fused[0] == sorted);
+}
+
+//! Relate parameters of a helix with its arc length
+void TestCore::parametrizeArcLength()
+{
+    double const kRadius = 2.0;
+    double const kPitch = 0.5;
+    double const kSpeed = std::sqrt(kRadius * kRadius + kPitch * kPitch);
+    double const kEndParameter = 4.0 * std::numbers::pi;
+    int const kNumPoints = 200;
+    VectorDataObject helix("Helix");
+    for (int i = 0; i <= kNumPoints; ++i)
+    {
+        double parameter = kEndParameter * i / kNumPoints;
+        DataItemType& item = helix.addItem(parameter);
+        item[0][0] = kRadius * std::cos(parameter);
+        item[0][1] = kRadius * std::sin(parameter);
+        item[0][2] = kPitch * parameter;
+    }
+    ArcLengthParametrization parametrization;
+    QVERIFY(parametrization.update(&helix));
+    QVERIFY(!parametrization.isCached());
+    QVERIFY(std::abs(parametrization.length() - kSpeed * kEndParameter) < 1e-4);
+    // Inverse mapping
+    std::vector<double> arcLengths = {0.0, 1.0, 10.0, parametrization.length()};
+    std::vector<double> parameters, mappedArcLengths;
+    parametrization.computeParameters(arcLengths, parameters);
+    parametrization.computeArcLengths(parameters, mappedArcLengths);
+    for (quint32 i = 0; i != arcLengths.size(); ++i)
+    {
+        QVERIFY(std::abs(parameters[i] - arcLengths[i] / kSpeed) < 1e-4);
+        QVERIFY(std::abs(mappedArcLengths[i] - arcLengths[i]) < 1e-9);
+    }
+    // Curvature and torsion
+    std::vector<double> curvatures, torsions;
+    parametrization.computeCurvatures(parameters, curvatures, torsions);
+    QVERIFY(std::abs(curvatures[2] - kRadius / (kSpeed * kSpeed)) < 1e-3);
+    QVERIFY(std::abs(torsions[2] - kPitch / (kSpeed * kSpeed)) < 1e-3);
+    // The table is rebuilt only after the geometry is modified
+    QVERIFY(parametrization.update(&helix));
+    QVERIFY(parametrization.isCached());
+    helix.setArrayValue(0.0, 1.0, 0, 2);
+    QVERIFY(parametrization.update(&helix));
+    QVERIFY(!parametrization.isCached());
+}
+
+//! Generate frames along a helix and check that the rotation-minimizing ones do not twist
+void TestCore::generateFrames()
+{
+    double const kRadius = 2.0;
+    double const kPitch = 0.5;
+    double const kEndParameter = 4.0 * std::numbers::pi;
+    int const kNumPoints = 200;
+    quint32 const kNumStations = 20001;
+    VectorDataObject helix("Helix");
+    for (int i = 0; i <= kNumPoints; ++i)
+    {
+        double parameter = kEndParameter * i / kNumPoints;
+        DataItemType& item = helix.addItem(parameter);
+        item[0][0] = kRadius * std::cos(parameter);
+        item[0][1] = kRadius * std::sin(parameter);
+        item[0][2] = kPitch * parameter;
+    }
+    ArcLengthParametrization parametrization;
+    QVERIFY(parametrization.update(&helix));
+    std::vector<double> parameters(kNumStations);
+    for (quint32 i = 0; i != kNumStations; ++i)
+        parameters[i] = kEndParameter * i / (kNumStations - 1);
+    MovingFrames movingFrames;
+    std::array<std::vector<double>, 9> frames, serialFrames, frenetFrames;
+    movingFrames.compute(parametrization, parameters, MovingFrames::kRotationMinimizing, frames);
+    movingFrames.setParallel(false);
+    movingFrames.compute(parametrization, parameters, MovingFrames::kRotationMinimizing, serialFrames);
+    movingFrames.compute(parametrization, parameters, MovingFrames::kFrenet, frenetFrames);
+    for (quint32 i = 0; i != kNumStations; ++i)
+    {
+        for (int j = 0; j != 9; ++j)
+            QVERIFY(std::abs(frames[j][i] - serialFrames[j][i]) < 1e-12);
+        // Columns are orthonormal
+        for (int j = 0; j != 3; ++j)
+        {
+            for (int k = 0; k != 3; ++k)
+            {
+                double product = 0.0;
+                for (int m = 0; m != 3; ++m)
+                    product += frames[3 * m + j][i] * frames[3 * m + k][i];
+                QVERIFY(std::abs(product - (j == k ? 1.0 : 0.0)) < 1e-12);
+            }
+        }
+        // The normal does not rotate around the tangent
+        if (i + 1 != kNumStations)
+        {
+            double twist = 0.0;
+            for (int m = 0; m != 3; ++m)
+                twist += (frames[3 * m][i + 1] - frames[3 * m][i]) * frames[3 * m + 1][i];
+            QVERIFY(std::abs(twist) < 1e-9);
+        }
+    }
+    // The principal normal of the helix points to its axis
+    QVERIFY(std::abs(frenetFrames[0][0] + 1.0) < 1e-6);
+    MatrixDataObject* pFrames = MovingFrames::createDataObject("Frames", parameters, frames);
+    QCOMPARE(pFrames->getItems().size(), size_t(kNumStations));
+    delete pFrames;
+}
+
+//! Compare products of small matrices and their batches with the naive ones
+void TestCore::multiplySmallMatrices()
+{
+    Matrix66 first, second;
+    for (int i = 0; i != 36; ++i)
+    {
+        first[i] = std::sin(i + 1.0);
+        second[i] = std::cos(2.0 * i);
+    }
+    Matrix66 product = first * second;
+    Matrix66 transposedProduct = transposeProduct(first, second);
+    for (int i = 0; i != 6; ++i)
+    {
+        for (int j = 0; j != 6; ++j)
+        {
+            double value = 0.0;
+            double transposedValue = 0.0;
+            for (int k = 0; k != 6; ++k)
+            {
+                value += first(i, k) * second(k, j);
+                transposedValue += first(k, i) * second(k, j);
+            }
+            QVERIFY(std::abs(product(i, j) - value) < 1e-14);
+            QVERIFY(std::abs(transposedProduct(i, j) - transposedValue) < 1e-14);
+        }
+    }
+    // Lanes of batches are independent
+    BatchMatrix<6, 6, 8> firstBatch, secondBatch, productBatch, transposedProductBatch;
+    for (int l = 0; l != 8; ++l)
+    {
+        firstBatch.set(l, (l + 1.0) * first);
+        secondBatch.set(l, second - (double)l * first);
+    }
+    multiply(firstBatch, secondBatch, productBatch);
+    transposeProduct(firstBatch, secondBatch, transposedProductBatch);
+    for (int l = 0; l != 8; ++l)
+    {
+        Matrix66 expected = firstBatch.get(l) * secondBatch.get(l);
+        Matrix66 transposedExpected = firstBatch.get(l).transpose() * secondBatch.get(l);
+        for (int i = 0; i != 36; ++i)
+        {
+            QVERIFY(std::abs(productBatch.get(l)[i] - expected[i]) < 1e-12);
+            QVERIFY(std::abs(transposedProductBatch.get(l)[i] - transposedExpected[i]) < 1e-12);
+        }
+    }
+    // Batches are gathered from and scattered to buffers of stations, the last batch is incomplete
+    std::array<std::vector<double>, 3> vectors, copies;
+    for (int k = 0; k != 3; ++k)
+    {
+        vectors[k] = {1.0 + k, 2.0 + k, 3.0 + k, 4.0 + k, 5.0 + k, 6.0 + k};
+        copies[k].assign(6, 0.0);
+    }
+    for (quint32 i = 0; i < 6; i += skBatchWidth)
+    {
+        BatchVector3<> batch;
+        batch.load(vectors, i);
+        batch.store(copies, i);
+    }
+    QVERIFY(copies == vectors);
+}
+
+//! Check that the maps between rotation vectors, matrices and quaternions are consistent for all the angles
+void TestCore::mapRotations()
+{
+    using namespace QRS::Core::Rotations;
+    double const kAlmostPi = std::numbers::pi - 1e-7;
+    std::vector<Vector3> const vectors = {{0.0, 0.0, 0.0}, {1e-9, -2e-9, 3e-9}, {1e-3, 2e-3, -1e-3}, {0.3, -0.2, 0.5},
+                                          {1.0, 2.0, -0.5}, {kAlmostPi, 0.0, 0.0}, {0.0, -kAlmostPi / std::sqrt(2.0), kAlmostPi / std::sqrt(2.0)},
+                                          {-2.0, 0.5, 0.5}};
+    auto isClose = [](auto const& first, auto const& second, double tolerance)
+    {
+        for (quint32 i = 0; i != first.data.size(); ++i)
+        {
+            if (std::abs(first[i] - second[i]) > tolerance)
+                return false;
+        }
+        return true;
+    };
+    BatchVector3<8> vectorsBatch;
+    for (int l = 0; l != 8; ++l)
+    {
+        Vector3 const& vector = vectors[l];
+        Matrix33 rotation = expMap(vector);
+        QVERIFY(isClose(transposeProduct(rotation, rotation), Matrix33::identity(), 1e-15));
+        QVERIFY(isClose(rotation * vector, vector, 1e-15));
+        QVERIFY(isClose(logMap(rotation), vector, 1e-8));
+        QVERIFY(isClose(fromQuaternion(toQuaternion(rotation)), rotation, 1e-15));
+        QVERIFY(isClose(expMap(vector) * skew(vector) * expMap(-1.0 * vector), skew(vector), 1e-14));
+        QVERIFY(isClose(inverseCayley(cayley(vector)), vector, 1e-14));
+        vectorsBatch.set(l, vector);
+    }
+    // Batched maps coincide with the scalar ones
+    BatchMatrix33<8> rotationsBatch, cayleyBatch;
+    BatchVector3<8> logBatch, inverseCayleyBatch;
+    expMap(vectorsBatch, rotationsBatch);
+    logMap(rotationsBatch, logBatch);
+    cayley(vectorsBatch, cayleyBatch);
+    inverseCayley(cayleyBatch, inverseCayleyBatch);
+    for (int l = 0; l != 8; ++l)
+    {
+        QVERIFY(isClose(rotationsBatch.get(l), expMap(vectors[l]), 1e-15));
+        QVERIFY(isClose(logBatch.get(l), logMap(expMap(vectors[l])), 1e-14));
+        QVERIFY(isClose(cayleyBatch.get(l), cayley(vectors[l]), 1e-15));
+        QVERIFY(isClose(inverseCayleyBatch.get(l), vectors[l], 1e-14));
+    }
+}
+
+//! Bend a cantilever by a small tip force and roll it into a circle by an end moment
+void TestCore::solveRodStatics()
+{
+    double const kLength = 10.0;
+    double const kStiffness = 1e4;
+    VectorDataObject radius("Radius");
+    radius.addItem(0.0)[0][0] = 0.0;
+    radius.addItem(kLength)[0][0] = kLength;
+    ScalarDataObject area("Area");
+    area.addItem(0.0)[0][0] = 1.0;
+    ScalarDataObject inertiaMoment("Inertia moment");
+    inertiaMoment.addItem(0.0)[0][0] = 0.01;
+    ScalarDataObject modulus("E");
+    modulus.addItem(0.0)[0][0] = 1e6;
+    ScalarDataObject poissonsRatio("Nu");
+    poissonsRatio.addItem(0.0)[0][0] = 0.25;
+    VectorDataObject direction("Direction");
+    direction.addItem(0.0)[0][1] = 1.0;
+    VectorDataObject axis("Axis");
+    axis.addItem(0.0)[0][2] = 1.0;
+    GeometryRodComponent geometry("Geometry");
+    geometry.setRadiusVector(&radius);
+    UserSectionRodComponent section("Section");
+    section.setArea(&area);
+    section.setInertiaMomentX(&inertiaMoment);
+    section.setInertiaMomentY(&inertiaMoment);
+    MaterialRodComponent material("Material");
+    material.setElasticModulus(&modulus);
+    material.setPoissonsRatio(&poissonsRatio);
+    LoadRodComponent force("Force");
+    force.setType(LoadRodComponent::LoadType::kPointForce);
+    force.setDirectionVector(&direction);
+    LoadRodComponent moment("Moment");
+    moment.setType(LoadRodComponent::LoadType::kPointMoment);
+    moment.setDirectionVector(&axis);
+    moment.setMultiplier(2.0 * std::numbers::pi * kStiffness / kLength);
+    ConstraintRodComponent clamp("Clamp");
+    for (int i = 0; i != 6; ++i)
+        clamp.setConstraint((ConstraintRodComponent::ConstraintType)i, ConstraintRodComponent::kGlobal);
+    RodComponents rodComponents = {{geometry.id(), &geometry}, {section.id(), &section}, {material.id(), &material},
+                                   {force.id(), &force}, {moment.id(), &moment}, {clamp.id(), &clamp}};
+    RodDefinition definition;
+    definition.geometryID = geometry.id();
+    definition.sectionID = section.id();
+    definition.materialID = material.id();
+    definition.loadIDs = {force.id()};
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    RodStaticSolver solver;
+    QVERIFY(!solver.solve(assembly.buffers()));
+    QVERIFY(!solver.errorMessage().isEmpty());
+    // Deflection of the tip includes the shear
+    definition.startConstraintID = clamp.id();
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    QVERIFY(solver.solve(assembly.buffers()));
+    RodState const& state = solver.state();
+    quint32 iTip = state.numStations() - 1;
+    double shearStiffness = 1e6 / (2.0 * 1.25);
+    double deflection = std::pow(kLength, 3) / (3.0 * kStiffness) + kLength / shearStiffness;
+    QVERIFY(std::abs(state.positions[1][iTip] / deflection - 1.0) < 1e-3);
+    QVERIFY(solver.numIterations() < 5);
+    // The moment bends the rod into a circle, so that the tip comes back to the clamp
+    definition.loadIDs = {moment.id()};
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    RodStaticOptions options;
+    options.numLoadSteps = 2;
+    QVERIFY(solver.solve(assembly.buffers(), options));
+    for (int k = 0; k != 3; ++k)
+        QVERIFY(std::abs(state.positions[k][iTip]) < 1e-8 * kLength);
+    for (quint32 i = 0; i != iTip; ++i)
+    {
+        double bendingMoment = std::hypot(state.moments[0][i], state.moments[1][i]);
+        QVERIFY(std::abs(bendingMoment / moment.multiplier() - 1.0) < 1e-8);
+    }
+}
+
+//! Trace the snap-through of a shallow frame by the arc-length method
+void TestCore::traceRodPath()
+{
+    double const kSpan = 10.0;
+    double const kRise = 0.4;
+    // Half of a symmetric frame: the apex can move only across the span
+    VectorDataObject radius("Radius");
+    radius.addItem(0.0)[0][0] = 0.0;
+    auto& apex = radius.addItem(kSpan);
+    apex[0][0] = kSpan;
+    apex[0][1] = kRise;
+    ScalarDataObject area("Area");
+    area.addItem(0.0)[0][0] = 1.0;
+    ScalarDataObject inertiaMoment("Inertia moment");
+    inertiaMoment.addItem(0.0)[0][0] = 1e-3;
+    ScalarDataObject modulus("E");
+    modulus.addItem(0.0)[0][0] = 1e6;
+    VectorDataObject direction("Direction");
+    direction.addItem(0.0)[0][1] = -1.0;
+    GeometryRodComponent geometry("Geometry");
+    geometry.setRadiusVector(&radius);
+    UserSectionRodComponent section("Section");
+    section.setArea(&area);
+    section.setInertiaMomentX(&inertiaMoment);
+    section.setInertiaMomentY(&inertiaMoment);
+    MaterialRodComponent material("Material");
+    material.setElasticModulus(&modulus);
+    LoadRodComponent force("Force");
+    force.setType(LoadRodComponent::LoadType::kPointForce);
+    force.setDirectionVector(&direction);
+    force.setMultiplier(100.0);
+    ConstraintRodComponent clamp("Clamp");
+    ConstraintRodComponent symmetry("Symmetry");
+    for (int i = 0; i != 6; ++i)
+    {
+        clamp.setConstraint((ConstraintRodComponent::ConstraintType)i, ConstraintRodComponent::kGlobal);
+        if (i != ConstraintRodComponent::kDisplacementY)
+            symmetry.setConstraint((ConstraintRodComponent::ConstraintType)i, ConstraintRodComponent::kGlobal);
+    }
+    RodComponents rodComponents = {{geometry.id(), &geometry}, {section.id(), &section}, {material.id(), &material},
+                                   {force.id(), &force}, {clamp.id(), &clamp}, {symmetry.id(), &symmetry}};
+    RodDefinition definition;
+    definition.geometryID = geometry.id();
+    definition.sectionID = section.id();
+    definition.materialID = material.id();
+    definition.loadIDs = {force.id()};
+    definition.startConstraintID = clamp.id();
+    definition.endConstraintID = symmetry.id();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    // Record the load-deflection path of the apex
+    std::vector<double> loadFactors;
+    std::vector<double> deflections;
+    auto writer = [&](double loadFactor, RodState const& state)
+    {
+        loadFactors.push_back(loadFactor);
+        deflections.push_back(kRise - state.positions[1][state.numStations() - 1]);
+        return true;
+    };
+    RodContinuationSolver solver;
+    RodContinuationOptions options;
+    options.maxNumSteps = 50;
+    options.maxLoadFactor = 10.0;
+    options.initialLoadStep = 0.02;
+    QVERIFY(solver.solve(assembly.buffers(), options, writer));
+    QCOMPARE(loadFactors.size(), std::size_t(options.maxNumSteps));
+    QCOMPARE(solver.loadFactor(), loadFactors.back());
+    QVERIFY(std::is_sorted(deflections.begin(), deflections.end()));
+    // The load passes through a maximum, and the apex ends up below the supports
+    auto iLimit = std::max_element(loadFactors.begin(), loadFactors.end() - 1) - loadFactors.begin();
+    QVERIFY(iLimit > 0);
+    QVERIFY(*std::min_element(loadFactors.begin() + iLimit, loadFactors.end()) < loadFactors[iLimit]);
+    QVERIFY(deflections.back() > 2.0 * kRise);
+    // Most of the iterations reuse the factorization of the tangent matrix
+    QVERIFY(solver.numFactorizations() < solver.numSteps());
+}
+
+//! Compute natural modes of a cantilever with different bending stiffnesses
+void TestCore::solveRodModes()
+{
+    double const kLength = 10.0;
+    double const kLinearMassDensity = 5.0;
+    VectorDataObject radius("Radius");
+    radius.addItem(0.0)[0][0] = 0.0;
+    radius.addItem(kLength)[0][0] = kLength;
+    ScalarDataObject tensionStiffness("Tension stiffness");
+    tensionStiffness.addItem(0.0)[0][0] = 1e5;
+    ScalarDataObject torsionalStiffness("Torsional stiffness");
+    torsionalStiffness.addItem(0.0)[0][0] = 100.0;
+    ScalarDataObject bendingStiffnessX("Bending stiffness X");
+    bendingStiffnessX.addItem(0.0)[0][0] = 100.0;
+    ScalarDataObject bendingStiffnessY("Bending stiffness Y");
+    bendingStiffnessY.addItem(0.0)[0][0] = 200.0;
+    ScalarDataObject linearMassDensity("Linear mass density");
+    linearMassDensity.addItem(0.0)[0][0] = kLinearMassDensity;
+    GeometryRodComponent geometry("Geometry");
+    geometry.setRadiusVector(&radius);
+    MechanicalRodComponent mechanical("Mechanical");
+    mechanical.setTensionStiffness(&tensionStiffness);
+    mechanical.setTorsionalStiffness(&torsionalStiffness);
+    mechanical.setBendingStiffnessX(&bendingStiffnessX);
+    mechanical.setBendingStiffnessY(&bendingStiffnessY);
+    mechanical.setLinearMassDensity(&linearMassDensity);
+    ConstraintRodComponent clamp("Clamp");
+    for (int i = 0; i != 6; ++i)
+        clamp.setConstraint((ConstraintRodComponent::ConstraintType)i, ConstraintRodComponent::kGlobal);
+    RodComponents rodComponents = {{geometry.id(), &geometry}, {mechanical.id(), &mechanical}, {clamp.id(), &clamp}};
+    RodDefinition definition;
+    definition.geometryID = geometry.id();
+    definition.mechanicalID = mechanical.id();
+    definition.startConstraintID = clamp.id();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    RodModalSolver solver;
+    RodModalOptions options;
+    QVERIFY(solver.solve(assembly.buffers(), options));
+    std::vector<RodMode> const& modes = solver.modes();
+    QCOMPARE(modes.size(), std::size_t(options.numModes));
+    // The lowest modes are the first and second bending modes of Euler-Bernoulli beams in both planes
+    auto computeFrequency = [&](double root, double stiffness)
+    {
+        return root * root * std::sqrt(stiffness / (kLinearMassDensity * std::pow(kLength, 4))) / (2.0 * std::numbers::pi);
+    };
+    std::vector<double> expectedFrequencies = {computeFrequency(1.8751040687, 100.0), computeFrequency(1.8751040687, 200.0),
+                                               computeFrequency(4.6940911330, 100.0), computeFrequency(4.6940911330, 200.0)};
+    for (quint32 i = 0; i != expectedFrequencies.size(); ++i)
+        QVERIFY(std::abs(modes[i].frequency / expectedFrequencies[i] - 1.0) < 1e-3);
+    // Shapes are normalized by the lumped mass
+    RodBuffers const& buffers = assembly.buffers();
+    quint32 numStations = buffers.numStations();
+    double modalMass = 0.0;
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        double tributaryLength = 0.5 * (buffers.arcLengths[std::min(i + 1, numStations - 1)] - buffers.arcLengths[i > 0 ? i - 1 : 0]);
+        for (int k = 0; k != 3; ++k)
+            modalMass += kLinearMassDensity * tributaryLength * std::pow(modes[0].displacements[k][i], 2);
+    }
+    QVERIFY(std::abs(modalMass - 1.0) < 1e-8);
+    // Partial reorthogonalization gives the same modes with fewer operations
+    quint32 numReorthogonalizations = solver.numReorthogonalizations();
+    std::vector<double> frequencies;
+    for (RodMode const& mode : modes)
+        frequencies.push_back(mode.frequency);
+    options.reorthogonalization = RodModalOptions::kPartial;
+    QVERIFY(solver.solve(assembly.buffers(), options));
+    QVERIFY(solver.numReorthogonalizations() < numReorthogonalizations);
+    for (quint32 i = 0; i != frequencies.size(); ++i)
+        QVERIFY(std::abs(modes[i].frequency / frequencies[i] - 1.0) < 1e-8);
+}
+
+//! Integrate the motion of a cantilever which is suddenly loaded at the tip
+void TestCore::solveRodDynamics()
+{
+    double const kForce = 0.1;
+    double const kBendingStiffness = 150.0;
+    Cantilever cantilever(kBendingStiffness);
+    cantilever.force.setMultiplier(kForce);
+    // Damping which is close to the critical one of the first mode
+    LoadRodComponent damping("Damping");
+    damping.setType(LoadRodComponent::LoadType::kDisplacementDamping);
+    damping.setDirectionVector(&cantilever.direction);
+    damping.setMultiplier(0.86);
+    RodComponents rodComponents = cantilever.components();
+    rodComponents.emplace(damping.id(), &damping);
+    RodDefinition definition = cantilever.definition();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    // The undamped rod overshoots the static deflection twice as much during the first half of the period
+    double staticDeflection = kForce * std::pow(Cantilever::kLength, 3) / (3.0 * kBendingStiffness);
+    double maxDeflection = 0.0;
+    auto writer = [&maxDeflection](double, RodState const& state)
+    {
+        maxDeflection = std::max(maxDeflection, state.positions[0][state.numStations() - 1]);
+        return true;
+    };
+    RodDynamicSolver solver;
+    RodDynamicOptions options;
+    options.endTime = 10.0;
+    options.initialTimeStep = 0.01;
+    options.maxTimeStep = 1.0;
+    QVERIFY(solver.solve(assembly.buffers(), options, writer));
+    QCOMPARE(solver.time(), options.endTime);
+    double ratio = maxDeflection / staticDeflection;
+    QVERIFY(ratio > 1.8 && ratio < 2.05);
+    // The damped rod settles at the static deflection
+    definition.loadIDs = {cantilever.force.id(), damping.id()};
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    options.endTime = 40.0;
+    QVERIFY(solver.solve(assembly.buffers(), options));
+    RodState const& state = solver.state();
+    QVERIFY(std::abs(state.positions[0][state.numStations() - 1] / staticDeflection - 1.0) < 2e-3);
+}
+
+//! Integrate the motion of a suddenly loaded cantilever whose tension stiffness decreases towards the tip by the explicit method
+void TestCore::solveRodExplicit()
+{
+    double const kForce = 0.1;
+    double const kBendingStiffness = 150.0;
+    Cantilever cantilever(kBendingStiffness);
+    cantilever.tensionStiffness.setArrayValue(0.0, 1.6e6);
+    cantilever.tensionStiffness.addItem(Cantilever::kLength)[0][0] = 1e5;
+    cantilever.force.setMultiplier(kForce);
+    RodComponents rodComponents = cantilever.components();
+    RodDefinition definition = cantilever.definition(51);
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    // The elements near the clamp subcycle the time step, and the rod overshoots the static deflection twice as much
+    double staticDeflection = kForce * std::pow(Cantilever::kLength, 3) / (3.0 * kBendingStiffness);
+    double maxDeflection = 0.0;
+    auto writer = [&maxDeflection](double, RodState const& state)
+    {
+        maxDeflection = std::max(maxDeflection, state.positions[0][state.numStations() - 1]);
+        return true;
+    };
+    RodExplicitSolver solver;
+    RodExplicitOptions options;
+    options.endTime = 10.0;
+    options.maxNumSubcycles = 4;
+    QVERIFY(solver.solve(assembly.buffers(), options, writer));
+    QCOMPARE(solver.time(), options.endTime);
+    QVERIFY(solver.numSubcycles() > 1);
+    quint64 numElements = definition.numStations - 1;
+    QVERIFY(solver.numEvaluations() < solver.numSteps() * solver.numSubcycles() * numElements);
+    double ratio = maxDeflection / staticDeflection;
+    QVERIFY(ratio > 1.8 && ratio < 2.05);
+    // The parallel computation gives the same results as the serial one
+    definition.numStations = 4001;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    options.endTime = 1e-3;
+    RodExplicitSolver serialSolver;
+    serialSolver.setParallel(false);
+    QVERIFY(serialSolver.solve(assembly.buffers(), options));
+    QVERIFY(solver.solve(assembly.buffers(), options));
+    QCOMPARE(solver.numSteps(), serialSolver.numSteps());
+    QVERIFY(solver.state().positions == serialSolver.state().positions);
+    QVERIFY(solver.state().frames == serialSolver.state().frames);
+}
+
+//! Specify ways to sample fields of a rod
+void TestCore::benchmarkSampling_data()
+{
+    QTest::addColumn<bool>("isFused");
+    QTest::newRow("separate") << false;
+    QTest::newRow("fused") << true;
+}
+
+//! Compare the sampling of each object separately with the fused one for a rod which refers to many objects
+void TestCore::benchmarkSampling()
+{
+    QFETCH(bool, isFused);
+    quint32 const numObjects = 24;
+    quint32 const numKeys = 2000;
+    quint32 const numStations = 20000;
+    std::vector<ScalarDataObject*> dataObjects;
+    for (quint32 i = 0; i != numObjects; ++i)
+    {
+        ScalarDataObject* pDataObject = new ScalarDataObject(QString("Field %1").arg(i));
+        // Most of the objects share the same keys
+        double step = i % 4 != 0 ? 1.0 : 1.0 + 1e-3 * i;
+        for (quint32 j = 0; j != numKeys; ++j)
+            pDataObject->addItem(j * step)[0][0] = std::sin(i + 0.01 * j);
+        dataObjects.push_back(pDataObject);
+    }
+    std::vector<double> parameters(numStations);
+    for (quint32 i = 0; i != numStations; ++i)
+        parameters[i] = (double)i * numKeys / numStations;
+    std::vector<std::vector<double>> values(numObjects, std::vector<double>(numStations));
+    RodSampler sampler;
+    for (quint32 i = 0; i != numObjects; ++i)
+        sampler.addField(dataObjects[i], 0, values[i].data());
+    if (isFused)
+    {
+        QBENCHMARK
+        {
+            sampler.sample(parameters);
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for (quint32 i = 0; i != numObjects; ++i)
+                RodAssembly::sampleElement(dataObjects[i], 0, parameters, values[i]);
+        }
+    }
+    for (ScalarDataObject* pDataObject : dataObjects)
+        delete pDataObject;
+}
+
+//! Specify ways to compute rotations between neighbouring frames
+void TestCore::benchmarkRotations_data()
+{
+    QTest::addColumn<bool>("isBatched");
+    QTest::newRow("scalar") << false;
+    QTest::newRow("batched") << true;
+}
+
+//! Compare the scalar and batched computation of rotation vectors between neighbouring frames of a rod
+void TestCore::benchmarkRotations()
+{
+    using namespace QRS::Core::Rotations;
+    QFETCH(bool, isBatched);
+    quint32 const numStations = 100000;
+    // Frames of the previous and next stations
+    std::array<std::vector<double>, 9> startFrames, endFrames;
+    std::array<std::vector<double>, 3> vectors, expectedVectors;
+    for (int k = 0; k != 9; ++k)
+    {
+        startFrames[k].resize(numStations);
+        endFrames[k].resize(numStations);
+    }
+    for (int k = 0; k != 3; ++k)
+    {
+        vectors[k].resize(numStations);
+        expectedVectors[k].resize(numStations);
+    }
+    for (quint32 i = 0; i != numStations; ++i)
+    {
+        Vector3 startVector = {1e-3 * i, 5e-4 * i, 0.3};
+        Vector3 relativeVector = {1e-2 * std::sin(i), 1e-2 * std::cos(i), 2e-3};
+        Matrix33 startFrame = expMap(startVector);
+        Matrix33 endFrame = startFrame * expMap(relativeVector);
+        for (int k = 0; k != 9; ++k)
+        {
+            startFrames[k][i] = startFrame[k];
+            endFrames[k][i] = endFrame[k];
+        }
+        for (int k = 0; k != 3; ++k)
+            expectedVectors[k][i] = relativeVector[k];
+    }
+    if (isBatched)
+    {
+        QBENCHMARK
+        {
+            BatchMatrix33<> startBatch, endBatch, relativeBatch;
+            BatchVector3<> vectorsBatch;
+            for (quint32 i = 0; i < numStations; i += skBatchWidth)
+            {
+                startBatch.load(startFrames, i);
+                endBatch.load(endFrames, i);
+                transposeProduct(startBatch, endBatch, relativeBatch);
+                logMap(relativeBatch, vectorsBatch);
+                vectorsBatch.store(vectors, i);
+            }
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for (quint32 i = 0; i != numStations; ++i)
+            {
+                Matrix33 startFrame, endFrame;
+                for (int k = 0; k != 9; ++k)
+                {
+                    startFrame[k] = startFrames[k][i];
+                    endFrame[k] = endFrames[k][i];
+                }
+                Vector3 vector = logMap(transposeProduct(startFrame, endFrame));
+                for (int k = 0; k != 3; ++k)
+                    vectors[k][i] = vector[k];
+            }
+        }
+    }
+    for (int k = 0; k != 3; ++k)
+    {
+        for (quint32 i = 0; i != numStations; ++i)
+            QVERIFY(std::abs(vectors[k][i] - expectedVectors[k][i]) < 1e-12);
+    }
+}
+
+//! Specify whether an expression is evaluated for each item separately or for all of them at once
+void TestCore::benchmarkExpression_data()
+{
+    QTest::addColumn<bool>("isBatched");
+    QTest::newRow("per item") << false;
+    QTest::newRow("batched") << true;
+}
+
+//! Compare evaluation of an expression item by item with evaluation in batches
+void TestCore::benchmarkExpression()
+{
+    QFETCH(bool, isBatched);
+    quint32 const numValues = 100000;
+    Expression expression("sqrt(x * x + key * key) / 2 + sin(key) * max(x, 0.5)");
+    QVERIFY(expression.isValid());
+    std::vector<double> values(numValues), keys(numValues), result(numValues);
+    for (quint32 i = 0; i != numValues; ++i)
+    {
+        values[i] = std::cos(1e-3 * i);
+        keys[i] = 1e-2 * i;
+    }
+    if (isBatched)
+    {
+        QBENCHMARK
+        {
+            double const* variables[] = {values.data(), keys.data()};
+            expression.evaluate(variables, result.data(), numValues);
+        }
+    }
+    else
+    {
+        QBENCHMARK
+        {
+            for (quint32 i = 0; i != numValues; ++i)
+            {
+                double const* variables[] = {&values[i], &keys[i]};
+                expression.evaluate(variables, &result[i], 1);
+            }
+        }
+    }
+    for (quint32 i = 0; i != numValues; i += 997)
+    {
+        double expected = std::sqrt(values[i] * values[i] + keys[i] * keys[i]) / 2 + std::sin(keys[i]) * std::max(values[i], 0.5);
+        QVERIFY(std::abs(result[i] - expected) < 1e-12);
+    }
+}
+
+//! Specify numbers of stations of the rod to solve
+void TestCore::benchmarkRodStatics_data()
+{
+    QTest::addColumn<quint32>("numStations");
+    QTest::newRow("1k") << quint32(1001);
+    if (isLargeBenchmarksEnabled())
+        QTest::newRow("100k") << quint32(100001);
+}
+
+//! Find the large deflection of a cantilever under a distributed load
+void TestCore::benchmarkRodStatics()
+{
+    QFETCH(quint32, numStations);
+    Cantilever cantilever;
+    cantilever.force.setType(LoadRodComponent::LoadType::kDistributedForce);
+    RodComponents rodComponents = cantilever.components();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(cantilever.definition(numStations), rodComponents));
+    RodStaticSolver solver;
+    QBENCHMARK
+    {
+        QVERIFY(solver.solve(assembly.buffers()));
+    }
+    // The tip rotates by wL^3 / (6 EI) = 1.67 rad according to the linear theory, so the solution differs a lot from it
+    QVERIFY(solver.state().positions[0][numStations - 1] > 5.0);
+}
+
+//! Specify sizes of rods for the modal analysis
+void TestCore::benchmarkRodModes_data()
+{
+    QTest::addColumn<quint32>("numStations");
+    QTest::newRow("10k DOF") << quint32(1667);
+    if (isLargeBenchmarksEnabled())
+        QTest::newRow("100k DOF") << quint32(16667);
+}
+
+//! Compute the lowest modes of a cantilever
+void TestCore::benchmarkRodModes()
+{
+    QFETCH(quint32, numStations);
+    Cantilever cantilever(150.0);
+    RodComponents rodComponents = cantilever.components();
+    RodDefinition definition = cantilever.definition(numStations);
+    definition.loadIDs.clear();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(definition, rodComponents));
+    RodModalSolver solver;
+    RodModalOptions options;
+    options.reorthogonalization = RodModalOptions::kPartial;
+    QBENCHMARK
+    {
+        QVERIFY(solver.solve(assembly.buffers(), options));
+    }
+    QCOMPARE(solver.modes().size(), std::size_t(options.numModes));
+}
+
+//! Specify sizes of rods for the transient analysis
+void TestCore::benchmarkRodDynamics_data()
+{
+    QTest::addColumn<quint32>("numStations");
+    QTest::addColumn<bool>("isAdaptive");
+    QTest::newRow("1k stations") << quint32(1001) << false;
+    QTest::newRow("1k stations, adaptive") << quint32(1001) << true;
+    if (isLargeBenchmarksEnabled())
+        QTest::newRow("100k stations") << quint32(100001) << false;
+}
+
+/*!
+ * \brief Integrate the motion of a suddenly loaded cantilever
+ *
+ * Either a few constant time steps are done, or the time step is adapted to the local error starting from a coarse one.
+ * In the latter case, some steps have to be rejected, and the tip deflection is compared with the one obtained by
+ * fine constant time steps.
+ */
+void TestCore::benchmarkRodDynamics()
+{
+    QFETCH(quint32, numStations);
+    QFETCH(bool, isAdaptive);
+    Cantilever cantilever;
+    RodComponents rodComponents = cantilever.components();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(cantilever.definition(numStations), rodComponents));
+    RodDynamicSolver solver;
+    RodDynamicOptions options;
+    if (isAdaptive)
+    {
+        options.endTime = 1.0;
+        options.initialTimeStep = options.maxTimeStep;
+        options.errorTolerance = 1e-4;
+    }
+    else
+    {
+        options.endTime = 0.05;
+        options.initialTimeStep = 0.01;
+        options.errorTolerance = 0.0;
+    }
+    QBENCHMARK
+    {
+        QVERIFY(solver.solve(assembly.buffers(), options));
+    }
+    if (!isAdaptive)
+    {
+        QCOMPARE(solver.numSteps(), quint32(5));
+        return;
+    }
+    QVERIFY(solver.numRejectedSteps() > 0);
+    RodDynamicSolver referenceSolver;
+    RodDynamicOptions referenceOptions = options;
+    referenceOptions.initialTimeStep = 1e-3;
+    referenceOptions.errorTolerance = 0.0;
+    QVERIFY(referenceSolver.solve(assembly.buffers(), referenceOptions));
+    QVERIFY(solver.numSteps() < referenceSolver.numSteps());
+    quint32 iTip = numStations - 1;
+    double deflection = solver.state().positions[0][iTip];
+    double referenceDeflection = referenceSolver.state().positions[0][iTip];
+    QVERIFY(referenceDeflection > 0.0);
+    QVERIFY(std::abs(deflection / referenceDeflection - 1.0) < 1e-2);
+}
+
+//! Specify sizes of rods whose motion is integrated explicitly and whether the integration is parallel
+void TestCore::benchmarkRodExplicit_data()
+{
+    QTest::addColumn<quint32>("numStations");
+    QTest::addColumn<bool>("isParallel");
+    QTest::newRow("1k stations") << quint32(1001) << true;
+    if (isLargeBenchmarksEnabled())
+    {
+        QTest::newRow("100k stations, serial") << quint32(100001) << false;
+        QTest::newRow("100k stations, parallel") << quint32(100001) << true;
+    }
+}
+
+//! Integrate about a hundred explicit time steps of a suddenly loaded cantilever
+void TestCore::benchmarkRodExplicit()
+{
+    QFETCH(quint32, numStations);
+    QFETCH(bool, isParallel);
+    Cantilever cantilever;
+    RodComponents rodComponents = cantilever.components();
+    RodAssembly assembly;
+    QVERIFY(assembly.assemble(cantilever.definition(numStations), rodComponents));
+    RodExplicitSolver solver;
+    solver.setParallel(isParallel);
+    RodExplicitOptions options;
+    // The stable time step is proportional to the length of the elements
+    options.endTime = 2.5 / numStations;
+    QBENCHMARK
+    {
+        QVERIFY(solver.solve(assembly.buffers(), options));
+    }
+    QVERIFY(solver.numSteps() > 0);
+}
+
 //! Cleanup
 void TestCore::cleanupTestCase()
 {
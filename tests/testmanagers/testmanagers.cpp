@@ -23,10 +23,16 @@
 #include "managers/managersfactory.h"
 #include "managers/dataobjectsmanager.h"
 #include "managers/rodcomponentsmanager.h"
+#include "models/hierarchy/dataobjectshierarchymodel.h"
+#include "models/table/tablemodelinterface.h"
 
 using namespace QRS::Managers;
 using namespace QRS::Core;
 using namespace QRS::Utilities;
+using namespace QRS::HierarchyModels;
+using namespace QRS::TableModels;
+
+QString const skHierarchyMimeType = "testmanagers/hierarchy";
 
 //! Test managers while creating data objects and modifying them
 class TestManagers : public QObject
@@ -37,8 +43,17 @@ private slots:
     void initTestCase();
     void testDataObjectsManager();
     void testRodComponentsManager();
+    void prepareContent();
+    void parseValues();
+    void copyValues();
+    void mirrorHierarchy();
+    void populateHierarchy();
     void cleanupTestCase();
 
+private:
+    bool isMirrored(QStandardItem const* pParentItem, HierarchyNode* pParentNode, DataObjects const& dataObjects,
+                    bool isPopulated = true) const;
+
 private:
     Project* mpProject;
     QSettings* mpSettings;
@@ -144,6 +159,201 @@ void TestManagers::testRodComponentsManager()
     pManager->apply();
 }
 
+//! Copy entities of the project in a background thread while the project is being modified
+void TestManagers::prepareContent()
+{
+    const int kNumAdded = 100;
+    mpProject->addGeometry();
+    DataIDType numDataObjects = mpProject->numberDataObjects();
+    DataObjects dataObjects;
+    RodComponents rodComponents;
+    HierarchyTree hierarchyDataObjects;
+    HierarchyTree hierarchyRodComponents;
+    QThread* pThread = QThread::create([&]()
+    {
+        mpProject->snapshotDataObjects(dataObjects, hierarchyDataObjects);
+        mpProject->snapshotRodComponents(rodComponents, hierarchyRodComponents);
+    });
+    pThread->start();
+    for (int i = 0; i != kNumAdded; ++i)
+        mpProject->addDataObject(AbstractDataObject::kScalar);
+    pThread->wait();
+    delete pThread;
+    // The copies are consistent with the hierarchy, even though some additions could be missed
+    QVERIFY(dataObjects.size() >= numDataObjects);
+    QCOMPARE(hierarchyDataObjects.root()->numberChildren(), quint32(dataObjects.size()));
+    // Components are passed to the main thread to be used by widgets
+    QVERIFY(!rodComponents.empty());
+    for (auto& item : rodComponents)
+        QCOMPARE(item.second->thread(), QThread::currentThread());
+    for (auto& item : dataObjects)
+        delete item.second;
+    for (auto& item : rodComponents)
+        delete item.second;
+    // Populating a manager when the copying is finished
+    mpManagersFactory->deleteManager(AbstractManager::ManagerType::kRodComponents);
+    QVERIFY(mpManagersFactory->createManager(AbstractManager::ManagerType::kRodComponents));
+    AbstractManager* pManager = mpManagersFactory->manager(AbstractManager::ManagerType::kRodComponents);
+    QVERIFY(pManager->isLoading());
+    mpProject->addGeometry();
+    QTRY_VERIFY(!pManager->isLoading());
+    mpManagersFactory->deleteManager(AbstractManager::ManagerType::kRodComponents);
+}
+
+//! Parse values pasted from spreadsheets and text files
+void TestManagers::parseValues()
+{
+    QLocale::setDefault(QLocale::c());
+    // Tabulations separate values, empty cells are skipped and the trailing line is ignored
+    ValuesTable values = TableModelInterface::parseValues("1\t2.5\n\t-3e2\n");
+    QCOMPARE(values.size(), 2);
+    QCOMPARE(values[0], QList<double>({1.0, 2.5}));
+    QCOMPARE(values[1].size(), 2);
+    QVERIFY(qIsNaN(values[1][0]));
+    QCOMPARE(values[1][1], -300.0);
+    // Commas are decimal separators when the values are separated otherwise
+    values = TableModelInterface::parseValues("1,5\t2\n3;4");
+    QCOMPARE(values.size(), 2);
+    QCOMPARE(values[0], QList<double>({1.5, 2.0}));
+    QCOMPARE(values[1].size(), 1);
+    QVERIFY(qIsNaN(values[1][0]));
+    values = TableModelInterface::parseValues("0,5;2\n3;4,25");
+    QCOMPARE(values, ValuesTable({{0.5, 2.0}, {3.0, 4.25}}));
+    // Otherwise, commas separate values unless the locale uses them as decimal separators
+    values = TableModelInterface::parseValues("1.5,2\n3,4");
+    QCOMPARE(values, ValuesTable({{1.5, 2.0}, {3.0, 4.0}}));
+    QLocale::setDefault(QLocale(QLocale::German));
+    values = TableModelInterface::parseValues("1,5\n3");
+    QCOMPARE(values, ValuesTable({{1.5}, {3.0}}));
+    QLocale::setDefault(QLocale::c());
+}
+
+//! Copy values of cells in the format which spreadsheets accept
+void TestManagers::copyValues()
+{
+    QStandardItemModel model;
+    for (int i = 0; i != 3; ++i)
+    {
+        QList<QStandardItem*> row;
+        for (int j = 0; j != 3; ++j)
+            row.push_back(TableModelInterface::makeDoubleItem(3 * i + j + 0.5));
+        model.appendRow(row);
+    }
+    QCOMPARE(TableModelInterface::copyValues({}), QString());
+    // Indices are sorted by position, and gaps within rows are kept
+    QModelIndexList indices = {model.index(1, 2), model.index(0, 1), model.index(1, 0), model.index(0, 2)};
+    QString text = TableModelInterface::copyValues(indices);
+    QCOMPARE(text, QString("\t1.5\t2.5\n3.5\t\t5.5\n"));
+    // Copied values are parsed back in the same positions
+    ValuesTable values = TableModelInterface::parseValues(text);
+    QCOMPARE(values.size(), 2);
+    QCOMPARE(values[0].size(), 3);
+    QVERIFY(qIsNaN(values[0][0]));
+    QCOMPARE(values[0][2], 2.5);
+    QCOMPARE(values[1].size(), 3);
+    QVERIFY(qIsNaN(values[1][1]));
+    QCOMPARE(values[1][2], 5.5);
+}
+
+//! Check that the hierarchy model follows the insertions, moves and removals of the nodes
+void TestManagers::mirrorHierarchy()
+{
+    Project project("Hierarchy");
+    for (int i = 0; i != 4; ++i)
+        project.addDataObject(AbstractDataObject::kScalar);
+    DataObjects dataObjects = project.cloneDataObjects();
+    HierarchyTree hierarchy = project.cloneHierarchyDataObjects();
+    QTreeView view;
+    DataObjectsHierarchyModel* pModel = new DataObjectsHierarchyModel(dataObjects, hierarchy, skHierarchyMimeType, &view);
+    view.setModel(pModel);
+    QCOMPARE(pModel->rowCount(), 4);
+    QVERIFY(isMirrored(pModel->invisibleRootItem(), hierarchy.root(), dataObjects));
+    // Dropping an item on another one inserts a folder in place of the target item
+    QMimeData* pMimeData = pModel->mimeData({pModel->index(2, 0)});
+    pModel->dropMimeData(pMimeData, Qt::CopyAction, -1, -1, pModel->index(0, 0));
+    delete pMimeData;
+    QCOMPARE(pModel->rowCount(), 3);
+    QCOMPARE(pModel->rowCount(pModel->index(0, 0)), 2);
+    QVERIFY(isMirrored(pModel->invisibleRootItem(), hierarchy.root(), dataObjects));
+    // Dropping an item between others moves it
+    QString name = pModel->index(1, 0).data().toString();
+    pMimeData = pModel->mimeData({pModel->index(1, 0)});
+    pModel->dropMimeData(pMimeData, Qt::CopyAction, 3, 0, QModelIndex());
+    delete pMimeData;
+    QCOMPARE(pModel->rowCount(), 3);
+    QCOMPARE(pModel->index(2, 0).data().toString(), name);
+    QVERIFY(isMirrored(pModel->invisibleRootItem(), hierarchy.root(), dataObjects));
+    // Removing selected items deletes only their rows
+    view.selectionModel()->select(pModel->index(1, 0), QItemSelectionModel::SelectCurrent);
+    pModel->removeSelectedItems();
+    QCOMPARE(pModel->rowCount(), 2);
+    QCOMPARE(dataObjects.size(), std::size_t(3));
+    QVERIFY(isMirrored(pModel->invisibleRootItem(), hierarchy.root(), dataObjects));
+    for (auto& [id, pDataObject] : dataObjects)
+        delete pDataObject;
+}
+
+//! Check that the children of folders are represented only when they are fetched
+void TestManagers::populateHierarchy()
+{
+    Project project("Hierarchy");
+    for (int i = 0; i != 3; ++i)
+        project.addDataObject(AbstractDataObject::kScalar);
+    DataObjects dataObjects = project.cloneDataObjects();
+    HierarchyTree hierarchy = project.cloneHierarchyDataObjects();
+    QTreeView view;
+    DataObjectsHierarchyModel* pModel = new DataObjectsHierarchyModel(dataObjects, hierarchy, skHierarchyMimeType, &view);
+    view.setModel(pModel);
+    QMimeData* pMimeData = pModel->mimeData({pModel->index(1, 0), pModel->index(2, 0)});
+    pModel->dropMimeData(pMimeData, Qt::CopyAction, -1, -1, pModel->index(0, 0));
+    delete pMimeData;
+    // Items which are created again represent only the top level
+    pModel->updateContent();
+    QCOMPARE(pModel->rowCount(), 1);
+    QModelIndex indexFolder = pModel->index(0, 0);
+    QVERIFY(!pModel->canFetchMore(QModelIndex()));
+    QVERIFY(pModel->canFetchMore(indexFolder));
+    QVERIFY(pModel->hasChildren(indexFolder));
+    QCOMPARE(pModel->rowCount(indexFolder), 0);
+    pModel->fetchMore(indexFolder);
+    QVERIFY(!pModel->canFetchMore(indexFolder));
+    QCOMPARE(pModel->rowCount(indexFolder), 3);
+    QVERIFY(isMirrored(pModel->invisibleRootItem(), hierarchy.root(), dataObjects));
+    // Selecting an object populates the path to it
+    pModel->updateContent();
+    pModel->selectItemByID(dataObjects.begin()->first);
+    QVERIFY(!pModel->canFetchMore(pModel->index(0, 0)));
+    QCOMPARE(view.selectionModel()->selectedIndexes().size(), 1);
+    for (auto& [id, pDataObject] : dataObjects)
+        delete pDataObject;
+}
+
+//! Check whether the items represent the children of the nodes in the same order
+bool TestManagers::isMirrored(QStandardItem const* pParentItem, HierarchyNode* pParentNode, DataObjects const& dataObjects,
+                              bool isPopulated) const
+{
+    HierarchyNode* pNode = pParentNode->firstChild();
+    int numRows = pParentItem->rowCount();
+    for (int i = 0; i != numRows; ++i)
+    {
+        if (!pNode)
+            return false;
+        QStandardItem const* pItem = pParentItem->child(i);
+        QString name;
+        if (pNode->type() == HierarchyNode::NodeType::kDirectory)
+            name = pNode->value().toString();
+        else
+            name = dataObjects.at(pNode->value().value<DataIDType>())->name();
+        if (pItem->text() != name)
+            return false;
+        if (!isMirrored(pItem, pNode, dataObjects, ((AbstractHierarchyItem const*)pItem)->isPopulated()))
+            return false;
+        pNode = pNode->nextSibling();
+    }
+    // Children of items which have not been populated are not represented yet
+    return !pNode || (!isPopulated && numRows == 0);
+}
+
 //! Cleanup
 void TestManagers::cleanupTestCase()
 {